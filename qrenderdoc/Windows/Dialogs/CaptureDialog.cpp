@@ -72,6 +72,10 @@ QVariantMap CaptureSettings::toJSON() const
   opts["SaveAllInitials"] = Options.SaveAllInitials;
   opts["CaptureAllCmdLists"] = Options.CaptureAllCmdLists;
   opts["DebugOutputMute"] = Options.DebugOutputMute;
+  opts["FlightRecorderFrames"] = Options.FlightRecorderFrames;
+  opts["FlightRecorderMemoryMB"] = Options.FlightRecorderMemoryMB;
+  opts["CaptureMemoryBudgetMB"] = Options.CaptureMemoryBudgetMB;
+  opts["ProfileLocks"] = Options.ProfileLocks;
   ret["Options"] = opts;
 
   return ret;
@@ -107,6 +111,11 @@ void CaptureSettings::fromJSON(const QVariantMap &data)
   Options.SaveAllInitials = opts["SaveAllInitials"].toBool();
   Options.CaptureAllCmdLists = opts["CaptureAllCmdLists"].toBool();
   Options.DebugOutputMute = opts["DebugOutputMute"].toBool();
+  Options.FlightRecorderFrames = opts["FlightRecorderFrames"].toUInt();
+  if(opts.contains("FlightRecorderMemoryMB"))
+    Options.FlightRecorderMemoryMB = opts["FlightRecorderMemoryMB"].toUInt();
+  Options.CaptureMemoryBudgetMB = opts["CaptureMemoryBudgetMB"].toUInt();
+  Options.ProfileLocks = opts["ProfileLocks"].toBool();
 }
 
 CaptureDialog::CaptureDialog(CaptureContext *ctx, OnCaptureMethod captureCallback,
@@ -191,6 +191,47 @@ typedef enum {
   // 0 - API debugging is displayed as normal
   eRENDERDOC_Option_DebugOutputMute = 11,
 
+  // Keep recent frames in memory so they can be saved after the fact with SaveRecentFrame(). In
+  // this mode every frame is captured, but only written to disk when requested. Frames are
+  // recorded in segments of up to N frames that share one copy of the initial contents, and a
+  // saved frame is written out along with the rest of its segment.
+  //
+  // Each segment starts the same way as a normal capture, fetching the initial contents of every
+  // resource, so as well as the steady cost of recording each frame there's a stall every N
+  // frames. The measured overhead per frame is written to the log when a frame is saved.
+  //
+  // Default - 0
+  //
+  // 0 - Frames are only captured when a capture is triggered
+  // N - The last N frames are kept in memory, up to FlightRecorderMemoryMB in total
+  eRENDERDOC_Option_FlightRecorderFrames = 12,
+
+  // The most memory in megabytes that frames kept by FlightRecorderFrames can use. The oldest
+  // frames are discarded first to stay under this limit.
+  //
+  // Default - 256
+  eRENDERDOC_Option_FlightRecorderMemoryMB = 13,
+
+  // The most memory in megabytes that captured data can occupy while a frame is being captured.
+  // Past this, data that won't be needed again until the capture is written out, such as
+  // submitted command buffers and completed initial contents, is moved to a temporary file.
+  //
+  // Default - 0
+  //
+  // 0 - No limit, all captured data stays in memory until the capture is written out
+  // N - Spill the oldest captured data to disk once more than N megabytes are in use
+  eRENDERDOC_Option_CaptureMemoryBudgetMB = 14,
+
+  // Track contention on RenderDoc's own internal locks. This records how often each lock is taken,
+  // how long threads wait on it and where it was held from. Results are logged at the end of each
+  // capture and sent over target control.
+  //
+  // Default - disabled
+  //
+  // 1 - Lock contention is measured, at a small cost on each lock
+  // 0 - Locks are not measured
+  eRENDERDOC_Option_ProfileLocks = 15,
+
 } RENDERDOC_CaptureOption;
 
 // Sets an option that controls how RenderDoc behaves on capture.
@@ -430,9 +471,20 @@ typedef void(RENDERDOC_CC *pRENDERDOC_SetActiveWindow)(RENDERDOC_DevicePointer d
 // capture the next frame on whichever window and API is currently considered active
 typedef void(RENDERDOC_CC *pRENDERDOC_TriggerCapture)();
 
-// capture the next N frames on whichever window and API is currently considered active
+// capture the next N frames on whichever window and API is currently considered active.
+// All N frames go into one capture, which stores resources and initial contents only once.
 typedef void(RENDERDOC_CC *pRENDERDOC_TriggerMultiFrameCapture)(uint32_t numFrames);
 
+// When eRENDERDOC_Option_FlightRecorderFrames is enabled, saves a frame that has already been
+// presented to disk, just as if it had been captured. 0 is the most recently completed frame,
+// 1 the frame before that, and so on. The capture holds the other frames recorded in the same
+// segment too, since the frames before the requested one are needed to reach its starting state.
+// It's named after the requested frame. If that segment is still being recorded it's ended and
+// written at the next present.
+//
+// Returns 1 if the frame was saved, or 0 if it's no longer (or was never) held in memory.
+typedef uint32_t(RENDERDOC_CC *pRENDERDOC_SaveRecentFrame)(uint32_t framesAgo);
+
 // When choosing either a device pointer or a window handle to capture, you can pass NULL.
 // Passing NULL specifies a 'wildcard' match against anything. This allows you to specify
 // any API rendering to a specific window, or a specific API instance rendering to any window,
@@ -484,6 +536,7 @@ typedef enum {
   eRENDERDOC_API_Version_1_0_2 = 10002,    // RENDERDOC_API_1_0_2 = 1 00 02
   eRENDERDOC_API_Version_1_1_0 = 10100,    // RENDERDOC_API_1_1_0 = 1 01 00
   eRENDERDOC_API_Version_1_1_1 = 10101,    // RENDERDOC_API_1_1_1 = 1 01 01
+  eRENDERDOC_API_Version_1_2_0 = 10200,    // RENDERDOC_API_1_2_0 = 1 02 00
 } RENDERDOC_Version;
 
 // API version changelog:
@@ -496,6 +549,8 @@ typedef enum {
 //         function pointer is added to the end of the struct, the original layout is identical
 // 1.1.1 - Refactor: Renamed remote access to target control (to better disambiguate from remote
 //         replay/remote server concept in replay UI)
+// 1.2.0 - Add feature: SaveRecentFrame() and the flight recorder capture options, for saving
+//         frames after they've been presented.
 
 // eRENDERDOC_API_Version_1_1_0
 typedef struct
@@ -588,6 +643,48 @@ typedef struct
   pRENDERDOC_TriggerMultiFrameCapture TriggerMultiFrameCapture;
 } RENDERDOC_API_1_1_1;
 
+// eRENDERDOC_API_Version_1_2_0
+typedef struct
+{
+  pRENDERDOC_GetAPIVersion GetAPIVersion;
+
+  pRENDERDOC_SetCaptureOptionU32 SetCaptureOptionU32;
+  pRENDERDOC_SetCaptureOptionF32 SetCaptureOptionF32;
+
+  pRENDERDOC_GetCaptureOptionU32 GetCaptureOptionU32;
+  pRENDERDOC_GetCaptureOptionF32 GetCaptureOptionF32;
+
+  pRENDERDOC_SetFocusToggleKeys SetFocusToggleKeys;
+  pRENDERDOC_SetCaptureKeys SetCaptureKeys;
+
+  pRENDERDOC_GetOverlayBits GetOverlayBits;
+  pRENDERDOC_MaskOverlayBits MaskOverlayBits;
+
+  pRENDERDOC_Shutdown Shutdown;
+  pRENDERDOC_UnloadCrashHandler UnloadCrashHandler;
+
+  pRENDERDOC_SetLogFilePathTemplate SetLogFilePathTemplate;
+  pRENDERDOC_GetLogFilePathTemplate GetLogFilePathTemplate;
+
+  pRENDERDOC_GetNumCaptures GetNumCaptures;
+  pRENDERDOC_GetCapture GetCapture;
+
+  pRENDERDOC_TriggerCapture TriggerCapture;
+
+  pRENDERDOC_IsTargetControlConnected IsTargetControlConnected;
+  pRENDERDOC_LaunchReplayUI LaunchReplayUI;
+
+  pRENDERDOC_SetActiveWindow SetActiveWindow;
+
+  pRENDERDOC_StartFrameCapture StartFrameCapture;
+  pRENDERDOC_IsFrameCapturing IsFrameCapturing;
+  pRENDERDOC_EndFrameCapture EndFrameCapture;
+
+  pRENDERDOC_TriggerMultiFrameCapture TriggerMultiFrameCapture;
+
+  pRENDERDOC_SaveRecentFrame SaveRecentFrame;
+} RENDERDOC_API_1_2_0;
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 // RenderDoc API entry point
 //
@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 // we provide a basic templated type that is a fixed array that just contains a pointer to the
@@ -106,6 +107,32 @@ struct array
     return *this;
   }
 
+  // the vector's storage can't be adopted, but its elements can be moved out so that any
+  // arrays/strings they contain aren't deep copied.
+  array(std::vector<T> &&in)
+  {
+    elems = 0;
+    count = 0;
+    *this = std::move(in);
+  }
+  array &operator=(std::vector<T> &&in)
+  {
+    Delete();
+    count = (int32_t)in.size();
+    if(count == 0)
+    {
+      elems = 0;
+    }
+    else
+    {
+      elems = (T *)allocate(sizeof(T) * count);
+      for(int32_t i = 0; i < count; i++)
+        new(elems + i) T(std::move(in[i]));
+    }
+    in.clear();
+    return *this;
+  }
+
   array(const array &o)
   {
     elems = 0;
@@ -134,6 +161,43 @@ struct array
     return *this;
   }
 
+  // moving just takes ownership of the other array's allocation, leaving it empty. These must be
+  // noexcept or std::vector will still copy elements when it reallocates
+  array(array &&o) noexcept
+  {
+    elems = o.elems;
+    count = o.count;
+    o.elems = 0;
+    o.count = 0;
+  }
+
+  array &operator=(array &&o) noexcept
+  {
+    if(this == &o)
+      return *this;
+
+    Delete();
+    swap(o);
+    return *this;
+  }
+
+  void swap(array &o)
+  {
+    std::swap(elems, o.elems);
+    std::swap(count, o.count);
+  }
+
+  // frees this array's contents and takes over o's, leaving o empty. For a caller that owns o and
+  // is done with it, this hands over the result without copying any elements
+  void take(array &o)
+  {
+    if(this == &o)
+      return;
+
+    Delete();
+    swap(o);
+  }
+
   // provide some of the familiar stl interface
   size_t size() const { return (size_t)count; }
   void clear() { Delete(); }
@@ -153,6 +217,12 @@ struct str : public rdctype::array<char>
   str(const str &o) : rdctype::array<char>() { *this = o; }
   str(const std::string &o) : rdctype::array<char>() { *this = o; }
   str(const char *const o) : rdctype::array<char>() { *this = o; }
+  str(str &&o) noexcept : rdctype::array<char>(std::move(o)) {}
+  str &operator=(str &&o) noexcept
+  {
+    rdctype::array<char>::operator=(std::move(o));
+    return *this;
+  }
   str &operator=(const str &o)
   {
     // do nothing if we're self-assigning
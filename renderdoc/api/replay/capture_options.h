@@ -49,4 +49,8 @@ struct CaptureOptions
   bool32 SaveAllInitials;
   bool32 CaptureAllCmdLists;
   bool32 DebugOutputMute;
+  uint32_t FlightRecorderFrames;
+  uint32_t FlightRecorderMemoryMB;
+  uint32_t CaptureMemoryBudgetMB;
+  bool32 ProfileLocks;
 };
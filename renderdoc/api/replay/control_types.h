@@ -201,6 +201,31 @@ struct TextureSave
   int jpegQuality;
 };
 
+// one texture written out by an export over a range of events
+struct TextureExport
+{
+  uint32_t eventID;
+  ResourceId id;
+
+  // the file holding this texture's contents at this event. If the contents were identical
+  // to a texture already exported, no new file is written and this is the earlier file.
+  rdctype::str path;
+  bool32 duplicate;
+};
+
+// contention on one of RenderDoc's internal locks in the target, see
+// eRENDERDOC_Option_ProfileLocks. Counts are totals since the target started.
+struct LockContentionStats
+{
+  rdctype::str name;
+  uint64_t acquisitions;
+  uint64_t contended;
+  double totalWaitMS;
+  double maxWaitMS;
+  // the call site that was holding the lock for the most time spent waiting on it
+  rdctype::str worstHolder;
+};
+
 struct TargetControlMessage
 {
   TargetControlMessage() {}
@@ -230,4 +255,19 @@ struct TargetControlMessage
     uint32_t PID;
     uint32_t ident;
   } NewChild;
+
+  struct CaptureMemoryData
+  {
+    // captured data held in memory, and moved out to the spill file
+    uint64_t residentBytes;
+    uint64_t spilledBytes;
+    uint64_t liveChunks;
+    // from eRENDERDOC_Option_CaptureMemoryBudgetMB, 0 for no limit
+    uint64_t budgetBytes;
+  } CaptureMemory;
+
+  struct LockContentionData
+  {
+    rdctype::array<LockContentionStats> locks;
+  } LockContention;
 };
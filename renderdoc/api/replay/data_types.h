@@ -40,6 +40,26 @@ struct DirectoryFile
   uint32_t flags;
 };
 
+struct RemoteServerSession
+{
+  // packed in host byte order
+  uint32_t clientIP;
+  // the capture this session has open, if any
+  rdctype::str capture;
+  // fraction of a core this session used over the last second
+  float cpuUsage;
+};
+
+struct RemoteServerStatus
+{
+  uint32_t maxSessions;
+  uint32_t maxQueued;
+  uint32_t queued;
+  // fraction of a core each session is limited to, or 0 if unlimited
+  float sessionCPUQuota;
+  rdctype::array<RemoteServerSession> sessions;
+};
+
 struct ResourceFormat
 {
   ResourceFormat()
@@ -313,6 +333,49 @@ struct FetchFrameInfo
   rdctype::array<DebugMessage> debugMessages;
 };
 
+// one of the frames in a capture. A capture triggered over several frames holds them all,
+// each ending with its present.
+struct FetchCapturedFrame
+{
+  uint32_t frameNumber;
+  uint32_t firstEvent;
+  uint32_t lastEvent;
+};
+
+struct FetchChunkLoadStats
+{
+  FetchChunkLoadStats() : chunkID(0), count(0), totalSize(0), totalTime(0.0) {}
+  uint32_t chunkID;
+  uint32_t count;
+  uint64_t totalSize;
+  double totalTime;
+  rdctype::str name;
+};
+
+struct FetchLoadProfile
+{
+  FetchLoadProfile()
+      : totalTime(0.0),
+        fileReadTime(0.0),
+        decompressTime(0.0),
+        initialContentsTime(0.0),
+        initialContentsApplyTime(0.0)
+  {
+  }
+
+  // all times are in milliseconds
+  double totalTime;
+  // time spent reading the capture from disk
+  double fileReadTime;
+  // time spent decompressing the capture as it was read, if it's compressed
+  double decompressTime;
+  // time spent processing initial contents chunks, including uploading their data
+  double initialContentsTime;
+  // time spent applying initial contents for the first time during load
+  double initialContentsApplyTime;
+  rdctype::array<FetchChunkLoadStats> chunks;
+};
+
 struct EventUsage
 {
 #ifdef __cplusplus
@@ -249,6 +249,8 @@ struct IReplayRenderer
   virtual bool GetD3D12PipelineState(D3D12PipelineState *state) = 0;
   virtual bool GetGLPipelineState(GLPipelineState *state) = 0;
   virtual bool GetVulkanPipelineState(VulkanPipelineState *state) = 0;
+  // incremented whenever SetFrameEvent results in a different pipeline state
+  virtual uint32_t GetPipelineStateVersion() = 0;
 
   virtual ResourceId BuildCustomShader(const char *entry, const char *source,
                                        const uint32_t compileFlags, ShaderStageType type,
@@ -263,6 +265,10 @@ struct IReplayRenderer
   virtual bool FreeTargetResource(ResourceId id) = 0;
 
   virtual bool GetFrameInfo(FetchFrameInfo *frame) = 0;
+  // lists the frames in the capture. Moving between frames is just SetFrameEvent to an event in
+  // the frame, no reload is needed.
+  virtual bool GetCapturedFrames(rdctype::array<FetchCapturedFrame> *frames) = 0;
+  virtual bool GetLoadProfile(FetchLoadProfile *profile) = 0;
   virtual bool GetDrawcalls(rdctype::array<FetchDrawcall> *draws) = 0;
   virtual bool FetchCounters(uint32_t *counters, uint32_t numCounters,
                              rdctype::array<CounterResult> *results) = 0;
@@ -291,12 +297,25 @@ struct IReplayRenderer
 
   virtual bool SaveTexture(const TextureSave &saveData, const char *path) = 0;
 
+  // saves the outputs bound at every drawcall in [firstEvent, lastEvent], or the given resources
+  // if numIDs is non-zero, to files named <pathPrefix>_<eventID>_<resource>.<ext>. saveData
+  // controls the format of each file, its id is ignored.
+  virtual bool ExportTextures(const TextureSave &saveData, uint32_t firstEvent, uint32_t lastEvent,
+                              const ResourceId *ids, uint32_t numIDs, const char *pathPrefix,
+                              rdctype::array<TextureExport> *exports) = 0;
+
   virtual bool GetPostVSData(uint32_t instID, MeshDataStage stage, MeshFormat *data) = 0;
 
   virtual bool GetBufferData(ResourceId buff, uint64_t offset, uint64_t len,
                              rdctype::array<byte> *data) = 0;
   virtual bool GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
                               rdctype::array<byte> *data) = 0;
+  // reads a box out of one subresource. The region is clamped to the subresource and aligned out
+  // to whole blocks, and on return x/y/z/width/height/depth hold the region actually read. Fails
+  // for formats that can't be cropped, such as ASTC with blocks other than 4x4.
+  virtual bool GetTextureRegionData(ResourceId tex, uint32_t arrayIdx, uint32_t mip, uint32_t *x,
+                                    uint32_t *y, uint32_t *z, uint32_t *width, uint32_t *height,
+                                    uint32_t *depth, rdctype::array<byte> *data) = 0;
 };
 
 #endif
@@ -341,6 +360,8 @@ extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetGLPipelineState(R
                                                                                GLPipelineState *state);
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC
 ReplayRenderer_GetVulkanPipelineState(ReplayRenderer *rend, VulkanPipelineState *state);
+extern "C" RENDERDOC_API uint32_t RENDERDOC_CC
+ReplayRenderer_GetPipelineStateVersion(ReplayRenderer *rend);
 
 extern "C" RENDERDOC_API void RENDERDOC_CC ReplayRenderer_BuildCustomShader(
     ReplayRenderer *rend, const char *entry, const char *source, const uint32_t compileFlags,
@@ -362,6 +383,10 @@ extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_FreeTargetResource(R
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetFrameInfo(ReplayRenderer *rend,
                                                                          FetchFrameInfo *frame);
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC
+ReplayRenderer_GetCapturedFrames(ReplayRenderer *rend, rdctype::array<FetchCapturedFrame> *frames);
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC
+ReplayRenderer_GetLoadProfile(ReplayRenderer *rend, FetchLoadProfile *profile);
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC
 ReplayRenderer_GetDrawcalls(ReplayRenderer *rend, rdctype::array<FetchDrawcall> *draws);
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC
 ReplayRenderer_FetchCounters(ReplayRenderer *rend, uint32_t *counters, uint32_t numCounters,
@@ -407,6 +432,10 @@ extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetCBufferVariableCo
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_SaveTexture(ReplayRenderer *rend,
                                                                         const TextureSave &saveData,
                                                                         const char *path);
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_ExportTextures(
+    ReplayRenderer *rend, const TextureSave &saveData, uint32_t firstEvent, uint32_t lastEvent,
+    const ResourceId *ids, uint32_t numIDs, const char *pathPrefix,
+    rdctype::array<TextureExport> *exports);
 
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetPostVSData(ReplayRenderer *rend,
                                                                           uint32_t instID,
@@ -418,6 +447,9 @@ extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetBufferData(
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC
 ReplayRenderer_GetTextureData(ReplayRenderer *rend, ResourceId tex, uint32_t arrayIdx, uint32_t mip,
                               rdctype::array<byte> *data);
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetTextureRegionData(
+    ReplayRenderer *rend, ResourceId tex, uint32_t arrayIdx, uint32_t mip, uint32_t *x, uint32_t *y,
+    uint32_t *z, uint32_t *width, uint32_t *height, uint32_t *depth, rdctype::array<byte> *data);
 
 // for C++ expose the interface as a virtual interface
 #ifdef __cplusplus
@@ -435,9 +467,13 @@ struct ITargetControl
 
   virtual void TriggerCapture(uint32_t numFrames) = 0;
   virtual void QueueCapture(uint32_t frameNumber) = 0;
+  virtual void SaveRecentFrame(uint32_t framesAgo) = 0;
   virtual void CopyCapture(uint32_t remoteID, const char *localpath) = 0;
   virtual void DeleteCapture(uint32_t remoteID) = 0;
 
+  virtual void SetTraceEnabled(bool enabled) = 0;
+  virtual void CopyTrace(const char *localpath) = 0;
+
   virtual void ReceiveMessage(TargetControlMessage *msg) = 0;
 };
 
@@ -466,12 +502,19 @@ extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_TriggerCapture(TargetCo
                                                                         uint32_t numFrames);
 extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_QueueCapture(TargetControl *control,
                                                                       uint32_t frameNumber);
+extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_SaveRecentFrame(TargetControl *control,
+                                                                         uint32_t framesAgo);
 extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_CopyCapture(TargetControl *control,
                                                                      uint32_t remoteID,
                                                                      const char *localpath);
 extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_DeleteCapture(TargetControl *control,
                                                                        uint32_t remoteID);
 
+extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_SetTraceEnabled(TargetControl *control,
+                                                                         bool32 enabled);
+extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_CopyTrace(TargetControl *control,
+                                                                   const char *localpath);
+
 extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_ReceiveMessage(TargetControl *control,
                                                                         TargetControlMessage *msg);
 
@@ -623,6 +666,9 @@ extern "C" RENDERDOC_API uint32_t RENDERDOC_CC RENDERDOC_EnumerateRemoteTargets(
 extern "C" RENDERDOC_API uint32_t RENDERDOC_CC RENDERDOC_GetDefaultRemoteServerPort();
 extern "C" RENDERDOC_API ReplayCreateStatus RENDERDOC_CC
 RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, RemoteServer **rend);
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC RENDERDOC_GetRemoteServerStatus(const char *host,
+                                                                         uint32_t port,
+                                                                         RemoteServerStatus *status);
 extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_BecomeRemoteServer(const char *listenhost,
                                                                         uint32_t port,
                                                                         volatile bool32 *killReplay);
@@ -662,6 +708,14 @@ extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_SetConfigSetting(const char
 
 extern "C" RENDERDOC_API void *RENDERDOC_CC RENDERDOC_MakeEnvironmentModificationList(int numElems);
 
+// tracing of internal zones in this process, exportable as Chrome trace event JSON. See
+// TargetControl_SetTraceEnabled/TargetControl_CopyTrace to trace a capturing application.
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_SetTraceEnabled(bool32 enabled);
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_ClearTrace();
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC RENDERDOC_WriteTrace(const char *filename);
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_BeginTraceZone(const char *name);
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_EndTraceZone();
+
 extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_SetEnvironmentModification(
     void *mem, int idx, const char *variable, const char *value, EnvironmentModificationType type,
     EnvironmentSeparator separator);
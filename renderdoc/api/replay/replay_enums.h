@@ -554,6 +554,9 @@ enum TargetControlMessageType
   eTargetControlMsg_CaptureCopied,
   eTargetControlMsg_RegisterAPI,
   eTargetControlMsg_NewChild,
+  eTargetControlMsg_TraceCopied,
+  eTargetControlMsg_CaptureMemory,
+  eTargetControlMsg_LockContention,
 };
 
 enum EnvironmentModificationType
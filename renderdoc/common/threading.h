@@ -32,7 +32,7 @@ namespace Threading
 class ScopedLock
 {
 public:
-  ScopedLock(CriticalSection &cs) : m_CS(&cs) { m_CS->Lock(); }
+  ScopedLock(CriticalSection &cs, const char *site = NULL) : m_CS(&cs) { m_CS->Lock(site); }
   ~ScopedLock() { m_CS->Unlock(); }
 private:
   CriticalSection *m_CS;
@@ -53,6 +53,27 @@ private:
   CriticalSection *m_CS;
   bool m_Owned;
 };
+
+class ScopedReadLock
+{
+public:
+  ScopedReadLock(RWLock &rw) : m_RW(&rw) { m_RW->ReadLock(); }
+  ~ScopedReadLock() { m_RW->ReadUnlock(); }
+private:
+  RWLock *m_RW;
+};
+
+class ScopedWriteLock
+{
+public:
+  ScopedWriteLock(RWLock &rw) : m_RW(&rw) { m_RW->WriteLock(); }
+  ~ScopedWriteLock() { m_RW->WriteUnlock(); }
+private:
+  RWLock *m_RW;
+};
 };
 
-#define SCOPED_LOCK(cs) Threading::ScopedLock CONCAT(scopedlock, __LINE__)(cs);
+#define SCOPED_LOCK(cs) \
+  Threading::ScopedLock CONCAT(scopedlock, __LINE__)(cs, __FILE__ ":" STRINGIZE(__LINE__));
+#define SCOPED_READLOCK(rw) Threading::ScopedReadLock CONCAT(scopedreadlock, __LINE__)(rw);
+#define SCOPED_WRITELOCK(rw) Threading::ScopedWriteLock CONCAT(scopedwritelock, __LINE__)(rw);
@@ -0,0 +1,290 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2016 Baldur Karlsson
+ * Copyright (c) 2014 Crytek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "trace.h"
+#include <algorithm>
+#include <set>
+#include "common/threading.h"
+
+namespace
+{
+// number of completed zones kept per thread. Older zones are overwritten
+const int64_t traceRingSize = 8192;
+
+struct TraceEvent
+{
+  const char *name;
+  uint64_t start;
+  uint64_t end;
+};
+
+struct TraceRing
+{
+  uint32_t index;
+  uint64_t threadID;
+
+  // only ever written by the owning thread. Exporting reads this first, so zones being
+  // written concurrently with an export may be torn or missing, which is acceptable here.
+  volatile int64_t written;
+  // the value of written when the trace was last cleared. Only accessed under traceLock, so that
+  // clearing never writes to anything the owning thread does.
+  int64_t cleared;
+  TraceEvent events[traceRingSize];
+
+  // zones opened with BeginZone that haven't been closed yet
+  std::vector<TraceEvent> open;
+};
+
+// the zones recorded by a thread, copied out of its ring
+struct ThreadEvents
+{
+  uint32_t index;
+  uint64_t threadID;
+  std::vector<TraceEvent> events;
+};
+
+Threading::CriticalSection traceLock;
+std::vector<TraceRing *> traceRings;
+std::vector<ThreadEvents> exitedThreads;
+std::set<std::string> traceNames;
+uint64_t traceRingSlot = 0;
+uint32_t traceThreadCount = 0;
+
+// must be called with traceLock held
+void CopyEvents(TraceRing *ring, std::vector<TraceEvent> &events)
+{
+  int64_t end = ring->written;
+  for(int64_t i = RDCMAX(ring->cleared, end - traceRingSize); i < end; i++)
+    events.push_back(ring->events[i % traceRingSize]);
+}
+
+// called on a thread as it exits. The ring is large, so only keep what it actually recorded
+void FreeThreadRing(void *value)
+{
+  TraceRing *ring = (TraceRing *)value;
+
+  {
+    SCOPED_LOCK(traceLock);
+
+    ThreadEvents exited;
+    exited.index = ring->index;
+    exited.threadID = ring->threadID;
+    CopyEvents(ring, exited.events);
+
+    if(!exited.events.empty())
+      exitedThreads.push_back(exited);
+
+    traceRings.erase(std::find(traceRings.begin(), traceRings.end(), ring));
+  }
+
+  delete ring;
+}
+
+TraceRing *GetThreadRing()
+{
+  TraceRing *ring = (TraceRing *)Threading::GetTLSValue(traceRingSlot);
+
+  if(ring == NULL)
+  {
+    ring = new TraceRing;
+    ring->threadID = Threading::GetCurrentID();
+    ring->written = 0;
+    ring->cleared = 0;
+
+    {
+      SCOPED_LOCK(traceLock);
+      ring->index = ++traceThreadCount;
+      traceRings.push_back(ring);
+    }
+
+    Threading::SetTLSValue(traceRingSlot, ring);
+  }
+
+  return ring;
+}
+
+void AppendEscaped(std::string &str, const char *name)
+{
+  for(const char *c = name; *c; c++)
+  {
+    if(*c == '"' || *c == '\\')
+    {
+      str.push_back('\\');
+      str.push_back(*c);
+    }
+    else if((unsigned char)*c < 0x20)
+    {
+      str.push_back(' ');
+    }
+    else
+    {
+      str.push_back(*c);
+    }
+  }
+}
+};
+
+namespace Trace
+{
+volatile int32_t enabled = 0;
+
+void SetEnabled(bool enable)
+{
+  if(enable)
+  {
+    SCOPED_LOCK(traceLock);
+    if(traceRingSlot == 0)
+      traceRingSlot = Threading::AllocateTLSSlot(&FreeThreadRing);
+  }
+
+  Atomic::CmpExch32(&enabled, enable ? 0 : 1, enable ? 1 : 0);
+
+  RDCLOG("Tracing %s", enable ? "enabled" : "disabled");
+}
+
+void Clear()
+{
+  SCOPED_LOCK(traceLock);
+
+  for(size_t i = 0; i < traceRings.size(); i++)
+    traceRings[i]->cleared = traceRings[i]->written;
+
+  exitedThreads.clear();
+}
+
+void RecordZone(const char *name, uint64_t startTick, uint64_t endTick)
+{
+  if(traceRingSlot == 0)
+    return;
+
+  TraceRing *ring = GetThreadRing();
+
+  TraceEvent &ev = ring->events[ring->written % traceRingSize];
+  ev.name = name;
+  ev.start = startTick;
+  ev.end = endTick;
+
+  ring->written++;
+}
+
+const char *InternName(const char *name)
+{
+  SCOPED_LOCK(traceLock);
+  return traceNames.insert(name).first->c_str();
+}
+
+void BeginZone(const char *name)
+{
+  if(!IsEnabled() || traceRingSlot == 0)
+    return;
+
+  TraceEvent ev = {InternName(name), Timing::GetTick(), 0};
+  GetThreadRing()->open.push_back(ev);
+}
+
+void EndZone()
+{
+  if(traceRingSlot == 0)
+    return;
+
+  TraceRing *ring = GetThreadRing();
+
+  // tracing may have been enabled between a begin and end, so tolerate unbalanced ends
+  if(ring->open.empty())
+    return;
+
+  TraceEvent ev = ring->open.back();
+  ring->open.pop_back();
+
+  if(IsEnabled())
+    RecordZone(ev.name, ev.start, Timing::GetTick());
+}
+
+std::string ExportJSON()
+{
+  std::vector<ThreadEvents> threads;
+
+  {
+    SCOPED_LOCK(traceLock);
+
+    threads = exitedThreads;
+
+    for(size_t r = 0; r < traceRings.size(); r++)
+    {
+      ThreadEvents thread;
+      thread.index = traceRings[r]->index;
+      thread.threadID = traceRings[r]->threadID;
+      CopyEvents(traceRings[r], thread.events);
+      threads.push_back(thread);
+    }
+  }
+
+  uint64_t base = ~0ULL;
+
+  for(size_t t = 0; t < threads.size(); t++)
+    for(size_t i = 0; i < threads[t].events.size(); i++)
+      base = RDCMIN(base, threads[t].events[i].start);
+
+  // Chrome trace timestamps are in microseconds, ticks are per-millisecond
+  double tickToUS = 1000.0 / Timing::GetTickFrequency();
+  uint32_t pid = Process::GetCurrentPID();
+
+  std::string ret = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  bool first = true;
+
+  for(size_t t = 0; t < threads.size(); t++)
+  {
+    const ThreadEvents &thread = threads[t];
+
+    ret += StringFormat::Fmt(
+        "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,"
+        "\"args\":{\"name\":\"Thread %llu\"}}",
+        first ? "" : ",\n", pid, thread.index, thread.threadID);
+    first = false;
+
+    for(size_t i = 0; i < thread.events.size(); i++)
+    {
+      const TraceEvent &ev = thread.events[i];
+
+      ret += ",\n{\"name\":\"";
+      AppendEscaped(ret, ev.name);
+      ret += StringFormat::Fmt("\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                               pid, thread.index, double(ev.start - base) * tickToUS,
+                               double(ev.end - ev.start) * tickToUS);
+    }
+  }
+
+  ret += "\n]}\n";
+
+  return ret;
+}
+
+bool WriteJSON(const char *filename)
+{
+  std::string json = ExportJSON();
+  return FileIO::dump(filename, json.c_str(), json.size());
+}
+};
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2016 Baldur Karlsson
+ * Copyright (c) 2014 Crytek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include "os/os_specific.h"
+#include "common.h"
+
+// Lightweight scoped-zone tracing. Zones are always compiled in, but only cost an atomic read
+// while tracing is disabled. When enabled, each thread records completed zones into its own
+// fixed-size ring buffer without locking, so only the most recent zones per thread are kept.
+// The recorded zones can be exported as Chrome trace event JSON, which can be loaded in
+// chrome://tracing or Perfetto.
+namespace Trace
+{
+extern volatile int32_t enabled;
+
+inline bool IsEnabled()
+{
+  return enabled != 0;
+}
+
+void SetEnabled(bool enable);
+
+// discards all recorded zones on every thread
+void Clear();
+
+// name must remain valid until the trace is exported - in practice a string literal. Names
+// without static storage should go through InternName first.
+void RecordZone(const char *name, uint64_t startTick, uint64_t endTick);
+
+const char *InternName(const char *name);
+
+// explicit begin/end pairs for callers that can't use a scoped object, such as the UI going
+// through the public API. These nest per-thread.
+void BeginZone(const char *name);
+void EndZone();
+
+std::string ExportJSON();
+bool WriteJSON(const char *filename);
+};
+
+class TraceZone
+{
+public:
+  TraceZone(const char *name)
+  {
+    m_Name = Trace::IsEnabled() ? name : NULL;
+    m_Start = m_Name ? Timing::GetTick() : 0;
+  }
+
+  ~TraceZone()
+  {
+    if(m_Name)
+      Trace::RecordZone(m_Name, m_Start, Timing::GetTick());
+  }
+
+private:
+  const char *m_Name;
+  uint64_t m_Start;
+};
+
+#define RDCTRACE_ZONE(name) TraceZone CONCAT(tracezone, __LINE__)(name);
@@ -222,6 +222,21 @@ RenderDoc::RenderDoc()
   m_Replay = false;
 
   m_Cap = 0;
+  m_CapFramesPending = 0;
+  m_CapFramesLeft = 0;
+
+  m_FlightBytes = 0;
+  m_FlightFramePending = false;
+  m_FlightFrame = false;
+  m_FlightDevice = NULL;
+  m_FlightWnd = NULL;
+  m_FlightFramesCompleted = 0;
+  m_FlightSegmentFirst = 0;
+  m_FlightSegmentMem = 0;
+  m_FlightSaveRequested = false;
+  m_FlightSaveFrame = 0;
+  m_FlightCaptureTime = 0.0;
+  m_FlightOverhead = 0.0;
 
   m_FocusKeys.clear();
   m_FocusKeys.push_back(eRENDERDOC_Key_F11);
@@ -345,6 +360,10 @@ RenderDoc::~RenderDoc()
   for(auto it = m_ShutdownFunctions.begin(); it != m_ShutdownFunctions.end(); ++it)
     (*it)();
 
+  for(size_t i = 0; i < m_FlightSegments.size(); i++)
+    delete m_FlightSegments[i];
+  m_FlightSegments.clear();
+
   for(size_t i = 0; i < m_Captures.size(); i++)
   {
     if(m_Captures[i].retrieved)
@@ -374,6 +393,8 @@ RenderDoc::~RenderDoc()
     m_RemoteThread = 0;
   }
 
+  Keyboard::Shutdown();
+
   Network::Shutdown();
 
   Threading::Shutdown();
@@ -471,8 +492,54 @@ void RenderDoc::StartFrameCapture(void *dev, void *wnd)
   IFrameCapturer *frameCap = MatchFrameCapturer(dev, wnd);
   if(frameCap)
   {
+    bool flightFrame = false;
+    void *flightDev = NULL, *flightWnd = NULL;
+
+    {
+      SCOPED_LOCK(m_FlightLock);
+      flightFrame = m_FlightFrame;
+      flightDev = m_FlightDevice;
+      flightWnd = m_FlightWnd;
+    }
+
+    // a real capture started while a flight recorder segment is in progress ends the segment
+    // first, so that the capture only holds what was asked for
+    if(flightFrame)
+      EndFrameCapture(flightDev, flightWnd);
+
+    {
+      SCOPED_LOCK(m_FlightLock);
+
+      // a capture started from anywhere other than a flight recorder trigger is a real capture
+      m_FlightFrame = flightFrame = m_FlightFramePending;
+      m_FlightFramePending = false;
+
+      if(m_FlightFrame)
+      {
+        m_FlightDevice = dev;
+        m_FlightWnd = wnd;
+        m_FlightSegmentFirst = m_FlightFramesCompleted;
+        m_FlightSegmentMem = Chunk::TotalMem();
+      }
+    }
+
+    // only a triggered capture spans several frames
+    m_CapFramesLeft = m_CapFramesPending > 1 ? m_CapFramesPending - 1 : 0;
+    m_CapFramesPending = 0;
+
+    if(m_Options.ProfileLocks && !flightFrame)
+      Threading::ResetLockContentionWindow();
+
+    PerformanceTimer timer;
+
     frameCap->StartFrameCapture(dev, wnd);
     m_CapturesActive++;
+
+    if(flightFrame)
+    {
+      SCOPED_LOCK(m_FlightLock);
+      m_FlightCaptureTime = timer.GetMilliseconds();
+    }
   }
 }
 
@@ -496,11 +563,281 @@ bool RenderDoc::EndFrameCapture(void *dev, void *wnd)
   if(frameCap)
   {
     m_CapturesActive--;
-    return frameCap->EndFrameCapture(dev, wnd);
+
+    PerformanceTimer timer;
+
+    bool flightFrame = IsFlightRecordingFrame();
+    bool ret = frameCap->EndFrameCapture(dev, wnd);
+
+    // track what recording each frame costs, to keep an eye on the steady-state overhead. The
+    // cost of starting and ending a segment is spread over the frames it holds.
+    if(flightFrame)
+    {
+      SCOPED_LOCK(m_FlightLock);
+
+      m_FlightFrame = false;
+
+      if(m_FlightSaveRequested)
+      {
+        RDCERR("Couldn't save flight recorder frame, its segment wasn't written");
+        m_FlightSaveRequested = false;
+      }
+
+      uint32_t numFrames = RDCMAX(1U, m_FlightFramesCompleted - m_FlightSegmentFirst);
+      double frameTime = (m_FlightCaptureTime + timer.GetMilliseconds()) / double(numFrames);
+
+      if(m_FlightOverhead == 0.0)
+        m_FlightOverhead = frameTime;
+      else
+        m_FlightOverhead = m_FlightOverhead * 0.95 + frameTime * 0.05;
+    }
+    else if(m_Options.ProfileLocks)
+    {
+      LogLockContention();
+    }
+
+    return ret;
   }
   return false;
 }
 
+void RenderDoc::LogLockContention()
+{
+  // only count what happened since the capture started
+  vector<Threading::LockContention> locks = Threading::GetLockContention(true);
+
+  RDCLOG("Lock contention during capture, by total time waiting:");
+
+  for(size_t i = 0; i < locks.size(); i++)
+  {
+    const Threading::LockContention &lock = locks[i];
+
+    if(lock.acquisitions == 0)
+      continue;
+
+    RDCLOG("  %s: %llu acquired, %llu contended, %.3f ms waiting (longest %.3f ms), mostly "
+           "held by %s",
+           lock.name.c_str(), lock.acquisitions, lock.contended, lock.totalWaitMS, lock.maxWaitMS,
+           lock.worstHolder.empty() ? "none" : lock.worstHolder.c_str());
+  }
+}
+
+bool RenderDoc::ContinueFrameCapture()
+{
+  {
+    SCOPED_LOCK(m_FlightLock);
+
+    if(m_FlightFrame)
+    {
+      m_FlightFramesCompleted++;
+
+      uint32_t numFrames = m_FlightFramesCompleted - m_FlightSegmentFirst;
+
+      // the ring holds the previous segment while this one is recorded, so each gets half
+      uint64_t maxBytes = uint64_t(m_Options.FlightRecorderMemoryMB) * 1024 * 1024 / 2;
+      uint64_t mem = Chunk::TotalMem();
+      mem = mem > m_FlightSegmentMem ? mem - m_FlightSegmentMem : 0;
+
+      // end the segment once it holds enough frames or grows too large, or when a frame in it is
+      // wanted or a real capture has to start
+      if(numFrames >= m_Options.FlightRecorderFrames || mem > maxBytes || m_FlightSaveRequested ||
+         m_Cap > 0 || !m_QueuedFrameCaptures.empty())
+        return false;
+
+      return true;
+    }
+  }
+
+  if(m_CapFramesLeft == 0)
+    return false;
+
+  m_CapFramesLeft--;
+  return true;
+}
+
+bool RenderDoc::IsFlightRecordingFrame()
+{
+  SCOPED_LOCK(m_FlightLock);
+  return m_FlightFrame;
+}
+
+void RenderDoc::MarkExplicitCapture()
+{
+  SCOPED_LOCK(m_FlightLock);
+
+  // a flight recorder segment in progress is ended when the capture starts
+  m_FlightFramePending = false;
+  m_CapFramesPending = 0;
+}
+
+void RenderDoc::RecordFlightSegment(uint32_t frameNumber)
+{
+  FlightSegment *save = NULL;
+  uint32_t saveFrame = 0;
+
+  {
+    SCOPED_LOCK(m_FlightLock);
+
+    FlightSegment *segment = new FlightSegment;
+    segment->first = m_FlightSegmentFirst;
+    segment->numFrames = m_FlightFramesCompleted - m_FlightSegmentFirst;
+    segment->frameNumber = frameNumber;
+    segment->data.swap(m_FlightPending);
+
+    if(m_FlightSaveRequested)
+    {
+      m_FlightSaveRequested = false;
+      save = segment;
+      saveFrame = m_FlightSaveFrame;
+    }
+    else
+    {
+      m_FlightSegments.push_back(segment);
+      m_FlightBytes += segment->data.size();
+
+      TrimFlightSegments(true);
+    }
+  }
+
+  if(save)
+    WriteFlightSegment(save, saveFrame);
+}
+
+void RenderDoc::TrimFlightSegments(bool reuseStorage)
+{
+  const uint64_t maxBytes = uint64_t(m_Options.FlightRecorderMemoryMB) * 1024 * 1024;
+
+  while(!m_FlightSegments.empty())
+  {
+    FlightSegment *oldest = m_FlightSegments.front();
+
+    // segments that don't hold any of the most recent frames go first, then the oldest until
+    // the ring is within the memory limit
+    uint32_t framesSince = m_FlightFramesCompleted - oldest->first - oldest->numFrames;
+    bool stale = oldest->numFrames == 0 || framesSince >= m_Options.FlightRecorderFrames;
+
+    if(!stale && m_FlightBytes <= maxBytes)
+      break;
+
+    m_FlightSegments.pop_front();
+
+    if(!stale && m_FlightSegments.empty())
+      RDCWARN("Flight recorder segment of %u frames is %llu bytes, too large to keep within the "
+              "memory limit",
+              oldest->numFrames, (uint64_t)oldest->data.size());
+
+    m_FlightBytes -= oldest->data.size();
+
+    // reuse the oldest segment's storage for the next one, to avoid reallocating each time. Only
+    // the capturing thread can do this, as it's the one writing into that storage.
+    oldest->data.clear();
+    if(reuseStorage && m_FlightPending.capacity() < oldest->data.capacity())
+      m_FlightPending.swap(oldest->data);
+
+    delete oldest;
+  }
+}
+
+bool RenderDoc::WriteFlightSegment(FlightSegment *segment, uint32_t frame)
+{
+  // the whole segment is written, since the frames before the requested one are needed to get
+  // to its starting state and only the segment's start has initial contents. Name the capture
+  // after the frame that was asked for, and say where it is in the capture.
+  uint32_t frameInSegment = frame - segment->first;
+  uint32_t framesAfter = segment->numFrames > 0 ? segment->numFrames - 1 - frameInSegment : 0;
+  uint32_t frameNumber = segment->frameNumber - RDCMIN(framesAfter, segment->frameNumber);
+
+  string path = StringFormat::Fmt("%s_frame%u.rdc", m_LogFile.c_str(), frameNumber);
+
+  bool success = false;
+
+  FILE *f = FileIO::fopen(path.c_str(), "wb");
+  if(f)
+  {
+    success =
+        FileIO::fwrite(&segment->data[0], 1, segment->data.size(), f) == segment->data.size();
+    FileIO::fclose(f);
+  }
+
+  if(success)
+  {
+    RDCLOG("Written flight recorder frame to disk: %s, the requested frame is frame %u of the %u "
+           "it holds (recording overhead %.2f ms/frame)",
+           path.c_str(), frameInSegment + 1, segment->numFrames, m_FlightOverhead);
+
+    CaptureData cap(path, Timing::GetUnixTimestamp(), frameNumber);
+    {
+      SCOPED_LOCK(m_CaptureLock);
+      m_Captures.push_back(cap);
+    }
+  }
+  else
+  {
+    RDCERR("Couldn't write flight recorder frame to '%s'", path.c_str());
+  }
+
+  // put the segment back in the ring, in order, since other frames in it can still be saved
+  {
+    SCOPED_LOCK(m_FlightLock);
+
+    auto it = m_FlightSegments.begin();
+    while(it != m_FlightSegments.end() && (*it)->first < segment->first)
+      ++it;
+
+    m_FlightSegments.insert(it, segment);
+    m_FlightBytes += segment->data.size();
+
+    TrimFlightSegments(false);
+  }
+
+  return success;
+}
+
+bool RenderDoc::SaveRecentFrame(uint32_t framesAgo)
+{
+  FlightSegment *segment = NULL;
+  uint32_t frame = 0;
+
+  {
+    SCOPED_LOCK(m_FlightLock);
+
+    if(framesAgo < m_FlightFramesCompleted)
+    {
+      frame = m_FlightFramesCompleted - 1 - framesAgo;
+
+      for(auto it = m_FlightSegments.begin(); it != m_FlightSegments.end(); ++it)
+      {
+        if(frame >= (*it)->first && frame - (*it)->first < (*it)->numFrames)
+        {
+          segment = *it;
+
+          // take the segment out of the ring while it's written, so it can't be evicted meanwhile
+          m_FlightSegments.erase(it);
+          m_FlightBytes -= segment->data.size();
+          break;
+        }
+      }
+
+      // the frame is in the segment still being recorded, which is ended at the next present
+      // and written out then
+      if(segment == NULL && m_FlightFrame && frame >= m_FlightSegmentFirst)
+      {
+        m_FlightSaveRequested = true;
+        m_FlightSaveFrame = frame;
+        return true;
+      }
+    }
+  }
+
+  if(segment == NULL)
+  {
+    RDCWARN("No flight recorder frame %u frames ago to save", framesAgo);
+    return false;
+  }
+
+  return WriteFlightSegment(segment, frame);
+}
+
 bool RenderDoc::IsTargetControlConnected()
 {
   SCOPED_LOCK(RenderDoc::Inst().m_SingleClientLock);
@@ -627,6 +964,28 @@ string RenderDoc::GetOverlayText(RDCDriver driver, uint32_t frameNumber, int fla
       }
     }
 
+    if(m_Options.FlightRecorderFrames > 0 && capturesEnabled)
+    {
+      SCOPED_LOCK(m_FlightLock);
+
+      uint32_t numFrames = 0;
+      for(size_t i = 0; i < m_FlightSegments.size(); i++)
+        numFrames += m_FlightSegments[i]->numFrames;
+
+      overlayText += StringFormat::Fmt(
+          "Flight recorder: %u frames in %u segments (%.2f MB), %.2f ms/frame.\n", numFrames,
+          (uint32_t)m_FlightSegments.size(), float(m_FlightBytes) / 1024.0f / 1024.0f,
+          m_FlightOverhead);
+    }
+
+    if(m_Options.CaptureMemoryBudgetMB > 0)
+    {
+      overlayText += StringFormat::Fmt(
+          "Capture memory: %.2f / %u MB, %.2f MB spilled\n",
+          float(Chunk::TotalMem()) / 1024.0f / 1024.0f, m_Options.CaptureMemoryBudgetMB,
+          float(Chunk::SpilledMem()) / 1024.0f / 1024.0f);
+    }
+
 #if ENABLED(RDOC_DEVEL)
     overlayText += StringFormat::Fmt("%llu chunks - %.2f MB\n", Chunk::NumLiveChunks(),
                                      float(Chunk::TotalMem()) / 1024.0f / 1024.0f);
@@ -661,8 +1020,8 @@ bool RenderDoc::ShouldTriggerCapture(uint32_t frameNumber)
 {
   bool ret = m_Cap > 0;
 
-  if(m_Cap > 0)
-    m_Cap--;
+  m_CapFramesPending = m_Cap;
+  m_Cap = 0;
 
   set<uint32_t> frames;
   frames.swap(m_QueuedFrameCaptures);
@@ -684,6 +1043,18 @@ bool RenderDoc::ShouldTriggerCapture(uint32_t frameNumber)
     }
   }
 
+  // when flight recording every frame is captured, but unless it was asked for it's only kept
+  // in memory
+  SCOPED_LOCK(m_FlightLock);
+
+  m_FlightFramePending = false;
+
+  if(!ret && m_Options.FlightRecorderFrames > 0)
+  {
+    ret = true;
+    m_FlightFramePending = true;
+  }
+
   return ret;
 }
 
@@ -698,10 +1069,20 @@ Serialiser *RenderDoc::OpenWriteSerialiser(uint32_t frameNum, RDCInitParams *par
   const bool debugSerialiser = true;
 #endif
 
-  m_CurrentLogFile = StringFormat::Fmt("%s_frame%u.rdc", m_LogFile.c_str(), frameNum);
+  Serialiser *fileSerialiser = NULL;
+
+  if(IsFlightRecordingFrame())
+  {
+    // flight recorder frames don't need debug text, they're written straight into memory
+    fileSerialiser = new Serialiser(NULL, Serialiser::WRITING, false);
+    fileSerialiser->RedirectToMemory(&m_FlightPending);
+  }
+  else
+  {
+    m_CurrentLogFile = StringFormat::Fmt("%s_frame%u.rdc", m_LogFile.c_str(), frameNum);
 
-  Serialiser *fileSerialiser =
-      new Serialiser(m_CurrentLogFile.c_str(), Serialiser::WRITING, debugSerialiser);
+    fileSerialiser = new Serialiser(m_CurrentLogFile.c_str(), Serialiser::WRITING, debugSerialiser);
+  }
 
   Serialiser *chunkSerialiser = new Serialiser(NULL, Serialiser::WRITING, debugSerialiser);
 
@@ -974,6 +1355,8 @@ void RenderDoc::SetCaptureOptions(const CaptureOptions &opts)
 {
   m_Options = opts;
 
+  Threading::SetLockProfiling(opts.ProfileLocks != 0);
+
   LibraryHooks::GetInstance().OptionsUpdated();
 }
 
@@ -1015,6 +1398,12 @@ void RenderDoc::SetProgress(LoadProgressSection section, float delta)
 
 void RenderDoc::SuccessfullyWrittenLog(uint32_t frameNumber)
 {
+  if(IsFlightRecordingFrame())
+  {
+    RecordFlightSegment(frameNumber);
+    return;
+  }
+
   RDCLOG("Written to disk: %s", m_CurrentLogFile.c_str());
 
   CaptureData cap(m_CurrentLogFile, Timing::GetUnixTimestamp(), frameNumber);
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <deque>
 #include <map>
 #include <set>
 #include <string>
@@ -279,6 +280,8 @@ public:
     return dev == m_ActiveWindow.dev && wnd == m_ActiveWindow.wnd;
   }
 
+  // a capture of several frames is a single capture running on over the presents in between,
+  // so resources and their initial contents are only stored once.
   void TriggerCapture(uint32_t numFrames) { m_Cap = numFrames; }
   uint32_t GetOverlayBits() { return m_Overlay; }
   void MaskOverlayBits(uint32_t And, uint32_t Or) { m_Overlay = (m_Overlay & And) | Or; }
@@ -299,6 +302,16 @@ public:
   const vector<RENDERDOC_InputButton> &GetFocusKeys() { return m_FocusKeys; }
   const vector<RENDERDOC_InputButton> &GetCaptureKeys() { return m_CaptureKeys; }
   bool ShouldTriggerCapture(uint32_t frameNumber);
+  // called by drivers at a present in the middle of a triggered capture. Returns true if the
+  // capture should carry on into the next frame, with just the end of this frame recorded.
+  bool ContinueFrameCapture();
+
+  // flight recorder, see eRENDERDOC_Option_FlightRecorderFrames. While it's enabled every frame is
+  // captured, as segments of several frames that share one copy of the initial contents. Segments
+  // nobody asked for are kept in a bounded ring in memory instead of being written to disk.
+  bool IsFlightRecordingFrame();
+  void MarkExplicitCapture();
+  bool SaveRecentFrame(uint32_t framesAgo);
 
   enum
   {
@@ -316,7 +329,11 @@ private:
 
   bool m_Replay;
 
+  // number of frames the next triggered capture will span
   uint32_t m_Cap;
+  // frames to span for the capture that's about to start, and for the one in progress
+  uint32_t m_CapFramesPending;
+  uint32_t m_CapFramesLeft;
 
   vector<RENDERDOC_InputButton> m_FocusKeys;
   vector<RENDERDOC_InputButton> m_CaptureKeys;
@@ -342,6 +359,50 @@ private:
 
   float *m_ProgressPtr;
 
+  // a capture of numFrames consecutive frames. first counts completed flight recorder frames, and
+  // frameNumber is the driver's number for the last frame, from which the saved frame's number
+  // is worked out.
+  struct FlightSegment
+  {
+    uint32_t first;
+    uint32_t numFrames;
+    uint32_t frameNumber;
+    vector<byte> data;
+  };
+
+  void RecordFlightSegment(uint32_t frameNumber);
+  void TrimFlightSegments(bool reuseStorage);
+  bool WriteFlightSegment(FlightSegment *segment, uint32_t frame);
+
+  // all of the flight recorder state below is protected by this lock, as frames are presented,
+  // saved and explicitly captured from different threads
+  Threading::CriticalSection m_FlightLock;
+  // complete capture files of recent segments, oldest first
+  std::deque<FlightSegment *> m_FlightSegments;
+  uint64_t m_FlightBytes;
+  // the capture file being written for the segment that's ending
+  vector<byte> m_FlightPending;
+  // whether the next capture to start, or the one in progress, is only for the flight recorder
+  bool m_FlightFramePending;
+  bool m_FlightFrame;
+  // where the segment in progress is being captured, so an explicit capture can end it first
+  void *m_FlightDevice;
+  void *m_FlightWnd;
+  // frames completed since flight recording began, and where the segment in progress started
+  uint32_t m_FlightFramesCompleted;
+  uint32_t m_FlightSegmentFirst;
+  // captured data held when the segment in progress started, to keep it within the memory limit
+  uint64_t m_FlightSegmentMem;
+  // a frame in the segment in progress was asked for, so end it and write it out
+  bool m_FlightSaveRequested;
+  uint32_t m_FlightSaveFrame;
+  // time spent starting and ending the current segment, and a moving average per frame
+  double m_FlightCaptureTime;
+  double m_FlightOverhead;
+
+  // logs lock contention over the capture that just ended, see eRENDERDOC_Option_ProfileLocks
+  void LogLockContention();
+
   Threading::CriticalSection m_CaptureLock;
   vector<CaptureData> m_Captures;
 
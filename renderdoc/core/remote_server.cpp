@@ -23,6 +23,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <set>
 #include <sstream>
 #include <utility>
 #include "api/replay/renderdoc_replay.h"
@@ -67,7 +68,14 @@ void Serialiser::Serialise(const char *name, Process::EnvironmentModification &e
   Serialise("value", el.value);
 }
 
-static const uint32_t RemoteServerProtocolVersion = 1;
+// bump whenever anything sent between the client and server changes, including the replay proxy
+// serialisation.
+// 2 - added the load profile to FetchFrameRecord
+// 3 - pipeline state is sent as a delta of only the replaying API's state
+// 4 - added the status packet and queueing for a session
+// 5 - pipeline state delta is made of copied and new segments instead of fixed-size blocks
+// 6 - added the frame boundaries to FetchFrameRecord
+static const uint32_t RemoteServerProtocolVersion = 6;
 
 enum RemoteServerPacket
 {
@@ -89,6 +97,8 @@ enum RemoteServerPacket
   eRemoteServer_ListDir,
   eRemoteServer_ExecuteAndInject,
   eRemoteServer_ShutdownServer,
+  // sent instead of a handshake to query the server's load without taking a session
+  eRemoteServer_Status,
   eRemoteServer_RemoteServerCount,
 };
 
@@ -122,10 +132,20 @@ static void ProgressTicker(void *d)
   }
 }
 
+struct RemoteServerState;
+
 struct ClientThread
 {
   ClientThread()
-      : socket(NULL), allowExecution(false), killThread(false), killServer(false), thread(0)
+      : socket(NULL),
+        allowExecution(false),
+        killThread(false),
+        killServer(false),
+        thread(0),
+        server(NULL),
+        ip(0),
+        admitted(false),
+        cpuUsage(0.0f)
   {
   }
 
@@ -136,49 +156,206 @@ struct ClientThread
   bool killServer;
 
   Threading::ThreadHandle thread;
+
+  RemoteServerState *server;
+
+  // below here is guarded by the server lock, for status reporting
+  uint32_t ip;
+  bool admitted;
+  string capture;
+  float cpuUsage;
 };
 
-static void InactiveRemoteClientThread(void *data)
+// The sessions a server is hosting, and the clients queued up waiting for one. By default
+// there's one session and no queue, so any other client is told the server is busy.
+struct RemoteServerState
 {
-  ClientThread *threadData = (ClientThread *)data;
-
-  uint32_t ip = threadData->socket->GetRemoteIP();
+  RemoteServerState()
+      : maxSessions(1), maxQueued(0), sessionCPUQuota(0.0f), activeSessions(0), nextTicket(0), headTicket(0)
+  {
+  }
 
-  // this thread just handles receiving the handshake and sending a busy signal without blocking the
-  // server thread
-  RemoteServerPacket type = eRemoteServer_Noop;
-  Serialiser *recvser = NULL;
+  uint32_t maxSessions;
+  uint32_t maxQueued;
+  // fraction of a core each session may use, or 0 for no limit
+  float sessionCPUQuota;
+
+  Threading::CriticalSection lock;
+  vector<ClientThread *> clients;
+  uint32_t activeSessions;
+  // queued clients take a ticket and are admitted in order. Tickets of clients that gave up
+  // while queued are skipped over when they reach the head.
+  uint64_t nextTicket;
+  uint64_t headTicket;
+  std::set<uint64_t> abandonedTickets;
+
+  uint32_t NumQueued() const
+  {
+    return uint32_t(nextTicket - headTicket - abandonedTickets.size());
+  }
 
-  if(!RecvPacket(threadData->socket, type, &recvser) || type != eRemoteServer_Handshake)
+  void SkipAbandonedTickets()
   {
-    RDCWARN("Didn't receive proper handshake");
-    SAFE_DELETE(threadData->socket);
-    return;
+    while(abandonedTickets.erase(headTicket))
+      headTicket++;
   }
 
-  uint32_t version = 0;
-  recvser->Serialise("version", version);
+  // opening a capture reports progress through a global pointer, so only one session can be
+  // loading at once.
+  Threading::CriticalSection loadLock;
+};
 
-  SAFE_DELETE(recvser);
+enum AdmitResult
+{
+  eAdmit_Accepted,
+  eAdmit_Busy,
+  eAdmit_Aborted,
+};
+
+static AdmitResult AdmitClient(ClientThread *threadData)
+{
+  RemoteServerState &server = *threadData->server;
+
+  uint64_t ticket = 0;
 
-  if(version != RemoteServerProtocolVersion)
   {
-    RDCLOG("Connection using protocol %u, but we are running %u", version,
-           RemoteServerProtocolVersion);
-    SendPacket(threadData->socket, eRemoteServer_VersionMismatch);
+    SCOPED_LOCK(server.lock);
+
+    if(server.activeSessions < server.maxSessions && server.headTicket == server.nextTicket)
+    {
+      server.activeSessions++;
+      threadData->admitted = true;
+      return eAdmit_Accepted;
+    }
+
+    if(server.NumQueued() >= server.maxQueued)
+      return eAdmit_Busy;
+
+    ticket = server.nextTicket++;
+
+    RDCLOG("All %u sessions in use, queueing connection at position %u", server.maxSessions,
+           server.NumQueued());
   }
-  else
+
+  // the client is blocked waiting for our handshake reply, so it simply waits until we admit it
+  while(!threadData->killThread)
   {
-    SendPacket(threadData->socket, eRemoteServer_Busy);
+    // the client won't send anything until we reply, so this only notices it disconnecting
+    threadData->socket->IsRecvDataWaiting();
+
+    if(!threadData->socket->Connected())
+      break;
+
+    {
+      SCOPED_LOCK(server.lock);
+
+      server.SkipAbandonedTickets();
+
+      if(ticket == server.headTicket && server.activeSessions < server.maxSessions)
+      {
+        server.headTicket++;
+        server.SkipAbandonedTickets();
+        server.activeSessions++;
+        threadData->admitted = true;
+        return eAdmit_Accepted;
+      }
+    }
+
+    Threading::Sleep(50);
   }
 
-  SAFE_DELETE(threadData->socket);
+  // give up our place in the queue so the clients behind us aren't stuck waiting for it
+  {
+    SCOPED_LOCK(server.lock);
+
+    server.abandonedTickets.insert(ticket);
+    server.SkipAbandonedTickets();
+  }
 
-  RDCLOG("Closed inactive connection from %u.%u.%u.%u.", Network::GetIPOctet(ip, 0),
-         Network::GetIPOctet(ip, 1), Network::GetIPOctet(ip, 2), Network::GetIPOctet(ip, 3));
+  return eAdmit_Aborted;
 }
 
-static void ActiveRemoteClientThread(void *data)
+static void SendServerStatus(ClientThread *threadData)
+{
+  RemoteServerState &server = *threadData->server;
+
+  Serialiser sendSer("", Serialiser::WRITING, false);
+
+  {
+    SCOPED_LOCK(server.lock);
+
+    uint32_t queued = server.NumQueued();
+
+    sendSer.Serialise("maxSessions", server.maxSessions);
+    sendSer.Serialise("maxQueued", server.maxQueued);
+    sendSer.Serialise("queued", queued);
+    sendSer.Serialise("sessionCPUQuota", server.sessionCPUQuota);
+
+    uint32_t count = 0;
+    for(size_t i = 0; i < server.clients.size(); i++)
+      if(server.clients[i]->admitted)
+        count++;
+
+    sendSer.Serialise("count", count);
+
+    for(size_t i = 0; i < server.clients.size(); i++)
+    {
+      ClientThread *c = server.clients[i];
+
+      if(!c->admitted)
+        continue;
+
+      sendSer.Serialise("ip", c->ip);
+      sendSer.Serialise("capture", c->capture);
+      sendSer.Serialise("cpuUsage", c->cpuUsage);
+    }
+  }
+
+  SendPacket(threadData->socket, eRemoteServer_Status, sendSer);
+}
+
+// keeps a session within its CPU quota by sleeping once it has used more than its share of
+// the current one second window, and records the usage for status queries.
+struct SessionCPUThrottle
+{
+  SessionCPUThrottle(ClientThread *t) : threadData(t)
+  {
+    windowCPUStart = Threading::GetCurrentThreadCPUTime();
+  }
+
+  void Update()
+  {
+    double wall = windowTimer.GetMilliseconds() / 1000.0;
+    double cpu = Threading::GetCurrentThreadCPUTime() - windowCPUStart;
+
+    float quota = threadData->server->sessionCPUQuota;
+
+    if(quota > 0.0f && cpu > wall * quota)
+    {
+      // sleep until our usage over the window is back within the quota
+      double sleepSeconds = RDCMIN(cpu / quota - wall, 1.0);
+      Threading::Sleep(uint32_t(sleepSeconds * 1000.0));
+      wall = windowTimer.GetMilliseconds() / 1000.0;
+    }
+
+    if(wall >= 1.0)
+    {
+      {
+        SCOPED_LOCK(threadData->server->lock);
+        threadData->cpuUsage = float(cpu / wall);
+      }
+
+      windowTimer.Restart();
+      windowCPUStart = Threading::GetCurrentThreadCPUTime();
+    }
+  }
+
+  ClientThread *threadData;
+  PerformanceTimer windowTimer;
+  double windowCPUStart;
+};
+
+static void RemoteClientThread(void *data)
 {
   ClientThread *threadData = (ClientThread *)data;
 
@@ -189,9 +366,19 @@ static void ActiveRemoteClientThread(void *data)
   RemoteServerPacket type = eRemoteServer_Noop;
   Serialiser *handshakeSer = NULL;
 
-  if(!RecvPacket(threadData->socket, type, &handshakeSer) || type != eRemoteServer_Handshake)
+  if(!RecvPacket(threadData->socket, type, &handshakeSer) ||
+     (type != eRemoteServer_Handshake && type != eRemoteServer_Status))
   {
     RDCWARN("Didn't receive proper handshake");
+    SAFE_DELETE(handshakeSer);
+    SAFE_DELETE(client);
+    return;
+  }
+
+  if(type == eRemoteServer_Status)
+  {
+    SAFE_DELETE(handshakeSer);
+    SendServerStatus(threadData);
     SAFE_DELETE(client);
     return;
   }
@@ -209,12 +396,26 @@ static void ActiveRemoteClientThread(void *data)
     SAFE_DELETE(client);
     return;
   }
-  else
+
+  AdmitResult admit = AdmitClient(threadData);
+
+  if(admit != eAdmit_Accepted)
   {
-    // handshake and continue
-    SendPacket(threadData->socket, eRemoteServer_Handshake);
+    if(admit == eAdmit_Busy)
+      SendPacket(threadData->socket, eRemoteServer_Busy);
+
+    SAFE_DELETE(client);
+
+    RDCLOG("Closed inactive connection from %u.%u.%u.%u.", Network::GetIPOctet(ip, 0),
+           Network::GetIPOctet(ip, 1), Network::GetIPOctet(ip, 2), Network::GetIPOctet(ip, 3));
+    return;
   }
 
+  // handshake and continue
+  SendPacket(threadData->socket, eRemoteServer_Handshake);
+
+  SessionCPUThrottle throttle(threadData);
+
   vector<string> tempFiles;
   IRemoteDriver *driver = NULL;
   ReplayProxy *proxy = NULL;
@@ -234,6 +435,8 @@ static void ActiveRemoteClientThread(void *data)
 
     Threading::Sleep(4);
 
+    throttle.Update();
+
     if(client->IsRecvDataWaiting())
     {
       type = eRemoteServer_Noop;
@@ -375,6 +578,8 @@ static void ActiveRemoteClientThread(void *data)
         }
         else if(RenderDoc::Inst().HasRemoteDriver(driverType))
         {
+          SCOPED_LOCK(threadData->server->loadLock);
+
           ProgressLoopData progressData;
 
           progressData.sock = client;
@@ -403,6 +608,9 @@ static void ActiveRemoteClientThread(void *data)
             Threading::CloseThread(ticker);
 
             proxy = new ReplayProxy(client, driver);
+
+            SCOPED_LOCK(threadData->server->lock);
+            threadData->capture = cap_file;
           }
         }
         else
@@ -422,6 +630,9 @@ static void ActiveRemoteClientThread(void *data)
         driver = NULL;
 
         SAFE_DELETE(proxy);
+
+        SCOPED_LOCK(threadData->server->lock);
+        threadData->capture = "";
       }
       else if(type == eRemoteServer_ExecuteAndInject)
       {
@@ -492,6 +703,13 @@ static void ActiveRemoteClientThread(void *data)
   RDCLOG("Closing active connection from %u.%u.%u.%u.", Network::GetIPOctet(ip, 0),
          Network::GetIPOctet(ip, 1), Network::GetIPOctet(ip, 2), Network::GetIPOctet(ip, 3));
 
+  {
+    SCOPED_LOCK(threadData->server->lock);
+    threadData->admitted = false;
+    threadData->capture = "";
+    threadData->server->activeSessions--;
+  }
+
   RDCLOG("Ready for new active connection...");
 
   SAFE_DELETE(client);
@@ -507,6 +725,8 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port, volati
   std::vector<std::pair<uint32_t, uint32_t> > listenRanges;
   bool allowExecution = true;
 
+  RemoteServerState server;
+
   FILE *f = FileIO::fopen(FileIO::GetAppFolderFilename("remoteserver.conf").c_str(), "r");
 
   while(f && !FileIO::feof(f))
@@ -545,6 +765,25 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port, volati
 
       continue;
     }
+    else if(line.substr(0, sizeof("sessions") - 1) == "sessions")
+    {
+      server.maxSessions = RDCMAX(1U, (uint32_t)atoi(line.c_str() + sizeof("sessions")));
+
+      continue;
+    }
+    else if(line.substr(0, sizeof("queue") - 1) == "queue")
+    {
+      server.maxQueued = (uint32_t)atoi(line.c_str() + sizeof("queue"));
+
+      continue;
+    }
+    else if(line.substr(0, sizeof("sessioncpu") - 1) == "sessioncpu")
+    {
+      // given as a percentage of one core
+      server.sessionCPUQuota = float(atof(line.c_str() + sizeof("sessioncpu"))) / 100.0f;
+
+      continue;
+    }
 
     RDCLOG("Malformed line '%s'. See documentation for file format.", line.c_str());
   }
@@ -581,40 +820,49 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port, volati
   else
     RDCLOG("Blocking execution commands");
 
-  RDCLOG("Replay host ready for requests...");
+  RDCLOG("Hosting up to %u sessions, queueing up to %u more clients", server.maxSessions,
+         server.maxQueued);
 
-  ClientThread *activeClientData = NULL;
+  if(server.sessionCPUQuota > 0.0f)
+    RDCLOG("Limiting each session to %.0f%% of a core", server.sessionCPUQuota * 100.0f);
 
-  std::vector<ClientThread *> inactives;
+  RDCLOG("Replay host ready for requests...");
 
   while(!killReplay)
   {
     Network::Socket *client = sock->AcceptClient(false);
 
-    if(activeClientData && activeClientData->killServer)
-      break;
+    bool killServer = false;
 
-    // reap any dead inactive threads
-    for(size_t i = 0; i < inactives.size(); i++)
     {
-      if(inactives[i]->socket == NULL)
-      {
-        Threading::JoinThread(inactives[i]->thread);
-        Threading::CloseThread(inactives[i]->thread);
-        delete inactives[i];
-        inactives.erase(inactives.begin() + i);
-        break;
-      }
+      SCOPED_LOCK(server.lock);
+
+      for(size_t i = 0; i < server.clients.size(); i++)
+        killServer |= server.clients[i]->killServer;
     }
 
-    // reap our active connection possibly
-    if(activeClientData && activeClientData->socket == NULL)
+    if(killServer)
+      break;
+
+    // reap any finished client threads
     {
-      Threading::JoinThread(activeClientData->thread);
-      Threading::CloseThread(activeClientData->thread);
+      SCOPED_LOCK(server.lock);
+
+      for(size_t i = 0; i < server.clients.size();)
+      {
+        ClientThread *c = server.clients[i];
 
-      delete activeClientData;
-      activeClientData = NULL;
+        if(c->socket == NULL)
+        {
+          Threading::JoinThread(c->thread);
+          Threading::CloseThread(c->thread);
+          delete c;
+          server.clients.erase(server.clients.begin() + i);
+          continue;
+        }
+
+        i++;
+      }
     }
 
     if(client == NULL)
@@ -658,48 +906,36 @@ void RenderDoc::BecomeRemoteServer(const char *listenhost, uint16_t port, volati
       continue;
     }
 
-    if(activeClientData == NULL)
-    {
-      activeClientData = new ClientThread();
-      activeClientData->socket = client;
-      activeClientData->allowExecution = allowExecution;
-
-      activeClientData->thread = Threading::CreateThread(ActiveRemoteClientThread, activeClientData);
+    // the client thread decides whether this connection gets a session, is queued for one,
+    // or is turned away
+    ClientThread *clientData = new ClientThread();
+    clientData->socket = client;
+    clientData->allowExecution = allowExecution;
+    clientData->server = &server;
+    clientData->ip = ip;
 
-      RDCLOG("Making active connection");
-    }
-    else
     {
-      ClientThread *inactive = new ClientThread();
-      inactive->socket = client;
-      inactive->allowExecution = false;
-
-      inactive->thread = Threading::CreateThread(InactiveRemoteClientThread, inactive);
-
-      inactives.push_back(inactive);
-
-      RDCLOG("Refusing inactive connection");
+      SCOPED_LOCK(server.lock);
+      server.clients.push_back(clientData);
     }
-  }
-
-  if(activeClientData && activeClientData->socket != NULL)
-  {
-    activeClientData->killThread = true;
-
-    Threading::JoinThread(activeClientData->thread);
-    Threading::CloseThread(activeClientData->thread);
 
-    delete activeClientData;
+    clientData->thread = Threading::CreateThread(RemoteClientThread, clientData);
   }
 
-  // shut down client threads
-  for(size_t i = 0; i < inactives.size(); i++)
+  // shut down client threads. Nothing adds to the list any more, and the threads need the
+  // lock to finish up, so don't hold it while joining.
+  for(size_t i = 0; i < server.clients.size(); i++)
+    server.clients[i]->killThread = true;
+
+  for(size_t i = 0; i < server.clients.size(); i++)
   {
-    Threading::JoinThread(inactives[i]->thread);
-    Threading::CloseThread(inactives[i]->thread);
-    delete inactives[i];
+    Threading::JoinThread(server.clients[i]->thread);
+    Threading::CloseThread(server.clients[i]->thread);
+    delete server.clients[i];
   }
 
+  server.clients.clear();
+
   SAFE_DELETE(sock);
 }
 
@@ -1213,12 +1449,8 @@ extern "C" RENDERDOC_API void RENDERDOC_CC RemoteServer_CloseCapture(RemoteServe
   return remote->CloseCapture(rend);
 }
 
-extern "C" RENDERDOC_API ReplayCreateStatus RENDERDOC_CC
-RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, RemoteServer **rend)
+static Network::Socket *ConnectToRemoteServer(const char *host, uint32_t port)
 {
-  if(rend == NULL)
-    return eReplayCreate_InternalError;
-
   string s = "localhost";
   if(host != NULL && host[0] != '\0')
     s = host;
@@ -1239,9 +1471,75 @@ RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, RemoteSe
   Network::Socket *sock = NULL;
 
   if(s != "-")
-  {
     sock = Network::CreateClientSocket(s.c_str(), (uint16_t)port, 750);
 
+  return sock;
+}
+
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC RENDERDOC_GetRemoteServerStatus(const char *host,
+                                                                         uint32_t port,
+                                                                         RemoteServerStatus *status)
+{
+  if(status == NULL)
+    return false;
+
+  Network::Socket *sock = ConnectToRemoteServer(host, port);
+
+  if(sock == NULL)
+    return false;
+
+  Serialiser sendData("", Serialiser::WRITING, false);
+  SendPacket(sock, eRemoteServer_Status, sendData);
+
+  RemoteServerPacket type = eRemoteServer_Noop;
+  Serialiser *ser = NULL;
+
+  if(!RecvPacket(sock, type, &ser) || type != eRemoteServer_Status)
+  {
+    RDCWARN("Didn't get a status response - server may be too old");
+    SAFE_DELETE(ser);
+    SAFE_DELETE(sock);
+    return false;
+  }
+
+  ser->Serialise("maxSessions", status->maxSessions);
+  ser->Serialise("maxQueued", status->maxQueued);
+  ser->Serialise("queued", status->queued);
+  ser->Serialise("sessionCPUQuota", status->sessionCPUQuota);
+
+  uint32_t count = 0;
+  ser->Serialise("count", count);
+
+  create_array_uninit(status->sessions, count);
+
+  for(uint32_t i = 0; i < count; i++)
+  {
+    string capture;
+    ser->Serialise("ip", status->sessions[i].clientIP);
+    ser->Serialise("capture", capture);
+    ser->Serialise("cpuUsage", status->sessions[i].cpuUsage);
+
+    status->sessions[i].capture = capture;
+  }
+
+  SAFE_DELETE(ser);
+  SAFE_DELETE(sock);
+
+  return true;
+}
+
+extern "C" RENDERDOC_API ReplayCreateStatus RENDERDOC_CC
+RENDERDOC_CreateRemoteServerConnection(const char *host, uint32_t port, RemoteServer **rend)
+{
+  if(rend == NULL)
+    return eReplayCreate_InternalError;
+
+  Network::Socket *sock = NULL;
+
+  if(host == NULL || strcmp(host, "-") != 0)
+  {
+    sock = ConnectToRemoteServer(host, port);
+
     if(sock == NULL)
       return eReplayCreate_NetworkIOFailed;
   }
@@ -24,6 +24,7 @@
  ******************************************************************************/
 
 #include "replay_proxy.h"
+#include "common/trace.h"
 #include "lz4/lz4.h"
 
 // these functions do compile time asserts on the size of the structure, to
@@ -1342,13 +1343,40 @@ void Serialiser::Serialise(const char *name, FetchFrameInfo &el)
   SIZE_CHECK(FetchFrameInfo, 1208);
 }
 
+template <>
+void Serialiser::Serialise(const char *name, FetchChunkLoadStats &el)
+{
+  Serialise("", el.chunkID);
+  Serialise("", el.count);
+  Serialise("", el.totalSize);
+  Serialise("", el.totalTime);
+  Serialise("", el.name);
+
+  SIZE_CHECK(FetchChunkLoadStats, 40);
+}
+
+template <>
+void Serialiser::Serialise(const char *name, FetchLoadProfile &el)
+{
+  Serialise("", el.totalTime);
+  Serialise("", el.fileReadTime);
+  Serialise("", el.decompressTime);
+  Serialise("", el.initialContentsTime);
+  Serialise("", el.initialContentsApplyTime);
+  Serialise("", el.chunks);
+
+  SIZE_CHECK(FetchLoadProfile, 56);
+}
+
 template <>
 void Serialiser::Serialise(const char *name, FetchFrameRecord &el)
 {
   Serialise("", el.frameInfo);
   Serialise("", el.drawcallList);
+  Serialise("", el.loadProfile);
+  Serialise("", el.frames);
 
-  SIZE_CHECK(FetchFrameRecord, 1224);
+  SIZE_CHECK(FetchFrameRecord, 1296);
 }
 
 template <>
@@ -1515,6 +1543,11 @@ string ToStrHelper<false, GraphicsAPI>::Get(const GraphicsAPI &el)
 
 // these structures we can just serialise as a blob, since they're POD.
 template <>
+string ToStrHelper<false, FetchCapturedFrame>::Get(const FetchCapturedFrame &el)
+{
+  return "<...>";
+}
+template <>
 string ToStrHelper<false, D3D11PipelineState::InputAssembler::VertexBuffer>::Get(
     const D3D11PipelineState::InputAssembler::VertexBuffer &el)
 {
@@ -1676,6 +1709,208 @@ string ToStrHelper<false, FloatVector>::Get(const FloatVector &el)
 
 #pragma endregion Plain - old data structures
 
+static uint64_t HashSegment(const byte *data, uint32_t length)
+{
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for(uint32_t i = 0; i < length; i++)
+    hash = (hash ^ data[i]) * 1099511628211ULL;
+  return hash;
+}
+
+template <typename PipeState>
+bool PipelineStateBlob::Update(PipeState &state)
+{
+  // don't split below this size - arrays of plain values would otherwise give a segment per
+  // value, and the per-segment overhead would outweigh what's saved
+  const uint64_t minSegment = 32;
+
+  vector<uint64_t> marks;
+
+  Serialiser ser(NULL, Serialiser::WRITING, false);
+  ser.SetElementMarks(&marks);
+  ser.Serialise("", state);
+  ser.SetElementMarks(NULL);
+
+  const byte *data = ser.GetRawPtr(0);
+  uint32_t size = (uint32_t)ser.GetOffset();
+
+  m_Delta.clear();
+
+  if(size == m_Blob.size() && (size == 0 || !memcmp(&m_Blob[0], data, size)))
+    return false;
+
+  // marks are recorded in increasing order as the state is written
+  vector<Segment> segments;
+  {
+    uint64_t prev = 0;
+    for(size_t i = 0; i < marks.size(); i++)
+    {
+      if(marks[i] >= size || marks[i] < prev + minSegment)
+        continue;
+
+      Segment seg = {(uint32_t)prev, (uint32_t)(marks[i] - prev)};
+      segments.push_back(seg);
+      prev = marks[i];
+    }
+
+    Segment seg = {(uint32_t)prev, (uint32_t)(size - prev)};
+    segments.push_back(seg);
+  }
+
+  // look up the previous blob's segments by contents. Elements are usually found at the same
+  // index or just after the last match, so only fall back to the lookup if those don't match.
+  map<uint64_t, size_t> oldSegments;
+  for(size_t i = 0; i < m_Segments.size(); i++)
+    oldSegments[HashSegment(&m_Blob[m_Segments[i].offset], m_Segments[i].length)] = i;
+
+  size_t nextOld = 0;
+
+  for(size_t i = 0; i < segments.size(); i++)
+  {
+    const Segment &seg = segments[i];
+    const byte *segData = data + seg.offset;
+
+    size_t candidates[] = {nextOld, i, m_Segments.size()};
+
+    auto it = oldSegments.find(HashSegment(segData, seg.length));
+    if(it != oldSegments.end())
+      candidates[2] = it->second;
+
+    const Segment *match = NULL;
+    for(size_t c = 0; c < ARRAY_COUNT(candidates) && match == NULL; c++)
+    {
+      if(candidates[c] >= m_Segments.size())
+        continue;
+
+      const Segment &old = m_Segments[candidates[c]];
+      if(old.length == seg.length && !memcmp(&m_Blob[old.offset], segData, seg.length))
+      {
+        match = &old;
+        nextOld = candidates[c] + 1;
+      }
+    }
+
+    DeltaOp op = {seg.offset, seg.length, false};
+    if(match)
+    {
+      op.offset = match->offset;
+      op.copy = true;
+    }
+
+    // extend the previous op if it continues on from it
+    if(!m_Delta.empty() && m_Delta.back().copy == op.copy &&
+       m_Delta.back().offset + m_Delta.back().length == op.offset)
+      m_Delta.back().length += op.length;
+    else
+      m_Delta.push_back(op);
+  }
+
+  // the ops reference the new blob's offsets for literal data, so we can drop the old blob now
+  m_Blob.assign(data, data + size);
+  m_Segments.swap(segments);
+
+  m_Version++;
+
+  return true;
+}
+
+template <typename PipeState>
+void PipelineStateBlob::Extract(PipeState &state)
+{
+  state = PipeState();
+
+  if(m_Blob.empty())
+    return;
+
+  Serialiser ser(m_Blob.size(), &m_Blob[0], false);
+  ser.Serialise("", state);
+}
+
+template bool PipelineStateBlob::Update(D3D11PipelineState &state);
+template bool PipelineStateBlob::Update(D3D12PipelineState &state);
+template bool PipelineStateBlob::Update(GLPipelineState &state);
+template bool PipelineStateBlob::Update(VulkanPipelineState &state);
+template void PipelineStateBlob::Extract(D3D11PipelineState &state);
+template void PipelineStateBlob::Extract(D3D12PipelineState &state);
+template void PipelineStateBlob::Extract(GLPipelineState &state);
+template void PipelineStateBlob::Extract(VulkanPipelineState &state);
+
+void PipelineStateBlob::WriteDelta(Serialiser *ser)
+{
+  uint32_t size = (uint32_t)m_Blob.size();
+  uint32_t numOps = (uint32_t)m_Delta.size();
+
+  ser->Serialise("", size);
+  ser->Serialise("", numOps);
+
+  for(uint32_t i = 0; i < numOps; i++)
+  {
+    ser->Serialise("", m_Delta[i].copy);
+    ser->Serialise("", m_Delta[i].length);
+
+    if(m_Delta[i].copy)
+      ser->Serialise("", m_Delta[i].offset);
+    else
+      ser->RawWriteBytes(&m_Blob[m_Delta[i].offset], m_Delta[i].length);
+  }
+
+  // only send each change once
+  m_Delta.clear();
+}
+
+bool PipelineStateBlob::ReadDelta(Serialiser *ser)
+{
+  uint32_t size = 0;
+  uint32_t numOps = 0;
+
+  ser->Serialise("", size);
+  ser->Serialise("", numOps);
+
+  if(numOps == 0)
+    return false;
+
+  vector<byte> blob(size);
+  uint32_t dest = 0;
+
+  for(uint32_t i = 0; i < numOps; i++)
+  {
+    DeltaOp op = {0, 0, false};
+    ser->Serialise("", op.copy);
+    ser->Serialise("", op.length);
+
+    const byte *src = NULL;
+
+    if(op.copy)
+    {
+      ser->Serialise("", op.offset);
+
+      if(op.offset + op.length <= m_Blob.size())
+        src = &m_Blob[op.offset];
+    }
+    else
+    {
+      src = (const byte *)ser->RawReadBytes(op.length);
+    }
+
+    if(src && dest + op.length <= size)
+      memcpy(&blob[dest], src, op.length);
+    else
+      RDCERR("Pipeline state delta op %u (%u bytes at %u) out of bounds", i, op.length, op.offset);
+
+    dest += op.length;
+  }
+
+  m_Blob.swap(blob);
+
+  // we don't know the new segments, so the next Update() on this side compares against nothing
+  m_Segments.clear();
+
+  m_Version++;
+
+  return true;
+}
+
 ReplayProxy::~ReplayProxy()
 {
   SAFE_DELETE(m_FromReplaySerialiser);
@@ -1691,6 +1926,8 @@ ReplayProxy::~ReplayProxy()
 
 bool ReplayProxy::SendReplayCommand(ReplayProxyPacket type)
 {
+  RDCTRACE_ZONE("ReplayProxy::SendReplayCommand");
+
   if(!m_Socket->Connected())
     return false;
 
@@ -1850,6 +2087,8 @@ bool ReplayProxy::Tick(int type, Serialiser *incomingPacket)
   if(!m_Socket || !m_Socket->Connected())
     return false;
 
+  RDCTRACE_ZONE("ReplayProxy::Tick");
+
   m_ToReplaySerialiser = incomingPacket;
 
   m_FromReplaySerialiser->Rewind();
@@ -2094,26 +2333,66 @@ void ReplayProxy::SavePipelineState()
   if(m_RemoteServer)
   {
     m_Remote->SavePipelineState();
-    m_D3D11PipelineState = m_Remote->GetD3D11PipelineState();
-    m_D3D12PipelineState = m_Remote->GetD3D12PipelineState();
-    m_GLPipelineState = m_Remote->GetGLPipelineState();
-    m_VulkanPipelineState = m_Remote->GetVulkanPipelineState();
+
+    // only the replaying API's state is ever filled out, so only that one is diffed and sent
+    GraphicsAPI api = m_Remote->GetAPIProperties().pipelineType;
+
+    m_FromReplaySerialiser->Serialise("", api);
+
+    // only send what changed since the last event
+    switch(api)
+    {
+      case eGraphicsAPI_D3D11:
+        m_D3D11PipelineState = m_Remote->GetD3D11PipelineState();
+        m_D3D11PipelineBlob.Update(m_D3D11PipelineState);
+        m_D3D11PipelineBlob.WriteDelta(m_FromReplaySerialiser);
+        break;
+      case eGraphicsAPI_D3D12:
+        m_D3D12PipelineState = m_Remote->GetD3D12PipelineState();
+        m_D3D12PipelineBlob.Update(m_D3D12PipelineState);
+        m_D3D12PipelineBlob.WriteDelta(m_FromReplaySerialiser);
+        break;
+      case eGraphicsAPI_OpenGL:
+        m_GLPipelineState = m_Remote->GetGLPipelineState();
+        m_GLPipelineBlob.Update(m_GLPipelineState);
+        m_GLPipelineBlob.WriteDelta(m_FromReplaySerialiser);
+        break;
+      case eGraphicsAPI_Vulkan:
+        m_VulkanPipelineState = m_Remote->GetVulkanPipelineState();
+        m_VulkanPipelineBlob.Update(m_VulkanPipelineState);
+        m_VulkanPipelineBlob.WriteDelta(m_FromReplaySerialiser);
+        break;
+    }
   }
   else
   {
     if(!SendReplayCommand(eReplayProxy_SavePipelineState))
       return;
 
-    m_D3D11PipelineState = D3D11PipelineState();
-    m_D3D12PipelineState = D3D12PipelineState();
-    m_GLPipelineState = GLPipelineState();
-    m_VulkanPipelineState = VulkanPipelineState();
-  }
+    GraphicsAPI api = eGraphicsAPI_D3D11;
+    m_FromReplaySerialiser->Serialise("", api);
 
-  m_FromReplaySerialiser->Serialise("", m_D3D11PipelineState);
-  m_FromReplaySerialiser->Serialise("", m_D3D12PipelineState);
-  m_FromReplaySerialiser->Serialise("", m_GLPipelineState);
-  m_FromReplaySerialiser->Serialise("", m_VulkanPipelineState);
+    // unchanged states keep their previous contents rather than being deserialised again
+    switch(api)
+    {
+      case eGraphicsAPI_D3D11:
+        if(m_D3D11PipelineBlob.ReadDelta(m_FromReplaySerialiser))
+          m_D3D11PipelineBlob.Extract(m_D3D11PipelineState);
+        break;
+      case eGraphicsAPI_D3D12:
+        if(m_D3D12PipelineBlob.ReadDelta(m_FromReplaySerialiser))
+          m_D3D12PipelineBlob.Extract(m_D3D12PipelineState);
+        break;
+      case eGraphicsAPI_OpenGL:
+        if(m_GLPipelineBlob.ReadDelta(m_FromReplaySerialiser))
+          m_GLPipelineBlob.Extract(m_GLPipelineState);
+        break;
+      case eGraphicsAPI_Vulkan:
+        if(m_VulkanPipelineBlob.ReadDelta(m_FromReplaySerialiser))
+          m_VulkanPipelineBlob.Extract(m_VulkanPipelineState);
+        break;
+    }
+  }
 }
 
 void ReplayProxy::ReplayLog(uint32_t endEventID, ReplayLogType replayType)
@@ -2379,6 +2658,12 @@ byte *ReplayProxy::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mi
   m_ToReplaySerialiser->Serialise("", params.remap);
   m_ToReplaySerialiser->Serialise("", params.blackPoint);
   m_ToReplaySerialiser->Serialise("", params.whitePoint);
+  m_ToReplaySerialiser->Serialise("", params.region.x);
+  m_ToReplaySerialiser->Serialise("", params.region.y);
+  m_ToReplaySerialiser->Serialise("", params.region.z);
+  m_ToReplaySerialiser->Serialise("", params.region.width);
+  m_ToReplaySerialiser->Serialise("", params.region.height);
+  m_ToReplaySerialiser->Serialise("", params.region.depth);
 
   if(m_RemoteServer)
   {
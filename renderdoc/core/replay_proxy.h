@@ -87,6 +87,55 @@ enum ReplayProxyPacket
   eReplayProxy_PixelHistory,
 };
 
+// Holds the serialised form of one API's pipeline state from the last event it was fetched
+// for. Comparing serialised bytes lets us detect whether anything changed between events
+// without a field-by-field compare, and over the network only the parts that changed need to
+// be sent - stepping between similar draws usually only touches a few bindings.
+//
+// The blob is split into segments at array and array element boundaries, and each segment is
+// matched against the previous blob's segments wherever they now are. That way a string or array
+// changing length only resends that element, rather than everything after it shifting.
+class PipelineStateBlob
+{
+public:
+  PipelineStateBlob() : m_Version(0) {}
+  // re-serialise state and diff it against the previous blob. Returns true if it changed.
+  template <typename PipeState>
+  bool Update(PipeState &state);
+
+  // deserialise the current blob into state.
+  template <typename PipeState>
+  void Extract(PipeState &state);
+
+  // send the changes from the last Update(), to be applied with ReadDelta on the other side.
+  // Returns true if the blob changed.
+  void WriteDelta(Serialiser *ser);
+  bool ReadDelta(Serialiser *ser);
+
+  // incremented every time the state changes
+  uint32_t GetVersion() const { return m_Version; }
+private:
+  struct Segment
+  {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  // one step in building the new blob, appended after the previous. Either a range copied from
+  // the previous blob, or a range of the new blob that's sent as-is.
+  struct DeltaOp
+  {
+    uint32_t offset;
+    uint32_t length;
+    bool copy;
+  };
+
+  vector<byte> m_Blob;
+  vector<Segment> m_Segments;
+  vector<DeltaOp> m_Delta;
+  uint32_t m_Version;
+};
+
 // This class implements IReplayDriver and StackResolver. On the local machine where the UI
 // is, this can then act like a full local replay by farming out over the network to a remote
 // replay where necessary to implement some functions, and using a local proxy where necessary.
@@ -556,4 +605,11 @@ private:
   D3D12PipelineState m_D3D12PipelineState;
   GLPipelineState m_GLPipelineState;
   VulkanPipelineState m_VulkanPipelineState;
+
+  // the last state sent (on the remote server) or received (locally), so that only changes
+  // need to go over the network
+  PipelineStateBlob m_D3D11PipelineBlob;
+  PipelineStateBlob m_D3D12PipelineBlob;
+  PipelineStateBlob m_GLPipelineBlob;
+  PipelineStateBlob m_VulkanPipelineBlob;
 };
@@ -29,6 +29,7 @@
 #include <set>
 #include "api/replay/renderdoc_replay.h"
 #include "common/threading.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "os/os_specific.h"
 #include "serialise/serialiser.h"
@@ -99,7 +100,14 @@ struct ResourceRecord
     m_ChunkLock = NULL;
 
     if(lock)
+    {
+      // records are created constantly, so don't look the name up each time
+      static Threading::LockStats *chunkLockStats =
+          Threading::GetLockStats("ResourceRecord::m_ChunkLock");
+
       m_ChunkLock = new Threading::CriticalSection();
+      m_ChunkLock->SetStats(chunkLockStats);
+    }
   }
 
   ~ResourceRecord() { SAFE_DELETE(m_ChunkLock); }
@@ -217,6 +225,16 @@ struct ResourceRecord
     UnlockChunks();
   }
 
+  // only for records whose chunks won't be read again until the capture is written out, see
+  // Chunk::MakeSpillable
+  void MakeChunksSpillable()
+  {
+    LockChunks();
+    for(auto it = m_Chunks.begin(); it != m_Chunks.end(); ++it)
+      it->second->MakeSpillable();
+    UnlockChunks();
+  }
+
   void DeleteChunks()
   {
     LockChunks();
@@ -387,6 +405,9 @@ public:
   // initial states are necessary
   bool ReadBeforeWrite(ResourceId id);
 
+  // check if this resource has been referenced at all in the frame being captured
+  bool IsResourceFrameReferenced(ResourceId id);
+
   ///////////////////////////////////////////
   // Replay-side methods
 
@@ -441,15 +462,38 @@ protected:
   Serialiser *GetSerialiser() { return m_pSerialiser; }
   bool m_InFrame;
 
-  // very coarse lock, protects EVERYTHING. This could certainly be improved and it may be a
-  // bottleneck
-  // for performance. Given that the main use cases are write-rarely read-often the lock should be
-  // optimised
-  // for that as we only want to make sure we're not modifying the objects together, by far the most
-  // common
-  // operation is looking up data.
+  // coarse lock for everything that isn't protected by one of the finer locks below. The lookups
+  // and frame reference/dirty tracking that happen constantly while the application records
+  // commands on many threads don't take it.
   Threading::CriticalSection m_Lock;
 
+  // read-mostly maps that are looked up far more often than they change. These locks aren't
+  // recursive, so nothing may call back into the manager while holding one.
+  Threading::RWLock m_CurrentResourceLock;    // protects m_CurrentResourceMap
+  Threading::RWLock m_ResourceRecordLock;     // protects m_ResourceRecords
+
+  // frame references and dirty resources are written from every recording thread, so they're
+  // split into shards by ID with a lock each. IDs are allocated sequentially, so the low bits
+  // spread them evenly.
+  struct ResourceShard
+  {
+    Threading::CriticalSection lock;
+    // used during capture - holds resources referenced in current frame (and how they're
+    // referenced)
+    map<ResourceId, FrameRefType> frameRefs;
+    // used during capture - holds resources marked as dirty, needing initial contents
+    set<ResourceId> dirty;
+  };
+
+  static const uint64_t NumResourceShards = 16;
+  ResourceShard m_Shards[NumResourceShards];
+
+  ResourceShard &GetShard(ResourceId id) { return m_Shards[id.id % NumResourceShards]; }
+  // gather the contents of every shard, in ID order. Only for the start and end of a capture
+  void GetFrameReferences(map<ResourceId, FrameRefType> &frameRefs);
+  void GetDirtyResources(set<ResourceId> &dirty);
+  void GetCurrentResources(vector<pair<ResourceId, WrappedResourceType> > &resources);
+
   // easy optimisation win - don't use maps everywhere. It's convenient but not optimal, and
   // profiling will
   // likely prove that some or all of these could be a problem
@@ -458,11 +502,7 @@ protected:
   // Unwrap)
   map<RealResourceType, WrappedResourceType> m_WrapperMap;
 
-  // used during capture - holds resources referenced in current frame (and how they're referenced)
-  map<ResourceId, FrameRefType> m_FrameReferencedResources;
-
-  // used during capture - holds resources marked as dirty, needing initial contents
-  set<ResourceId> m_DirtyResources;
+  // used during capture - resources to move into the dirty set when it's next safe to
   set<ResourceId> m_PendingDirtyResources;
 
   // used during capture or replay - holds initial contents
@@ -500,6 +540,41 @@ ResourceManager<WrappedResourceType, RealResourceType, RecordType>::ResourceMana
   m_pSerialiser = ser;
 
   m_InFrame = false;
+
+  m_Lock.SetName("ResourceManager::m_Lock");
+
+  for(uint64_t i = 0; i < NumResourceShards; i++)
+    m_Shards[i].lock.SetName("ResourceManager::ResourceShard");
+}
+
+template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
+void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::GetFrameReferences(
+    map<ResourceId, FrameRefType> &frameRefs)
+{
+  for(uint64_t i = 0; i < NumResourceShards; i++)
+  {
+    SCOPED_LOCK(m_Shards[i].lock);
+    frameRefs.insert(m_Shards[i].frameRefs.begin(), m_Shards[i].frameRefs.end());
+  }
+}
+
+template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
+void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::GetDirtyResources(
+    set<ResourceId> &dirty)
+{
+  for(uint64_t i = 0; i < NumResourceShards; i++)
+  {
+    SCOPED_LOCK(m_Shards[i].lock);
+    dirty.insert(m_Shards[i].dirty.begin(), m_Shards[i].dirty.end());
+  }
+}
+
+template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
+void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::GetCurrentResources(
+    vector<pair<ResourceId, WrappedResourceType> > &resources)
+{
+  SCOPED_READLOCK(m_CurrentResourceLock);
+  resources.assign(m_CurrentResourceMap.begin(), m_CurrentResourceMap.end());
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
@@ -591,12 +666,14 @@ template <typename WrappedResourceType, typename RealResourceType, typename Reco
 void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::MarkResourceFrameReferenced(
     ResourceId id, FrameRefType refType)
 {
-  SCOPED_LOCK(m_Lock);
-
   if(id == ResourceId())
     return;
 
-  bool newRef = MarkReferenced(m_FrameReferencedResources, id, refType);
+  ResourceShard &shard = GetShard(id);
+
+  SCOPED_LOCK(shard.lock);
+
+  bool newRef = MarkReferenced(shard.frameRefs, id, refType);
 
   if(newRef)
   {
@@ -610,22 +687,39 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::MarkRes
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 bool ResourceManager<WrappedResourceType, RealResourceType, RecordType>::ReadBeforeWrite(ResourceId id)
 {
-  if(m_FrameReferencedResources.find(id) != m_FrameReferencedResources.end())
-    return m_FrameReferencedResources[id] == eFrameRef_ReadBeforeWrite ||
-           m_FrameReferencedResources[id] == eFrameRef_ReadOnly;
+  ResourceShard &shard = GetShard(id);
+
+  SCOPED_LOCK(shard.lock);
+
+  auto it = shard.frameRefs.find(id);
+  if(it != shard.frameRefs.end())
+    return it->second == eFrameRef_ReadBeforeWrite || it->second == eFrameRef_ReadOnly;
 
   return false;
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
-void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::MarkDirtyResource(ResourceId res)
+bool ResourceManager<WrappedResourceType, RealResourceType, RecordType>::IsResourceFrameReferenced(
+    ResourceId id)
 {
-  SCOPED_LOCK(m_Lock);
+  ResourceShard &shard = GetShard(id);
+
+  SCOPED_LOCK(shard.lock);
 
+  return shard.frameRefs.find(id) != shard.frameRefs.end();
+}
+
+template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
+void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::MarkDirtyResource(ResourceId res)
+{
   if(res == ResourceId())
     return;
 
-  m_DirtyResources.insert(res);
+  ResourceShard &shard = GetShard(res);
+
+  SCOPED_LOCK(shard.lock);
+
+  shard.dirty.insert(res);
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
@@ -644,33 +738,36 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::FlushPe
 {
   SCOPED_LOCK(m_Lock);
 
-  m_DirtyResources.insert(m_PendingDirtyResources.begin(), m_PendingDirtyResources.end());
+  for(auto it = m_PendingDirtyResources.begin(); it != m_PendingDirtyResources.end(); ++it)
+    MarkDirtyResource(*it);
+
   m_PendingDirtyResources.clear();
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 bool ResourceManager<WrappedResourceType, RealResourceType, RecordType>::IsResourceDirty(ResourceId res)
 {
-  SCOPED_LOCK(m_Lock);
-
   if(res == ResourceId())
     return false;
 
-  return m_DirtyResources.find(res) != m_DirtyResources.end();
+  ResourceShard &shard = GetShard(res);
+
+  SCOPED_LOCK(shard.lock);
+
+  return shard.dirty.find(res) != shard.dirty.end();
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::MarkCleanResource(ResourceId res)
 {
-  SCOPED_LOCK(m_Lock);
-
   if(res == ResourceId())
     return;
 
-  if(IsResourceDirty(res))
-  {
-    m_DirtyResources.erase(res);
-  }
+  ResourceShard &shard = GetShard(res);
+
+  SCOPED_LOCK(shard.lock);
+
+  shard.dirty.erase(res);
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
@@ -713,6 +810,9 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::SetInit
   }
 
   m_InitialChunks[id] = chunk;
+
+  // nothing reads a prepared chunk again until it's written out with the capture
+  chunk->MakeSpillable();
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
@@ -742,10 +842,16 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::Seriali
   };
   vector<WrittenRecord> written;
 
+  map<ResourceId, FrameRefType> frameRefs;
+  GetFrameReferences(frameRefs);
+
+  set<ResourceId> dirtyResources;
+  GetDirtyResources(dirtyResources);
+
   // reasonable estimate, and these records are small
-  written.reserve(m_FrameReferencedResources.size());
+  written.reserve(frameRefs.size());
 
-  for(auto it = m_FrameReferencedResources.begin(); it != m_FrameReferencedResources.end(); ++it)
+  for(auto it = frameRefs.begin(); it != frameRefs.end(); ++it)
   {
     RecordType *record = GetResourceRecord(it->first);
 
@@ -757,11 +863,11 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::Seriali
     }
   }
 
-  for(auto it = m_DirtyResources.begin(); it != m_DirtyResources.end(); ++it)
+  for(auto it = dirtyResources.begin(); it != dirtyResources.end(); ++it)
   {
     ResourceId id = *it;
-    auto ref = m_FrameReferencedResources.find(id);
-    if(ref == m_FrameReferencedResources.end() || ref->second == eFrameRef_ReadOnly)
+    auto ref = frameRefs.find(id);
+    if(ref == frameRefs.end() || ref->second == eFrameRef_ReadOnly)
     {
       WrittenRecord wr = {id, true};
 
@@ -795,6 +901,8 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::FreeIni
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::CreateInitialContents()
 {
+  RDCTRACE_ZONE("ResourceManager::CreateInitialContents");
+
   set<ResourceId> neededInitials;
 
   uint32_t NumWrittenResources = 0;
@@ -835,6 +943,8 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::CreateI
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::ApplyInitialContents()
 {
+  RDCTRACE_ZONE("ResourceManager::ApplyInitialContents");
+
   RDCDEBUG("Applying initial contents");
   uint32_t numContents = 0;
   for(auto it = m_InitialContents.begin(); it != m_InitialContents.end(); ++it)
@@ -856,7 +966,7 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::ApplyIn
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::MarkUnwrittenResources()
 {
-  SCOPED_LOCK(m_Lock);
+  SCOPED_READLOCK(m_ResourceRecordLock);
 
   for(auto it = m_ResourceRecords.begin(); it != m_ResourceRecords.end(); ++it)
   {
@@ -872,11 +982,21 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::InsertR
 
   SCOPED_LOCK(m_Lock);
 
-  RDCDEBUG("%u frame resource records", (uint32_t)m_FrameReferencedResources.size());
+  map<ResourceId, FrameRefType> frameRefs;
+  GetFrameReferences(frameRefs);
+
+  RDCDEBUG("%u frame resource records", (uint32_t)frameRefs.size());
 
   if(RenderDoc::Inst().GetCaptureOptions().RefAllResources)
   {
-    for(auto it = m_ResourceRecords.begin(); it != m_ResourceRecords.end(); ++it)
+    // copy the records out, SerialisableResource may look up other records
+    vector<pair<ResourceId, RecordType *> > records;
+    {
+      SCOPED_READLOCK(m_ResourceRecordLock);
+      records.assign(m_ResourceRecords.begin(), m_ResourceRecords.end());
+    }
+
+    for(auto it = records.begin(); it != records.end(); ++it)
     {
       if(!SerialisableResource(it->first, it->second))
         continue;
@@ -886,7 +1006,7 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::InsertR
   }
   else
   {
-    for(auto it = m_FrameReferencedResources.begin(); it != m_FrameReferencedResources.end(); ++it)
+    for(auto it = frameRefs.begin(); it != frameRefs.end(); ++it)
     {
       RecordType *record = GetResourceRecord(it->first);
       if(record)
@@ -907,12 +1027,17 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::InsertR
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::PrepareInitialContents()
 {
+  RDCTRACE_ZONE("ResourceManager::PrepareInitialContents");
+
   SCOPED_LOCK(m_Lock);
 
-  RDCDEBUG("Preparing up to %u potentially dirty resources", (uint32_t)m_DirtyResources.size());
+  set<ResourceId> dirtyResources;
+  GetDirtyResources(dirtyResources);
+
+  RDCDEBUG("Preparing up to %u potentially dirty resources", (uint32_t)dirtyResources.size());
   uint32_t prepared = 0;
 
-  for(auto it = m_DirtyResources.begin(); it != m_DirtyResources.end(); ++it)
+  for(auto it = dirtyResources.begin(); it != dirtyResources.end(); ++it)
   {
     ResourceId id = *it;
 
@@ -938,7 +1063,10 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::Prepare
 
   prepared = 0;
 
-  for(auto it = m_CurrentResourceMap.begin(); it != m_CurrentResourceMap.end(); ++it)
+  vector<pair<ResourceId, WrappedResourceType> > currentResources;
+  GetCurrentResources(currentResources);
+
+  for(auto it = currentResources.begin(); it != currentResources.end(); ++it)
   {
     if(it->second == (WrappedResourceType)RecordType::NullResource)
       continue;
@@ -962,14 +1090,16 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::InsertI
   uint32_t dirty = 0;
   uint32_t skipped = 0;
 
-  RDCDEBUG("Checking %u possibly dirty resources", (uint32_t)m_DirtyResources.size());
+  set<ResourceId> dirtyResources;
+  GetDirtyResources(dirtyResources);
+
+  RDCDEBUG("Checking %u possibly dirty resources", (uint32_t)dirtyResources.size());
 
-  for(auto it = m_DirtyResources.begin(); it != m_DirtyResources.end(); ++it)
+  for(auto it = dirtyResources.begin(); it != dirtyResources.end(); ++it)
   {
     ResourceId id = *it;
 
-    if(m_FrameReferencedResources.find(id) == m_FrameReferencedResources.end() &&
-       !RenderDoc::Inst().GetCaptureOptions().RefAllResources)
+    if(!IsResourceFrameReferenced(id) && !RenderDoc::Inst().GetCaptureOptions().RefAllResources)
     {
 #if VERBOSE_DIRTY_RESOURCES
       RDCDEBUG("Dirty tesource %llu is GPU dirty but not referenced - skipping", id);
@@ -1044,7 +1174,10 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::InsertI
 
   dirty = 0;
 
-  for(auto it = m_CurrentResourceMap.begin(); it != m_CurrentResourceMap.end(); ++it)
+  vector<pair<ResourceId, WrappedResourceType> > currentResources;
+  GetCurrentResources(currentResources);
+
+  for(auto it = currentResources.begin(); it != currentResources.end(); ++it)
   {
     if(it->second == (WrappedResourceType)RecordType::NullResource)
       continue;
@@ -1101,15 +1234,22 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::ClearRe
 {
   SCOPED_LOCK(m_Lock);
 
-  for(auto it = m_FrameReferencedResources.begin(); it != m_FrameReferencedResources.end(); ++it)
+  for(uint64_t i = 0; i < NumResourceShards; i++)
   {
-    RecordType *record = GetResourceRecord(it->first);
+    ResourceShard &shard = m_Shards[i];
 
-    if(record)
-      record->Delete(this);
-  }
+    SCOPED_LOCK(shard.lock);
 
-  m_FrameReferencedResources.clear();
+    for(auto it = shard.frameRefs.begin(); it != shard.frameRefs.end(); ++it)
+    {
+      RecordType *record = GetResourceRecord(it->first);
+
+      if(record)
+        record->Delete(this);
+    }
+
+    shard.frameRefs.clear();
+  }
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
@@ -1147,7 +1287,7 @@ template <typename WrappedResourceType, typename RealResourceType, typename Reco
 RecordType *ResourceManager<WrappedResourceType, RealResourceType, RecordType>::GetResourceRecord(
     ResourceId id)
 {
-  SCOPED_LOCK(m_Lock);
+  SCOPED_READLOCK(m_ResourceRecordLock);
 
   auto it = m_ResourceRecords.find(id);
 
@@ -1160,7 +1300,7 @@ RecordType *ResourceManager<WrappedResourceType, RealResourceType, RecordType>::
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 bool ResourceManager<WrappedResourceType, RealResourceType, RecordType>::HasResourceRecord(ResourceId id)
 {
-  SCOPED_LOCK(m_Lock);
+  SCOPED_READLOCK(m_ResourceRecordLock);
 
   auto it = m_ResourceRecords.find(id);
 
@@ -1174,18 +1314,21 @@ template <typename WrappedResourceType, typename RealResourceType, typename Reco
 RecordType *ResourceManager<WrappedResourceType, RealResourceType, RecordType>::AddResourceRecord(
     ResourceId id)
 {
-  SCOPED_LOCK(m_Lock);
+  // construct outside the lock, it allocates and names the record's chunk lock
+  RecordType *record = new RecordType(id);
+
+  SCOPED_WRITELOCK(m_ResourceRecordLock);
 
   RDCASSERT(m_ResourceRecords.find(id) == m_ResourceRecords.end(), id);
 
-  return (m_ResourceRecords[id] = new RecordType(id));
+  return (m_ResourceRecords[id] = record);
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::RemoveResourceRecord(
     ResourceId id)
 {
-  SCOPED_LOCK(m_Lock);
+  SCOPED_WRITELOCK(m_ResourceRecordLock);
 
   RDCASSERT(m_ResourceRecords.find(id) != m_ResourceRecords.end(), id);
 
@@ -1361,7 +1504,7 @@ template <typename WrappedResourceType, typename RealResourceType, typename Reco
 void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::AddCurrentResource(
     ResourceId id, WrappedResourceType res)
 {
-  SCOPED_LOCK(m_Lock);
+  SCOPED_WRITELOCK(m_CurrentResourceLock);
 
   RDCASSERT(m_CurrentResourceMap.find(id) == m_CurrentResourceMap.end(), id);
   m_CurrentResourceMap[id] = res;
@@ -1370,7 +1513,7 @@ void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::AddCurr
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 bool ResourceManager<WrappedResourceType, RealResourceType, RecordType>::HasCurrentResource(ResourceId id)
 {
-  SCOPED_LOCK(m_Lock);
+  SCOPED_READLOCK(m_CurrentResourceLock);
 
   return m_CurrentResourceMap.find(id) != m_CurrentResourceMap.end();
 }
@@ -1379,20 +1522,31 @@ template <typename WrappedResourceType, typename RealResourceType, typename Reco
 WrappedResourceType ResourceManager<WrappedResourceType, RealResourceType,
                                     RecordType>::GetCurrentResource(ResourceId id)
 {
-  SCOPED_LOCK(m_Lock);
+  // replacements only exist on replay
+  if(IsReading())
+  {
+    SCOPED_LOCK(m_Lock);
 
-  if(m_Replacements.find(id) != m_Replacements.end())
-    return GetCurrentResource(m_Replacements[id]);
+    auto it = m_Replacements.find(id);
+    if(it != m_Replacements.end())
+      return GetCurrentResource(it->second);
+  }
 
-  RDCASSERT(m_CurrentResourceMap.find(id) != m_CurrentResourceMap.end(), id);
-  return m_CurrentResourceMap[id];
+  SCOPED_READLOCK(m_CurrentResourceLock);
+
+  auto it = m_CurrentResourceMap.find(id);
+  RDCASSERT(it != m_CurrentResourceMap.end(), id);
+  if(it == m_CurrentResourceMap.end())
+    return (WrappedResourceType)RecordType::NullResource;
+
+  return it->second;
 }
 
 template <typename WrappedResourceType, typename RealResourceType, typename RecordType>
 void ResourceManager<WrappedResourceType, RealResourceType, RecordType>::ReleaseCurrentResource(
     ResourceId id)
 {
-  SCOPED_LOCK(m_Lock);
+  SCOPED_WRITELOCK(m_CurrentResourceLock);
 
   RDCASSERT(m_CurrentResourceMap.find(id) != m_CurrentResourceMap.end(), id);
   m_CurrentResourceMap.erase(id);
@@ -24,6 +24,7 @@
  ******************************************************************************/
 
 #include "api/replay/renderdoc_replay.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "os/os_specific.h"
 #include "replay/type_helpers.h"
@@ -42,6 +43,11 @@ enum PacketType
   ePacket_DeleteCapture,
   ePacket_QueueCapture,
   ePacket_NewChild,
+  ePacket_SetTraceEnabled,
+  ePacket_CopyTrace,
+  ePacket_SaveRecentFrame,
+  ePacket_CaptureMemory,
+  ePacket_LockContention,
 };
 
 void RenderDoc::TargetControlClientThread(void *s)
@@ -84,6 +90,10 @@ void RenderDoc::TargetControlClientThread(void *s)
   vector<CaptureData> captures;
   vector<pair<uint32_t, uint32_t> > children;
 
+  // resident, spilled, live chunks and budget, as last sent
+  uint64_t captureMemory[4] = {};
+  bool lockContentionNext = false;
+
   while(client)
   {
     if(RenderDoc::Inst().m_ControlClientThreadShutdown || (client && !client->Connected()))
@@ -145,6 +155,45 @@ void RenderDoc::TargetControlClientThread(void *s)
       ser.Serialise("", children.back().first);
       ser.Serialise("", children.back().second);
     }
+    else if(curtime >= pingtime)
+    {
+      uint64_t mem[4] = {Chunk::TotalMem(), Chunk::SpilledMem(), Chunk::NumLiveChunks(),
+                         Chunk::MemoryBudget()};
+
+      // if capture memory has changed, send that instead of an empty ping. When lock contention
+      // is also being sent, alternate between the two so neither is starved
+      if(memcmp(mem, captureMemory, sizeof(mem)) &&
+         !(Threading::LockProfilingEnabled && lockContentionNext))
+      {
+        memcpy(captureMemory, mem, sizeof(mem));
+        lockContentionNext = true;
+
+        packetType = ePacket_CaptureMemory;
+
+        for(int i = 0; i < 4; i++)
+          ser.Serialise("", captureMemory[i]);
+      }
+      else if(Threading::LockProfilingEnabled)
+      {
+        vector<Threading::LockContention> locks = Threading::GetLockContention();
+
+        packetType = ePacket_LockContention;
+        lockContentionNext = false;
+
+        uint32_t numLocks = (uint32_t)locks.size();
+        ser.Serialise("", numLocks);
+
+        for(uint32_t i = 0; i < numLocks; i++)
+        {
+          ser.Serialise("", locks[i].name);
+          ser.Serialise("", locks[i].acquisitions);
+          ser.Serialise("", locks[i].contended);
+          ser.Serialise("", locks[i].totalWaitMS);
+          ser.Serialise("", locks[i].maxWaitMS);
+          ser.Serialise("", locks[i].worstHolder);
+        }
+      }
+    }
 
     if(curtime < pingtime && packetType == ePacket_Noop)
     {
@@ -175,6 +224,13 @@ void RenderDoc::TargetControlClientThread(void *s)
 
           RenderDoc::Inst().QueueCapture(frameNum);
         }
+        else if(type == ePacket_SaveRecentFrame)
+        {
+          uint32_t framesAgo = 0;
+          recvser->Serialise("", framesAgo);
+
+          RenderDoc::Inst().SaveRecentFrame(framesAgo);
+        }
         else if(type == ePacket_DeleteCapture)
         {
           uint32_t id = 0;
@@ -211,6 +267,26 @@ void RenderDoc::TargetControlClientThread(void *s)
             RenderDoc::Inst().MarkCaptureRetrieved(id);
           }
         }
+        else if(type == ePacket_SetTraceEnabled)
+        {
+          bool enabled = false;
+          recvser->Serialise("", enabled);
+
+          Trace::SetEnabled(enabled);
+        }
+        else if(type == ePacket_CopyTrace)
+        {
+          string json = Trace::ExportJSON();
+          ser.Serialise("", json);
+
+          if(!SendPacket(client, ePacket_CopyTrace, ser))
+          {
+            SAFE_DELETE(client);
+            continue;
+          }
+
+          ser.Rewind();
+        }
 
         SAFE_DELETE(recvser);
       }
@@ -456,6 +532,19 @@ public:
     }
   }
 
+  void SaveRecentFrame(uint32_t framesAgo)
+  {
+    Serialiser ser("", Serialiser::WRITING, false);
+
+    ser.Serialise("", framesAgo);
+
+    if(!SendPacket(m_Socket, ePacket_SaveRecentFrame, ser))
+    {
+      SAFE_DELETE(m_Socket);
+      return;
+    }
+  }
+
   void CopyCapture(uint32_t remoteID, const char *localpath)
   {
     Serialiser ser("", Serialiser::WRITING, false);
@@ -484,6 +573,32 @@ public:
     }
   }
 
+  void SetTraceEnabled(bool enabled)
+  {
+    Serialiser ser("", Serialiser::WRITING, false);
+
+    ser.Serialise("", enabled);
+
+    if(!SendPacket(m_Socket, ePacket_SetTraceEnabled, ser))
+    {
+      SAFE_DELETE(m_Socket);
+      return;
+    }
+  }
+
+  void CopyTrace(const char *localpath)
+  {
+    Serialiser ser("", Serialiser::WRITING, false);
+
+    if(!SendPacket(m_Socket, ePacket_CopyTrace, ser))
+    {
+      SAFE_DELETE(m_Socket);
+      return;
+    }
+
+    m_TraceCopies.push_back(localpath);
+  }
+
   void ReceiveMessage(TargetControlMessage *msg)
   {
     if(m_Socket == NULL)
@@ -568,6 +683,31 @@ public:
 
         return;
       }
+      else if(type == ePacket_CopyTrace)
+      {
+        string json;
+        ser->Serialise("", json);
+
+        SAFE_DELETE(ser);
+
+        // replies come back in the order the copies were requested
+        string path = m_TraceCopies.empty() ? "" : m_TraceCopies.front();
+        if(!m_TraceCopies.empty())
+          m_TraceCopies.erase(m_TraceCopies.begin());
+
+        if(path.empty() || !FileIO::dump(path.c_str(), json.c_str(), json.size()))
+        {
+          RDCERR("Couldn't write trace to '%s'", path.c_str());
+          msg->Type = eTargetControlMsg_Noop;
+          return;
+        }
+
+        msg->Type = eTargetControlMsg_TraceCopied;
+        msg->NewCapture.ID = 0;
+        msg->NewCapture.path = path;
+
+        return;
+      }
       else if(type == ePacket_NewChild)
       {
         msg->Type = eTargetControlMsg_NewChild;
@@ -609,6 +749,48 @@ public:
 
         return;
       }
+      else if(type == ePacket_CaptureMemory)
+      {
+        msg->Type = eTargetControlMsg_CaptureMemory;
+
+        ser->Serialise("", msg->CaptureMemory.residentBytes);
+        ser->Serialise("", msg->CaptureMemory.spilledBytes);
+        ser->Serialise("", msg->CaptureMemory.liveChunks);
+        ser->Serialise("", msg->CaptureMemory.budgetBytes);
+
+        SAFE_DELETE(ser);
+
+        return;
+      }
+      else if(type == ePacket_LockContention)
+      {
+        msg->Type = eTargetControlMsg_LockContention;
+
+        uint32_t numLocks = 0;
+        ser->Serialise("", numLocks);
+
+        create_array(msg->LockContention.locks, numLocks);
+
+        for(uint32_t i = 0; i < numLocks; i++)
+        {
+          LockContentionStats &lock = msg->LockContention.locks[i];
+
+          string name, holder;
+          ser->Serialise("", name);
+          ser->Serialise("", lock.acquisitions);
+          ser->Serialise("", lock.contended);
+          ser->Serialise("", lock.totalWaitMS);
+          ser->Serialise("", lock.maxWaitMS);
+          ser->Serialise("", holder);
+
+          lock.name = name;
+          lock.worstHolder = holder;
+        }
+
+        SAFE_DELETE(ser);
+
+        return;
+      }
       else if(type == ePacket_RegisterAPI)
       {
         msg->Type = eTargetControlMsg_RegisterAPI;
@@ -636,6 +818,7 @@ private:
   uint32_t m_PID;
 
   map<uint32_t, string> m_CaptureCopies;
+  vector<string> m_TraceCopies;
 
   void GetPacket(PacketType &type, Serialiser *&ser)
   {
@@ -676,6 +859,11 @@ extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_QueueCapture(TargetCont
 {
   control->QueueCapture(frameNumber);
 }
+extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_SaveRecentFrame(TargetControl *control,
+                                                                         uint32_t framesAgo)
+{
+  control->SaveRecentFrame(framesAgo);
+}
 extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_CopyCapture(TargetControl *control,
                                                                      uint32_t remoteID,
                                                                      const char *localpath)
@@ -689,6 +877,18 @@ extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_DeleteCapture(TargetCon
   control->DeleteCapture(remoteID);
 }
 
+extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_SetTraceEnabled(TargetControl *control,
+                                                                         bool32 enabled)
+{
+  control->SetTraceEnabled(enabled != 0);
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_CopyTrace(TargetControl *control,
+                                                                   const char *localpath)
+{
+  control->CopyTrace(localpath);
+}
+
 extern "C" RENDERDOC_API void RENDERDOC_CC TargetControl_ReceiveMessage(TargetControl *control,
                                                                         TargetControlMessage *msg)
 {
@@ -474,6 +474,9 @@ void WrappedID3D11DeviceContext::EndCaptureFrame()
   SCOPED_SERIALISE_CONTEXT(CONTEXT_CAPTURE_FOOTER);
   m_pSerialiser->Serialise("context", m_ResourceID);
 
+  uint32_t FrameNumber = m_pDevice->GetFrameCounter();
+  m_pSerialiser->Serialise("FrameNumber", FrameNumber);
+
   bool HasCallstack = RenderDoc::Inst().GetCaptureOptions().CaptureCallstacks != 0;
   m_pSerialiser->Serialise("HasCallstack", HasCallstack);
 
@@ -773,6 +776,10 @@ void WrappedID3D11DeviceContext::ProcessChunk(uint64_t offset, D3D11ChunkType ch
 
     case CONTEXT_CAPTURE_FOOTER:
     {
+      uint32_t FrameNumber = m_pDevice->GetFrameRecord().frameInfo.frameNumber;
+      if(m_pDevice->GetLogVersion() >= 0x00000C)
+        m_pSerialiser->Serialise("FrameNumber", FrameNumber);
+
       bool HasCallstack = false;
       m_pSerialiser->Serialise("HasCallstack", HasCallstack);
 
@@ -800,6 +807,14 @@ void WrappedID3D11DeviceContext::ProcessChunk(uint64_t offset, D3D11ChunkType ch
         draw.copyDestination = m_pDevice->GetBackbufferResourceID();
 
         AddDrawcall(draw, true);
+
+        FetchCapturedFrame frame;
+        frame.frameNumber = FrameNumber;
+        frame.firstEvent = m_ReadFrames.empty()
+                               ? m_pDevice->GetFrameRecord().frameInfo.firstEvent
+                               : m_ReadFrames.back().lastEvent + 1;
+        frame.lastEvent = m_CurEventID;
+        m_ReadFrames.push_back(frame);
       }
     }
     break;
@@ -1421,6 +1436,7 @@ void WrappedID3D11DeviceContext::ReplayLog(LogState readType, uint32_t startEven
   else if(m_State == READING)
   {
     m_CurEventID = 1;
+    m_ReadFrames.clear();
   }
 
   if(m_State == EXECUTING)
@@ -1456,9 +1472,9 @@ void WrappedID3D11DeviceContext::ReplayLog(LogState readType, uint32_t startEven
     RenderDoc::Inst().SetProgress(FrameEventsRead,
                                   float(offset - startOffset) / float(m_pSerialiser->GetSize()));
 
-    // for now just abort after capture scope. Really we'd need to support multiple frames
-    // but for now this will do.
-    if(chunktype == CONTEXT_CAPTURE_FOOTER)
+    // captures spanning several frames have a footer at the end of each frame, only the last
+    // one ends the capture
+    if(chunktype == CONTEXT_CAPTURE_FOOTER && m_pSerialiser->AtEnd())
       break;
 
     m_CurEventID++;
@@ -1467,6 +1483,7 @@ void WrappedID3D11DeviceContext::ReplayLog(LogState readType, uint32_t startEven
   if(m_State == READING)
   {
     m_pDevice->GetFrameRecord().drawcallList = m_ParentDrawcall.Bake();
+    m_pDevice->GetFrameRecord().frames = m_ReadFrames;
     m_pDevice->GetFrameRecord().frameInfo.debugMessages = m_pDevice->GetDebugMessages();
 
     for(auto it = WrappedID3D11Buffer::m_BufferList.begin();
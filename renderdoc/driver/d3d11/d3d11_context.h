@@ -245,6 +245,9 @@ private:
   DrawcallTreeNode m_ParentDrawcall;
   map<ResourceId, DrawcallTreeNode> m_CmdLists;
 
+  // each frame's footer read so far, while reading the log
+  vector<FetchCapturedFrame> m_ReadFrames;
+
   list<DrawcallTreeNode *> m_DrawcallStack;
 
   void FlattenLog();
@@ -240,6 +240,9 @@ const uint32_t D3D11InitParams::D3D11_OLD_VERSIONS[D3D11InitParams::D3D11_NUM_SU
     0x000009,
     // from 0xA to 0xB, we added the SwapDeviceContextState from ID3D11DeviceContext1
     0x00000A,
+    // from 0xB to 0xC, each frame's footer records its frame number. Older logs only have one
+    // frame, so they use the capture's frame number instead.
+    0x00000B,
 };
 
 ReplayCreateStatus D3D11InitParams::Serialise()
@@ -1135,18 +1138,12 @@ void WrappedID3D11Device::ReadLogInitialisation()
 
   int chunkIdx = 0;
 
-  struct chunkinfo
-  {
-    chunkinfo() : count(0), totalsize(0), total(0.0) {}
-    int count;
-    uint64_t totalsize;
-    double total;
-  };
-
-  map<D3D11ChunkType, chunkinfo> chunkInfos;
+  map<D3D11ChunkType, FetchChunkLoadStats> chunkInfos;
 
   SCOPED_TIMER("chunk initialisation");
 
+  PerformanceTimer loadTimer;
+
   for(;;)
   {
     PerformanceTimer timer;
@@ -1173,16 +1170,28 @@ void WrappedID3D11Device::ReadLogInitialisation()
     {
       frameOffset = offset;
 
+      PerformanceTimer applyTimer;
+
       GetResourceManager()->ApplyInitialContents();
 
+      m_FrameRecord.loadProfile.initialContentsApplyTime = applyTimer.GetMilliseconds();
+
       m_pImmediateContext->ReplayLog(READING, 0, 0, false);
     }
 
     uint64_t offset2 = m_pSerialiser->GetOffset();
 
-    chunkInfos[context].total += timer.GetMilliseconds();
-    chunkInfos[context].totalsize += offset2 - offset;
-    chunkInfos[context].count++;
+    FetchChunkLoadStats &stats = chunkInfos[context];
+
+    if(stats.count == 0)
+    {
+      stats.chunkID = uint32_t(context);
+      stats.name = GetChunkName(context);
+    }
+
+    stats.totalTime += timer.GetMilliseconds();
+    stats.totalSize += offset2 - offset;
+    stats.count++;
 
     if(context == CAPTURE_SCOPE)
       break;
@@ -1199,18 +1208,25 @@ void WrappedID3D11Device::ReadLogInitialisation()
     double dcount = double(it->second.count);
 
     RDCDEBUG(
-        "% 5d chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
-        it->second.count, it->second.total, it->second.total / dcount,
-        double(it->second.totalsize) / (1024.0 * 1024.0),
-        double(it->second.totalsize) / (dcount * 1024.0 * 1024.0), GetChunkName(it->first),
-        uint32_t(it->first));
+        "% 5u chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
+        it->second.count, it->second.totalTime, it->second.totalTime / dcount,
+        double(it->second.totalSize) / (1024.0 * 1024.0),
+        double(it->second.totalSize) / (dcount * 1024.0 * 1024.0), it->second.name.c_str(),
+        it->second.chunkID);
   }
 #endif
 
   m_FrameRecord.frameInfo.uncompressedFileSize = m_pSerialiser->GetSize();
   m_FrameRecord.frameInfo.compressedFileSize = m_pSerialiser->GetFileSize();
   m_FrameRecord.frameInfo.persistentSize = m_pSerialiser->GetSize() - frameOffset;
-  m_FrameRecord.frameInfo.initDataSize = chunkInfos[(D3D11ChunkType)INITIAL_CONTENTS].totalsize;
+  m_FrameRecord.frameInfo.initDataSize = chunkInfos[(D3D11ChunkType)INITIAL_CONTENTS].totalSize;
+
+  m_FrameRecord.loadProfile.totalTime = loadTimer.GetMilliseconds();
+  m_FrameRecord.loadProfile.fileReadTime = m_pSerialiser->GetFileReadTime();
+  m_FrameRecord.loadProfile.decompressTime = m_pSerialiser->GetDecompressTime();
+  m_FrameRecord.loadProfile.initialContentsTime =
+      chunkInfos[(D3D11ChunkType)INITIAL_CONTENTS].totalTime;
+  FillLoadProfileChunks(m_FrameRecord.loadProfile, chunkInfos);
 
   RDCDEBUG("Allocating %llu persistant bytes of memory for the log.",
            m_pSerialiser->GetSize() - frameOffset);
@@ -2426,6 +2442,8 @@ void WrappedID3D11Device::Apply_InitialState(ID3D11DeviceChild *live,
 void WrappedID3D11Device::ReplayLog(uint32_t startEventID, uint32_t endEventID,
                                     ReplayLogType replayType)
 {
+  RDCTRACE_ZONE("WrappedID3D11Device::ReplayLog");
+
   uint64_t offs = m_FrameRecord.frameInfo.fileOffset;
 
   m_pSerialiser->SetOffset(offs);
@@ -2678,6 +2696,8 @@ void WrappedID3D11Device::StartFrameCapture(void *dev, void *wnd)
   if(m_State != WRITING_IDLE)
     return;
 
+  RDCTRACE_ZONE("WrappedID3D11Device::StartFrameCapture");
+
   SCOPED_LOCK(m_D3DLock);
 
   RenderDoc::Inst().SetCurrentDriver(RDC_D3D11);
@@ -2735,6 +2755,8 @@ bool WrappedID3D11Device::EndFrameCapture(void *dev, void *wnd)
   if(m_State != WRITING_CAPFRAME)
     return true;
 
+  RDCTRACE_ZONE("WrappedID3D11Device::EndFrameCapture");
+
   CaptureFailReason reason;
 
   WrappedIDXGISwapChain4 *swap = NULL;
@@ -2793,7 +2815,8 @@ bool WrappedID3D11Device::EndFrameCapture(void *dev, void *wnd)
     uint32_t thwidth = 0;
     uint32_t thheight = 0;
 
-    if(swap != NULL)
+    // flight recorder frames are kept in memory without a thumbnail
+    if(swap != NULL && !RenderDoc::Inst().IsFlightRecordingFrame())
     {
       ID3D11RenderTargetView *rtv = m_SwapChains[swap];
 
@@ -3355,12 +3378,16 @@ HRESULT WrappedID3D11Device::Present(WrappedIDXGISwapChain4 *swap, UINT SyncInte
 
   RenderDoc::Inst().SetCurrentDriver(RDC_D3D11);
 
-  // kill any current capture that isn't application defined
+  // kill any current capture that isn't application defined, unless it spans more frames - then
+  // only record where this frame ended
   if(m_State == WRITING_CAPFRAME && !m_AppControlledCapture)
   {
     m_pImmediateContext->Present(SyncInterval, Flags);
 
-    RenderDoc::Inst().EndFrameCapture((ID3D11Device *)this, swapdesc.OutputWindow);
+    if(RenderDoc::Inst().ContinueFrameCapture())
+      m_pImmediateContext->EndCaptureFrame();
+    else
+      RenderDoc::Inst().EndFrameCapture((ID3D11Device *)this, swapdesc.OutputWindow);
   }
 
   if(RenderDoc::Inst().ShouldTriggerCapture(m_FrameCounter) && m_State == WRITING_IDLE)
@@ -62,10 +62,10 @@ struct D3D11InitParams : public RDCInitParams
   UINT NumFeatureLevels;
   D3D_FEATURE_LEVEL FeatureLevels[16];
 
-  static const uint32_t D3D11_SERIALISE_VERSION = 0x000000B;
+  static const uint32_t D3D11_SERIALISE_VERSION = 0x000000C;
 
   // backwards compatibility for old logs described at the declaration of this array
-  static const uint32_t D3D11_NUM_SUPPORTED_OLD_VERSIONS = 7;
+  static const uint32_t D3D11_NUM_SUPPORTED_OLD_VERSIONS = 8;
   static const uint32_t D3D11_OLD_VERSIONS[D3D11_NUM_SUPPORTED_OLD_VERSIONS];
 
   // version number internal to d3d11 stream
@@ -409,6 +409,7 @@ public:
     m_InitParams.SerialiseVersion = fileversion;
   }
   uint32_t GetLogVersion() { return m_InitParams.SerialiseVersion; }
+  uint32_t GetFrameCounter() { return m_FrameCounter; }
   virtual ~WrappedID3D11Device();
 
   ////////////////////////////////////////////////////////////////
@@ -1443,7 +1443,34 @@ void D3D11Replay::GetBufferData(ResourceId buff, uint64_t offset, uint64_t len,
 byte *D3D11Replay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
                                   const GetTextureDataParams &params, size_t &dataSize)
 {
-  return m_pDevice->GetDebugManager()->GetTextureData(tex, arrayIdx, mip, params, dataSize);
+  byte *ret = m_pDevice->GetDebugManager()->GetTextureData(tex, arrayIdx, mip, params, dataSize);
+
+  if(ret == NULL || params.region.IsWhole())
+    return ret;
+
+  // the debug manager reads back whole subresources, so crop to the region afterwards
+  FetchTexture details = GetTexture(tex);
+
+  uint32_t blockDim = 1, blockBytes = 0;
+  if(!GetTextureDataBlockSize(details.format, params.remap, blockDim, blockBytes))
+  {
+    RDCERR("Can't read a region of texture %llu with format %s", tex,
+           details.format.strname.elems);
+    delete[] ret;
+    dataSize = 0;
+    return new byte[0];
+  }
+
+  uint32_t width = RDCMAX(1U, details.width >> mip);
+  uint32_t height = RDCMAX(1U, details.height >> mip);
+  uint32_t depth = details.dimension == 3 ? RDCMAX(1U, details.depth >> mip) : 1;
+
+  TextureRegion region = ClampTextureRegion(params.region, width, height, depth, blockDim);
+
+  byte *cropped = CropTextureData(ret, width, height, depth, blockDim, blockBytes, region, dataSize);
+  delete[] ret;
+
+  return cropped;
 }
 
 void D3D11Replay::ReplaceResource(ResourceId from, ResourceId to)
@@ -98,6 +98,9 @@ class WrappedID3D12CommandQueue : public ID3D12CommandQueue,
 
   ResourceId m_BackbufferID;
 
+  // each frame's footer read so far, while reading the log
+  vector<FetchCapturedFrame> m_ReadFrames;
+
   void ProcessChunk(uint64_t offset, D3D12ChunkType context);
 
   const char *GetChunkName(uint32_t idx) { return m_pDevice->GetChunkName(idx); }
@@ -120,6 +123,7 @@ public:
   FetchAPIEvent GetEvent(uint32_t eventID);
   uint32_t GetMaxEID() { return m_Cmd.m_Events.back().eventID; }
   ResourceId GetBackbufferResourceID() { return m_BackbufferID; }
+  const vector<FetchCapturedFrame> &GetReadFrames() { return m_ReadFrames; }
   void ClearAfterCapture();
 
   void ReplayLog(LogState readType, uint32_t startEventID, uint32_t endEventID, bool partial);
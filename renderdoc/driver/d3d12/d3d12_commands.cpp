@@ -389,6 +389,7 @@ void WrappedID3D12CommandQueue::ProcessChunk(uint64_t offset, D3D12ChunkType chu
     case CONTEXT_CAPTURE_FOOTER:
     {
       SERIALISE_ELEMENT(ResourceId, bbid, ResourceId());
+      SERIALISE_ELEMENT(uint32_t, FrameNumber, 0);
 
       bool HasCallstack = false;
       m_pSerialiser->Serialise("HasCallstack", HasCallstack);
@@ -418,6 +419,14 @@ void WrappedID3D12CommandQueue::ProcessChunk(uint64_t offset, D3D12ChunkType chu
         draw.copyDestination = bbid;
 
         m_Cmd.AddDrawcall(draw, true);
+
+        FetchCapturedFrame frame;
+        frame.frameNumber = FrameNumber;
+        frame.firstEvent = m_ReadFrames.empty()
+                               ? m_pDevice->GetFrameRecord().frameInfo.firstEvent
+                               : m_ReadFrames.back().lastEvent + 1;
+        frame.lastEvent = m_Cmd.m_RootEventID;
+        m_ReadFrames.push_back(frame);
       }
       break;
     }
@@ -505,6 +514,7 @@ void WrappedID3D12CommandQueue::ReplayLog(LogState readType, uint32_t startEvent
     m_Cmd.m_RootDrawcallID = 1;
     m_Cmd.m_FirstEventID = 0;
     m_Cmd.m_LastEventID = ~0U;
+    m_ReadFrames.clear();
   }
 
   for(;;)
@@ -526,9 +536,9 @@ void WrappedID3D12CommandQueue::ReplayLog(LogState readType, uint32_t startEvent
 
     RenderDoc::Inst().SetProgress(FileInitialRead, float(offset) / float(m_pSerialiser->GetSize()));
 
-    // for now just abort after capture scope. Really we'd need to support multiple frames
-    // but for now this will do.
-    if(context == CONTEXT_CAPTURE_FOOTER)
+    // captures spanning several frames have a footer at the end of each frame, only the last
+    // one ends the capture
+    if(context == CONTEXT_CAPTURE_FOOTER && m_pSerialiser->AtEnd())
       break;
 
     // break out if we were only executing one event
@@ -195,6 +195,8 @@ WrappedID3D12Device::WrappedID3D12Device(ID3D12Device *realDevice, D3D12InitPara
 
   m_AppControlledCapture = false;
 
+  m_CapTransitionLock.SetName("WrappedID3D12Device::m_CapTransitionLock");
+
   threadSerialiserTLSSlot = Threading::AllocateTLSSlot();
   tempMemoryTLSSlot = Threading::AllocateTLSSlot();
 
@@ -1021,9 +1023,25 @@ HRESULT WrappedID3D12Device::Present(WrappedIDXGISwapChain4 *swap, UINT SyncInte
 
   RenderDoc::Inst().SetCurrentDriver(RDC_D3D12);
 
-  // kill any current capture that isn't application defined
+  // kill any current capture that isn't application defined, unless it spans more frames - then
+  // only record where this frame ended
   if(m_State == WRITING_CAPFRAME && !m_AppControlledCapture)
-    RenderDoc::Inst().EndFrameCapture((ID3D12Device *)this, swapdesc.OutputWindow);
+  {
+    if(RenderDoc::Inst().ContinueFrameCapture())
+    {
+      ID3D12Resource *backbuffer =
+          (ID3D12Resource *)swap->GetBackbuffers()[m_SwapChains[swap].lastPresentedBuffer];
+
+      GetResourceManager()->MarkResourceFrameReferenced(GetResID(backbuffer), eFrameRef_Read);
+
+      SCOPED_LOCK(m_CapTransitionLock);
+      EndCaptureFrame(backbuffer);
+    }
+    else
+    {
+      RenderDoc::Inst().EndFrameCapture((ID3D12Device *)this, swapdesc.OutputWindow);
+    }
+  }
 
   if(RenderDoc::Inst().ShouldTriggerCapture(m_FrameCounter) && m_State == WRITING_IDLE)
   {
@@ -1095,6 +1113,7 @@ void WrappedID3D12Device::EndCaptureFrame(ID3D12Resource *presentImage)
   SCOPED_SERIALISE_CONTEXT(CONTEXT_CAPTURE_FOOTER);
 
   SERIALISE_ELEMENT(ResourceId, bbid, GetResID(presentImage));
+  SERIALISE_ELEMENT(uint32_t, FrameNumber, m_FrameCounter);
 
   bool HasCallstack = RenderDoc::Inst().GetCaptureOptions().CaptureCallstacks != 0;
   localSerialiser->Serialise("HasCallstack", HasCallstack);
@@ -1121,6 +1140,8 @@ void WrappedID3D12Device::StartFrameCapture(void *dev, void *wnd)
   if(m_State != WRITING_IDLE)
     return;
 
+  RDCTRACE_ZONE("WrappedID3D12Device::StartFrameCapture");
+
   RenderDoc::Inst().SetCurrentDriver(RDC_D3D12);
 
   m_AppControlledCapture = true;
@@ -1177,6 +1198,8 @@ bool WrappedID3D12Device::EndFrameCapture(void *dev, void *wnd)
   if(m_State != WRITING_CAPFRAME)
     return true;
 
+  RDCTRACE_ZONE("WrappedID3D12Device::EndFrameCapture");
+
   WrappedIDXGISwapChain4 *swap = NULL;
   SwapPresentInfo swapInfo = {};
 
@@ -1237,8 +1260,8 @@ bool WrappedID3D12Device::EndFrameCapture(void *dev, void *wnd)
 
   const uint32_t maxSize = 2048;
 
-  // gather backbuffer screenshot
-  if(backbuffer != NULL)
+  // gather backbuffer screenshot, flight recorder frames are kept in memory without one
+  if(backbuffer != NULL && !RenderDoc::Inst().IsFlightRecordingFrame())
   {
     D3D12_HEAP_PROPERTIES heapProps;
     heapProps.Type = D3D12_HEAP_TYPE_READBACK;
@@ -2081,18 +2104,12 @@ void WrappedID3D12Device::ReadLogInitialisation()
 
   int chunkIdx = 0;
 
-  struct chunkinfo
-  {
-    chunkinfo() : count(0), totalsize(0), total(0.0) {}
-    int count;
-    uint64_t totalsize;
-    double total;
-  };
-
-  map<D3D12ChunkType, chunkinfo> chunkInfos;
+  map<D3D12ChunkType, FetchChunkLoadStats> chunkInfos;
 
   SCOPED_TIMER("chunk initialisation");
 
+  PerformanceTimer loadTimer;
+
   for(;;)
   {
     PerformanceTimer timer;
@@ -2119,16 +2136,28 @@ void WrappedID3D12Device::ReadLogInitialisation()
     {
       frameOffset = offset;
 
+      PerformanceTimer applyTimer;
+
       GetResourceManager()->ApplyInitialContents();
 
+      m_FrameRecord.loadProfile.initialContentsApplyTime = applyTimer.GetMilliseconds();
+
       m_Queue->ReplayLog(READING, 0, 0, false);
     }
 
     uint64_t offset2 = m_pSerialiser->GetOffset();
 
-    chunkInfos[context].total += timer.GetMilliseconds();
-    chunkInfos[context].totalsize += offset2 - offset;
-    chunkInfos[context].count++;
+    FetchChunkLoadStats &stats = chunkInfos[context];
+
+    if(stats.count == 0)
+    {
+      stats.chunkID = uint32_t(context);
+      stats.name = GetChunkName(context);
+    }
+
+    stats.totalTime += timer.GetMilliseconds();
+    stats.totalSize += offset2 - offset;
+    stats.count++;
 
     if(context == CAPTURE_SCOPE)
       break;
@@ -2140,6 +2169,7 @@ void WrappedID3D12Device::ReadLogInitialisation()
   if(m_State == READING)
   {
     GetFrameRecord().drawcallList = m_Queue->GetParentDrawcall().Bake();
+    GetFrameRecord().frames = m_Queue->GetReadFrames();
 
     m_Queue->GetParentDrawcall().children.clear();
 
@@ -2164,18 +2194,25 @@ void WrappedID3D12Device::ReadLogInitialisation()
     double dcount = double(it->second.count);
 
     RDCDEBUG(
-        "% 5d chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
-        it->second.count, it->second.total, it->second.total / dcount,
-        double(it->second.totalsize) / (1024.0 * 1024.0),
-        double(it->second.totalsize) / (dcount * 1024.0 * 1024.0), GetChunkName(it->first),
-        uint32_t(it->first));
+        "% 5u chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
+        it->second.count, it->second.totalTime, it->second.totalTime / dcount,
+        double(it->second.totalSize) / (1024.0 * 1024.0),
+        double(it->second.totalSize) / (dcount * 1024.0 * 1024.0), it->second.name.c_str(),
+        it->second.chunkID);
   }
 #endif
 
   m_FrameRecord.frameInfo.uncompressedFileSize = m_pSerialiser->GetSize();
   m_FrameRecord.frameInfo.compressedFileSize = m_pSerialiser->GetFileSize();
   m_FrameRecord.frameInfo.persistentSize = m_pSerialiser->GetSize() - frameOffset;
-  m_FrameRecord.frameInfo.initDataSize = chunkInfos[(D3D12ChunkType)INITIAL_CONTENTS].totalsize;
+  m_FrameRecord.frameInfo.initDataSize = chunkInfos[(D3D12ChunkType)INITIAL_CONTENTS].totalSize;
+
+  m_FrameRecord.loadProfile.totalTime = loadTimer.GetMilliseconds();
+  m_FrameRecord.loadProfile.fileReadTime = m_pSerialiser->GetFileReadTime();
+  m_FrameRecord.loadProfile.decompressTime = m_pSerialiser->GetDecompressTime();
+  m_FrameRecord.loadProfile.initialContentsTime =
+      chunkInfos[(D3D12ChunkType)INITIAL_CONTENTS].totalTime;
+  FillLoadProfileChunks(m_FrameRecord.loadProfile, chunkInfos);
 
   RDCDEBUG("Allocating %llu persistant bytes of memory for the log.",
            m_pSerialiser->GetSize() - frameOffset);
@@ -2186,6 +2223,8 @@ void WrappedID3D12Device::ReadLogInitialisation()
 void WrappedID3D12Device::ReplayLog(uint32_t startEventID, uint32_t endEventID,
                                     ReplayLogType replayType)
 {
+  RDCTRACE_ZONE("WrappedID3D12Device::ReplayLog");
+
   uint64_t offs = m_FrameRecord.frameInfo.fileOffset;
 
   m_pSerialiser->SetOffset(offs);
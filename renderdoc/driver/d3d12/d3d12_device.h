@@ -45,7 +45,7 @@ struct D3D12InitParams : public RDCInitParams
 
   D3D_FEATURE_LEVEL MinimumFeatureLevel;
 
-  static const uint32_t D3D12_SERIALISE_VERSION = 0x0000001;
+  static const uint32_t D3D12_SERIALISE_VERSION = 0x0000002;
 
   // version number internal to d3d12 stream
   uint32_t SerialiseVersion;
@@ -585,14 +585,10 @@ void GLReplay::DeleteDebugData()
   MakeCurrentReplayContext(m_DebugCtx);
 
   for(auto it = m_PostVSData.begin(); it != m_PostVSData.end(); ++it)
-  {
-    gl.glDeleteBuffers(1, &it->second.vsout.buf);
-    gl.glDeleteBuffers(1, &it->second.vsout.idxBuf);
-    gl.glDeleteBuffers(1, &it->second.gsout.buf);
-    gl.glDeleteBuffers(1, &it->second.gsout.idxBuf);
-  }
+    FreePostVSBuffers(it->second);
 
   m_PostVSData.clear();
+  m_PostVSCache.Clear();
 
   if(DebugData.overlayFBO)
   {
@@ -2899,13 +2895,72 @@ ResourceId GLReplay::RenderOverlay(ResourceId texid, FormatComponentType typeHin
   return m_pDriver->GetResourceManager()->GetID(TextureRes(ctx, DebugData.overlayTex));
 }
 
+void GLReplay::FreePostVSBuffers(GLPostVSData &data)
+{
+  WrappedOpenGL &gl = *m_pDriver;
+
+  gl.glDeleteBuffers(1, &data.vsout.buf);
+  gl.glDeleteBuffers(1, &data.vsout.idxBuf);
+  gl.glDeleteBuffers(1, &data.gsout.buf);
+  gl.glDeleteBuffers(1, &data.gsout.idxBuf);
+}
+
 void GLReplay::InitPostVSBuffers(uint32_t eventID)
 {
   if(m_PostVSData.find(eventID) != m_PostVSData.end())
+  {
+    m_PostVSCache.Touch(eventID);
+    return;
+  }
+
+  GeneratePostVSBuffers(eventID);
+
+  auto it = m_PostVSData.find(eventID);
+  if(it == m_PostVSData.end())
     return;
 
   MakeCurrentReplayContext(&m_ReplayCtx);
 
+  WrappedOpenGL &gl = *m_pDriver;
+
+  GLuint bufs[] = {it->second.vsout.buf, it->second.vsout.idxBuf, it->second.gsout.buf,
+                   it->second.gsout.idxBuf};
+
+  uint64_t bytes = 0;
+  for(size_t i = 0; i < ARRAY_COUNT(bufs); i++)
+  {
+    if(bufs[i] == 0)
+      continue;
+
+    GLint size = 0;
+    gl.glGetNamedBufferParameterivEXT(bufs[i], eGL_BUFFER_SIZE, &size);
+    bytes += (uint64_t)size;
+  }
+
+  m_PostVSCache.Add(eventID, bytes);
+
+  TrimPostVSBuffers();
+}
+
+void GLReplay::TrimPostVSBuffers()
+{
+  // free the least recently used data if we've gone over budget
+  vector<uint32_t> evicted = m_PostVSCache.Trim();
+
+  if(!evicted.empty())
+    MakeCurrentReplayContext(&m_ReplayCtx);
+
+  for(size_t i = 0; i < evicted.size(); i++)
+  {
+    FreePostVSBuffers(m_PostVSData[evicted[i]]);
+    m_PostVSData.erase(evicted[i]);
+  }
+}
+
+void GLReplay::GeneratePostVSBuffers(uint32_t eventID)
+{
+  MakeCurrentReplayContext(&m_ReplayCtx);
+
   void *ctx = m_ReplayCtx.ctx;
 
   WrappedOpenGL &gl = *m_pDriver;
@@ -3923,26 +3978,49 @@ void GLReplay::InitPostVSBuffers(uint32_t eventID)
     gl.glEnable(eGL_RASTERIZER_DISCARD);
 }
 
+struct GLInitPostVSCallback : public GLDrawcallCallback
+{
+  GLInitPostVSCallback(GLReplay *r, const vector<uint32_t> &events)
+      : m_pReplay(r), m_Events(events.begin(), events.end())
+  {
+  }
+
+  void PreDraw(uint32_t eid)
+  {
+    if(m_Events.find(eid) != m_Events.end())
+      m_pReplay->InitPostVSBuffers(eid);
+  }
+
+  GLReplay *m_pReplay;
+  set<uint32_t> m_Events;
+};
+
 void GLReplay::InitPostVSBuffers(const vector<uint32_t> &passEvents)
 {
-  uint32_t prev = 0;
+  if(passEvents.empty())
+    return;
+
+  m_pDriver->ReplayLog(0, passEvents.front(), eReplay_WithoutDraw);
+
+  // don't free anything in the middle of the replay, and protect the pass's entries from being
+  // evicted by each other
+  m_PostVSCache.BeginDeferTrim(passEvents);
 
-  // since we can always replay between drawcalls, just loop through all the events
-  // doing partial replays and calling InitPostVSBuffers for each
-  for(size_t i = 0; i < passEvents.size(); i++)
+  // replay the whole pass once, generating the data for each drawcall just before it executes
+  // rather than doing a partial replay up to each one
   {
-    if(prev != passEvents[i])
-    {
-      m_pDriver->ReplayLog(prev, passEvents[i], eReplay_WithoutDraw);
+    GLInitPostVSCallback cb(this, passEvents);
 
-      prev = passEvents[i];
-    }
+    m_pDriver->SetDrawcallCB(&cb);
 
-    const FetchDrawcall *d = m_pDriver->GetDrawcall(passEvents[i]);
+    m_pDriver->ReplayLog(passEvents.front(), passEvents.back(), eReplay_Full);
 
-    if(d)
-      InitPostVSBuffers(passEvents[i]);
+    m_pDriver->SetDrawcallCB(NULL);
   }
+
+  m_PostVSCache.EndDeferTrim();
+
+  TrimPostVSBuffers();
 }
 
 MeshFormat GLReplay::GetPostVSBuffers(uint32_t eventID, uint32_t instID, MeshDataStage stage)
@@ -3951,7 +4029,10 @@ MeshFormat GLReplay::GetPostVSBuffers(uint32_t eventID, uint32_t instID, MeshDat
   RDCEraseEl(postvs);
 
   if(m_PostVSData.find(eventID) != m_PostVSData.end())
+  {
     postvs = m_PostVSData[eventID];
+    m_PostVSCache.Touch(eventID);
+  }
 
   GLPostVSData::StageData s = postvs.GetStage(stage);
 
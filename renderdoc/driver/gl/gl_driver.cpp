@@ -343,6 +343,8 @@ const uint32_t GLInitParams::GL_OLD_VERSIONS[GLInitParams::GL_NUM_SUPPORTED_OLD_
                  // anything special to support older logs, just make sure we don't open new logs
                  // in an older version.
     0x000012,    // Added support for GL-DX interop
+    0x000013,    // from 0x13 to 0x14, each frame's footer records its frame number. Older logs only
+                 // have one frame, so they use the capture's frame number instead.
 };
 
 ReplayCreateStatus GLInitParams::Serialise()
@@ -739,6 +741,8 @@ WrappedOpenGL::WrappedOpenGL(const char *logfile, const GLHookSet &funcs) : m_Re
   m_FirstEventID = 0;
   m_LastEventID = ~0U;
 
+  m_DrawcallCallback = NULL;
+
   RDCEraseEl(m_ActiveQueries);
   m_ActiveConditional = false;
   m_ActiveFeedback = false;
@@ -769,6 +773,7 @@ WrappedOpenGL::WrappedOpenGL(const char *logfile, const GLHookSet &funcs) : m_Re
   {
     m_State = WRITING_IDLE;
     m_pSerialiser = new Serialiser(NULL, Serialiser::WRITING, false);
+    m_pSerialiser->SetBlobStorage(true);
   }
 
   m_DeviceRecord = NULL;
@@ -996,6 +1001,9 @@ WrappedOpenGL::~WrappedOpenGL()
 
   SAFE_DELETE(m_pSerialiser);
 
+  for(auto it = m_ContextData.begin(); it != m_ContextData.end(); ++it)
+    SAFE_DELETE(it->second.m_BindingState);
+
   GetResourceManager()->ReleaseCurrentResource(m_DeviceResourceID);
   GetResourceManager()->ReleaseCurrentResource(m_ContextResourceID);
 
@@ -1029,6 +1037,59 @@ WrappedOpenGL::ContextData &WrappedOpenGL::GetCtxData()
   return m_ContextData[GetCtx()];
 }
 
+GLRenderState &WrappedOpenGL::GetBindingState()
+{
+  ContextData &cd = GetCtxData();
+
+  if(cd.m_BindingState == NULL)
+    cd.m_BindingState = new GLRenderState(&m_Real, NULL, m_State);
+
+  if(!cd.m_BindingStateValid)
+  {
+    cd.m_BindingState->FetchBindings(GetCtx(), this);
+    cd.m_BindingStateValid = true;
+  }
+
+  return *cd.m_BindingState;
+}
+
+GLRenderState &WrappedOpenGL::GetCurrentState()
+{
+  ContextData &cd = GetCtxData();
+
+  if(cd.m_BindingState == NULL)
+    cd.m_BindingState = new GLRenderState(&m_Real, NULL, m_State);
+
+  if(!cd.m_FullStateValid)
+  {
+    cd.m_BindingState->FetchState(GetCtx(), this);
+    cd.m_BindingStateValid = true;
+    cd.m_FullStateValid = true;
+    cd.m_VertexAttribsDirty = false;
+  }
+  else
+  {
+    if(!cd.m_BindingStateValid)
+    {
+      cd.m_BindingState->FetchBindings(GetCtx(), this);
+      cd.m_BindingStateValid = true;
+    }
+
+    if(cd.m_VertexAttribsDirty)
+    {
+      cd.m_BindingState->FetchVertexAttribs();
+      cd.m_VertexAttribsDirty = false;
+    }
+
+    // subroutine uniforms are reset by any program change, so they're never mirrored
+    cd.m_BindingState->FetchSubroutines();
+
+    ClearGLErrors(m_Real);
+  }
+
+  return *cd.m_BindingState;
+}
+
 // defined in gl_<platform>_hooks.cpp
 void MakeContextCurrent(GLWindowingData data);
 
@@ -1070,6 +1131,8 @@ void WrappedOpenGL::DeleteContext(void *contextHandle)
     }
   }
 
+  SAFE_DELETE(ctxdata.m_BindingState);
+
   m_ContextData.erase(contextHandle);
 }
 
@@ -2275,9 +2338,20 @@ void WrappedOpenGL::SwapBuffers(void *windowHandle)
   if(ctxdata.Legacy())
     return;
 
-  // kill any current capture that isn't application defined
+  // read back the full state while idle, rather than when a capture starts. From then on the
+  // wrappers keep it current.
+  if(m_State == WRITING_IDLE && !ctxdata.m_FullStateValid)
+    GetCurrentState();
+
+  // kill any current capture that isn't application defined, unless it spans more frames - then
+  // only record where this frame ended
   if(m_State == WRITING_CAPFRAME && !m_AppControlledCapture)
-    RenderDoc::Inst().EndFrameCapture(ctxdata.ctx, windowHandle);
+  {
+    if(RenderDoc::Inst().ContinueFrameCapture())
+      ContextEndFrame();
+    else
+      RenderDoc::Inst().EndFrameCapture(ctxdata.ctx, windowHandle);
+  }
 
   if(RenderDoc::Inst().ShouldTriggerCapture(m_FrameCounter) && m_State == WRITING_IDLE)
   {
@@ -2330,6 +2404,8 @@ void WrappedOpenGL::StartFrameCapture(void *dev, void *wnd)
   if(m_State != WRITING_IDLE)
     return;
 
+  RDCTRACE_ZONE("WrappedOpenGL::StartFrameCapture");
+
   RenderDoc::Inst().SetCurrentDriver(RDC_OpenGL);
 
   m_State = WRITING_CAPFRAME;
@@ -2386,6 +2462,8 @@ bool WrappedOpenGL::EndFrameCapture(void *dev, void *wnd)
   if(m_State != WRITING_CAPFRAME)
     return true;
 
+  RDCTRACE_ZONE("WrappedOpenGL::EndFrameCapture");
+
   CaptureFailReason reason = CaptureSucceeded;
 
   GLWindowingData prevctx = m_ActiveContexts[Threading::GetCurrentID()];
@@ -2579,8 +2657,9 @@ WrappedOpenGL::BackbufferImage *WrappedOpenGL::SaveBackbufferImage()
   uint32_t thwidth = 0;
   uint32_t thheight = 0;
 
-  if(m_Real.glGetIntegerv && m_Real.glReadBuffer && m_Real.glBindFramebuffer &&
-     m_Real.glBindBuffer && m_Real.glReadPixels)
+  // flight recorder frames are kept in memory without a thumbnail
+  if(!RenderDoc::Inst().IsFlightRecordingFrame() && m_Real.glGetIntegerv && m_Real.glReadBuffer &&
+     m_Real.glBindFramebuffer && m_Real.glBindBuffer && m_Real.glReadPixels)
   {
     RDCGLenum prevReadBuf = eGL_BACK;
     GLint prevBuf = 0;
@@ -2734,6 +2813,9 @@ void WrappedOpenGL::ContextEndFrame()
 {
   SCOPED_SERIALISE_CONTEXT(CONTEXT_CAPTURE_FOOTER);
 
+  uint32_t FrameNumber = m_FrameCounter;
+  m_pSerialiser->Serialise("FrameNumber", FrameNumber);
+
   bool HasCallstack = RenderDoc::Inst().GetCaptureOptions().CaptureCallstacks != 0;
   m_pSerialiser->Serialise("HasCallstack", HasCallstack);
 
@@ -2823,7 +2905,7 @@ bool WrappedOpenGL::Serialise_BeginCaptureFrame(bool applyInitialState)
 
   if(m_State >= WRITING)
   {
-    state.FetchState(GetCtx(), this);
+    state.CopyState(GetCurrentState());
 
     state.MarkReferenced(this, true);
   }
@@ -3046,18 +3128,12 @@ void WrappedOpenGL::ReadLogInitialisation()
 
   int chunkIdx = 0;
 
-  struct chunkinfo
-  {
-    chunkinfo() : count(0), totalsize(0), total(0.0) {}
-    int count;
-    uint64_t totalsize;
-    double total;
-  };
-
-  map<GLChunkType, chunkinfo> chunkInfos;
+  map<GLChunkType, FetchChunkLoadStats> chunkInfos;
 
   SCOPED_TIMER("chunk initialisation");
 
+  PerformanceTimer loadTimer;
+
   for(;;)
   {
     PerformanceTimer timer;
@@ -3084,16 +3160,28 @@ void WrappedOpenGL::ReadLogInitialisation()
     {
       frameOffset = offset;
 
+      PerformanceTimer applyTimer;
+
       GetResourceManager()->ApplyInitialContents();
 
+      m_FrameRecord.loadProfile.initialContentsApplyTime = applyTimer.GetMilliseconds();
+
       ContextReplayLog(READING, 0, 0, false);
     }
 
     uint64_t offset2 = m_pSerialiser->GetOffset();
 
-    chunkInfos[context].total += timer.GetMilliseconds();
-    chunkInfos[context].totalsize += offset2 - offset;
-    chunkInfos[context].count++;
+    FetchChunkLoadStats &stats = chunkInfos[context];
+
+    if(stats.count == 0)
+    {
+      stats.chunkID = uint32_t(context);
+      stats.name = GetChunkName(context);
+    }
+
+    stats.totalTime += timer.GetMilliseconds();
+    stats.totalSize += offset2 - offset;
+    stats.count++;
 
     if(context == CAPTURE_SCOPE)
       break;
@@ -3108,18 +3196,25 @@ void WrappedOpenGL::ReadLogInitialisation()
     double dcount = double(it->second.count);
 
     RDCDEBUG(
-        "% 5d chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
-        it->second.count, it->second.total, it->second.total / dcount,
-        double(it->second.totalsize) / (1024.0 * 1024.0),
-        double(it->second.totalsize) / (dcount * 1024.0 * 1024.0), GetChunkName(it->first),
-        uint32_t(it->first));
+        "% 5u chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
+        it->second.count, it->second.totalTime, it->second.totalTime / dcount,
+        double(it->second.totalSize) / (1024.0 * 1024.0),
+        double(it->second.totalSize) / (dcount * 1024.0 * 1024.0), it->second.name.c_str(),
+        it->second.chunkID);
   }
 #endif
 
   m_FrameRecord.frameInfo.uncompressedFileSize = m_pSerialiser->GetSize();
   m_FrameRecord.frameInfo.compressedFileSize = m_pSerialiser->GetFileSize();
   m_FrameRecord.frameInfo.persistentSize = m_pSerialiser->GetSize() - frameOffset;
-  m_FrameRecord.frameInfo.initDataSize = chunkInfos[(GLChunkType)INITIAL_CONTENTS].totalsize;
+  m_FrameRecord.frameInfo.initDataSize = chunkInfos[(GLChunkType)INITIAL_CONTENTS].totalSize;
+
+  m_FrameRecord.loadProfile.totalTime = loadTimer.GetMilliseconds();
+  m_FrameRecord.loadProfile.fileReadTime = m_pSerialiser->GetFileReadTime();
+  m_FrameRecord.loadProfile.decompressTime = m_pSerialiser->GetDecompressTime();
+  m_FrameRecord.loadProfile.initialContentsTime =
+      chunkInfos[(GLChunkType)INITIAL_CONTENTS].totalTime;
+  FillLoadProfileChunks(m_FrameRecord.loadProfile, chunkInfos);
 
   RDCDEBUG("Allocating %llu persistant bytes of memory for the log.",
            m_pSerialiser->GetSize() - frameOffset);
@@ -3533,6 +3628,10 @@ void WrappedOpenGL::ProcessChunk(uint64_t offset, GLChunkType context)
       break;
     case CONTEXT_CAPTURE_FOOTER:
     {
+      uint32_t FrameNumber = m_FrameRecord.frameInfo.frameNumber;
+      if(GetLogVersion() >= 0x000014)
+        m_pSerialiser->Serialise("FrameNumber", FrameNumber);
+
       bool HasCallstack = false;
       m_pSerialiser->Serialise("HasCallstack", HasCallstack);
 
@@ -3560,6 +3659,13 @@ void WrappedOpenGL::ProcessChunk(uint64_t offset, GLChunkType context)
             GetResourceManager()->GetID(TextureRes(GetCtx(), m_FakeBB_Color)));
 
         AddDrawcall(draw, true);
+
+        FetchCapturedFrame frame;
+        frame.frameNumber = FrameNumber;
+        frame.firstEvent = m_ReadFrames.empty() ? m_FrameRecord.frameInfo.firstEvent
+                                                : m_ReadFrames.back().lastEvent + 1;
+        frame.lastEvent = m_CurEventID;
+        m_ReadFrames.push_back(frame);
       }
     }
     break;
@@ -3638,6 +3744,7 @@ void WrappedOpenGL::ContextReplayLog(LogState readType, uint32_t startEventID, u
     m_CurDrawcallID = 1;
     m_FirstEventID = 0;
     m_LastEventID = ~0U;
+    m_ReadFrames.clear();
   }
 
   GetResourceManager()->MarkInFrame(true);
@@ -3656,14 +3763,22 @@ void WrappedOpenGL::ContextReplayLog(LogState readType, uint32_t startEventID, u
 
     GLChunkType chunktype = (GLChunkType)m_pSerialiser->PushContext(NULL, NULL, 1, false);
 
+    if(m_State == EXECUTING && m_DrawcallCallback)
+    {
+      const FetchDrawcall *draw = GetDrawcall(m_CurEventID);
+
+      if(draw && draw->eventID == m_CurEventID && (draw->flags & eDraw_Drawcall))
+        m_DrawcallCallback->PreDraw(m_CurEventID);
+    }
+
     ContextProcessChunk(offset, chunktype);
 
     RenderDoc::Inst().SetProgress(FrameEventsRead,
                                   float(offset - startOffset) / float(m_pSerialiser->GetSize()));
 
-    // for now just abort after capture scope. Really we'd need to support multiple frames
-    // but for now this will do.
-    if(chunktype == CONTEXT_CAPTURE_FOOTER)
+    // captures spanning several frames have a footer at the end of each frame, only the last
+    // one ends the capture
+    if(chunktype == CONTEXT_CAPTURE_FOOTER && m_pSerialiser->AtEnd())
       break;
 
     m_CurEventID++;
@@ -3673,6 +3788,7 @@ void WrappedOpenGL::ContextReplayLog(LogState readType, uint32_t startEventID, u
   {
     GetFrameRecord().drawcallList = m_ParentDrawcall.Bake();
     GetFrameRecord().frameInfo.debugMessages = GetDebugMessages();
+    GetFrameRecord().frames = m_ReadFrames;
 
     SetupDrawcallPointers(&m_Drawcalls, GetFrameRecord().drawcallList, NULL, NULL);
 
@@ -4105,6 +4221,8 @@ const FetchDrawcall *WrappedOpenGL::GetDrawcall(uint32_t eventID)
 
 void WrappedOpenGL::ReplayLog(uint32_t startEventID, uint32_t endEventID, ReplayLogType replayType)
 {
+  RDCTRACE_ZONE("WrappedOpenGL::ReplayLog");
+
   uint64_t offs = m_FrameRecord.frameInfo.fileOffset;
 
   m_pSerialiser->SetOffset(offs);
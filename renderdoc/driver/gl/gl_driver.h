@@ -53,10 +53,10 @@ struct GLInitParams : public RDCInitParams
   uint32_t width;
   uint32_t height;
 
-  static const uint32_t GL_SERIALISE_VERSION = 0x0000013;
+  static const uint32_t GL_SERIALISE_VERSION = 0x0000014;
 
   // backwards compatibility for old logs described at the declaration of this array
-  static const uint32_t GL_NUM_SUPPORTED_OLD_VERSIONS = 3;
+  static const uint32_t GL_NUM_SUPPORTED_OLD_VERSIONS = 4;
   static const uint32_t GL_OLD_VERSIONS[GL_NUM_SUPPORTED_OLD_VERSIONS];
 
   // version number internal to opengl stream
@@ -106,6 +106,15 @@ struct Replacement
   GLResource res;
 };
 
+struct GLDrawcallCallback
+{
+  // called while replaying, with the state set up for the drawcall at eid but before it has been
+  // executed. The callback must restore any state it changes.
+  virtual void PreDraw(uint32_t eid) = 0;
+
+  virtual ~GLDrawcallCallback() {}
+};
+
 class WrappedOpenGL : public IFrameCapturer
 {
 private:
@@ -204,6 +213,8 @@ private:
   vector<FetchFrameInfo> m_CapturedFrames;
   FetchFrameRecord m_FrameRecord;
   vector<FetchDrawcall *> m_Drawcalls;
+  // each frame's footer read so far, while reading the log
+  vector<FetchCapturedFrame> m_ReadFrames;
 
   // replay
 
@@ -215,6 +226,8 @@ private:
   uint32_t m_FirstEventID;
   uint32_t m_LastEventID;
 
+  GLDrawcallCallback *m_DrawcallCallback;
+
   DrawcallTreeNode m_ParentDrawcall;
 
   list<DrawcallTreeNode *> m_DrawcallStack;
@@ -370,6 +383,10 @@ private:
       m_Renderbuffer = ResourceId();
       m_TextureUnit = 0;
       m_ProgramPipeline = m_Program = 0;
+      m_BindingState = NULL;
+      m_BindingStateValid = false;
+      m_FullStateValid = false;
+      m_VertexAttribsDirty = false;
     }
 
     void *ctx;
@@ -422,11 +439,26 @@ private:
     GLuint m_Program;
 
     GLResourceRecord *GetActiveTexRecord() { return m_TextureRecord[m_TextureUnit]; }
+    // shadow of the context's state, kept current by the wrappers so that neither every draw
+    // nor the start of a capture has to read it all back from GL. The object bindings are
+    // fetched on their own by FetchBindings(), and anything the bind wrappers can't mirror
+    // exactly invalidates just those. The rest is fetched once by FetchState() and then mirrored
+    // by the state wrappers, except the generic vertex attribs which are only flagged dirty.
+    GLRenderState *m_BindingState;
+    bool m_BindingStateValid;
+    bool m_FullStateValid;
+    bool m_VertexAttribsDirty;
+
+    GLRenderState *GetTrackedBindings() { return m_BindingStateValid ? m_BindingState : NULL; }
+    GLRenderState *GetTrackedState() { return m_FullStateValid ? m_BindingState : NULL; }
   };
 
   map<void *, ContextData> m_ContextData;
 
   ContextData &GetCtxData();
+  GLRenderState &GetBindingState();
+  GLRenderState &GetCurrentState();
+  void TrackTextureUnitBinding(GLuint unit, GLuint texture);
   GLuint GetUniformProgram();
 
   void MakeValidContextCurrent(GLWindowingData &prevctx, void *favourWnd);
@@ -509,6 +541,8 @@ public:
   const DrawcallTreeNode &GetRootDraw() { return m_ParentDrawcall; }
   const FetchDrawcall *GetDrawcall(uint32_t eventID);
 
+  void SetDrawcallCB(GLDrawcallCallback *cb) { m_DrawcallCallback = cb; }
+
   void SuppressDebugMessages(bool suppress) { m_SuppressDebugMessages = suppress; }
   vector<EventUsage> GetUsage(ResourceId id) { return m_ResourceUses[id]; }
   void CreateContext(GLWindowingData winData, void *shareContext, GLInitParams initParams,
@@ -25,6 +25,7 @@
 
 #include <dlfcn.h>
 #include <stdio.h>
+#include <unordered_map>
 #include "common/threading.h"
 #include "driver/gl/gl_common.h"
 #include "driver/gl/gl_driver.h"
@@ -61,43 +62,40 @@ typedef const char *(*PFNGLXQUERYEXTENSIONSSTRINGPROC)(Display *dpy, int screen)
 void *libGLdlsymHandle =
     RTLD_NEXT;    // default to RTLD_NEXT, but overwritten if app calls dlopen() on real libGL
 
-#define HookInit(function)                                                   \
-  if(!strcmp(func, STRINGIZE(function)))                                     \
-  {                                                                          \
-    OpenGLHook::glhooks.GL.function = (CONCAT(function, _hooktype))realFunc; \
-    return (__GLXextFuncPtr)&CONCAT(function, _renderdoc_hooked);            \
-  }
+// glXGetProcAddress is called for every function the application loads, often once per context,
+// so instead of string comparing against the whole hookset on each call the hooks are registered
+// into hash tables once. Each entry records where to store the real function pointer and the hook
+// to hand back in its place.
+struct GLHookEntry
+{
+  GLHookEntry() : realSlot(NULL), hook(NULL) {}
+  GLHookEntry(void **slot, __GLXextFuncPtr h) : realSlot(slot), hook(h) {}
+  void **realSlot;
+  __GLXextFuncPtr hook;
+};
 
-#define HookExtension(funcPtrType, function)                      \
-  if(!strcmp(func, STRINGIZE(function)))                          \
-  {                                                               \
-    OpenGLHook::glhooks.GL.function = (funcPtrType)realFunc;      \
-    return (__GLXextFuncPtr)&CONCAT(function, _renderdoc_hooked); \
-  }
+typedef std::unordered_map<string, GLHookEntry> GLHookMap;
 
-#define HookExtensionAlias(funcPtrType, function, alias)          \
-  if(!strcmp(func, STRINGIZE(alias)))                             \
-  {                                                               \
-    OpenGLHook::glhooks.GL.function = (funcPtrType)realFunc;      \
-    return (__GLXextFuncPtr)&CONCAT(function, _renderdoc_hooked); \
-  }
+// insert() keeps the first registration of a name, matching the order the checks used to run in
+#define HookInit(function)                                                       \
+  hookMap.insert(std::make_pair(string(STRINGIZE(function)),                     \
+                                GLHookEntry((void **)&OpenGLHook::glhooks.GL.function, \
+                                            (__GLXextFuncPtr)&CONCAT(function, _renderdoc_hooked))));
 
-#if 0    // debug print for each unsupported function requested (but not used)
-#define HandleUnsupported(funcPtrType, function)                                           \
-  if(lowername == STRINGIZE(function))                                                     \
-  {                                                                                        \
-    CONCAT(unsupported_real_, function) = (CONCAT(function, _hooktype))realFunc;           \
-    RDCDEBUG("Requesting function pointer for unsupported function " STRINGIZE(function)); \
-    return (__GLXextFuncPtr)&CONCAT(function, _renderdoc_hooked);                          \
-  }
-#else
-#define HandleUnsupported(funcPtrType, function)                                 \
-  if(lowername == STRINGIZE(function))                                           \
-  {                                                                              \
-    CONCAT(unsupported_real_, function) = (CONCAT(function, _hooktype))realFunc; \
-    return (__GLXextFuncPtr)&CONCAT(function, _renderdoc_hooked);                \
-  }
-#endif
+#define HookExtension(funcPtrType, function) HookInit(function)
+
+#define HookExtensionAlias(funcPtrType, function, alias)                         \
+  hookMap.insert(std::make_pair(string(STRINGIZE(alias)),                        \
+                                GLHookEntry((void **)&OpenGLHook::glhooks.GL.function, \
+                                            (__GLXextFuncPtr)&CONCAT(function, _renderdoc_hooked))));
+
+// at the moment the unsupported functions are all lowercase (as their name is generated from the
+// typedef name), so they're kept separately and looked up by lowercase name.
+#define HandleUnsupported(funcPtrType, function)                                \
+  unsupportedMap.insert(                                                        \
+      std::make_pair(string(STRINGIZE(function)),                               \
+                     GLHookEntry((void **)&CONCAT(unsupported_real_, function), \
+                                 (__GLXextFuncPtr)&CONCAT(function, _renderdoc_hooked))));
 
 /*
   in bash:
@@ -394,6 +392,8 @@ public:
   {
     LibraryHooks::GetInstance().RegisterHook("libGL.so", this);
 
+    glLock.SetName("glLock");
+
     RDCEraseEl(GL);
 
     m_HasHooks = false;
@@ -1133,6 +1133,49 @@ bool OpenGLHook::SetupHooks(GLHookSet &GL)
   return success;
 }
 
+static GLHookMap BuildHookMap()
+{
+  SCOPED_TIMER("Building GL hook lookup table");
+
+  GLHookMap hookMap;
+
+  DLLExportHooks();
+  HookCheckGLExtensions();
+
+  return hookMap;
+}
+
+static GLHookMap BuildUnsupportedMap()
+{
+  GLHookMap unsupportedMap;
+
+  CheckUnsupported();
+
+  return unsupportedMap;
+}
+
+static const GLHookEntry *LookupHook(const char *func)
+{
+  // function-local statics are initialised thread-safely on first use
+  static const GLHookMap hookMap = BuildHookMap();
+  static const GLHookMap unsupportedMap = BuildUnsupportedMap();
+
+  auto it = hookMap.find(func);
+  if(it != hookMap.end())
+    return &it->second;
+
+  it = unsupportedMap.find(strlower(string(func)));
+  if(it != unsupportedMap.end())
+  {
+#if 0    // debug print for each unsupported function requested (but not used)
+    RDCDEBUG("Requesting function pointer for unsupported function %s", func);
+#endif
+    return &it->second;
+  }
+
+  return NULL;
+}
+
 __attribute__((visibility("default"))) __GLXextFuncPtr glXGetProcAddress(const GLubyte *f)
 {
   if(OpenGLHook::glhooks.glXGetProcAddress_real == NULL)
@@ -1179,14 +1222,13 @@ __attribute__((visibility("default"))) __GLXextFuncPtr glXGetProcAddress(const G
   if(realFunc == NULL)
     return realFunc;
 
-  DLLExportHooks();
-  HookCheckGLExtensions();
-
-  // at the moment the unsupported functions are all lowercase (as their name is generated from the
-  // typedef name).
-  string lowername = strlower(string(func));
+  const GLHookEntry *entry = LookupHook(func);
 
-  CheckUnsupported();
+  if(entry)
+  {
+    *entry->realSlot = (void *)realFunc;
+    return entry->hook;
+  }
 
   // for any other function, if it's not a core or extension function we know about,
   // just return NULL
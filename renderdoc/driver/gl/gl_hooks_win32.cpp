@@ -316,6 +316,8 @@ public:
   {
     LibraryHooks::GetInstance().RegisterHook(DLL_NAME, this);
 
+    glLock.SetName("glLock");
+
     m_GLDriver = NULL;
 
     m_HasHooks = false;
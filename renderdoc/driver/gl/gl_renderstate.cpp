@@ -64,6 +64,25 @@ void PixelUnpackState::Apply(const GLHookSet *funcs, bool compressed)
   }
 }
 
+void PixelUnpackState::Store(GLenum pname, GLint param)
+{
+  switch(pname)
+  {
+    case eGL_UNPACK_SWAP_BYTES: swapBytes = param; break;
+    case eGL_UNPACK_ROW_LENGTH: rowlength = param; break;
+    case eGL_UNPACK_IMAGE_HEIGHT: imageheight = param; break;
+    case eGL_UNPACK_SKIP_PIXELS: skipPixels = param; break;
+    case eGL_UNPACK_SKIP_ROWS: skipRows = param; break;
+    case eGL_UNPACK_SKIP_IMAGES: skipImages = param; break;
+    case eGL_UNPACK_ALIGNMENT: alignment = param; break;
+    case eGL_UNPACK_COMPRESSED_BLOCK_WIDTH: compressedBlockWidth = param; break;
+    case eGL_UNPACK_COMPRESSED_BLOCK_HEIGHT: compressedBlockHeight = param; break;
+    case eGL_UNPACK_COMPRESSED_BLOCK_DEPTH: compressedBlockDepth = param; break;
+    case eGL_UNPACK_COMPRESSED_BLOCK_SIZE: compressedBlockSize = param; break;
+    default: break;
+  }
+}
+
 bool PixelUnpackState::FastPath(GLsizei width, GLsizei height, GLsizei depth, GLenum dataformat,
                                 GLenum basetype)
 {
@@ -292,6 +311,60 @@ byte *PixelUnpackState::UnpackCompressed(byte *pixels, GLsizei width, GLsizei he
   return ret;
 }
 
+// indexed by GLRenderState::eEnabled_*
+static const GLenum EnabledPNames[] = {
+    eGL_CLIP_DISTANCE0,
+    eGL_CLIP_DISTANCE1,
+    eGL_CLIP_DISTANCE2,
+    eGL_CLIP_DISTANCE3,
+    eGL_CLIP_DISTANCE4,
+    eGL_CLIP_DISTANCE5,
+    eGL_CLIP_DISTANCE6,
+    eGL_CLIP_DISTANCE7,
+    eGL_COLOR_LOGIC_OP,
+    eGL_CULL_FACE,
+    eGL_DEPTH_CLAMP,
+    eGL_DEPTH_TEST,
+    eGL_DEPTH_BOUNDS_TEST_EXT,
+    eGL_DITHER,
+    eGL_FRAMEBUFFER_SRGB,
+    eGL_LINE_SMOOTH,
+    eGL_MULTISAMPLE,
+    eGL_POLYGON_SMOOTH,
+    eGL_POLYGON_OFFSET_FILL,
+    eGL_POLYGON_OFFSET_LINE,
+    eGL_POLYGON_OFFSET_POINT,
+    eGL_PROGRAM_POINT_SIZE,
+    eGL_PRIMITIVE_RESTART,
+    eGL_PRIMITIVE_RESTART_FIXED_INDEX,
+    eGL_SAMPLE_ALPHA_TO_COVERAGE,
+    eGL_SAMPLE_ALPHA_TO_ONE,
+    eGL_SAMPLE_COVERAGE,
+    eGL_SAMPLE_MASK,
+    eGL_SAMPLE_SHADING,
+    eGL_RASTER_MULTISAMPLE_EXT,
+    eGL_STENCIL_TEST,
+    eGL_TEXTURE_CUBE_MAP_SEAMLESS,
+    eGL_BLEND_ADVANCED_COHERENT_KHR,
+    eGL_RASTERIZER_DISCARD,
+};
+
+RDCCOMPILE_ASSERT(ARRAY_COUNT(EnabledPNames) == GLRenderState::eEnabled_Count,
+                  "Wrong number of pnames");
+
+// some caps come from extensions, and can't be queried or set without them
+static bool EnabledPNameSupported(GLenum pname)
+{
+  if(pname == eGL_BLEND_ADVANCED_COHERENT_KHR)
+    return ExtensionSupported[ExtensionSupported_KHR_blend_equation_advanced_coherent];
+  if(pname == eGL_RASTER_MULTISAMPLE_EXT)
+    return ExtensionSupported[ExtensionSupported_EXT_raster_multisample];
+  if(pname == eGL_DEPTH_BOUNDS_TEST_EXT)
+    return ExtensionSupported[ExtensionSupported_EXT_depth_bounds_test];
+
+  return true;
+}
+
 GLRenderState::GLRenderState(const GLHookSet *funcs, Serialiser *ser, LogState state)
     : m_Real(funcs), m_pSerialiser(ser), m_State(state)
 {
@@ -396,57 +469,30 @@ void GLRenderState::MarkDirty(WrappedOpenGL *gl)
 
   void *ctx = gl->GetCtx();
 
-  GLint maxCount = 0;
-  m_Real->glGetIntegerv(eGL_MAX_IMAGE_UNITS, &maxCount);
-
-  GLuint name = 0;
-
-  for(GLint i = 0; i < maxCount; i++)
-  {
-    name = 0;
-
-    m_Real->glGetIntegeri_v(eGL_IMAGE_BINDING_NAME, i, (GLint *)&name);
-
-    if(name)
-      manager->MarkDirtyResource(TextureRes(ctx, name));
-  }
-
-  m_Real->glGetIntegerv(eGL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS, &maxCount);
-
-  for(GLint i = 0; i < maxCount; i++)
-  {
-    m_Real->glGetIntegeri_v(eGL_TRANSFORM_FEEDBACK_BUFFER_BINDING, i, (GLint *)&name);
-
-    if(name)
-      manager->MarkDirtyResource(BufferRes(ctx, name));
-  }
-
-  m_Real->glGetIntegerv(eGL_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS, &maxCount);
+  // the bindings are expected to have been fetched already, see FetchBindings(). Only the
+  // framebuffer attachments are queried here.
+  for(size_t i = 0; i < ARRAY_COUNT(Images); i++)
+    if(Images[i].name)
+      manager->MarkDirtyResource(TextureRes(ctx, Images[i].name));
 
-  for(GLint i = 0; i < maxCount; i++)
-  {
-    m_Real->glGetIntegeri_v(eGL_ATOMIC_COUNTER_BUFFER_BINDING, i, (GLint *)&name);
+  for(size_t i = 0; i < ARRAY_COUNT(TransformFeedback); i++)
+    if(TransformFeedback[i].name)
+      manager->MarkDirtyResource(BufferRes(ctx, TransformFeedback[i].name));
 
-    if(name)
-      manager->MarkDirtyResource(BufferRes(ctx, name));
-  }
+  for(size_t i = 0; i < ARRAY_COUNT(AtomicCounter); i++)
+    if(AtomicCounter[i].name)
+      manager->MarkDirtyResource(BufferRes(ctx, AtomicCounter[i].name));
 
-  m_Real->glGetIntegerv(eGL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, &maxCount);
+  for(size_t i = 0; i < ARRAY_COUNT(ShaderStorage); i++)
+    if(ShaderStorage[i].name)
+      manager->MarkDirtyResource(BufferRes(ctx, ShaderStorage[i].name));
 
-  for(GLint i = 0; i < maxCount; i++)
+  if(DrawFBO)
   {
-    m_Real->glGetIntegeri_v(eGL_SHADER_STORAGE_BUFFER_BINDING, i, (GLint *)&name);
-
-    if(name)
-      manager->MarkDirtyResource(BufferRes(ctx, name));
-  }
-
-  m_Real->glGetIntegerv(eGL_MAX_COLOR_ATTACHMENTS, &maxCount);
-
-  m_Real->glGetIntegerv(eGL_DRAW_FRAMEBUFFER_BINDING, (GLint *)&name);
+    GLint maxCount = 0;
+    m_Real->glGetIntegerv(eGL_MAX_COLOR_ATTACHMENTS, &maxCount);
 
-  if(name)
-  {
+    GLuint name = 0;
     GLenum type = eGL_TEXTURE;
     for(GLint i = 0; i < maxCount; i++)
     {
@@ -498,85 +544,14 @@ void GLRenderState::MarkDirty(WrappedOpenGL *gl)
   }
 }
 
-void GLRenderState::FetchState(void *ctx, WrappedOpenGL *gl)
+void GLRenderState::FetchBindings(void *ctx, WrappedOpenGL *gl)
 {
-  GLint boolread = 0;
-  // TODO check GL_MAX_*
-  // TODO check the extensions/core version for these is around
-
   if(ctx == NULL)
   {
     ContextPresent = false;
     return;
   }
 
-  {
-    GLenum pnames[] = {
-        eGL_CLIP_DISTANCE0,
-        eGL_CLIP_DISTANCE1,
-        eGL_CLIP_DISTANCE2,
-        eGL_CLIP_DISTANCE3,
-        eGL_CLIP_DISTANCE4,
-        eGL_CLIP_DISTANCE5,
-        eGL_CLIP_DISTANCE6,
-        eGL_CLIP_DISTANCE7,
-        eGL_COLOR_LOGIC_OP,
-        eGL_CULL_FACE,
-        eGL_DEPTH_CLAMP,
-        eGL_DEPTH_TEST,
-        eGL_DEPTH_BOUNDS_TEST_EXT,
-        eGL_DITHER,
-        eGL_FRAMEBUFFER_SRGB,
-        eGL_LINE_SMOOTH,
-        eGL_MULTISAMPLE,
-        eGL_POLYGON_SMOOTH,
-        eGL_POLYGON_OFFSET_FILL,
-        eGL_POLYGON_OFFSET_LINE,
-        eGL_POLYGON_OFFSET_POINT,
-        eGL_PROGRAM_POINT_SIZE,
-        eGL_PRIMITIVE_RESTART,
-        eGL_PRIMITIVE_RESTART_FIXED_INDEX,
-        eGL_SAMPLE_ALPHA_TO_COVERAGE,
-        eGL_SAMPLE_ALPHA_TO_ONE,
-        eGL_SAMPLE_COVERAGE,
-        eGL_SAMPLE_MASK,
-        eGL_SAMPLE_SHADING,
-        eGL_RASTER_MULTISAMPLE_EXT,
-        eGL_STENCIL_TEST,
-        eGL_TEXTURE_CUBE_MAP_SEAMLESS,
-        eGL_BLEND_ADVANCED_COHERENT_KHR,
-        eGL_RASTERIZER_DISCARD,
-    };
-
-    RDCCOMPILE_ASSERT(ARRAY_COUNT(pnames) == eEnabled_Count, "Wrong number of pnames");
-
-    for(GLuint i = 0; i < eEnabled_Count; i++)
-    {
-      if(pnames[i] == eGL_BLEND_ADVANCED_COHERENT_KHR &&
-         !ExtensionSupported[ExtensionSupported_KHR_blend_equation_advanced_coherent])
-      {
-        Enabled[i] = true;
-        continue;
-      }
-
-      if(pnames[i] == eGL_RASTER_MULTISAMPLE_EXT &&
-         !ExtensionSupported[ExtensionSupported_EXT_raster_multisample])
-      {
-        Enabled[i] = false;
-        continue;
-      }
-
-      if(pnames[i] == eGL_DEPTH_BOUNDS_TEST_EXT &&
-         !ExtensionSupported[ExtensionSupported_EXT_depth_bounds_test])
-      {
-        Enabled[i] = false;
-        continue;
-      }
-
-      Enabled[i] = (m_Real->glIsEnabled(pnames[i]) == GL_TRUE);
-    }
-  }
-
   m_Real->glGetIntegerv(eGL_ACTIVE_TEXTURE, (GLint *)&ActiveTexture);
 
   RDCCOMPILE_ASSERT(
@@ -624,64 +599,9 @@ void GLRenderState::FetchState(void *ctx, WrappedOpenGL *gl)
   m_Real->glGetIntegerv(eGL_VERTEX_ARRAY_BINDING, (GLint *)&VAO);
   m_Real->glGetIntegerv(eGL_TRANSFORM_FEEDBACK_BINDING, (GLint *)&FeedbackObj);
 
-  // the spec says that you can only query for the format that was previously set, or you get
-  // undefined results. Ie. if someone set ints, this might return anything. However there's also
-  // no way to query for the type so we just have to hope for the best and hope most people are
-  // sane and don't use these except for a default "all 0s" attrib.
-
-  GLuint maxNumAttribs = 0;
-  m_Real->glGetIntegerv(eGL_MAX_VERTEX_ATTRIBS, (GLint *)&maxNumAttribs);
-  for(GLuint i = 0; i < RDCMIN(maxNumAttribs, (GLuint)ARRAY_COUNT(GenericVertexAttribs)); i++)
-    m_Real->glGetVertexAttribfv(i, eGL_CURRENT_VERTEX_ATTRIB, &GenericVertexAttribs[i].x);
-
-  m_Real->glGetFloatv(eGL_POINT_FADE_THRESHOLD_SIZE, &PointFadeThresholdSize);
-  m_Real->glGetIntegerv(eGL_POINT_SPRITE_COORD_ORIGIN, (GLint *)&PointSpriteOrigin);
-  m_Real->glGetFloatv(eGL_LINE_WIDTH, &LineWidth);
-  m_Real->glGetFloatv(eGL_POINT_SIZE, &PointSize);
-
-  m_Real->glGetIntegerv(eGL_PRIMITIVE_RESTART_INDEX, (GLint *)&PrimitiveRestartIndex);
-  if(GLCoreVersion >= 45 || ExtensionSupported[ExtensionSupported_ARB_clip_control])
-  {
-    m_Real->glGetIntegerv(eGL_CLIP_ORIGIN, (GLint *)&ClipOrigin);
-    m_Real->glGetIntegerv(eGL_CLIP_DEPTH_MODE, (GLint *)&ClipDepth);
-  }
-  else
-  {
-    ClipOrigin = eGL_LOWER_LEFT;
-    ClipDepth = eGL_NEGATIVE_ONE_TO_ONE;
-  }
-  m_Real->glGetIntegerv(eGL_PROVOKING_VERTEX, (GLint *)&ProvokingVertex);
-
   m_Real->glGetIntegerv(eGL_CURRENT_PROGRAM, (GLint *)&Program);
   m_Real->glGetIntegerv(eGL_PROGRAM_PIPELINE_BINDING, (GLint *)&Pipeline);
 
-  const GLenum shs[] = {
-      eGL_VERTEX_SHADER,   eGL_TESS_CONTROL_SHADER, eGL_TESS_EVALUATION_SHADER,
-      eGL_GEOMETRY_SHADER, eGL_FRAGMENT_SHADER,     eGL_COMPUTE_SHADER,
-  };
-
-  RDCCOMPILE_ASSERT(ARRAY_COUNT(shs) == ARRAY_COUNT(Subroutines),
-                    "Subroutine array not the right size");
-  for(size_t s = 0; s < ARRAY_COUNT(shs); s++)
-  {
-    GLuint prog = Program;
-    if(prog == 0 && Pipeline != 0)
-    {
-      // can't query for GL_COMPUTE_SHADER on some AMD cards
-      if(shs[s] != eGL_COMPUTE_SHADER || !VendorCheck[VendorCheck_AMD_pipeline_compute_query])
-        m_Real->glGetProgramPipelineiv(Pipeline, shs[s], (GLint *)&prog);
-    }
-
-    if(prog == 0)
-      continue;
-
-    m_Real->glGetProgramStageiv(prog, shs[s], eGL_ACTIVE_SUBROUTINE_UNIFORM_LOCATIONS,
-                                &Subroutines[s].numSubroutines);
-
-    for(GLint i = 0; i < Subroutines[s].numSubroutines; i++)
-      m_Real->glGetUniformSubroutineuiv(shs[s], i, &Subroutines[s].Values[0]);
-  }
-
   m_Real->glGetIntegerv(eGL_ARRAY_BUFFER_BINDING, (GLint *)&BufferBindings[eBufIdx_Array]);
   m_Real->glGetIntegerv(eGL_COPY_READ_BUFFER_BINDING, (GLint *)&BufferBindings[eBufIdx_Copy_Read]);
   m_Real->glGetIntegerv(eGL_COPY_WRITE_BUFFER_BINDING, (GLint *)&BufferBindings[eBufIdx_Copy_Write]);
@@ -740,6 +660,478 @@ void GLRenderState::FetchState(void *ctx, WrappedOpenGL *gl)
     }
   }
 
+  m_Real->glGetIntegerv(eGL_DRAW_FRAMEBUFFER_BINDING, (GLint *)&DrawFBO);
+  m_Real->glGetIntegerv(eGL_READ_FRAMEBUFFER_BINDING, (GLint *)&ReadFBO);
+
+  ClearGLErrors(*m_Real);
+}
+
+void GLRenderState::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+  if(unit >= (GLuint)ARRAY_COUNT(Tex2D))
+    return;
+
+  switch(target)
+  {
+    case eGL_TEXTURE_1D: Tex1D[unit] = texture; break;
+    case eGL_TEXTURE_2D: Tex2D[unit] = texture; break;
+    case eGL_TEXTURE_3D: Tex3D[unit] = texture; break;
+    case eGL_TEXTURE_1D_ARRAY: Tex1DArray[unit] = texture; break;
+    case eGL_TEXTURE_2D_ARRAY: Tex2DArray[unit] = texture; break;
+    case eGL_TEXTURE_CUBE_MAP_ARRAY: TexCubeArray[unit] = texture; break;
+    case eGL_TEXTURE_RECTANGLE: TexRect[unit] = texture; break;
+    case eGL_TEXTURE_BUFFER: TexBuffer[unit] = texture; break;
+    case eGL_TEXTURE_CUBE_MAP: TexCube[unit] = texture; break;
+    case eGL_TEXTURE_2D_MULTISAMPLE: Tex2DMS[unit] = texture; break;
+    case eGL_TEXTURE_2D_MULTISAMPLE_ARRAY: Tex2DMSArray[unit] = texture; break;
+    default: break;
+  }
+}
+
+void GLRenderState::BindBuffer(GLenum target, GLuint buffer)
+{
+  switch(target)
+  {
+    case eGL_ARRAY_BUFFER: BufferBindings[eBufIdx_Array] = buffer; break;
+    case eGL_COPY_READ_BUFFER: BufferBindings[eBufIdx_Copy_Read] = buffer; break;
+    case eGL_COPY_WRITE_BUFFER: BufferBindings[eBufIdx_Copy_Write] = buffer; break;
+    case eGL_DRAW_INDIRECT_BUFFER: BufferBindings[eBufIdx_Draw_Indirect] = buffer; break;
+    case eGL_DISPATCH_INDIRECT_BUFFER: BufferBindings[eBufIdx_Dispatch_Indirect] = buffer; break;
+    case eGL_PIXEL_PACK_BUFFER: BufferBindings[eBufIdx_Pixel_Pack] = buffer; break;
+    case eGL_PIXEL_UNPACK_BUFFER: BufferBindings[eBufIdx_Pixel_Unpack] = buffer; break;
+    case eGL_QUERY_BUFFER: BufferBindings[eBufIdx_Query] = buffer; break;
+    case eGL_TEXTURE_BUFFER: BufferBindings[eBufIdx_Texture] = buffer; break;
+    case eGL_PARAMETER_BUFFER_ARB: BufferBindings[eBufIdx_Parameter] = buffer; break;
+    default: break;
+  }
+}
+
+void GLRenderState::BindIndexedBuffer(GLenum target, GLuint index, GLuint buffer, uint64_t start,
+                                      uint64_t size)
+{
+  IdxRangeBuffer *bufs = NULL;
+  GLuint count = 0;
+
+  switch(target)
+  {
+    case eGL_ATOMIC_COUNTER_BUFFER:
+      bufs = AtomicCounter;
+      count = ARRAY_COUNT(AtomicCounter);
+      break;
+    case eGL_SHADER_STORAGE_BUFFER:
+      bufs = ShaderStorage;
+      count = ARRAY_COUNT(ShaderStorage);
+      break;
+    case eGL_TRANSFORM_FEEDBACK_BUFFER:
+      bufs = TransformFeedback;
+      count = ARRAY_COUNT(TransformFeedback);
+      break;
+    case eGL_UNIFORM_BUFFER:
+      bufs = UniformBinding;
+      count = ARRAY_COUNT(UniformBinding);
+      break;
+    default: break;
+  }
+
+  if(bufs && index < count)
+  {
+    bufs[index].name = buffer;
+    bufs[index].start = start;
+    bufs[index].size = size;
+  }
+}
+
+void GLRenderState::UnbindTextureUnit(GLuint unit)
+{
+  if(unit >= (GLuint)ARRAY_COUNT(Tex2D))
+    return;
+
+  Tex1D[unit] = Tex2D[unit] = Tex3D[unit] = 0;
+  Tex1DArray[unit] = Tex2DArray[unit] = TexCubeArray[unit] = 0;
+  TexRect[unit] = TexBuffer[unit] = TexCube[unit] = 0;
+  Tex2DMS[unit] = Tex2DMSArray[unit] = 0;
+}
+
+void GLRenderState::FetchFeedbackBindings()
+{
+  GLint maxCount = 0;
+  m_Real->glGetIntegerv(eGL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS, &maxCount);
+  for(GLint i = 0; i < (GLint)ARRAY_COUNT(TransformFeedback) && i < maxCount; i++)
+  {
+    m_Real->glGetIntegeri_v(eGL_TRANSFORM_FEEDBACK_BUFFER_BINDING, i,
+                            (GLint *)&TransformFeedback[i].name);
+    m_Real->glGetInteger64i_v(eGL_TRANSFORM_FEEDBACK_BUFFER_START, i,
+                              (GLint64 *)&TransformFeedback[i].start);
+    m_Real->glGetInteger64i_v(eGL_TRANSFORM_FEEDBACK_BUFFER_SIZE, i,
+                              (GLint64 *)&TransformFeedback[i].size);
+  }
+}
+
+void GLRenderState::DeleteTextures(GLsizei n, const GLuint *textures)
+{
+  uint32_t *texs[] = {
+      Tex1D,   Tex2D,     Tex3D,   Tex1DArray, Tex2DArray,   TexCubeArray,
+      TexRect, TexBuffer, TexCube, Tex2DMS,    Tex2DMSArray,
+  };
+
+  for(GLsizei d = 0; textures && d < n; d++)
+  {
+    if(textures[d] == 0)
+      continue;
+
+    for(size_t t = 0; t < ARRAY_COUNT(texs); t++)
+      for(size_t i = 0; i < ARRAY_COUNT(Tex2D); i++)
+        if(texs[t][i] == textures[d])
+          texs[t][i] = 0;
+
+    for(size_t i = 0; i < ARRAY_COUNT(Images); i++)
+      if(Images[i].name == textures[d])
+        Images[i].name = 0;
+  }
+}
+
+void GLRenderState::DeleteBuffers(GLsizei n, const GLuint *buffers)
+{
+  struct
+  {
+    IdxRangeBuffer *bufs;
+    size_t count;
+  } idxBufs[] = {
+      {AtomicCounter, ARRAY_COUNT(AtomicCounter)},
+      {ShaderStorage, ARRAY_COUNT(ShaderStorage)},
+      {TransformFeedback, ARRAY_COUNT(TransformFeedback)},
+      {UniformBinding, ARRAY_COUNT(UniformBinding)},
+  };
+
+  for(GLsizei d = 0; buffers && d < n; d++)
+  {
+    if(buffers[d] == 0)
+      continue;
+
+    for(size_t i = 0; i < ARRAY_COUNT(BufferBindings); i++)
+      if(BufferBindings[i] == buffers[d])
+        BufferBindings[i] = 0;
+
+    for(size_t b = 0; b < ARRAY_COUNT(idxBufs); b++)
+    {
+      for(size_t i = 0; i < idxBufs[b].count; i++)
+      {
+        if(idxBufs[b].bufs[i].name == buffers[d])
+        {
+          idxBufs[b].bufs[i].name = 0;
+          idxBufs[b].bufs[i].start = 0;
+          idxBufs[b].bufs[i].size = 0;
+        }
+      }
+    }
+  }
+}
+
+void GLRenderState::DeleteSamplers(GLsizei n, const GLuint *samplers)
+{
+  for(GLsizei d = 0; samplers && d < n; d++)
+    for(size_t i = 0; i < ARRAY_COUNT(Samplers); i++)
+      if(samplers[d] != 0 && Samplers[i] == samplers[d])
+        Samplers[i] = 0;
+}
+
+void GLRenderState::CopyState(const GLRenderState &other)
+{
+  Serialiser *ser = m_pSerialiser;
+  LogState state = m_State;
+  const GLHookSet *funcs = m_Real;
+
+  *this = other;
+
+  m_pSerialiser = ser;
+  m_State = state;
+  m_Real = funcs;
+}
+
+void GLRenderState::FetchVertexAttribs()
+{
+  // the spec says that you can only query for the format that was previously set, or you get
+  // undefined results. Ie. if someone set ints, this might return anything. However there's also
+  // no way to query for the type so we just have to hope for the best and hope most people are
+  // sane and don't use these except for a default "all 0s" attrib.
+
+  GLuint maxNumAttribs = 0;
+  m_Real->glGetIntegerv(eGL_MAX_VERTEX_ATTRIBS, (GLint *)&maxNumAttribs);
+  for(GLuint i = 0; i < RDCMIN(maxNumAttribs, (GLuint)ARRAY_COUNT(GenericVertexAttribs)); i++)
+    m_Real->glGetVertexAttribfv(i, eGL_CURRENT_VERTEX_ATTRIB, &GenericVertexAttribs[i].x);
+}
+
+void GLRenderState::FetchSubroutines()
+{
+  const GLenum shs[] = {
+      eGL_VERTEX_SHADER,   eGL_TESS_CONTROL_SHADER, eGL_TESS_EVALUATION_SHADER,
+      eGL_GEOMETRY_SHADER, eGL_FRAGMENT_SHADER,     eGL_COMPUTE_SHADER,
+  };
+
+  RDCCOMPILE_ASSERT(ARRAY_COUNT(shs) == ARRAY_COUNT(Subroutines),
+                    "Subroutine array not the right size");
+  for(size_t s = 0; s < ARRAY_COUNT(shs); s++)
+  {
+    // this state may be re-fetched, so don't leave a previous program's values behind
+    Subroutines[s].numSubroutines = 0;
+
+    GLuint prog = Program;
+    if(prog == 0 && Pipeline != 0)
+    {
+      // can't query for GL_COMPUTE_SHADER on some AMD cards
+      if(shs[s] != eGL_COMPUTE_SHADER || !VendorCheck[VendorCheck_AMD_pipeline_compute_query])
+        m_Real->glGetProgramPipelineiv(Pipeline, shs[s], (GLint *)&prog);
+    }
+
+    if(prog == 0)
+      continue;
+
+    m_Real->glGetProgramStageiv(prog, shs[s], eGL_ACTIVE_SUBROUTINE_UNIFORM_LOCATIONS,
+                                &Subroutines[s].numSubroutines);
+
+    Subroutines[s].numSubroutines =
+        RDCMIN(Subroutines[s].numSubroutines, (GLint)ARRAY_COUNT(Subroutines[s].Values));
+
+    for(GLint i = 0; i < Subroutines[s].numSubroutines; i++)
+      m_Real->glGetUniformSubroutineuiv(shs[s], i, &Subroutines[s].Values[i]);
+  }
+}
+
+void GLRenderState::SetEnabled(GLenum cap, GLint index, bool enabled)
+{
+  if(cap == eGL_BLEND)
+  {
+    for(GLint i = 0; i < (GLint)ARRAY_COUNT(Blends); i++)
+      if(index < 0 || i == index)
+        Blends[i].Enabled = enabled;
+    return;
+  }
+
+  if(cap == eGL_SCISSOR_TEST)
+  {
+    for(GLint i = 0; i < (GLint)ARRAY_COUNT(Scissors); i++)
+      if(index < 0 || i == index)
+        Scissors[i].enabled = enabled;
+    return;
+  }
+
+  // only blending and scissoring are indexed
+  if(index >= 0 || !EnabledPNameSupported(cap))
+    return;
+
+  for(GLuint i = 0; i < eEnabled_Count; i++)
+  {
+    if(EnabledPNames[i] == cap)
+    {
+      Enabled[i] = enabled;
+      return;
+    }
+  }
+}
+
+void GLRenderState::SetBlendFunc(GLint buf, GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha,
+                                 GLenum dstAlpha)
+{
+  for(GLint i = 0; i < (GLint)ARRAY_COUNT(Blends); i++)
+  {
+    if(buf < 0 || i == buf)
+    {
+      Blends[i].SourceRGB = srcRGB;
+      Blends[i].DestinationRGB = dstRGB;
+      Blends[i].SourceAlpha = srcAlpha;
+      Blends[i].DestinationAlpha = dstAlpha;
+    }
+  }
+}
+
+void GLRenderState::SetBlendEquation(GLint buf, GLenum modeRGB, GLenum modeAlpha)
+{
+  for(GLint i = 0; i < (GLint)ARRAY_COUNT(Blends); i++)
+  {
+    if(buf < 0 || i == buf)
+    {
+      Blends[i].EquationRGB = modeRGB;
+      Blends[i].EquationAlpha = modeAlpha;
+    }
+  }
+}
+
+void GLRenderState::SetColorMask(GLint buf, GLboolean red, GLboolean green, GLboolean blue,
+                                 GLboolean alpha)
+{
+  for(GLint i = 0; i < (GLint)ARRAY_COUNT(ColorMasks); i++)
+  {
+    if(buf < 0 || i == buf)
+    {
+      ColorMasks[i].red = red;
+      ColorMasks[i].green = green;
+      ColorMasks[i].blue = blue;
+      ColorMasks[i].alpha = alpha;
+    }
+  }
+}
+
+void GLRenderState::SetStencilFunc(GLenum face, GLenum func, GLint ref, GLuint mask)
+{
+  if(face != eGL_BACK)
+  {
+    StencilFront.func = func;
+    StencilFront.ref = ref;
+    StencilFront.valuemask = uint8_t(mask & 0xff);
+  }
+
+  if(face != eGL_FRONT)
+  {
+    StencilBack.func = func;
+    StencilBack.ref = ref;
+    StencilBack.valuemask = uint8_t(mask & 0xff);
+  }
+}
+
+void GLRenderState::SetStencilMask(GLenum face, GLuint mask)
+{
+  if(face != eGL_BACK)
+    StencilFront.writemask = uint8_t(mask & 0xff);
+
+  if(face != eGL_FRONT)
+    StencilBack.writemask = uint8_t(mask & 0xff);
+}
+
+void GLRenderState::SetStencilOp(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+  if(face != eGL_BACK)
+  {
+    StencilFront.stencilFail = sfail;
+    StencilFront.depthFail = dpfail;
+    StencilFront.pass = dppass;
+  }
+
+  if(face != eGL_FRONT)
+  {
+    StencilBack.stencilFail = sfail;
+    StencilBack.depthFail = dpfail;
+    StencilBack.pass = dppass;
+  }
+}
+
+void GLRenderState::SetViewport(GLint index, const GLfloat *v)
+{
+  for(GLint i = 0; i < (GLint)ARRAY_COUNT(Viewports); i++)
+  {
+    if(index < 0 || i == index)
+    {
+      Viewports[i].x = v[0];
+      Viewports[i].y = v[1];
+      Viewports[i].width = v[2];
+      Viewports[i].height = v[3];
+    }
+  }
+}
+
+void GLRenderState::SetScissor(GLint index, const GLint *v)
+{
+  for(GLint i = 0; i < (GLint)ARRAY_COUNT(Scissors); i++)
+  {
+    if(index < 0 || i == index)
+    {
+      Scissors[i].x = v[0];
+      Scissors[i].y = v[1];
+      Scissors[i].width = v[2];
+      Scissors[i].height = v[3];
+    }
+  }
+}
+
+void GLRenderState::SetDepthRange(GLint index, GLdouble nearVal, GLdouble farVal)
+{
+  for(GLint i = 0; i < (GLint)ARRAY_COUNT(DepthRanges); i++)
+  {
+    if(index < 0 || i == index)
+    {
+      DepthRanges[i].nearZ = nearVal;
+      DepthRanges[i].farZ = farVal;
+    }
+  }
+}
+
+void GLRenderState::SetPointParameter(GLenum pname, GLfloat param)
+{
+  if(pname == eGL_POINT_FADE_THRESHOLD_SIZE)
+    PointFadeThresholdSize = param;
+  else if(pname == eGL_POINT_SPRITE_COORD_ORIGIN)
+    PointSpriteOrigin = (GLenum)(GLint)param;
+}
+
+void GLRenderState::SetHint(GLenum target, GLenum mode)
+{
+  switch(target)
+  {
+    case eGL_FRAGMENT_SHADER_DERIVATIVE_HINT: Hints.Derivatives = mode; break;
+    case eGL_LINE_SMOOTH_HINT: Hints.LineSmooth = mode; break;
+    case eGL_POLYGON_SMOOTH_HINT: Hints.PolySmooth = mode; break;
+    case eGL_TEXTURE_COMPRESSION_HINT: Hints.TexCompression = mode; break;
+    default: break;
+  }
+}
+
+void GLRenderState::SetDrawBuffers(GLsizei n, const GLenum *bufs)
+{
+  for(GLsizei i = 0; i < (GLsizei)ARRAY_COUNT(DrawBuffers); i++)
+    DrawBuffers[i] = (bufs && i < n) ? bufs[i] : eGL_NONE;
+}
+
+void GLRenderState::FetchState(void *ctx, WrappedOpenGL *gl)
+{
+  GLint boolread = 0;
+  // TODO check GL_MAX_*
+  // TODO check the extensions/core version for these is around
+
+  if(ctx == NULL)
+  {
+    ContextPresent = false;
+    return;
+  }
+
+  {
+    const GLenum *pnames = EnabledPNames;
+
+    for(GLuint i = 0; i < eEnabled_Count; i++)
+    {
+      // advanced blending is coherent if the extension to make it non-coherent isn't present
+      if(!EnabledPNameSupported(pnames[i]))
+      {
+        Enabled[i] = (pnames[i] == eGL_BLEND_ADVANCED_COHERENT_KHR);
+        continue;
+      }
+
+      Enabled[i] = (m_Real->glIsEnabled(pnames[i]) == GL_TRUE);
+    }
+  }
+
+  FetchBindings(ctx, gl);
+
+  FetchVertexAttribs();
+
+  m_Real->glGetFloatv(eGL_POINT_FADE_THRESHOLD_SIZE, &PointFadeThresholdSize);
+  m_Real->glGetIntegerv(eGL_POINT_SPRITE_COORD_ORIGIN, (GLint *)&PointSpriteOrigin);
+  m_Real->glGetFloatv(eGL_LINE_WIDTH, &LineWidth);
+  m_Real->glGetFloatv(eGL_POINT_SIZE, &PointSize);
+
+  m_Real->glGetIntegerv(eGL_PRIMITIVE_RESTART_INDEX, (GLint *)&PrimitiveRestartIndex);
+  if(GLCoreVersion >= 45 || ExtensionSupported[ExtensionSupported_ARB_clip_control])
+  {
+    m_Real->glGetIntegerv(eGL_CLIP_ORIGIN, (GLint *)&ClipOrigin);
+    m_Real->glGetIntegerv(eGL_CLIP_DEPTH_MODE, (GLint *)&ClipDepth);
+  }
+  else
+  {
+    ClipOrigin = eGL_LOWER_LEFT;
+    ClipDepth = eGL_NEGATIVE_ONE_TO_ONE;
+  }
+  m_Real->glGetIntegerv(eGL_PROVOKING_VERTEX, (GLint *)&ProvokingVertex);
+
+  FetchSubroutines();
+
   for(GLuint i = 0; i < (GLuint)ARRAY_COUNT(Blends); i++)
   {
     m_Real->glGetIntegeri_v(eGL_BLEND_EQUATION_RGB, i, (GLint *)&Blends[i].EquationRGB);
@@ -765,9 +1157,6 @@ void GLRenderState::FetchState(void *ctx, WrappedOpenGL *gl)
     Scissors[i].enabled = (m_Real->glIsEnabledi(eGL_SCISSOR_TEST, i) == GL_TRUE);
   }
 
-  m_Real->glGetIntegerv(eGL_DRAW_FRAMEBUFFER_BINDING, (GLint *)&DrawFBO);
-  m_Real->glGetIntegerv(eGL_READ_FRAMEBUFFER_BINDING, (GLint *)&ReadFBO);
-
   m_Real->glBindFramebuffer(eGL_DRAW_FRAMEBUFFER, 0);
   m_Real->glBindFramebuffer(eGL_READ_FRAMEBUFFER, 0);
 
@@ -835,7 +1224,7 @@ void GLRenderState::FetchState(void *ctx, WrappedOpenGL *gl)
     m_Real->glGetBooleanv(eGL_COLOR_WRITEMASK, &ColorMasks[i].red);
 
   m_Real->glGetIntegeri_v(eGL_SAMPLE_MASK_VALUE, 0, (GLint *)&SampleMask[0]);
-  m_Real->glGetIntegerv(eGL_SAMPLE_COVERAGE_VALUE, (GLint *)&SampleCoverage);
+  m_Real->glGetFloatv(eGL_SAMPLE_COVERAGE_VALUE, &SampleCoverage);
   m_Real->glGetIntegerv(eGL_SAMPLE_COVERAGE_INVERT, (GLint *)&boolread);
   SampleCoverageInvert = (boolread != 0);
   m_Real->glGetFloatv(eGL_MIN_SAMPLE_SHADING_VALUE, &MinSampleShading);
@@ -895,57 +1284,11 @@ void GLRenderState::ApplyState(void *ctx, WrappedOpenGL *gl)
     return;
 
   {
-    GLenum pnames[] = {
-        eGL_CLIP_DISTANCE0,
-        eGL_CLIP_DISTANCE1,
-        eGL_CLIP_DISTANCE2,
-        eGL_CLIP_DISTANCE3,
-        eGL_CLIP_DISTANCE4,
-        eGL_CLIP_DISTANCE5,
-        eGL_CLIP_DISTANCE6,
-        eGL_CLIP_DISTANCE7,
-        eGL_COLOR_LOGIC_OP,
-        eGL_CULL_FACE,
-        eGL_DEPTH_CLAMP,
-        eGL_DEPTH_TEST,
-        eGL_DEPTH_BOUNDS_TEST_EXT,
-        eGL_DITHER,
-        eGL_FRAMEBUFFER_SRGB,
-        eGL_LINE_SMOOTH,
-        eGL_MULTISAMPLE,
-        eGL_POLYGON_SMOOTH,
-        eGL_POLYGON_OFFSET_FILL,
-        eGL_POLYGON_OFFSET_LINE,
-        eGL_POLYGON_OFFSET_POINT,
-        eGL_PROGRAM_POINT_SIZE,
-        eGL_PRIMITIVE_RESTART,
-        eGL_PRIMITIVE_RESTART_FIXED_INDEX,
-        eGL_SAMPLE_ALPHA_TO_COVERAGE,
-        eGL_SAMPLE_ALPHA_TO_ONE,
-        eGL_SAMPLE_COVERAGE,
-        eGL_SAMPLE_MASK,
-        eGL_SAMPLE_SHADING,
-        eGL_RASTER_MULTISAMPLE_EXT,
-        eGL_STENCIL_TEST,
-        eGL_TEXTURE_CUBE_MAP_SEAMLESS,
-        eGL_BLEND_ADVANCED_COHERENT_KHR,
-        eGL_RASTERIZER_DISCARD,
-    };
-
-    RDCCOMPILE_ASSERT(ARRAY_COUNT(pnames) == eEnabled_Count, "Wrong number of pnames");
+    const GLenum *pnames = EnabledPNames;
 
     for(GLuint i = 0; i < eEnabled_Count; i++)
     {
-      if(pnames[i] == eGL_BLEND_ADVANCED_COHERENT_KHR &&
-         !ExtensionSupported[ExtensionSupported_KHR_blend_equation_advanced_coherent])
-        continue;
-
-      if(pnames[i] == eGL_RASTER_MULTISAMPLE_EXT &&
-         !ExtensionSupported[ExtensionSupported_EXT_raster_multisample])
-        continue;
-
-      if(pnames[i] == eGL_DEPTH_BOUNDS_TEST_EXT &&
-         !ExtensionSupported[ExtensionSupported_EXT_depth_bounds_test])
+      if(!EnabledPNameSupported(pnames[i]))
         continue;
 
       if(Enabled[i])
@@ -43,6 +43,9 @@ struct PixelUnpackState
   void Fetch(const GLHookSet *funcs, bool compressed);
   void Apply(const GLHookSet *funcs, bool compressed);
 
+  // mirror a glPixelStore call. Pack parameters are ignored.
+  void Store(GLenum pname, GLint param);
+
   bool FastPath(GLsizei width, GLsizei height, GLsizei depth, GLenum dataformat, GLenum basetype);
   bool FastPathCompressed(GLsizei width, GLsizei height, GLsizei depth);
 
@@ -62,6 +65,45 @@ struct GLRenderState
   void Clear();
   void Serialise(LogState state, void *ctx, WrappedOpenGL *gl);
 
+  // fetches only the object bindings - everything MarkReferenced and MarkDirty look at.
+  void FetchBindings(void *ctx, WrappedOpenGL *gl);
+
+  // update fetched bindings in place to mirror a bind call, instead of fetching them again.
+  // Targets and indices outside what FetchBindings() tracks are ignored.
+  void BindTexture(GLuint unit, GLenum target, GLuint texture);
+  void BindBuffer(GLenum target, GLuint buffer);
+  void BindIndexedBuffer(GLenum target, GLuint index, GLuint buffer, uint64_t start, uint64_t size);
+  void UnbindTextureUnit(GLuint unit);
+  void FetchFeedbackBindings();
+
+  // deleting a bound object reverts its bindings to 0
+  void DeleteTextures(GLsizei n, const GLuint *textures);
+  void DeleteBuffers(GLsizei n, const GLuint *buffers);
+  void DeleteSamplers(GLsizei n, const GLuint *samplers);
+
+  // copy a fetched state, keeping this state's serialiser
+  void CopyState(const GLRenderState &other);
+
+  // re-fetch the parts of FetchState() that aren't mirrored by the setters below
+  void FetchVertexAttribs();
+  void FetchSubroutines();
+
+  // update the fetched fixed-function state in place to mirror a state call. An index (or draw
+  // buffer) of -1 applies to all of them, as the non-indexed calls do.
+  void SetEnabled(GLenum cap, GLint index, bool enabled);
+  void SetBlendFunc(GLint buf, GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+  void SetBlendEquation(GLint buf, GLenum modeRGB, GLenum modeAlpha);
+  void SetColorMask(GLint buf, GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+  void SetStencilFunc(GLenum face, GLenum func, GLint ref, GLuint mask);
+  void SetStencilMask(GLenum face, GLuint mask);
+  void SetStencilOp(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass);
+  void SetViewport(GLint index, const GLfloat *v);
+  void SetScissor(GLint index, const GLint *v);
+  void SetDepthRange(GLint index, GLdouble nearVal, GLdouble farVal);
+  void SetPointParameter(GLenum pname, GLfloat param);
+  void SetHint(GLenum target, GLenum mode);
+  void SetDrawBuffers(GLsizei n, const GLenum *bufs);
+
   void MarkReferenced(WrappedOpenGL *gl, bool initial) const;
   void MarkDirty(WrappedOpenGL *gl);
 
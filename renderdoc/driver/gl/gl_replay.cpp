@@ -31,6 +31,22 @@
 #define OPENGL 1
 #include "data/glsl/debuguniforms.h"
 
+static uint64_t GetCurrentReplayContextSlot()
+{
+  static uint64_t slot = Threading::AllocateTLSSlot();
+  return slot;
+}
+
+GLWindowingData *GLReplay::GetCurrentReplayContext()
+{
+  return (GLWindowingData *)Threading::GetTLSValue(GetCurrentReplayContextSlot());
+}
+
+void GLReplay::SetCurrentReplayContext(GLWindowingData *ctx)
+{
+  Threading::SetTLSValue(GetCurrentReplayContextSlot(), (void *)ctx);
+}
+
 GLReplay::GLReplay()
 {
   m_pDriver = NULL;
@@ -2195,6 +2211,19 @@ byte *GLReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
     return new byte[0];
   }
 
+  // ASTC blocks other than 4x4 can't be cropped to, so fail rather than silently returning the
+  // whole subresource
+  if(!params.region.IsWhole() && ((intFormat >= eGL_COMPRESSED_RGBA_ASTC_5x4_KHR &&
+                                   intFormat <= eGL_COMPRESSED_RGBA_ASTC_12x12_KHR) ||
+                                  (intFormat >= eGL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4_KHR &&
+                                   intFormat <= eGL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR)))
+  {
+    RDCERR("Can't read a region of %s texture %llu, only 4x4 ASTC blocks are supported",
+           ToStr::Get(intFormat).c_str(), tex);
+    dataSize = 0;
+    return new byte[0];
+  }
+
   if(texType == eGL_TEXTURE_BUFFER)
   {
     GLuint bufName = 0;
@@ -2456,6 +2485,9 @@ byte *GLReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
       target = targets[arrayIdx];
     }
 
+    // whether we've read back only params.region, or need to crop the data afterwards
+    bool regionRead = false;
+
     if(IsCompressedFormat(intFormat))
     {
       GLuint compSize;
@@ -2472,10 +2504,38 @@ byte *GLReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
       GLenum fmt = GetBaseFormat(intFormat);
       GLenum type = GetDataType(intFormat);
 
-      dataSize = GetByteSize(width, height, depth, fmt, type);
-      ret = new byte[dataSize];
+      // when it's available read just the region straight out of the texture. For disk saves
+      // the region is relative to the flipped image, so those are cropped after flipping below.
+      if(!params.region.IsWhole() && !params.forDiskSave &&
+         gl.GetHookset().glGetTextureSubImage != NULL)
+      {
+        bool layered = (texType == eGL_TEXTURE_2D_ARRAY || texType == eGL_TEXTURE_CUBE_MAP ||
+                        texType == eGL_TEXTURE_CUBE_MAP_ARRAY);
+
+        TextureRegion region =
+            ClampTextureRegion(params.region, width, texType == eGL_TEXTURE_1D_ARRAY ? 1 : height,
+                               texType == eGL_TEXTURE_3D ? depth : 1, 1);
 
-      m_pDriver->glGetTexImage(target, (GLint)mip, fmt, type, ret);
+        // 1D arrays store their layers in y, other arrays and cubemaps in z
+        GLint yoffs = texType == eGL_TEXTURE_1D_ARRAY ? (GLint)arrayIdx : (GLint)region.y;
+        GLint zoffs = layered ? (GLint)arrayIdx : (GLint)region.z;
+
+        dataSize = GetByteSize(region.width, region.height, region.depth, fmt, type);
+        ret = new byte[dataSize];
+
+        gl.glGetTextureSubImage(texname, (GLint)mip, (GLint)region.x, yoffs, zoffs,
+                                (GLsizei)region.width, (GLsizei)region.height,
+                                (GLsizei)region.depth, fmt, type, (GLsizei)dataSize, ret);
+
+        regionRead = true;
+      }
+      else
+      {
+        dataSize = GetByteSize(width, height, depth, fmt, type);
+        ret = new byte[dataSize];
+
+        m_pDriver->glGetTexImage(target, (GLint)mip, fmt, type, ret);
+      }
 
       // if we're saving to disk we make the decision to vertically flip any non-compressed
       // images. This is a bit arbitrary, but really origin top-left is common for all disk
@@ -2484,7 +2544,7 @@ byte *GLReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
       // order is consistent (and we just need to take care to apply an extra vertical flip
       // for display when proxying).
 
-      if(params.forDiskSave)
+      if(params.forDiskSave && !regionRead)
       {
         // need to vertically flip the image now to get conventional row ordering
         // we either do this when copying out the slice of interest, or just
@@ -2546,6 +2606,50 @@ byte *GLReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
       }
     }
 
+    // otherwise crop the region out of what we read
+    if(!params.region.IsWhole() && !regionRead)
+    {
+      uint32_t blockDim = 1, blockBytes = 0;
+      if(IsCompressedFormat(intFormat))
+      {
+        blockDim = 4;
+        blockBytes = (uint32_t)GetCompressedByteSize(4, 4, 1, intFormat, 0);
+      }
+      else
+      {
+        blockBytes = (uint32_t)GetByteSize(1, 1, 1, GetBaseFormat(intFormat), GetDataType(intFormat));
+      }
+
+      uint32_t w = (uint32_t)width, h = (uint32_t)height;
+      uint32_t d = texType == eGL_TEXTURE_3D ? (uint32_t)depth : 1;
+      size_t sliceOffset = 0;
+
+      // disk saves have already extracted the slice, otherwise array and multisampled reads
+      // return every layer. Cubemap faces are read individually.
+      if(!params.forDiskSave)
+      {
+        if(texType == eGL_TEXTURE_1D_ARRAY)
+        {
+          sliceOffset = (dataSize / RDCMAX(1U, h)) * arrayIdx;
+          h = 1;
+        }
+        else if(texType == eGL_TEXTURE_2D_ARRAY || texType == eGL_TEXTURE_CUBE_MAP_ARRAY)
+        {
+          sliceOffset = (dataSize / RDCMAX(1, depth)) * arrayIdx;
+        }
+      }
+
+      TextureRegion region = ClampTextureRegion(params.region, w, h, d, blockDim);
+
+      size_t sliceSize = dataSize - sliceOffset;
+      byte *cropped =
+          CropTextureData(ret + sliceOffset, w, h, d, blockDim, blockBytes, region, sliceSize);
+
+      delete[] ret;
+      ret = cropped;
+      dataSize = sliceSize;
+    }
+
     unpack.Apply(&gl.GetHookset(), true);
 
     gl.glBindTexture(texType, prevtex);
@@ -373,6 +373,11 @@ private:
 
   // eventID -> data
   map<uint32_t, GLPostVSData> m_PostVSData;
+  PostVSCacheLRU m_PostVSCache;
+
+  void GeneratePostVSBuffers(uint32_t eventID);
+  void FreePostVSBuffers(GLPostVSData &data);
+  void TrimPostVSBuffers();
 
   void InitDebugData();
   void DeleteDebugData();
@@ -400,6 +405,11 @@ private:
   void SwapBuffers(GLWindowingData *ctx);
   void CloseReplayContext();
 
+  // which context MakeCurrentReplayContext last made current. GL contexts are current per-thread
+  // and replay sessions can each run on their own thread, so this is tracked per-thread too.
+  static GLWindowingData *GetCurrentReplayContext();
+  static void SetCurrentReplayContext(GLWindowingData *ctx);
+
   uint64_t m_OutputWindowID;
   map<uint64_t, OutputWindow> m_OutputWindows;
 
@@ -44,11 +44,9 @@ PFNGLXSWAPBUFFERSPROC glXSwapProc = NULL;
 
 void GLReplay::MakeCurrentReplayContext(GLWindowingData *ctx)
 {
-  static GLWindowingData *prev = NULL;
-
-  if(glXMakeContextCurrentProc && ctx && ctx != prev)
+  if(glXMakeContextCurrentProc && ctx && ctx != GetCurrentReplayContext())
   {
-    prev = ctx;
+    SetCurrentReplayContext(ctx);
     glXMakeContextCurrentProc(ctx->dpy, ctx->wnd, ctx->wnd, ctx->ctx);
     m_pDriver->ActivateContext(*ctx);
   }
@@ -64,6 +62,7 @@ void GLReplay::CloseReplayContext()
   if(glXDestroyCtxProc)
   {
     glXMakeContextCurrentProc(m_ReplayCtx.dpy, 0L, 0L, NULL);
+    SetCurrentReplayContext(NULL);
     glXDestroyCtxProc(m_ReplayCtx.dpy, m_ReplayCtx.ctx);
   }
 }
@@ -219,6 +218,7 @@ void GLReplay::DestroyOutputWindow(uint64_t id)
   gl.glDeleteFramebuffers(1, &outw.BlitData.readFBO);
 
   glXMakeContextCurrentProc(outw.dpy, 0L, 0L, NULL);
+  SetCurrentReplayContext(NULL);
   glXDestroyCtxProc(outw.dpy, outw.ctx);
 
   m_OutputWindows.erase(it);
@@ -42,11 +42,9 @@ WGLDELETECONTEXTPROC wglDeleteRC = NULL;
 
 void GLReplay::MakeCurrentReplayContext(GLWindowingData *ctx)
 {
-  static GLWindowingData *prev = NULL;
-
-  if(wglMakeCurrentProc && ctx && ctx != prev)
+  if(wglMakeCurrentProc && ctx && ctx != GetCurrentReplayContext())
   {
-    prev = ctx;
+    SetCurrentReplayContext(ctx);
     wglMakeCurrentProc(ctx->DC, ctx->ctx);
     m_pDriver->ActivateContext(*ctx);
   }
@@ -62,6 +60,7 @@ void GLReplay::CloseReplayContext()
   if(wglDeleteRC)
   {
     wglMakeCurrentProc(NULL, NULL);
+    SetCurrentReplayContext(NULL);
     wglDeleteRC(m_ReplayCtx.ctx);
     ReleaseDC(m_ReplayCtx.wnd, m_ReplayCtx.DC);
     ::DestroyWindow(m_ReplayCtx.wnd);
@@ -221,6 +220,7 @@ void GLReplay::DestroyOutputWindow(uint64_t id)
   gl.glDeleteFramebuffers(1, &outw.BlitData.readFBO);
 
   wglMakeCurrentProc(NULL, NULL);
+  SetCurrentReplayContext(NULL);
   wglDeleteRC(outw.ctx);
   ReleaseDC(outw.wnd, outw.DC);
 
@@ -187,6 +187,10 @@ void WrappedOpenGL::glBindBuffer(GLenum target, GLuint buffer)
 
   ContextData &cd = GetCtxData();
 
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  if(bindings)
+    bindings->BindBuffer(target, buffer);
+
   size_t idx = BufferIdx(target);
 
   if(m_State == WRITING_CAPFRAME)
@@ -320,6 +324,9 @@ bool WrappedOpenGL::Serialise_glNamedBufferStorageEXT(GLuint buffer, GLsizeiptr
   // for satisfying GL_MIN_MAP_BUFFER_ALIGNMENT
   m_pSerialiser->AlignNextBuffer(64);
 
+  // the record points into this chunk for its data, so the contents must stay inline
+  m_pSerialiser->InlineNextBuffer();
+
   SERIALISE_ELEMENT_BUF(byte *, bytes, data, (size_t)Bytesize);
 
   uint64_t offs = m_pSerialiser->GetOffset();
@@ -450,6 +457,9 @@ bool WrappedOpenGL::Serialise_glNamedBufferDataEXT(GLuint buffer, GLsizeiptr siz
   // for satisfying GL_MIN_MAP_BUFFER_ALIGNMENT
   m_pSerialiser->AlignNextBuffer(64);
 
+  // the record points into this chunk for its data, so the contents must stay inline
+  m_pSerialiser->InlineNextBuffer();
+
   SERIALISE_ELEMENT_BUF(byte *, bytes, data, (size_t)Bytesize);
 
   uint64_t offs = m_pSerialiser->GetOffset();
@@ -1087,6 +1097,10 @@ void WrappedOpenGL::glBindBufferBase(GLenum target, GLuint index, GLuint buffer)
   }
 
   m_Real.glBindBufferBase(target, index, buffer);
+
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  if(bindings)
+    bindings->BindIndexedBuffer(target, index, buffer, 0, 0);
 }
 
 bool WrappedOpenGL::Serialise_glBindBufferRange(GLenum target, GLuint index, GLuint buffer,
@@ -1195,6 +1209,10 @@ void WrappedOpenGL::glBindBufferRange(GLenum target, GLuint index, GLuint buffer
   }
 
   m_Real.glBindBufferRange(target, index, buffer, offset, size);
+
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  if(bindings)
+    bindings->BindIndexedBuffer(target, index, buffer, (uint64_t)offset, (uint64_t)size);
 }
 
 bool WrappedOpenGL::Serialise_glBindBuffersBase(GLenum target, GLuint first, GLsizei count,
@@ -1241,6 +1259,10 @@ void WrappedOpenGL::glBindBuffersBase(GLenum target, GLuint first, GLsizei count
 
   ContextData &cd = GetCtxData();
 
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  for(GLsizei i = 0; bindings && i < count; i++)
+    bindings->BindIndexedBuffer(target, first + i, buffers ? buffers[i] : 0, 0, 0);
+
   if(m_State >= WRITING && buffers && count > 0)
   {
     size_t idx = BufferIdx(target);
@@ -1392,6 +1414,16 @@ void WrappedOpenGL::glBindBuffersRange(GLenum target, GLuint first, GLsizei coun
 
   ContextData &cd = GetCtxData();
 
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  for(GLsizei i = 0; bindings && i < count; i++)
+  {
+    if(buffers && buffers[i])
+      bindings->BindIndexedBuffer(target, first + i, buffers[i], (uint64_t)offsets[i],
+                                  (uint64_t)sizes[i]);
+    else
+      bindings->BindIndexedBuffer(target, first + i, 0, 0, 0);
+  }
+
   if(m_State >= WRITING && buffers && count > 0)
   {
     size_t idx = BufferIdx(target);
@@ -2570,6 +2602,17 @@ void WrappedOpenGL::glDeleteTransformFeedbacks(GLsizei n, const GLuint *ids)
   }
 
   m_Real.glDeleteTransformFeedbacks(n, ids);
+
+  // deleting the bound object reverts to the default one, along with its buffer bindings
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  for(GLsizei i = 0; bindings && i < n; i++)
+  {
+    if(ids[i] != 0 && ids[i] == bindings->FeedbackObj)
+    {
+      bindings->FeedbackObj = 0;
+      bindings->FetchFeedbackBindings();
+    }
+  }
 }
 
 bool WrappedOpenGL::Serialise_glTransformFeedbackBufferBase(GLuint xfb, GLuint index, GLuint buffer)
@@ -2601,6 +2644,11 @@ void WrappedOpenGL::glTransformFeedbackBufferBase(GLuint xfb, GLuint index, GLui
 {
   m_Real.glTransformFeedbackBufferBase(xfb, index, buffer);
 
+  // only the bound feedback object's buffer bindings are tracked
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings && xfb == bindings->FeedbackObj)
+    bindings->BindIndexedBuffer(eGL_TRANSFORM_FEEDBACK_BUFFER, index, buffer, 0, 0);
+
   if(m_State >= WRITING)
   {
     SCOPED_SERIALISE_CONTEXT(FEEDBACK_BUFFER_BASE);
@@ -2660,6 +2708,12 @@ void WrappedOpenGL::glTransformFeedbackBufferRange(GLuint xfb, GLuint index, GLu
 {
   m_Real.glTransformFeedbackBufferRange(xfb, index, buffer, offset, size);
 
+  // only the bound feedback object's buffer bindings are tracked
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings && xfb == bindings->FeedbackObj)
+    bindings->BindIndexedBuffer(eGL_TRANSFORM_FEEDBACK_BUFFER, index, buffer, (uint64_t)offset,
+                                (uint64_t)size);
+
   if(m_State >= WRITING)
   {
     SCOPED_SERIALISE_CONTEXT(FEEDBACK_BUFFER_RANGE);
@@ -2704,6 +2758,14 @@ void WrappedOpenGL::glBindTransformFeedback(GLenum target, GLuint id)
 {
   m_Real.glBindTransformFeedback(target, id);
 
+  // the indexed feedback buffer bindings come with the object, so read back just those
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings)
+  {
+    bindings->FeedbackObj = id;
+    bindings->FetchFeedbackBindings();
+  }
+
   GLResourceRecord *record = NULL;
 
   if(m_State >= WRITING)
@@ -3880,6 +3942,10 @@ void WrappedOpenGL::glBindVertexArray(GLuint array)
 {
   m_Real.glBindVertexArray(array);
 
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings)
+    bindings->VAO = array;
+
   GLResourceRecord *record = NULL;
 
   if(m_State >= WRITING)
@@ -4339,6 +4405,10 @@ void WrappedOpenGL::glDeleteBuffers(GLsizei n, const GLuint *buffers)
   }
 
   m_Real.glDeleteBuffers(n, buffers);
+
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings)
+    bindings->DeleteBuffers(n, buffers);
 }
 
 void WrappedOpenGL::glDeleteVertexArrays(GLsizei n, const GLuint *arrays)
@@ -4356,6 +4426,11 @@ void WrappedOpenGL::glDeleteVertexArrays(GLsizei n, const GLuint *arrays)
   }
 
   m_Real.glDeleteVertexArrays(n, arrays);
+
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  for(GLsizei i = 0; bindings && i < n; i++)
+    if(arrays[i] == bindings->VAO)
+      bindings->VAO = 0;
 }
 
 #pragma endregion
@@ -4536,6 +4611,7 @@ bool WrappedOpenGL::Serialise_glVertexAttrib(GLuint index, int count, GLenum typ
                                                                                 \
   {                                                                             \
     m_Real.CONCAT(glVertexAttrib, suffix)(index, ARRAYLIST);                    \
+    GetCtxData().m_VertexAttribsDirty = true;                                   \
                                                                                 \
     if(m_State >= WRITING_CAPFRAME)                                             \
     {                                                                           \
@@ -4595,6 +4671,7 @@ ATTRIB_FUNC(4, 4Nub, Attrib_N, GLubyte, GLubyte x, GLubyte y, GLubyte z, GLubyte
                                                                                            \
   {                                                                                        \
     m_Real.CONCAT(glVertexAttrib, suffix)(index, value);                                   \
+    GetCtxData().m_VertexAttribsDirty = true;                                              \
                                                                                            \
     if(m_State >= WRITING_CAPFRAME)                                                        \
     {                                                                                      \
@@ -4658,6 +4735,7 @@ ATTRIB_FUNC(4, 4Nusv, Attrib_N, GLushort)
                                                                                            \
   {                                                                                        \
     m_Real.CONCAT(CONCAT(glVertexAttribP, count), suffix)(index, type, normalized, value); \
+    GetCtxData().m_VertexAttribsDirty = true;                                              \
                                                                                            \
     if(m_State >= WRITING_CAPFRAME)                                                        \
     {                                                                                      \
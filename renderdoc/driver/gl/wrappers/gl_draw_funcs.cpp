@@ -89,14 +89,11 @@ void WrappedOpenGL::glDispatchCompute(GLuint num_groups_x, GLuint num_groups_y,
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -187,14 +184,11 @@ void WrappedOpenGL::glDispatchComputeGroupSizeARB(GLuint num_groups_x, GLuint nu
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -254,14 +248,11 @@ void WrappedOpenGL::glDispatchComputeIndirect(GLintptr indirect)
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -458,14 +449,11 @@ void WrappedOpenGL::glDrawTransformFeedback(GLenum mode, GLuint id)
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -524,14 +512,11 @@ void WrappedOpenGL::glDrawTransformFeedbackInstanced(GLenum mode, GLuint id, GLs
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -589,14 +574,11 @@ void WrappedOpenGL::glDrawTransformFeedbackStream(GLenum mode, GLuint id, GLuint
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -660,14 +642,11 @@ void WrappedOpenGL::glDrawTransformFeedbackStreamInstanced(GLenum mode, GLuint i
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -722,14 +701,11 @@ void WrappedOpenGL::glDrawArrays(GLenum mode, GLint first, GLsizei count)
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -792,14 +768,11 @@ void WrappedOpenGL::glDrawArraysIndirect(GLenum mode, const void *indirect)
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -858,14 +831,11 @@ void WrappedOpenGL::glDrawArraysInstanced(GLenum mode, GLint first, GLsizei coun
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -926,14 +896,11 @@ void WrappedOpenGL::glDrawArraysInstancedBaseInstance(GLenum mode, GLint first,
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1085,14 +1052,11 @@ void WrappedOpenGL::glDrawElements(GLenum mode, GLsizei count, GLenum type, cons
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1162,14 +1126,11 @@ void WrappedOpenGL::glDrawElementsIndirect(GLenum mode, GLenum type, const void
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1239,14 +1200,11 @@ void WrappedOpenGL::glDrawRangeElements(GLenum mode, GLuint start, GLuint end, G
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1320,14 +1278,11 @@ void WrappedOpenGL::glDrawRangeElementsBaseVertex(GLenum mode, GLuint start, GLu
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1396,14 +1351,11 @@ void WrappedOpenGL::glDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1472,14 +1424,11 @@ void WrappedOpenGL::glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum t
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1554,14 +1503,11 @@ void WrappedOpenGL::glDrawElementsInstancedBaseInstance(GLenum mode, GLsizei cou
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1637,14 +1583,11 @@ void WrappedOpenGL::glDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1723,14 +1666,11 @@ void WrappedOpenGL::glDrawElementsInstancedBaseVertexBaseInstance(GLenum mode, G
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1855,14 +1795,11 @@ void WrappedOpenGL::glMultiDrawArrays(GLenum mode, const GLint *first, const GLs
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -2018,14 +1955,11 @@ void WrappedOpenGL::glMultiDrawElements(GLenum mode, const GLsizei *count, GLenu
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -2187,14 +2121,11 @@ void WrappedOpenGL::glMultiDrawElementsBaseVertex(GLenum mode, const GLsizei *co
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -2349,14 +2280,11 @@ void WrappedOpenGL::glMultiDrawArraysIndirect(GLenum mode, const void *indirect,
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -2521,14 +2449,11 @@ void WrappedOpenGL::glMultiDrawElementsIndirect(GLenum mode, GLenum type, const
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -2697,14 +2622,11 @@ void WrappedOpenGL::glMultiDrawArraysIndirectCountARB(GLenum mode, GLintptr indi
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -2886,14 +2808,11 @@ void WrappedOpenGL::glMultiDrawElementsIndirectCountARB(GLenum mode, GLenum type
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -3005,14 +2924,11 @@ void WrappedOpenGL::glClearNamedFramebufferfv(GLuint framebuffer, GLenum buffer,
 
     m_ContextRecord->AddChunk(scope.Get());
 
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.FetchState(GetCtx(), this);
-    state.MarkReferenced(this, false);
+    GetBindingState().MarkReferenced(this, false);
   }
   else if(m_State == WRITING_IDLE)
   {
-    GLRenderState state(&m_Real, m_pSerialiser, m_State);
-    state.MarkDirty(this);
+    GetBindingState().MarkDirty(this);
   }
 }
 
@@ -1091,6 +1091,10 @@ void WrappedOpenGL::glFramebufferReadBufferEXT(GLuint framebuffer, GLenum buf)
 {
   m_Real.glFramebufferReadBufferEXT(framebuffer, buf);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state && framebuffer == 0)
+    state->ReadBuffer = buf;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(READ_BUFFER);
@@ -1133,6 +1137,10 @@ void WrappedOpenGL::glReadBuffer(GLenum mode)
   }
 
   m_Real.glReadBuffer(mode);
+
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state && GetCtxData().m_ReadFramebufferRecord == NULL)
+    state->ReadBuffer = mode;
 }
 
 bool WrappedOpenGL::Serialise_glBindFramebuffer(GLenum target, GLuint framebuffer)
@@ -1170,13 +1178,23 @@ void WrappedOpenGL::glBindFramebuffer(GLenum target, GLuint framebuffer)
                                             eFrameRef_ReadBeforeWrite);
   }
 
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings)
+  {
+    if(target == eGL_DRAW_FRAMEBUFFER || target == eGL_FRAMEBUFFER)
+      bindings->DrawFBO = framebuffer;
+    if(target == eGL_READ_FRAMEBUFFER || target == eGL_FRAMEBUFFER)
+      bindings->ReadFBO = framebuffer;
+  }
+
   if(framebuffer == 0 && m_State < WRITING)
     framebuffer = m_FakeBB_FBO;
 
+  // GL_FRAMEBUFFER binds both, and the default framebuffer has no record
   if(target == eGL_DRAW_FRAMEBUFFER || target == eGL_FRAMEBUFFER)
     GetCtxData().m_DrawFramebufferRecord =
         GetResourceManager()->GetResourceRecord(FramebufferRes(GetCtx(), framebuffer));
-  else
+  if(target == eGL_READ_FRAMEBUFFER || target == eGL_FRAMEBUFFER)
     GetCtxData().m_ReadFramebufferRecord =
         GetResourceManager()->GetResourceRecord(FramebufferRes(GetCtx(), framebuffer));
 
@@ -1216,6 +1234,10 @@ void WrappedOpenGL::glFramebufferDrawBufferEXT(GLuint framebuffer, GLenum buf)
 {
   m_Real.glFramebufferDrawBufferEXT(framebuffer, buf);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state && framebuffer == 0)
+    state->SetDrawBuffers(1, &buf);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DRAW_BUFFER);
@@ -1258,6 +1280,10 @@ void WrappedOpenGL::glDrawBuffer(GLenum buf)
   }
 
   m_Real.glDrawBuffer(buf);
+
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state && GetCtxData().m_DrawFramebufferRecord == NULL)
+    state->SetDrawBuffers(1, &buf);
 }
 
 bool WrappedOpenGL::Serialise_glFramebufferDrawBuffersEXT(GLuint framebuffer, GLsizei n,
@@ -1291,6 +1317,10 @@ void WrappedOpenGL::glFramebufferDrawBuffersEXT(GLuint framebuffer, GLsizei n, c
 {
   m_Real.glFramebufferDrawBuffersEXT(framebuffer, n, bufs);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state && framebuffer == 0)
+    state->SetDrawBuffers(n, bufs);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DRAW_BUFFERS);
@@ -1336,6 +1366,11 @@ void WrappedOpenGL::glDrawBuffers(GLsizei n, const GLenum *bufs)
   }
 
   m_Real.glDrawBuffers(n, bufs);
+
+  // the fetched draw and read buffers are only those of the default framebuffer
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state && GetCtxData().m_DrawFramebufferRecord == NULL)
+    state->SetDrawBuffers(n, bufs);
 }
 
 void WrappedOpenGL::glInvalidateFramebuffer(GLenum target, GLsizei numAttachments,
@@ -1642,6 +1677,15 @@ void WrappedOpenGL::glDeleteFramebuffers(GLsizei n, const GLuint *framebuffers)
   }
 
   m_Real.glDeleteFramebuffers(n, framebuffers);
+
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  for(GLsizei i = 0; bindings && i < n; i++)
+  {
+    if(framebuffers[i] == bindings->DrawFBO)
+      bindings->DrawFBO = 0;
+    if(framebuffers[i] == bindings->ReadFBO)
+      bindings->ReadFBO = 0;
+  }
 }
 
 bool WrappedOpenGL::Serialise_glGenRenderbuffers(GLsizei n, GLuint *renderbuffers)
@@ -156,6 +156,10 @@ void WrappedOpenGL::glBindSampler(GLuint unit, GLuint sampler)
 {
   m_Real.glBindSampler(unit, sampler);
 
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings && unit < (GLuint)ARRAY_COUNT(bindings->Samplers))
+    bindings->Samplers[unit] = sampler;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BIND_SAMPLER);
@@ -205,6 +209,11 @@ void WrappedOpenGL::glBindSamplers(GLuint first, GLsizei count, const GLuint *sa
 {
   m_Real.glBindSamplers(first, count, samplers);
 
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  for(GLsizei i = 0; bindings && i < count; i++)
+    if(first + i < (GLuint)ARRAY_COUNT(bindings->Samplers))
+      bindings->Samplers[first + i] = samplers ? samplers[i] : 0;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BIND_SAMPLERS);
@@ -514,4 +523,8 @@ void WrappedOpenGL::glDeleteSamplers(GLsizei n, const GLuint *ids)
   }
 
   m_Real.glDeleteSamplers(n, ids);
+
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings)
+    bindings->DeleteSamplers(n, ids);
 }
@@ -954,7 +954,13 @@ void WrappedOpenGL::glUseProgram(GLuint program)
 {
   m_Real.glUseProgram(program);
 
-  GetCtxData().m_Program = program;
+  ContextData &cd = GetCtxData();
+
+  cd.m_Program = program;
+
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  if(bindings)
+    bindings->Program = program;
 
   if(m_State == WRITING_CAPFRAME)
   {
@@ -1338,7 +1344,13 @@ void WrappedOpenGL::glBindProgramPipeline(GLuint pipeline)
 {
   m_Real.glBindProgramPipeline(pipeline);
 
-  GetCtxData().m_ProgramPipeline = pipeline;
+  ContextData &cd = GetCtxData();
+
+  cd.m_ProgramPipeline = pipeline;
+
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  if(bindings)
+    bindings->Pipeline = pipeline;
 
   if(m_State == WRITING_CAPFRAME)
   {
@@ -1398,6 +1410,11 @@ void WrappedOpenGL::glDeleteProgramPipelines(GLsizei n, const GLuint *pipelines)
   }
 
   m_Real.glDeleteProgramPipelines(n, pipelines);
+
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  for(GLsizei i = 0; bindings && i < n; i++)
+    if(pipelines[i] == bindings->Pipeline)
+      bindings->Pipeline = 0;
 }
 
 #pragma endregion
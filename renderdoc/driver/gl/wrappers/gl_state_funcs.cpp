@@ -44,6 +44,10 @@ void WrappedOpenGL::glBlendFunc(GLenum sfactor, GLenum dfactor)
 {
   m_Real.glBlendFunc(sfactor, dfactor);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetBlendFunc(-1, sfactor, dfactor, sfactor, dfactor);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BLEND_FUNC);
@@ -71,6 +75,10 @@ void WrappedOpenGL::glBlendFunci(GLuint buf, GLenum src, GLenum dst)
 {
   m_Real.glBlendFunci(buf, src, dst);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetBlendFunc((GLint)buf, src, dst, src, dst);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BLEND_FUNCI);
@@ -99,6 +107,15 @@ void WrappedOpenGL::glBlendColor(GLfloat red, GLfloat green, GLfloat blue, GLflo
 {
   m_Real.glBlendColor(red, green, blue, alpha);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    state->BlendColor[0] = red;
+    state->BlendColor[1] = green;
+    state->BlendColor[2] = blue;
+    state->BlendColor[3] = alpha;
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BLEND_COLOR);
@@ -129,6 +146,10 @@ void WrappedOpenGL::glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GL
 {
   m_Real.glBlendFuncSeparate(sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetBlendFunc(-1, sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BLEND_FUNC_SEP);
@@ -160,6 +181,10 @@ void WrappedOpenGL::glBlendFuncSeparatei(GLuint buf, GLenum sfactorRGB, GLenum d
 {
   m_Real.glBlendFuncSeparatei(buf, sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetBlendFunc((GLint)buf, sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BLEND_FUNC_SEPI);
@@ -185,6 +210,10 @@ void WrappedOpenGL::glBlendEquation(GLenum mode)
 {
   m_Real.glBlendEquation(mode);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetBlendEquation(-1, mode, mode);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BLEND_EQ);
@@ -211,6 +240,10 @@ void WrappedOpenGL::glBlendEquationi(GLuint buf, GLenum mode)
 {
   m_Real.glBlendEquationi(buf, mode);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetBlendEquation((GLint)buf, mode, mode);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BLEND_EQI);
@@ -237,6 +270,10 @@ void WrappedOpenGL::glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
 {
   m_Real.glBlendEquationSeparate(modeRGB, modeAlpha);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetBlendEquation(-1, modeRGB, modeAlpha);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BLEND_EQ_SEP);
@@ -264,6 +301,10 @@ void WrappedOpenGL::glBlendEquationSeparatei(GLuint buf, GLenum modeRGB, GLenum
 {
   m_Real.glBlendEquationSeparatei(buf, modeRGB, modeAlpha);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetBlendEquation((GLint)buf, modeRGB, modeAlpha);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BLEND_EQ_SEPI);
@@ -312,6 +353,10 @@ void WrappedOpenGL::glLogicOp(GLenum opcode)
 {
   m_Real.glLogicOp(opcode);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->LogicOp = opcode;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(LOGIC_OP);
@@ -339,6 +384,10 @@ void WrappedOpenGL::glStencilFunc(GLenum func, GLint ref, GLuint mask)
 {
   m_Real.glStencilFunc(func, ref, mask);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetStencilFunc(eGL_FRONT_AND_BACK, func, ref, mask);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(STENCIL_FUNC);
@@ -367,6 +416,10 @@ void WrappedOpenGL::glStencilFuncSeparate(GLenum face, GLenum func, GLint ref, G
 {
   m_Real.glStencilFuncSeparate(face, func, ref, mask);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetStencilFunc(face, func, ref, mask);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(STENCIL_FUNC_SEP);
@@ -392,6 +445,10 @@ void WrappedOpenGL::glStencilMask(GLuint mask)
 {
   m_Real.glStencilMask(mask);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetStencilMask(eGL_FRONT_AND_BACK, mask);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(STENCIL_MASK);
@@ -418,6 +475,10 @@ void WrappedOpenGL::glStencilMaskSeparate(GLenum face, GLuint mask)
 {
   m_Real.glStencilMaskSeparate(face, mask);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetStencilMask(face, mask);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(STENCIL_MASK_SEP);
@@ -445,6 +506,10 @@ void WrappedOpenGL::glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
 {
   m_Real.glStencilOp(fail, zfail, zpass);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetStencilOp(eGL_FRONT_AND_BACK, fail, zfail, zpass);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(STENCIL_OP);
@@ -474,6 +539,10 @@ void WrappedOpenGL::glStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail
 {
   m_Real.glStencilOpSeparate(face, sfail, dpfail, dppass);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetStencilOp(face, sfail, dpfail, dppass);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(STENCIL_OP_SEP);
@@ -502,6 +571,15 @@ void WrappedOpenGL::glClearColor(GLclampf red, GLclampf green, GLclampf blue, GL
 {
   m_Real.glClearColor(red, green, blue, alpha);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    state->ColorClearValue.red = red;
+    state->ColorClearValue.green = green;
+    state->ColorClearValue.blue = blue;
+    state->ColorClearValue.alpha = alpha;
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(CLEAR_COLOR);
@@ -527,6 +605,10 @@ void WrappedOpenGL::glClearStencil(GLint stencil)
 {
   m_Real.glClearStencil(stencil);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->StencilClearValue = (uint32_t)stencil;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(CLEAR_STENCIL);
@@ -552,6 +634,10 @@ void WrappedOpenGL::glClearDepth(GLdouble depth)
 {
   m_Real.glClearDepth(depth);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->DepthClearValue = (float)depth;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(CLEAR_DEPTH);
@@ -565,6 +651,10 @@ void WrappedOpenGL::glClearDepthf(GLfloat depth)
 {
   m_Real.glClearDepthf(depth);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->DepthClearValue = depth;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(CLEAR_DEPTH);
@@ -590,6 +680,10 @@ void WrappedOpenGL::glDepthFunc(GLenum func)
 {
   m_Real.glDepthFunc(func);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->DepthFunc = func;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DEPTH_FUNC);
@@ -615,6 +709,10 @@ void WrappedOpenGL::glDepthMask(GLboolean flag)
 {
   m_Real.glDepthMask(flag);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->DepthWriteMask = flag;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DEPTH_MASK);
@@ -639,6 +737,10 @@ void WrappedOpenGL::glDepthRange(GLdouble nearVal, GLdouble farVal)
 {
   m_Real.glDepthRange(nearVal, farVal);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetDepthRange(-1, nearVal, farVal);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DEPTH_RANGE);
@@ -663,6 +765,10 @@ void WrappedOpenGL::glDepthRangef(GLfloat nearVal, GLfloat farVal)
 {
   m_Real.glDepthRangef(nearVal, farVal);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetDepthRange(-1, nearVal, farVal);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DEPTH_RANGEF);
@@ -688,6 +794,10 @@ void WrappedOpenGL::glDepthRangeIndexed(GLuint index, GLdouble nearVal, GLdouble
 {
   m_Real.glDepthRangeIndexed(index, nearVal, farVal);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetDepthRange((GLint)index, nearVal, farVal);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DEPTH_RANGE_IDX);
@@ -717,6 +827,13 @@ void WrappedOpenGL::glDepthRangeArrayv(GLuint first, GLsizei count, const GLdoub
 {
   m_Real.glDepthRangeArrayv(first, count, v);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    for(GLsizei i = 0; i < count; i++)
+      state->SetDepthRange(GLint(first + i), v[i * 2 + 0], v[i * 2 + 1]);
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DEPTH_RANGEARRAY);
@@ -743,6 +860,13 @@ void WrappedOpenGL::glDepthBoundsEXT(GLclampd nearVal, GLclampd farVal)
 {
   m_Real.glDepthBoundsEXT(nearVal, farVal);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    state->DepthBounds.nearZ = nearVal;
+    state->DepthBounds.farZ = farVal;
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DEPTH_BOUNDS);
@@ -769,6 +893,13 @@ void WrappedOpenGL::glClipControl(GLenum origin, GLenum depth)
 {
   m_Real.glClipControl(origin, depth);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    state->ClipOrigin = origin;
+    state->ClipDepth = depth;
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(CLIP_CONTROL);
@@ -794,6 +925,10 @@ void WrappedOpenGL::glProvokingVertex(GLenum mode)
 {
   m_Real.glProvokingVertex(mode);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->ProvokingVertex = mode;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(PROVOKING_VERTEX);
@@ -819,6 +954,10 @@ void WrappedOpenGL::glPrimitiveRestartIndex(GLuint index)
 {
   m_Real.glPrimitiveRestartIndex(index);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->PrimitiveRestartIndex = index;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(PRIMITIVE_RESTART);
@@ -844,6 +983,10 @@ void WrappedOpenGL::glDisable(GLenum cap)
 {
   m_Real.glDisable(cap);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetEnabled(cap, -1, false);
+
   if(m_State == WRITING_CAPFRAME)
   {
     // Skip some compatibility caps purely for the sake of avoiding debug message spam.
@@ -880,6 +1023,10 @@ void WrappedOpenGL::glEnable(GLenum cap)
 {
   m_Real.glEnable(cap);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetEnabled(cap, -1, true);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(ENABLE);
@@ -906,6 +1053,10 @@ void WrappedOpenGL::glDisablei(GLenum cap, GLuint index)
 {
   m_Real.glDisablei(cap, index);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetEnabled(cap, (GLint)index, false);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(DISABLEI);
@@ -932,6 +1083,10 @@ void WrappedOpenGL::glEnablei(GLenum cap, GLuint index)
 {
   m_Real.glEnablei(cap, index);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetEnabled(cap, (GLint)index, true);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(ENABLEI);
@@ -957,6 +1112,10 @@ void WrappedOpenGL::glFrontFace(GLenum mode)
 {
   m_Real.glFrontFace(mode);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->FrontFace = mode;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(FRONT_FACE);
@@ -982,6 +1141,10 @@ void WrappedOpenGL::glCullFace(GLenum mode)
 {
   m_Real.glCullFace(mode);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->CullFace = mode;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(CULL_FACE);
@@ -1008,6 +1171,10 @@ void WrappedOpenGL::glHint(GLenum target, GLenum mode)
 {
   m_Real.glHint(target, mode);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetHint(target, mode);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(HINT);
@@ -1037,6 +1204,10 @@ void WrappedOpenGL::glColorMask(GLboolean red, GLboolean green, GLboolean blue,
 {
   m_Real.glColorMask(red, green, blue, alpha);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetColorMask(-1, red, green, blue, alpha);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(COLOR_MASK);
@@ -1068,6 +1239,10 @@ void WrappedOpenGL::glColorMaski(GLuint buf, GLboolean red, GLboolean green, GLb
 {
   m_Real.glColorMaski(buf, red, green, blue, alpha);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetColorMask((GLint)buf, red, green, blue, alpha);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(COLOR_MASKI);
@@ -1094,6 +1269,10 @@ void WrappedOpenGL::glSampleMaski(GLuint maskNumber, GLbitfield mask)
 {
   m_Real.glSampleMaski(maskNumber, mask);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state && maskNumber < (GLuint)ARRAY_COUNT(state->SampleMask))
+    state->SampleMask[maskNumber] = mask;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(SAMPLE_MASK);
@@ -1120,6 +1299,13 @@ void WrappedOpenGL::glSampleCoverage(GLfloat value, GLboolean invert)
 {
   m_Real.glSampleCoverage(value, invert);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    state->SampleCoverage = value;
+    state->SampleCoverageInvert = (invert == GL_TRUE);
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(SAMPLE_COVERAGE);
@@ -1145,6 +1331,10 @@ void WrappedOpenGL::glMinSampleShading(GLfloat value)
 {
   m_Real.glMinSampleShading(value);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->MinSampleShading = value;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(MIN_SAMPLE_SHADING);
@@ -1171,6 +1361,13 @@ void WrappedOpenGL::glRasterSamplesEXT(GLuint samples, GLboolean fixedsampleloca
 {
   m_Real.glRasterSamplesEXT(samples, fixedsamplelocations);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    state->RasterSamples = samples;
+    state->RasterFixed = (fixedsamplelocations == GL_TRUE);
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(RASTER_SAMPLES);
@@ -1197,6 +1394,10 @@ void WrappedOpenGL::glPatchParameteri(GLenum pname, GLint value)
 {
   m_Real.glPatchParameteri(pname, value);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state && pname == eGL_PATCH_VERTICES)
+    state->PatchParams.numVerts = value;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(PATCH_PARAMI);
@@ -1226,6 +1427,15 @@ void WrappedOpenGL::glPatchParameterfv(GLenum pname, const GLfloat *values)
 {
   m_Real.glPatchParameterfv(pname, values);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    if(pname == eGL_PATCH_DEFAULT_INNER_LEVEL)
+      memcpy(state->PatchParams.defaultInnerLevel, values, sizeof(float) * 2);
+    else if(pname == eGL_PATCH_DEFAULT_OUTER_LEVEL)
+      memcpy(state->PatchParams.defaultOuterLevel, values, sizeof(float) * 4);
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(PATCH_PARAMFV);
@@ -1251,6 +1461,10 @@ void WrappedOpenGL::glLineWidth(GLfloat width)
 {
   m_Real.glLineWidth(width);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->LineWidth = width;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(LINE_WIDTH);
@@ -1276,6 +1490,10 @@ void WrappedOpenGL::glPointSize(GLfloat size)
 {
   m_Real.glPointSize(size);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->PointSize = size;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(POINT_SIZE);
@@ -1319,6 +1537,10 @@ void WrappedOpenGL::glPointParameteri(GLenum pname, GLint param)
 {
   m_Real.glPointParameteri(pname, param);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetPointParameter(pname, (GLfloat)param);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(POINT_PARAMI);
@@ -1345,6 +1567,10 @@ void WrappedOpenGL::glPointParameteriv(GLenum pname, const GLint *params)
 {
   m_Real.glPointParameteriv(pname, params);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetPointParameter(pname, (GLfloat)params[0]);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(POINT_PARAMIV);
@@ -1371,6 +1597,10 @@ void WrappedOpenGL::glPointParameterf(GLenum pname, GLfloat param)
 {
   m_Real.glPointParameterf(pname, param);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetPointParameter(pname, param);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(POINT_PARAMF);
@@ -1397,6 +1627,10 @@ void WrappedOpenGL::glPointParameterfv(GLenum pname, const GLfloat *params)
 {
   m_Real.glPointParameterfv(pname, params);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->SetPointParameter(pname, params[0]);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(POINT_PARAMFV);
@@ -1425,6 +1659,13 @@ void WrappedOpenGL::glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
 {
   m_Real.glViewport(x, y, width, height);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    const GLfloat v[4] = {(GLfloat)x, (GLfloat)y, (GLfloat)width, (GLfloat)height};
+    state->SetViewport(-1, v);
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(VIEWPORT);
@@ -1454,6 +1695,13 @@ void WrappedOpenGL::glViewportArrayv(GLuint index, GLuint count, const GLfloat *
 {
   m_Real.glViewportArrayv(index, count, v);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    for(GLuint i = 0; i < count; i++)
+      state->SetViewport(GLint(index + i), v + i * 4);
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(VIEWPORT_ARRAY);
@@ -1493,6 +1741,13 @@ void WrappedOpenGL::glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
 {
   m_Real.glScissor(x, y, width, height);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    const GLint v[4] = {x, y, width, height};
+    state->SetScissor(-1, v);
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(SCISSOR);
@@ -1522,6 +1777,13 @@ void WrappedOpenGL::glScissorArrayv(GLuint first, GLsizei count, const GLint *v)
 {
   m_Real.glScissorArrayv(first, count, v);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    for(GLsizei i = 0; i < count; i++)
+      state->SetScissor(GLint(first + i), v + i * 4);
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(SCISSOR_ARRAY);
@@ -1560,6 +1822,10 @@ void WrappedOpenGL::glPolygonMode(GLenum face, GLenum mode)
 {
   m_Real.glPolygonMode(face, mode);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->PolygonMode = mode;
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(POLYGON_MODE);
@@ -1586,6 +1852,13 @@ void WrappedOpenGL::glPolygonOffset(GLfloat factor, GLfloat units)
 {
   m_Real.glPolygonOffset(factor, units);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    state->PolygonOffset[0] = factor;
+    state->PolygonOffset[1] = units;
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(POLYGON_OFFSET);
@@ -1613,6 +1886,14 @@ void WrappedOpenGL::glPolygonOffsetClampEXT(GLfloat factor, GLfloat units, GLflo
 {
   m_Real.glPolygonOffsetClampEXT(factor, units, clamp);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+  {
+    state->PolygonOffset[0] = factor;
+    state->PolygonOffset[1] = units;
+    state->PolygonOffset[2] = clamp;
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(POLYGON_OFFSET_CLAMP);
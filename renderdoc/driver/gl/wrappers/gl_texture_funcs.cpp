@@ -182,6 +182,10 @@ void WrappedOpenGL::glDeleteTextures(GLsizei n, const GLuint *textures)
   }
 
   m_Real.glDeleteTextures(n, textures);
+
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings)
+    bindings->DeleteTextures(n, textures);
 }
 
 bool WrappedOpenGL::Serialise_glBindTexture(GLenum target, GLuint texture)
@@ -226,6 +230,10 @@ void WrappedOpenGL::glBindTexture(GLenum target, GLuint texture)
 {
   m_Real.glBindTexture(target, texture);
 
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings)
+    bindings->BindTexture(GLuint(bindings->ActiveTexture - eGL_TEXTURE0), target, texture);
+
   if(texture != 0 && GetResourceManager()->GetID(TextureRes(GetCtx(), texture)) == ResourceId())
     return;
 
@@ -330,6 +338,9 @@ void WrappedOpenGL::glBindTextures(GLuint first, GLsizei count, const GLuint *te
 {
   m_Real.glBindTextures(first, count, textures);
 
+  for(GLsizei i = 0; i < count; i++)
+    TrackTextureUnitBinding(first + i, textures ? textures[i] : 0);
+
   if(m_State == WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BIND_TEXTURES);
@@ -394,6 +405,10 @@ void WrappedOpenGL::glBindMultiTextureEXT(GLenum texunit, GLenum target, GLuint
 {
   m_Real.glBindMultiTextureEXT(texunit, target, texture);
 
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings)
+    bindings->BindTexture(GLuint(texunit - eGL_TEXTURE0), target, texture);
+
   if(texture != 0 && GetResourceManager()->GetID(TextureRes(GetCtx(), texture)) == ResourceId())
     return;
 
@@ -479,6 +494,8 @@ void WrappedOpenGL::glBindTextureUnit(GLuint unit, GLuint texture)
 {
   m_Real.glBindTextureUnit(unit, texture);
 
+  TrackTextureUnitBinding(unit, texture);
+
   if(texture != 0 && GetResourceManager()->GetID(TextureRes(GetCtx(), texture)) == ResourceId())
     return;
 
@@ -533,6 +550,17 @@ void WrappedOpenGL::glBindImageTexture(GLuint unit, GLuint texture, GLint level,
 {
   m_Real.glBindImageTexture(unit, texture, level, layered, layer, access, format);
 
+  GLRenderState *bindings = GetCtxData().GetTrackedBindings();
+  if(bindings && unit < (GLuint)ARRAY_COUNT(bindings->Images))
+  {
+    bindings->Images[unit].name = texture;
+    bindings->Images[unit].level = (uint32_t)level;
+    bindings->Images[unit].layered = (layered == GL_TRUE);
+    bindings->Images[unit].layer = (uint32_t)layer;
+    bindings->Images[unit].access = access;
+    bindings->Images[unit].format = format;
+  }
+
   if(m_State == WRITING_CAPFRAME)
   {
     Chunk *chunk = NULL;
@@ -594,6 +622,37 @@ void WrappedOpenGL::glBindImageTextures(GLuint first, GLsizei count, const GLuin
 {
   m_Real.glBindImageTextures(first, count, textures);
 
+  ContextData &cd = GetCtxData();
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  for(GLsizei i = 0; bindings && i < count; i++)
+  {
+    GLuint unit = first + i;
+    if(unit >= (GLuint)ARRAY_COUNT(bindings->Images))
+      break;
+
+    GLuint tex = textures ? textures[i] : 0;
+
+    // the multi-bind uses fixed parameters, and the format of the texture's base level
+    GLenum format = eGL_R8;
+    if(tex)
+    {
+      auto it = m_Textures.find(GetResourceManager()->GetID(TextureRes(GetCtx(), tex)));
+      if(it == m_Textures.end() || it->second.internalFormat == eGL_NONE)
+      {
+        cd.m_BindingStateValid = false;
+        break;
+      }
+      format = it->second.internalFormat;
+    }
+
+    bindings->Images[unit].name = tex;
+    bindings->Images[unit].level = 0;
+    bindings->Images[unit].layered = (tex != 0);
+    bindings->Images[unit].layer = 0;
+    bindings->Images[unit].access = tex ? eGL_READ_WRITE : eGL_READ_ONLY;
+    bindings->Images[unit].format = format;
+  }
+
   if(m_State >= WRITING_CAPFRAME)
   {
     SCOPED_SERIALISE_CONTEXT(BIND_IMAGE_TEXTURES);
@@ -1873,6 +1932,10 @@ void WrappedOpenGL::glPixelStorei(GLenum pname, GLint param)
 {
   m_Real.glPixelStorei(pname, param);
 
+  GLRenderState *state = GetCtxData().GetTrackedState();
+  if(state)
+    state->Unpack.Store(pname, param);
+
   // except for capturing frames we ignore this and embed the relevant
   // parameters in the chunks that reference them.
   if(m_State == WRITING_CAPFRAME)
@@ -1899,11 +1962,39 @@ bool WrappedOpenGL::Serialise_glActiveTexture(GLenum texture)
   return true;
 }
 
+void WrappedOpenGL::TrackTextureUnitBinding(GLuint unit, GLuint texture)
+{
+  ContextData &cd = GetCtxData();
+
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  if(bindings == NULL)
+    return;
+
+  if(texture == 0)
+  {
+    bindings->UnbindTextureUnit(unit);
+    return;
+  }
+
+  // the target isn't given, so use the type the texture was created or first bound with
+  GLResourceRecord *record = GetResourceManager()->GetResourceRecord(TextureRes(GetCtx(), texture));
+  if(record && record->datatype)
+    bindings->BindTexture(unit, TextureTarget(record->datatype), texture);
+  else
+    cd.m_BindingStateValid = false;
+}
+
 void WrappedOpenGL::glActiveTexture(GLenum texture)
 {
   m_Real.glActiveTexture(texture);
 
-  GetCtxData().m_TextureUnit = texture - eGL_TEXTURE0;
+  ContextData &cd = GetCtxData();
+
+  cd.m_TextureUnit = texture - eGL_TEXTURE0;
+
+  GLRenderState *bindings = cd.GetTrackedBindings();
+  if(bindings)
+    bindings->ActiveTexture = texture;
 
   if(m_State == WRITING_CAPFRAME)
   {
@@ -258,8 +258,13 @@ WrappedVulkan::WrappedVulkan(const char *logFilename) : m_RenderState(&m_Creatio
   {
     m_State = WRITING_IDLE;
     m_pSerialiser = new Serialiser(NULL, Serialiser::WRITING, debugSerialiser);
+    m_pSerialiser->SetBlobStorage(true);
   }
 
+  m_CapTransitionLock.SetName("WrappedVulkan::m_CapTransitionLock");
+  m_CoherentMapsLock.SetName("WrappedVulkan::m_CoherentMapsLock");
+  m_ImageLayoutsLock.SetName("WrappedVulkan::m_ImageLayoutsLock");
+
   InitSPIRVCompiler();
   RenderDoc::Inst().RegisterShutdownFunction(&ShutdownSPIRVCompiler);
 
@@ -289,6 +294,8 @@ WrappedVulkan::WrappedVulkan(const char *logFilename) : m_RenderState(&m_Creatio
 
   m_SetDeviceLoaderData = NULL;
 
+  m_CurInitStateBatch = 0;
+
   m_ResourceManager = new VulkanResourceManager(m_State, m_pSerialiser, this);
 
   m_DebugManager = NULL;
@@ -632,6 +639,7 @@ Serialiser *WrappedVulkan::GetThreadSerialiser()
 
   ser = new Serialiser(NULL, Serialiser::WRITING, debugSerialiser);
   ser->SetUserData(m_ResourceManager);
+  ser->SetBlobStorage(true);
 
   ser->SetChunkNameLookup(&GetChunkName);
 
@@ -824,6 +832,7 @@ void WrappedVulkan::EndCaptureFrame(VkImage presentImage)
   SCOPED_SERIALISE_CONTEXT(CONTEXT_CAPTURE_FOOTER);
 
   SERIALISE_ELEMENT(ResourceId, bbid, GetResID(presentImage));
+  SERIALISE_ELEMENT(uint32_t, FrameNumber, m_FrameCounter);
 
   bool HasCallstack = RenderDoc::Inst().GetCaptureOptions().CaptureCallstacks != 0;
   localSerialiser->Serialise("HasCallstack", HasCallstack);
@@ -929,6 +938,8 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
   if(m_State != WRITING_IDLE)
     return;
 
+  RDCTRACE_ZONE("WrappedVulkan::StartFrameCapture");
+
   RenderDoc::Inst().SetCurrentDriver(RDC_Vulkan);
 
   m_AppControlledCapture = true;
@@ -954,6 +965,10 @@ void WrappedVulkan::StartFrameCapture(void *dev, void *wnd)
     SCOPED_LOCK(m_CapTransitionLock);
     GetResourceManager()->PrepareInitialContents();
 
+    // wait for the remaining batched readbacks before the application can modify or destroy
+    // any of the resources they copy from
+    FlushInitStateBatches();
+
     RDCDEBUG("Attempting capture");
     m_FrameCaptureRecord->DeleteChunks();
 
@@ -981,6 +996,8 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
   if(m_State != WRITING_CAPFRAME)
     return true;
 
+  RDCTRACE_ZONE("WrappedVulkan::EndFrameCapture");
+
   VkSwapchainKHR swap = VK_NULL_HANDLE;
 
   if(wnd)
@@ -1050,6 +1067,17 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
 
     // m_SuccessfulCapture = false;
 
+    {
+      SCOPED_LOCK(m_MemoryBindingsLock);
+      for(auto it = m_PendingMemoryUnbinds.begin(); it != m_PendingMemoryUnbinds.end(); ++it)
+      {
+        auto bindit = m_MemoryBindings.find(it->first);
+        if(bindit != m_MemoryBindings.end())
+          bindit->second.ranges.erase(it->second);
+      }
+      m_PendingMemoryUnbinds.clear();
+    }
+
     ObjDisp(GetDev())->DeviceWaitIdle(Unwrap(GetDev()));
 
     {
@@ -1067,10 +1095,10 @@ bool WrappedVulkan::EndFrameCapture(void *dev, void *wnd)
   uint32_t thwidth = 0;
   uint32_t thheight = 0;
 
-  // gather backbuffer screenshot
+  // gather backbuffer screenshot, flight recorder frames are kept in memory without one
   const uint32_t maxSize = 2048;
 
-  if(swap != VK_NULL_HANDLE)
+  if(swap != VK_NULL_HANDLE && !RenderDoc::Inst().IsFlightRecordingFrame())
   {
     VkDevice device = GetDev();
     VkCommandBuffer cmd = GetNextCmd();
@@ -1433,18 +1461,12 @@ void WrappedVulkan::ReadLogInitialisation()
 
   int chunkIdx = 0;
 
-  struct chunkinfo
-  {
-    chunkinfo() : count(0), totalsize(0), total(0.0) {}
-    int count;
-    uint64_t totalsize;
-    double total;
-  };
-
-  map<VulkanChunkType, chunkinfo> chunkInfos;
+  map<VulkanChunkType, FetchChunkLoadStats> chunkInfos;
 
   SCOPED_TIMER("chunk initialisation");
 
+  PerformanceTimer loadTimer;
+
   for(;;)
   {
     PerformanceTimer timer;
@@ -1473,9 +1495,17 @@ void WrappedVulkan::ReadLogInitialisation()
 
     uint64_t offset2 = m_pSerialiser->GetOffset();
 
-    chunkInfos[context].total += timer.GetMilliseconds();
-    chunkInfos[context].totalsize += offset2 - offset;
-    chunkInfos[context].count++;
+    FetchChunkLoadStats &stats = chunkInfos[context];
+
+    if(stats.count == 0)
+    {
+      stats.chunkID = uint32_t(context);
+      stats.name = GetChunkName(context);
+    }
+
+    stats.totalTime += timer.GetMilliseconds();
+    stats.totalSize += offset2 - offset;
+    stats.count++;
 
     if(context == CAPTURE_SCOPE)
     {
@@ -1495,18 +1525,25 @@ void WrappedVulkan::ReadLogInitialisation()
     double dcount = double(it->second.count);
 
     RDCDEBUG(
-        "% 5d chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
-        it->second.count, it->second.total, it->second.total / dcount,
-        double(it->second.totalsize) / (1024.0 * 1024.0),
-        double(it->second.totalsize) / (dcount * 1024.0 * 1024.0), GetChunkName(it->first),
-        uint32_t(it->first));
+        "% 5u chunks - Time: %9.3fms total/%9.3fms avg - Size: %8.3fMB total/%7.3fMB avg - %s (%u)",
+        it->second.count, it->second.totalTime, it->second.totalTime / dcount,
+        double(it->second.totalSize) / (1024.0 * 1024.0),
+        double(it->second.totalSize) / (dcount * 1024.0 * 1024.0), it->second.name.c_str(),
+        it->second.chunkID);
   }
 #endif
 
   m_FrameRecord.frameInfo.uncompressedFileSize = m_pSerialiser->GetSize();
   m_FrameRecord.frameInfo.compressedFileSize = m_pSerialiser->GetFileSize();
   m_FrameRecord.frameInfo.persistentSize = m_pSerialiser->GetSize() - firstFrame;
-  m_FrameRecord.frameInfo.initDataSize = chunkInfos[(VulkanChunkType)INITIAL_CONTENTS].totalsize;
+  m_FrameRecord.frameInfo.initDataSize = chunkInfos[(VulkanChunkType)INITIAL_CONTENTS].totalSize;
+
+  m_FrameRecord.loadProfile.totalTime = loadTimer.GetMilliseconds();
+  m_FrameRecord.loadProfile.fileReadTime = m_pSerialiser->GetFileReadTime();
+  m_FrameRecord.loadProfile.decompressTime = m_pSerialiser->GetDecompressTime();
+  m_FrameRecord.loadProfile.initialContentsTime =
+      chunkInfos[(VulkanChunkType)INITIAL_CONTENTS].totalTime;
+  FillLoadProfileChunks(m_FrameRecord.loadProfile, chunkInfos);
 
   RDCDEBUG("Allocating %llu persistant bytes of memory for the log.",
            m_pSerialiser->GetSize() - firstFrame);
@@ -1534,10 +1571,14 @@ void WrappedVulkan::ContextReplayLog(LogState readType, uint32_t startEventID, u
   // (not undefined)
   if(readType == READING)
   {
+    PerformanceTimer applyTimer;
+
     ApplyInitialContents();
 
     SubmitCmds();
     FlushQ();
+
+    m_FrameRecord.loadProfile.initialContentsApplyTime = applyTimer.GetMilliseconds();
   }
 
   m_pSerialiser->PopContext(header);
@@ -1570,6 +1611,7 @@ void WrappedVulkan::ContextReplayLog(LogState readType, uint32_t startEventID, u
     m_RootDrawcallID = 1;
     m_FirstEventID = 0;
     m_LastEventID = ~0U;
+    m_ReadFrames.clear();
   }
 
   for(;;)
@@ -1591,9 +1633,9 @@ void WrappedVulkan::ContextReplayLog(LogState readType, uint32_t startEventID, u
 
     RenderDoc::Inst().SetProgress(FileInitialRead, float(offset) / float(m_pSerialiser->GetSize()));
 
-    // for now just abort after capture scope. Really we'd need to support multiple frames
-    // but for now this will do.
-    if(context == CONTEXT_CAPTURE_FOOTER)
+    // captures spanning several frames have a footer at the end of each frame, only the last
+    // one ends the capture
+    if(context == CONTEXT_CAPTURE_FOOTER && m_pSerialiser->AtEnd())
       break;
 
     // break out if we were only executing one event
@@ -1623,6 +1665,7 @@ void WrappedVulkan::ContextReplayLog(LogState readType, uint32_t startEventID, u
   if(m_State == READING)
   {
     GetFrameRecord().drawcallList = m_ParentDrawcall.Bake();
+    GetFrameRecord().frames = m_ReadFrames;
 
     SetupDrawcallPointers(&m_Drawcalls, GetFrameRecord().drawcallList, NULL, NULL);
 
@@ -1699,9 +1742,81 @@ void WrappedVulkan::ApplyInitialContents()
   SubmitCmds();
   FlushQ();
 
+  m_InitialContentsArena.preBarriers.clear();
+  m_InitialContentsArena.postBarriers.clear();
+
+  // the first time through, record the copies for every uploaded initial state
+  if(!m_InitialContentsArena.copiesRecorded)
+  {
+    if(m_InitialContentsArena.copyCmd == VK_NULL_HANDLE)
+    {
+      VkCommandBufferAllocateInfo cmdInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO, NULL,
+                                             Unwrap(m_InternalCmds.cmdpool),
+                                             VK_COMMAND_BUFFER_LEVEL_SECONDARY, 1};
+      vkr = ObjDisp(m_Device)->AllocateCommandBuffers(Unwrap(m_Device), &cmdInfo,
+                                                      &m_InitialContentsArena.copyCmd);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+      if(m_SetDeviceLoaderData)
+        m_SetDeviceLoaderData(m_Device, m_InitialContentsArena.copyCmd);
+      else
+        SetDispatchTableOverMagicNumber(m_Device, m_InitialContentsArena.copyCmd);
+
+      GetResourceManager()->WrapResource(Unwrap(m_Device), m_InitialContentsArena.copyCmd);
+    }
+
+    VkCommandBufferInheritanceInfo inheritInfo = {
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        NULL,
+        VK_NULL_HANDLE,
+        0,
+        VK_NULL_HANDLE,
+        VK_FALSE,
+        0,
+        0,
+    };
+
+    VkCommandBufferBeginInfo copyBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL, 0,
+                                              &inheritInfo};
+
+    vkr = ObjDisp(m_InitialContentsArena.copyCmd)
+              ->BeginCommandBuffer(Unwrap(m_InitialContentsArena.copyCmd), &copyBeginInfo);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  }
+
   // actually apply the initial contents here
   GetResourceManager()->ApplyInitialContents();
 
+  if(!m_InitialContentsArena.copiesRecorded)
+  {
+    vkr = ObjDisp(m_InitialContentsArena.copyCmd)
+              ->EndCommandBuffer(Unwrap(m_InitialContentsArena.copyCmd));
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    m_InitialContentsArena.copiesRecorded = true;
+  }
+
+  // restore all uploaded image and memory contents together, surrounded by the image
+  // transitions gathered while applying
+  cmd = GetNextCmd();
+
+  vkr = ObjDisp(cmd)->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  if(!m_InitialContentsArena.preBarriers.empty())
+    DoPipelineBarrier(cmd, (uint32_t)m_InitialContentsArena.preBarriers.size(),
+                      &m_InitialContentsArena.preBarriers[0]);
+
+  VkCommandBuffer copyCmd = Unwrap(m_InitialContentsArena.copyCmd);
+  ObjDisp(cmd)->CmdExecuteCommands(Unwrap(cmd), 1, &copyCmd);
+
+  if(!m_InitialContentsArena.postBarriers.empty())
+    DoPipelineBarrier(cmd, (uint32_t)m_InitialContentsArena.postBarriers.size(),
+                      &m_InitialContentsArena.postBarriers[0]);
+
+  vkr = ObjDisp(cmd)->EndCommandBuffer(Unwrap(cmd));
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
   // likewise again to make sure the initial states are all applied
   cmd = GetNextCmd();
 
@@ -2064,6 +2179,7 @@ void WrappedVulkan::ProcessChunk(uint64_t offset, VulkanChunkType context)
       Serialiser *localSerialiser = GetMainSerialiser();
 
       SERIALISE_ELEMENT(ResourceId, bbid, ResourceId());
+      SERIALISE_ELEMENT(uint32_t, FrameNumber, 0);
 
       bool HasCallstack = false;
       localSerialiser->Serialise("HasCallstack", HasCallstack);
@@ -2091,6 +2207,13 @@ void WrappedVulkan::ProcessChunk(uint64_t offset, VulkanChunkType context)
         draw.copyDestination = bbid;
 
         AddDrawcall(draw, true);
+
+        FetchCapturedFrame frame;
+        frame.frameNumber = FrameNumber;
+        frame.firstEvent = m_ReadFrames.empty() ? m_FrameRecord.frameInfo.firstEvent
+                                                : m_ReadFrames.back().lastEvent + 1;
+        frame.lastEvent = m_RootEventID;
+        m_ReadFrames.push_back(frame);
       }
       break;
     }
@@ -2110,6 +2233,8 @@ void WrappedVulkan::ProcessChunk(uint64_t offset, VulkanChunkType context)
 
 void WrappedVulkan::ReplayLog(uint32_t startEventID, uint32_t endEventID, ReplayLogType replayType)
 {
+  RDCTRACE_ZONE("WrappedVulkan::ReplayLog");
+
   uint64_t offs = m_FrameRecord.frameInfo.fileOffset;
 
   m_pSerialiser->SetOffset(offs);
@@ -44,7 +44,7 @@ struct VkInitParams : public RDCInitParams
 
   void Set(const VkInstanceCreateInfo *pCreateInfo, ResourceId inst);
 
-  static const uint32_t VK_SERIALISE_VERSION = 0x0000005;
+  static const uint32_t VK_SERIALISE_VERSION = 0x0000007;
 
   // version number internal to vulkan stream
   uint32_t SerialiseVersion;
@@ -252,6 +252,8 @@ private:
   vector<FetchFrameInfo> m_CapturedFrames;
   FetchFrameRecord m_FrameRecord;
   vector<FetchDrawcall *> m_Drawcalls;
+  // each frame's footer read so far, while reading the log
+  vector<FetchCapturedFrame> m_ReadFrames;
 
   struct PhysicalDeviceData
   {
@@ -346,9 +348,95 @@ private:
     // -> FlushQ() ----back to freesems-------^
   } m_InternalCmds;
 
+  // initial state readbacks for images and memory at capture start are batched. Each readback is
+  // sub-allocated from a persistently mapped staging block and its copies are recorded into the
+  // batch's command buffer. A full batch is submitted with a fence and we swap to the other one,
+  // so the CPU serialises one batch's data while the GPU is still copying the next.
+  struct InitStateReadback
+  {
+    ResourceId id;
+    VkResourceType type;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+  };
+
+  struct InitStateBatch
+  {
+    InitStateBatch()
+        : cmd(VK_NULL_HANDLE),
+          fence(VK_NULL_HANDLE),
+          mem(VK_NULL_HANDLE),
+          buf(VK_NULL_HANDLE),
+          data(NULL),
+          used(0),
+          submitted(false)
+    {
+    }
+
+    VkCommandBuffer cmd;
+    VkFence fence;
+    VkDeviceMemory mem;
+    VkBuffer buf;
+    byte *data;
+    VkDeviceSize used;
+    bool submitted;
+
+    vector<InitStateReadback> readbacks;
+    // temporary buffers used by the recorded copies, destroyed once the batch has completed
+    vector<VkBuffer> tempBufs;
+  };
+
+  InitStateBatch m_InitStateBatches[2];
+  int m_CurInitStateBatch;
+
+  InitStateBatch *BatchInitStateReadback(ResourceId id, VkResourceType type, VkDeviceSize size,
+                                         VkDeviceSize &offset);
+  void SubmitInitStateBatch(InitStateBatch &batch);
+  void CompleteInitStateBatch(InitStateBatch &batch);
+  void FlushInitStateBatches();
+  bool Serialise_BatchedInitialState(ResourceId resid, VkResourceType restype, byte *data,
+                                     uint32_t dataSize);
+  void GetReferencedMemoryRegions(ResourceId mem, VkDeviceSize memSize,
+                                  vector<VkBufferCopy> &regions);
+  void Serialise_MemoryInitialRegions(byte *data, vector<VkBufferCopy> &regions);
+
   vector<VkDeviceMemory> m_CleanupMems;
   vector<VkEvent> m_CleanupEvents;
 
+  // on replay, the upload buffers holding image and memory initial contents are sub-allocated
+  // from a few large blocks rather than each getting a dedicated allocation. The copies that
+  // restore them never change, so they're recorded once into a secondary command buffer that is
+  // re-executed on every ApplyInitialContents. Only the layout transitions around it, which
+  // depend on the current image layouts, are rebuilt each time.
+  struct
+  {
+    void Reset()
+    {
+      mem = VK_NULL_HANDLE;
+      memIndex = 0;
+      size = used = 0;
+      data = NULL;
+      copyCmd = VK_NULL_HANDLE;
+      copiesRecorded = false;
+      preBarriers.clear();
+      postBarriers.clear();
+    }
+
+    // current block being sub-allocated. Blocks are freed via m_CleanupMems
+    VkDeviceMemory mem;
+    uint32_t memIndex;
+    VkDeviceSize size, used;
+    byte *data;
+
+    VkCommandBuffer copyCmd;
+    bool copiesRecorded;
+
+    vector<VkImageMemoryBarrier> preBarriers;
+    vector<VkImageMemoryBarrier> postBarriers;
+  } m_InitialContentsArena;
+
+  byte *BindInitialContentsUpload(VkBuffer buf);
+
   const VkPhysicalDeviceFeatures &GetDeviceFeatures() { return m_PhysicalDeviceData.features; }
   const VkPhysicalDeviceProperties &GetDeviceProps() { return m_PhysicalDeviceData.props; }
   VkDriverInfo GetDriverVersion() { return VkDriverInfo(m_PhysicalDeviceData.props); }
@@ -544,6 +632,15 @@ private:
   map<ResourceId, ImageLayouts> m_ImageLayouts;
   Threading::CriticalSection m_ImageLayoutsLock;
 
+  // capture-side only, what is bound where in each memory object
+  map<ResourceId, MemoryBindings> m_MemoryBindings;
+  // memory -> resource bindings removed during a captured frame, applied once it ends
+  vector<pair<ResourceId, ResourceId> > m_PendingMemoryUnbinds;
+  Threading::CriticalSection m_MemoryBindingsLock;
+
+  void AddMemoryBinding(ResourceId mem, ResourceId res, VkDeviceSize offset, VkDeviceSize size);
+  void RemoveMemoryBinding(ResourceId mem, ResourceId res);
+
   // find swapchain for an image
   map<RENDERDOC_WindowHandle, VkSwapchainKHR> m_SwapLookup;
   Threading::CriticalSection m_SwapLookupLock;
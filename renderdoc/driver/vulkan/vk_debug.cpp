@@ -2448,14 +2448,10 @@ VulkanDebugManager::~VulkanDebugManager()
   }
 
   for(auto it = m_PostVSData.begin(); it != m_PostVSData.end(); ++it)
-  {
-    m_pDriver->vkDestroyBuffer(dev, it->second.vsout.buf, NULL);
-    m_pDriver->vkDestroyBuffer(dev, it->second.vsout.idxBuf, NULL);
-    m_pDriver->vkFreeMemory(dev, it->second.vsout.bufmem, NULL);
-    m_pDriver->vkFreeMemory(dev, it->second.vsout.idxBufMem, NULL);
-  }
+    FreePostVSBuffers(it->second);
 
   m_PostVSData.clear();
+  m_PostVSCache.Clear();
 
   // since we don't have properly registered resources, releasing our descriptor
   // pool here won't remove the descriptor sets, so we need to free our own
@@ -7769,6 +7765,14 @@ static void AddOutputDumping(const ShaderReflection &refl, const char *entryName
   spirv[3] = idBound;
 }
 
+void VulkanDebugManager::FreePostVSBuffers(VulkanPostVSData &data)
+{
+  m_pDriver->vkDestroyBuffer(m_Device, data.vsout.buf, NULL);
+  m_pDriver->vkDestroyBuffer(m_Device, data.vsout.idxBuf, NULL);
+  m_pDriver->vkFreeMemory(m_Device, data.vsout.bufmem, NULL);
+  m_pDriver->vkFreeMemory(m_Device, data.vsout.idxBufMem, NULL);
+}
+
 void VulkanDebugManager::InitPostVSBuffers(uint32_t eventID)
 {
   // go through any aliasing
@@ -7776,8 +7780,67 @@ void VulkanDebugManager::InitPostVSBuffers(uint32_t eventID)
     eventID = m_PostVSAlias[eventID];
 
   if(m_PostVSData.find(eventID) != m_PostVSData.end())
+  {
+    m_PostVSCache.Touch(eventID);
+    return;
+  }
+
+  GeneratePostVSBuffers(eventID);
+
+  auto it = m_PostVSData.find(eventID);
+  if(it == m_PostVSData.end())
     return;
 
+  VkBuffer bufs[] = {it->second.vsout.buf, it->second.vsout.idxBuf};
+
+  uint64_t bytes = 0;
+  for(size_t i = 0; i < ARRAY_COUNT(bufs); i++)
+  {
+    if(bufs[i] == VK_NULL_HANDLE)
+      continue;
+
+    VkMemoryRequirements mrq = {0};
+    m_pDriver->vkGetBufferMemoryRequirements(m_Device, bufs[i], &mrq);
+    bytes += mrq.size;
+  }
+
+  m_PostVSCache.Add(eventID, bytes);
+
+  TrimPostVSBuffers();
+}
+
+void VulkanDebugManager::BeginPostVSPass(const vector<uint32_t> &events)
+{
+  m_PostVSCache.BeginDeferTrim(events);
+}
+
+void VulkanDebugManager::EndPostVSPass()
+{
+  m_PostVSCache.EndDeferTrim();
+
+  TrimPostVSBuffers();
+}
+
+void VulkanDebugManager::TrimPostVSBuffers()
+{
+  // free the least recently used data if we've gone over budget
+  vector<uint32_t> evicted = m_PostVSCache.Trim();
+
+  if(!evicted.empty())
+  {
+    // make sure no previous mesh rendering is still using the buffers
+    m_pDriver->FlushQ();
+
+    for(size_t i = 0; i < evicted.size(); i++)
+    {
+      FreePostVSBuffers(m_PostVSData[evicted[i]]);
+      m_PostVSData.erase(evicted[i]);
+    }
+  }
+}
+
+void VulkanDebugManager::GeneratePostVSBuffers(uint32_t eventID)
+{
   if(!m_pDriver->GetDeviceFeatures().vertexPipelineStoresAndAtomics)
     return;
 
@@ -8522,7 +8585,10 @@ MeshFormat VulkanDebugManager::GetPostVSBuffers(uint32_t eventID, uint32_t instI
   RDCEraseEl(postvs);
 
   if(m_PostVSData.find(eventID) != m_PostVSData.end())
+  {
     postvs = m_PostVSData[eventID];
+    m_PostVSCache.Touch(eventID);
+  }
 
   VulkanPostVSData::StageData s = postvs.GetStage(stage);
 
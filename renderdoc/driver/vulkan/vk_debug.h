@@ -115,6 +115,10 @@ public:
 
   void InitPostVSBuffers(uint32_t eventID);
 
+  // while generating a whole pass, freeing over-budget data is held back until the replay is done
+  void BeginPostVSPass(const vector<uint32_t> &events);
+  void EndPostVSPass();
+
   // indicates that EID alias is the same as eventID
   void AliasPostVSBuffers(uint32_t eventID, uint32_t alias) { m_PostVSAlias[alias] = eventID; }
   MeshFormat GetPostVSBuffers(uint32_t eventID, uint32_t instID, MeshDataStage stage);
@@ -371,6 +375,11 @@ private:
 
   map<uint32_t, VulkanPostVSData> m_PostVSData;
   map<uint32_t, uint32_t> m_PostVSAlias;
+  PostVSCacheLRU m_PostVSCache;
+
+  void GeneratePostVSBuffers(uint32_t eventID);
+  void FreePostVSBuffers(VulkanPostVSData &data);
+  void TrimPostVSBuffers();
 
   WrappedVulkan *m_pDriver;
   VulkanResourceManager *m_ResourceManager;
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <map>
 #include <unordered_map>
 #include "common/threading.h"
 #include "os/os_specific.h"
@@ -160,30 +161,170 @@ void InitDeviceExtensionTables(VkDevice device)
 
 #undef DeviceGPA
 
-static Threading::CriticalSection devlock;
-std::map<void *, VkLayerDispatchTableExtended> devlookup;
-
-static Threading::CriticalSection instlock;
-std::map<void *, VkLayerInstanceDispatchTableExtended> instlookup;
-
 static void *GetKey(void *obj)
 {
   VkLayerDispatchTable **tablePtr = (VkLayerDispatchTable **)obj;
   return (void *)*tablePtr;
 }
 
-void InitDeviceTable(VkDevice dev, PFN_vkGetDeviceProcAddr gpa)
+// Dispatch tables are keyed by the loader's dispatch pointer, and are looked up every time a
+// dispatchable object is wrapped as well as from the layer's GetProcAddr entry points. They live in
+// a fixed-size open-addressed table that readers probe without taking any lock. Each slot holds a
+// single pointer to an entry containing both key and table, which is fully written before being
+// published into the slot. Removed entries are left in place as tombstones and reused by later
+// adds, and are never freed so a racing reader never sees freed memory. If the table ever fills
+// up, further tables go into a locked map.
+template <typename TableType>
+class DispatchTableLookup
 {
-  void *key = GetKey(dev);
+public:
+  DispatchTableLookup()
+  {
+    for(uint32_t i = 0; i < NumSlots; i++)
+      m_Slots[i] = NULL;
+  }
+
+  TableType *Add(void *key)
+  {
+    SCOPED_LOCK(m_Lock);
+
+    Entry *tombstone = NULL;
+
+    for(uint32_t i = 0, idx = Hash(key); i < NumSlots; i++, idx = (idx + 1) & (NumSlots - 1))
+    {
+      Entry *entry = m_Slots[idx];
+
+      // the same loader dispatch pointer can be reused for a new object, so reset the old table
+      if(entry && entry->key == key)
+      {
+        RDCEraseEl(entry->table);
+        return &entry->table;
+      }
+
+      if(entry && entry->key == Tombstone && tombstone == NULL)
+        tombstone = entry;
+
+      if(entry == NULL)
+      {
+        if(tombstone)
+          break;
+
+        entry = new Entry;
+        entry->key = key;
+        RDCEraseEl(entry->table);
+
+        // the exchange is a full barrier, so the entry is visible before the pointer to it
+        Atomic::CmpExchPtr((void *volatile *)&m_Slots[idx], NULL, entry);
+        return &entry->table;
+      }
+    }
+
+    {
+      auto it = m_Overflow.find(key);
+      if(it != m_Overflow.end())
+      {
+        RDCEraseEl(it->second);
+        return &it->second;
+      }
+    }
+
+    if(tombstone)
+    {
+      RDCEraseEl(tombstone->table);
+
+      // publish the key last, with a barrier so the table is cleared before it can be found
+      Atomic::CmpExchPtr((void *volatile *)&tombstone->key, Tombstone, key);
+      return &tombstone->table;
+    }
+
+    RDCWARN("Dispatch table lookup is full, falling back to locked lookup for %p", key);
+
+    TableType &table = m_Overflow[key];
+    RDCEraseEl(table);
+    return &table;
+  }
+
+  void Remove(void *key)
+  {
+    SCOPED_LOCK(m_Lock);
+
+    for(uint32_t i = 0, idx = Hash(key); i < NumSlots; i++, idx = (idx + 1) & (NumSlots - 1))
+    {
+      Entry *entry = m_Slots[idx];
+
+      if(entry == NULL)
+        return;
+
+      if(entry->key == key)
+      {
+        Atomic::CmpExchPtr((void *volatile *)&entry->key, key, Tombstone);
+        return;
+      }
+    }
+
+    m_Overflow.erase(key);
+  }
+
+  TableType *Find(void *key)
+  {
+    for(uint32_t i = 0, idx = Hash(key); i < NumSlots; i++, idx = (idx + 1) & (NumSlots - 1))
+    {
+      Entry *entry = m_Slots[idx];
+
+      if(entry == NULL)
+        return NULL;
+
+      if(entry->key == key)
+        return &entry->table;
+    }
+
+    // we only get here if every slot has been filled at some point, so check the overflow map
+    SCOPED_LOCK(m_Lock);
+
+    auto it = m_Overflow.find(key);
+    if(it != m_Overflow.end())
+      return &it->second;
+
+    return NULL;
+  }
 
-  VkLayerDispatchTableExtended *table = NULL;
+private:
+  // there's one table per live instance or device, so this is far more than will normally be used
+  static const uint32_t NumSlots = 256;
 
+  // never a valid dispatch pointer, since those are always aligned
+  static void *const Tombstone;
+
+  struct Entry
+  {
+    void *volatile key;
+    TableType table;
+  };
+
+  static uint32_t Hash(void *key)
   {
-    SCOPED_LOCK(devlock);
-    RDCEraseEl(devlookup[key]);
-    table = &devlookup[key];
+    // fibonacci hashing, skipping the low bits which are always zero from alignment
+    uint64_t k = uint64_t(uintptr_t(key) >> 4);
+    return uint32_t((k * 11400714819323198485ULL) >> 32) & (NumSlots - 1);
   }
 
+  Entry *volatile m_Slots[NumSlots];
+  std::map<void *, TableType> m_Overflow;
+  Threading::CriticalSection m_Lock;
+};
+
+template <typename TableType>
+void *const DispatchTableLookup<TableType>::Tombstone = (void *)uintptr_t(1);
+
+static DispatchTableLookup<VkLayerDispatchTableExtended> devlookup;
+static DispatchTableLookup<VkLayerInstanceDispatchTableExtended> instlookup;
+
+void InitDeviceTable(VkDevice dev, PFN_vkGetDeviceProcAddr gpa)
+{
+  void *key = GetKey(dev);
+
+  VkLayerDispatchTableExtended *table = devlookup.Add(key);
+
   table->GetDeviceProcAddr = gpa;
 
 // fetch the rest of the functions
@@ -199,13 +340,7 @@ void InitInstanceTable(VkInstance inst, PFN_vkGetInstanceProcAddr gpa)
 {
   void *key = GetKey(inst);
 
-  VkLayerInstanceDispatchTableExtended *table = NULL;
-
-  {
-    SCOPED_LOCK(instlock);
-    RDCEraseEl(instlookup[key]);
-    table = &instlookup[key];
-  }
+  VkLayerInstanceDispatchTableExtended *table = instlookup.Add(key);
 
   // init the GetInstanceProcAddr function first
   table->GetInstanceProcAddr = gpa;
@@ -228,18 +363,22 @@ VkLayerDispatchTableExtended *GetDeviceDispatchTable(void *device)
   if(replay)
     return &replayDeviceTable;
 
-  void *key = GetKey(device);
+  VkLayerDispatchTableExtended *table = devlookup.Find(GetKey(device));
 
-  {
-    SCOPED_LOCK(devlock);
+  if(table == NULL)
+    RDCFATAL("Bad device pointer");
 
-    auto it = devlookup.find(key);
+  return table;
+}
 
-    if(it == devlookup.end())
-      RDCFATAL("Bad device pointer");
+void RemoveDeviceTable(void *device)
+{
+  devlookup.Remove(device);
+}
 
-    return &it->second;
-  }
+void RemoveInstanceTable(void *instance)
+{
+  instlookup.Remove(instance);
 }
 
 VkLayerInstanceDispatchTableExtended *GetInstanceDispatchTable(void *instance)
@@ -247,16 +386,10 @@ VkLayerInstanceDispatchTableExtended *GetInstanceDispatchTable(void *instance)
   if(replay)
     return &replayInstanceTable;
 
-  void *key = GetKey(instance);
-
-  {
-    SCOPED_LOCK(instlock);
-
-    auto it = instlookup.find(key);
+  VkLayerInstanceDispatchTableExtended *table = instlookup.Find(GetKey(instance));
 
-    if(it == instlookup.end())
-      RDCFATAL("Bad device pointer");
+  if(table == NULL)
+    RDCFATAL("Bad instance pointer");
 
-    return &it->second;
-  }
+  return table;
 }
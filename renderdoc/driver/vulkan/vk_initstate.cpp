@@ -35,10 +35,9 @@
 // AllocAlignedBuffer for the initial contents buffer is ugly.
 
 // VKTODOLOW in general we do a lot of "create buffer, use it, flush/sync then destroy".
-// I don't know what the exact cost is, but it would be nice to batch up the buffers/etc
-// used across init state use, and only do a single flush. Also we could then get some
-// nice command buffer reuse (although need to be careful we don't create too large a
-// command buffer that stalls the GPU).
+// Non-sparse image and memory readbacks at capture start are batched (see
+// BatchInitStateReadback), but sparse resources, MSAA images and applying initial states on
+// replay still flush once per resource.
 // See INITSTATEBATCH
 
 struct MemIDOffset
@@ -1022,8 +1021,6 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     }
 
     VkDevice d = GetDev();
-    // INITSTATEBATCH
-    VkCommandBuffer cmd = GetNextCmd();
 
     ImageLayouts *layout = NULL;
     {
@@ -1031,6 +1028,14 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
       layout = &m_ImageLayouts[im->id];
     }
 
+    // submits on other threads update the image's states under its own lock, so take a copy to
+    // transition from and back to
+    vector<ImageRegionState> subresourceStates;
+    {
+      SCOPED_LOCK(layout->lock);
+      subresourceStates = layout->subresourceStates;
+    }
+
     // must ensure offset remains valid. Must be multiple of block size, or 4, depending on format
     VkDeviceSize bufAlignment = 4;
     if(IsBlockFormat(layout->format))
@@ -1112,34 +1117,52 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
       }
     }
 
-    // since this is very short lived, it is not wrapped
-    VkBuffer dstBuf;
+    VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
+                                          VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
 
-    vkr = ObjDisp(d)->CreateBuffer(Unwrap(d), &bufInfo, NULL, &dstBuf);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+
+    // since this is very short lived, it is not wrapped
+    VkBuffer dstBuf = VK_NULL_HANDLE;
 
     VkMemoryRequirements mrq = {0};
 
-    ObjDisp(d)->GetBufferMemoryRequirements(Unwrap(d), dstBuf, &mrq);
+    // MSAA images need a separate submit to decompose to an array, so aren't batched
+    VkDeviceSize bufBase = 0;
+    InitStateBatch *batch = NULL;
+    if(arrayIm == VK_NULL_HANDLE)
+      batch = BatchInitStateReadback(id, type, bufInfo.size, bufBase);
 
-    VkMemoryAllocateInfo allocInfo = {
-        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, NULL, mrq.size,
-        GetReadbackMemoryIndex(mrq.memoryTypeBits),
-    };
+    if(batch)
+    {
+      cmd = batch->cmd;
+      dstBuf = batch->buf;
+    }
+    else
+    {
+      cmd = GetNextCmd();
 
-    vkr = ObjDisp(d)->AllocateMemory(Unwrap(d), &allocInfo, NULL, &readbackmem);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+      vkr = ObjDisp(d)->CreateBuffer(Unwrap(d), &bufInfo, NULL, &dstBuf);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    GetResourceManager()->WrapResource(Unwrap(d), readbackmem);
+      ObjDisp(d)->GetBufferMemoryRequirements(Unwrap(d), dstBuf, &mrq);
 
-    vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), dstBuf, Unwrap(readbackmem), 0);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+      VkMemoryAllocateInfo allocInfo = {
+          VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, NULL, mrq.size,
+          GetReadbackMemoryIndex(mrq.memoryTypeBits),
+      };
 
-    VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
-                                          VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+      vkr = ObjDisp(d)->AllocateMemory(Unwrap(d), &allocInfo, NULL, &readbackmem);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    vkr = ObjDisp(d)->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+      GetResourceManager()->WrapResource(Unwrap(d), readbackmem);
+
+      vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), dstBuf, Unwrap(readbackmem), 0);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+      vkr = ObjDisp(d)->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    }
 
     VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
     if(IsStencilOnlyFormat(layout->format))
@@ -1172,10 +1195,10 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     // before we go reading
     srcimBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
 
-    for(size_t si = 0; si < layout->subresourceStates.size(); si++)
+    for(size_t si = 0; si < subresourceStates.size(); si++)
     {
-      srcimBarrier.subresourceRange = layout->subresourceStates[si].subresourceRange;
-      srcimBarrier.oldLayout = layout->subresourceStates[si].newLayout;
+      srcimBarrier.subresourceRange = subresourceStates[si].subresourceRange;
+      srcimBarrier.oldLayout = subresourceStates[si].newLayout;
       DoPipelineBarrier(cmd, 1, &srcimBarrier);
     }
 
@@ -1217,7 +1240,7 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
       realim = arrayIm;
     }
 
-    VkDeviceSize bufOffset = 0;
+    VkDeviceSize bufOffset = bufBase;
 
     // loop over every slice/mip, copying it to the appropriate point in the buffer
     for(int a = 0; a < numLayers; a++)
@@ -1269,7 +1292,7 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
       }
     }
 
-    RDCASSERTMSG("buffer wasn't sized sufficiently!", bufOffset <= bufInfo.size, bufOffset,
+    RDCASSERTMSG("buffer wasn't sized sufficiently!", bufOffset - bufBase <= bufInfo.size, bufOffset,
                  mrq.size, layout->extent, layout->format, numLayers, layout->levelCount);
 
     // transfer back to whatever it was
@@ -1278,18 +1301,21 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     srcimBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
     srcimBarrier.dstAccessMask = 0;
 
-    for(size_t si = 0; si < layout->subresourceStates.size(); si++)
+    for(size_t si = 0; si < subresourceStates.size(); si++)
     {
-      srcimBarrier.subresourceRange = layout->subresourceStates[si].subresourceRange;
-      srcimBarrier.newLayout = layout->subresourceStates[si].newLayout;
+      srcimBarrier.subresourceRange = subresourceStates[si].subresourceRange;
+      srcimBarrier.newLayout = subresourceStates[si].newLayout;
       srcimBarrier.dstAccessMask = MakeAccessMask(srcimBarrier.newLayout);
       DoPipelineBarrier(cmd, 1, &srcimBarrier);
     }
 
+    // batched readbacks are submitted and serialised along with the rest of their batch
+    if(batch)
+      return true;
+
     vkr = ObjDisp(d)->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    // INITSTATEBATCH
     SubmitCmds();
     FlushQ();
 
@@ -1312,8 +1338,6 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     VkResult vkr = VK_SUCCESS;
 
     VkDevice d = GetDev();
-    // INITSTATEBATCH
-    VkCommandBuffer cmd = GetNextCmd();
 
     VkResourceRecord *record = GetResourceManager()->GetResourceRecord(id);
     VkDeviceSize dataoffs = 0;
@@ -1338,16 +1362,36 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     // since these are very short lived, they are not wrapped
     VkBuffer srcBuf, dstBuf;
 
-    // dstBuf is just over the allocated memory, so only the image's size
-    bufInfo.size = datasize;
-    vkr = ObjDisp(d)->CreateBuffer(Unwrap(d), &bufInfo, NULL, &dstBuf);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
     // srcBuf spans the entire memory, then we copy out the sub-region we're interested in
     bufInfo.size = memsize;
     vkr = ObjDisp(d)->CreateBuffer(Unwrap(d), &bufInfo, NULL, &srcBuf);
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
+    vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), srcBuf, datamem, 0);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    VkDeviceSize bufBase = 0;
+    InitStateBatch *batch = BatchInitStateReadback(id, type, datasize, bufBase);
+
+    if(batch)
+    {
+      VkBufferCopy region = {dataoffs, bufBase, datasize};
+
+      ObjDisp(d)->CmdCopyBuffer(Unwrap(batch->cmd), srcBuf, batch->buf, 1, &region);
+
+      // srcBuf must stay alive until the batch has executed
+      batch->tempBufs.push_back(srcBuf);
+
+      return true;
+    }
+
+    VkCommandBuffer cmd = GetNextCmd();
+
+    // dstBuf is just over the allocated memory, so only the image's size
+    bufInfo.size = datasize;
+    vkr = ObjDisp(d)->CreateBuffer(Unwrap(d), &bufInfo, NULL, &dstBuf);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
     VkMemoryRequirements mrq = {0};
 
     ObjDisp(d)->GetBufferMemoryRequirements(Unwrap(d), srcBuf, &mrq);
@@ -1364,8 +1408,6 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
 
     GetResourceManager()->WrapResource(Unwrap(d), readbackmem);
 
-    vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), srcBuf, datamem, 0);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
     vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), dstBuf, Unwrap(readbackmem), 0);
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
@@ -1382,7 +1424,6 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
     vkr = ObjDisp(d)->EndCommandBuffer(Unwrap(cmd));
     RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-    // INITSTATEBATCH
     SubmitCmds();
     FlushQ();
 
@@ -1403,6 +1444,377 @@ bool WrappedVulkan::Prepare_InitialState(WrappedVkRes *res)
   return false;
 }
 
+// size of each staging block for batched initial state readback. Two blocks are used so this
+// also bounds the staging memory used at once. Anything larger than a block is read back on
+// its own.
+static const VkDeviceSize InitStateBatchSize = 64 * 1024 * 1024;
+
+WrappedVulkan::InitStateBatch *WrappedVulkan::BatchInitStateReadback(ResourceId id,
+                                                                     VkResourceType type,
+                                                                     VkDeviceSize size,
+                                                                     VkDeviceSize &offset)
+{
+  if(size > InitStateBatchSize)
+    return NULL;
+
+  VkDevice d = GetDev();
+  VkResult vkr = VK_SUCCESS;
+
+  InitStateBatch *batch = &m_InitStateBatches[m_CurInitStateBatch];
+
+  // keep every readback aligned for the largest texel block size, so that the offsets within
+  // each readback are the same as if it had its own buffer
+  offset = AlignUp(batch->used, (VkDeviceSize)16);
+
+  if(offset + size > InitStateBatchSize)
+  {
+    SubmitInitStateBatch(*batch);
+
+    m_CurInitStateBatch = 1 - m_CurInitStateBatch;
+    batch = &m_InitStateBatches[m_CurInitStateBatch];
+
+    // serialise the previous batch while the one we just submitted is copying
+    CompleteInitStateBatch(*batch);
+
+    offset = 0;
+  }
+
+  if(batch->mem == VK_NULL_HANDLE)
+  {
+    VkBufferCreateInfo bufInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        NULL,
+        0,
+        InitStateBatchSize,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+    };
+
+    vkr = ObjDisp(d)->CreateBuffer(Unwrap(d), &bufInfo, NULL, &batch->buf);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    VkMemoryRequirements mrq = {0};
+
+    ObjDisp(d)->GetBufferMemoryRequirements(Unwrap(d), batch->buf, &mrq);
+
+    VkMemoryAllocateInfo allocInfo = {
+        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, NULL, mrq.size,
+        GetReadbackMemoryIndex(mrq.memoryTypeBits),
+    };
+
+    vkr = ObjDisp(d)->AllocateMemory(Unwrap(d), &allocInfo, NULL, &batch->mem);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), batch->buf, batch->mem, 0);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    vkr = ObjDisp(d)->MapMemory(Unwrap(d), batch->mem, 0, VK_WHOLE_SIZE, 0, (void **)&batch->data);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, NULL, 0};
+
+    vkr = ObjDisp(d)->CreateFence(Unwrap(d), &fenceInfo, NULL, &batch->fence);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  }
+
+  if(batch->cmd == VK_NULL_HANDLE)
+  {
+    batch->cmd = GetNextCmd();
+
+    // the batch is submitted with its own fence, so keep it out of the next SubmitCmds()
+    m_InternalCmds.pendingcmds.pop_back();
+
+    VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
+                                          VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+
+    vkr = ObjDisp(d)->BeginCommandBuffer(Unwrap(batch->cmd), &beginInfo);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+  }
+
+  InitStateReadback readback = {id, type, offset, size};
+  batch->readbacks.push_back(readback);
+
+  batch->used = offset + size;
+
+  return batch;
+}
+
+void WrappedVulkan::SubmitInitStateBatch(InitStateBatch &batch)
+{
+  if(batch.cmd == VK_NULL_HANDLE || batch.submitted)
+    return;
+
+  VkResult vkr = ObjDisp(batch.cmd)->EndCommandBuffer(Unwrap(batch.cmd));
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  VkCommandBuffer cmd = Unwrap(batch.cmd);
+
+  VkSubmitInfo submitInfo = {
+      VK_STRUCTURE_TYPE_SUBMIT_INFO, NULL, 0, NULL, NULL, 1, &cmd, 0, NULL,
+  };
+
+  vkr = ObjDisp(m_Queue)->QueueSubmit(Unwrap(m_Queue), 1, &submitInfo, batch.fence);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  batch.submitted = true;
+}
+
+void WrappedVulkan::CompleteInitStateBatch(InitStateBatch &batch)
+{
+  if(!batch.submitted)
+    return;
+
+  VkDevice d = GetDev();
+
+  VkResult vkr = ObjDisp(d)->WaitForFences(Unwrap(d), 1, &batch.fence, VK_TRUE, UINT64_MAX);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  vkr = ObjDisp(d)->ResetFences(Unwrap(d), 1, &batch.fence);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  VkMappedMemoryRange range = {
+      VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, NULL, batch.mem, 0, VK_WHOLE_SIZE,
+  };
+
+  vkr = ObjDisp(d)->InvalidateMappedMemoryRanges(Unwrap(d), 1, &range);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  for(size_t i = 0; i < batch.readbacks.size(); i++)
+  {
+    const InitStateReadback &readback = batch.readbacks[i];
+
+    ScopedContext scope(GetMainSerialiser(), "Initial Contents", "Initial Contents",
+                        INITIAL_CONTENTS, false);
+
+    Serialise_BatchedInitialState(readback.id, readback.type, batch.data + readback.offset,
+                                  (uint32_t)readback.size);
+
+    GetResourceManager()->SetInitialChunk(readback.id, scope.Get());
+  }
+
+  for(size_t i = 0; i < batch.tempBufs.size(); i++)
+    ObjDisp(d)->DestroyBuffer(Unwrap(d), batch.tempBufs[i], NULL);
+
+  m_InternalCmds.freecmds.push_back(batch.cmd);
+
+  batch.cmd = VK_NULL_HANDLE;
+  batch.used = 0;
+  batch.submitted = false;
+  batch.readbacks.clear();
+  batch.tempBufs.clear();
+}
+
+void WrappedVulkan::FlushInitStateBatches()
+{
+  InitStateBatch &cur = m_InitStateBatches[m_CurInitStateBatch];
+  InitStateBatch &prev = m_InitStateBatches[1 - m_CurInitStateBatch];
+
+  SubmitInitStateBatch(cur);
+
+  CompleteInitStateBatch(prev);
+  CompleteInitStateBatch(cur);
+
+  // the staging blocks are only needed while preparing, don't hold onto them through the frame
+  VkDevice d = GetDev();
+
+  for(int i = 0; i < 2; i++)
+  {
+    InitStateBatch &batch = m_InitStateBatches[i];
+
+    if(batch.mem == VK_NULL_HANDLE)
+      continue;
+
+    ObjDisp(d)->UnmapMemory(Unwrap(d), batch.mem);
+    ObjDisp(d)->DestroyBuffer(Unwrap(d), batch.buf, NULL);
+    ObjDisp(d)->FreeMemory(Unwrap(d), batch.mem, NULL);
+    ObjDisp(d)->DestroyFence(Unwrap(d), batch.fence, NULL);
+
+    batch.mem = VK_NULL_HANDLE;
+    batch.buf = VK_NULL_HANDLE;
+    batch.fence = VK_NULL_HANDLE;
+    batch.data = NULL;
+  }
+
+  m_CurInitStateBatch = 0;
+}
+
+// writes the same data as Serialise_InitialState does for a non-sparse image or memory, from an
+// already read-back batch
+bool WrappedVulkan::Serialise_BatchedInitialState(ResourceId resid, VkResourceType restype,
+                                                  byte *data, uint32_t dataSize)
+{
+  Serialiser *localSerialiser = GetMainSerialiser();
+
+  SERIALISE_ELEMENT(VkResourceType, type, restype);
+  SERIALISE_ELEMENT(ResourceId, id, resid);
+
+  bool isSparse = false;
+  m_pSerialiser->Serialise("isSparse", isSparse);
+
+  if(type == eResDeviceMemory)
+  {
+    // batches are serialised while preparing, before we know what the frame references, so
+    // the whole memory is saved
+    vector<VkBufferCopy> regions;
+    VkBufferCopy region = {0, 0, dataSize};
+    regions.push_back(region);
+
+    Serialise_MemoryInitialRegions(data, regions);
+
+    return true;
+  }
+
+  m_pSerialiser->Serialise("dataSize", dataSize);
+
+  size_t size = (size_t)dataSize;
+  m_pSerialiser->SerialiseBuffer("data", data, size);
+
+  return true;
+}
+
+void WrappedVulkan::GetReferencedMemoryRegions(ResourceId mem, VkDeviceSize memSize,
+                                               vector<VkBufferCopy> &regions)
+{
+  // start and end of each referenced range
+  vector<pair<VkDeviceSize, VkDeviceSize> > ranges;
+
+  bool wholeMemory = RenderDoc::Inst().GetCaptureOptions().RefAllResources;
+
+  if(!wholeMemory)
+  {
+    SCOPED_LOCK(m_MemoryBindingsLock);
+
+    auto it = m_MemoryBindings.find(mem);
+
+    // if we don't know what's bound where, we have to save everything
+    if(it == m_MemoryBindings.end() || it->second.untracked)
+    {
+      wholeMemory = true;
+    }
+    else
+    {
+      for(auto r = it->second.ranges.begin(); r != it->second.ranges.end(); ++r)
+      {
+        VkDeviceSize start = r->second.first;
+        VkDeviceSize end = RDCMIN(start + r->second.second, memSize);
+
+        if(start < end && GetResourceManager()->IsResourceFrameReferenced(r->first))
+          ranges.push_back(std::make_pair(start, end));
+      }
+    }
+  }
+
+  if(wholeMemory)
+  {
+    VkBufferCopy region = {0, 0, memSize};
+    regions.push_back(region);
+    return;
+  }
+
+  std::sort(ranges.begin(), ranges.end());
+
+  // merge overlapping ranges, as well as ranges close enough together that the gap is cheaper
+  // than the overhead of another region. srcOffset is where each region is packed on replay
+  const VkDeviceSize mergeGap = 4096;
+
+  VkDeviceSize packedSize = 0;
+
+  for(size_t i = 0; i < ranges.size(); i++)
+  {
+    if(!regions.empty())
+    {
+      VkBufferCopy &prev = regions.back();
+
+      if(ranges[i].first <= prev.dstOffset + prev.size + mergeGap)
+      {
+        VkDeviceSize end = RDCMAX(prev.dstOffset + prev.size, ranges[i].second);
+        packedSize += end - (prev.dstOffset + prev.size);
+        prev.size = end - prev.dstOffset;
+        continue;
+      }
+    }
+
+    VkBufferCopy region = {packedSize, ranges[i].first, ranges[i].second - ranges[i].first};
+    regions.push_back(region);
+
+    packedSize += region.size;
+  }
+}
+
+// data is the contents of the whole memory, only the given regions are serialised
+void WrappedVulkan::Serialise_MemoryInitialRegions(byte *data, vector<VkBufferCopy> &regions)
+{
+  uint32_t dataSize = 0;
+  for(size_t i = 0; i < regions.size(); i++)
+    dataSize += (uint32_t)regions[i].size;
+
+  m_pSerialiser->Serialise("dataSize", dataSize);
+
+  uint32_t numRegions = (uint32_t)regions.size();
+  VkBufferCopy *regionArray = regions.empty() ? NULL : &regions[0];
+  m_pSerialiser->SerialiseComplexArray("regions", regionArray, numRegions);
+
+  for(uint32_t i = 0; i < numRegions; i++)
+  {
+    byte *regionData = data + regions[i].dstOffset;
+    size_t regionSize = (size_t)regions[i].size;
+    m_pSerialiser->SerialiseBuffer("data", regionData, regionSize);
+  }
+}
+
+// size of each block in the replay initial contents arena. Larger uploads get a block of their own
+static const VkDeviceSize InitialContentsBlockSize = 64 * 1024 * 1024;
+
+// binds the given (wrapped) upload buffer to space sub-allocated out of the initial contents
+// arena and returns a pointer to write its contents
+byte *WrappedVulkan::BindInitialContentsUpload(VkBuffer buf)
+{
+  VkDevice d = GetDev();
+
+  VkMemoryRequirements mrq = {0};
+
+  ObjDisp(d)->GetBufferMemoryRequirements(Unwrap(d), Unwrap(buf), &mrq);
+
+  uint32_t memIndex = GetUploadMemoryIndex(mrq.memoryTypeBits);
+
+  VkDeviceSize offs = AlignUp(m_InitialContentsArena.used, mrq.alignment);
+
+  if(m_InitialContentsArena.mem == VK_NULL_HANDLE || m_InitialContentsArena.memIndex != memIndex ||
+     offs + mrq.size > m_InitialContentsArena.size)
+  {
+    VkMemoryAllocateInfo allocInfo = {
+        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, NULL, RDCMAX(mrq.size, InitialContentsBlockSize),
+        memIndex,
+    };
+
+    VkDeviceMemory mem = VK_NULL_HANDLE;
+
+    VkResult vkr = ObjDisp(d)->AllocateMemory(Unwrap(d), &allocInfo, NULL, &mem);
+    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+    GetResourceManager()->WrapResource(Unwrap(d), mem);
+
+    // the block stays mapped until it's freed on shutdown
+    ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(mem), 0, VK_WHOLE_SIZE, 0,
+                          (void **)&m_InitialContentsArena.data);
+
+    m_CleanupMems.push_back(mem);
+
+    m_InitialContentsArena.mem = mem;
+    m_InitialContentsArena.memIndex = memIndex;
+    m_InitialContentsArena.size = allocInfo.allocationSize;
+
+    offs = 0;
+  }
+
+  VkResult vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), Unwrap(buf),
+                                              Unwrap(m_InitialContentsArena.mem), offs);
+  RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+  m_InitialContentsArena.used = offs + mrq.size;
+
+  return m_InitialContentsArena.data + offs;
+}
+
 // second parameter isn't used, as we might be serialising init state for a deleted resource
 bool WrappedVulkan::Serialise_InitialState(ResourceId resid, WrappedVkRes *)
 {
@@ -1459,10 +1871,22 @@ bool WrappedVulkan::Serialise_InitialState(ResourceId resid, WrappedVkRes *)
       ObjDisp(d)->MapMemory(Unwrap(d), ToHandle<VkDeviceMemory>(initContents.resource), 0,
                             VK_WHOLE_SIZE, 0, (void **)&ptr);
 
-      size_t dataSize = (size_t)initContents.num;
+      if(type == eResDeviceMemory)
+      {
+        // memory is often a large block sub-allocated between many resources, so only save the
+        // parts bound to resources that the frame references
+        vector<VkBufferCopy> regions;
+        GetReferencedMemoryRegions(id, initContents.num, regions);
 
-      m_pSerialiser->Serialise("dataSize", initContents.num);
-      m_pSerialiser->SerialiseBuffer("data", ptr, dataSize);
+        Serialise_MemoryInitialRegions(ptr, regions);
+      }
+      else
+      {
+        size_t dataSize = (size_t)initContents.num;
+
+        m_pSerialiser->Serialise("dataSize", initContents.num);
+        m_pSerialiser->SerialiseBuffer("data", ptr, dataSize);
+      }
 
       ObjDisp(d)->UnmapMemory(Unwrap(d), ToHandle<VkDeviceMemory>(initContents.resource));
     }
@@ -1670,6 +2094,8 @@ bool WrappedVulkan::Serialise_InitialState(ResourceId resid, WrappedVkRes *)
 
       GetResourceManager()->WrapResource(Unwrap(d), buf);
 
+      VulkanCreationInfo::Image &c = m_CreationInfo.m_Image[liveid];
+
       VkMemoryRequirements mrq = {0};
 
       ObjDisp(d)->GetBufferMemoryRequirements(Unwrap(d), Unwrap(buf), &mrq);
@@ -1679,34 +2105,37 @@ bool WrappedVulkan::Serialise_InitialState(ResourceId resid, WrappedVkRes *)
           GetUploadMemoryIndex(mrq.memoryTypeBits),
       };
 
-      // first we upload the data into a single buffer, then we do
-      // a copy per-mip from that buffer to a new image
-      vkr = ObjDisp(d)->AllocateMemory(Unwrap(d), &allocInfo, NULL, &uploadmem);
-      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+      byte *ptr = NULL;
 
-      GetResourceManager()->WrapResource(Unwrap(d), uploadmem);
+      if(c.samples == VK_SAMPLE_COUNT_1_BIT)
+      {
+        // the buffer is kept until shutdown, so comes from the initial contents arena
+        ptr = BindInitialContentsUpload(buf);
+      }
+      else
+      {
+        // first we upload the data into a single buffer, then we do
+        // a copy per-mip from that buffer to a new image
+        vkr = ObjDisp(d)->AllocateMemory(Unwrap(d), &allocInfo, NULL, &uploadmem);
+        RDCASSERTEQUAL(vkr, VK_SUCCESS);
 
-      vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), Unwrap(buf), Unwrap(uploadmem), 0);
-      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+        GetResourceManager()->WrapResource(Unwrap(d), uploadmem);
 
-      byte *ptr = NULL;
-      ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(uploadmem), 0, VK_WHOLE_SIZE, 0, (void **)&ptr);
+        vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), Unwrap(buf), Unwrap(uploadmem), 0);
+        RDCASSERTEQUAL(vkr, VK_SUCCESS);
+
+        ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(uploadmem), 0, VK_WHOLE_SIZE, 0, (void **)&ptr);
+      }
 
       size_t dummy = 0;
       m_pSerialiser->SerialiseBuffer("data", ptr, dummy);
 
-      ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(uploadmem));
+      if(uploadmem != VK_NULL_HANDLE)
+        ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(uploadmem));
 
       VulkanResourceManager::InitialContentData initial(GetWrapped(buf), 0, NULL);
 
-      VulkanCreationInfo::Image &c = m_CreationInfo.m_Image[liveid];
-
-      if(c.samples == VK_SAMPLE_COUNT_1_BIT)
-      {
-        // remember to free this memory on shutdown
-        m_CleanupMems.push_back(uploadmem);
-      }
-      else
+      if(c.samples != VK_SAMPLE_COUNT_1_BIT)
       {
         int numLayers = c.arrayLayers * (int)c.samples;
 
@@ -1891,12 +2320,22 @@ bool WrappedVulkan::Serialise_InitialState(ResourceId resid, WrappedVkRes *)
       uint32_t dataSize = 0;
       m_pSerialiser->Serialise("dataSize", dataSize);
 
+      // the regions of memory that were saved, packed together in the data
+      uint32_t numRegions = 0;
+      VkBufferCopy *regions = NULL;
+      m_pSerialiser->SerialiseComplexArray("regions", regions, numRegions);
+
+      // nothing referenced in the frame was bound to this memory
+      if(dataSize == 0)
+      {
+        SAFE_DELETE_ARRAY(regions);
+        return true;
+      }
+
       VkResult vkr = VK_SUCCESS;
 
       VkDevice d = GetDev();
 
-      VkDeviceMemory mem = VK_NULL_HANDLE;
-
       VkBufferCreateInfo bufInfo = {
           VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
           NULL,
@@ -1912,35 +2351,23 @@ bool WrappedVulkan::Serialise_InitialState(ResourceId resid, WrappedVkRes *)
 
       GetResourceManager()->WrapResource(Unwrap(d), buf);
 
-      VkMemoryRequirements mrq = {0};
-
-      ObjDisp(d)->GetBufferMemoryRequirements(Unwrap(d), Unwrap(buf), &mrq);
-
-      VkMemoryAllocateInfo allocInfo = {
-          VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, NULL, mrq.size,
-          GetUploadMemoryIndex(mrq.memoryTypeBits),
-      };
-
-      vkr = ObjDisp(d)->AllocateMemory(Unwrap(d), &allocInfo, NULL, &mem);
-      RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-      GetResourceManager()->WrapResource(Unwrap(d), mem);
-
-      vkr = ObjDisp(d)->BindBufferMemory(Unwrap(d), Unwrap(buf), Unwrap(mem), 0);
-      RDCASSERTEQUAL(vkr, VK_SUCCESS);
+      byte *ptr = BindInitialContentsUpload(buf);
 
-      byte *ptr = NULL;
-      ObjDisp(d)->MapMemory(Unwrap(d), Unwrap(mem), 0, VK_WHOLE_SIZE, 0, (void **)&ptr);
-
-      size_t dummy = 0;
-      m_pSerialiser->SerialiseBuffer("data", ptr, dummy);
+      for(uint32_t i = 0; i < numRegions; i++)
+      {
+        byte *regionData = ptr + regions[i].srcOffset;
+        size_t dummy = 0;
+        m_pSerialiser->SerialiseBuffer("data", regionData, dummy);
+      }
 
-      ObjDisp(d)->UnmapMemory(Unwrap(d), Unwrap(mem));
+      // keep the regions to copy them into place when applying
+      byte *blob = Serialiser::AllocAlignedBuffer(sizeof(VkBufferCopy) * numRegions);
+      memcpy(blob, regions, sizeof(VkBufferCopy) * numRegions);
 
-      m_CleanupMems.push_back(mem);
+      SAFE_DELETE_ARRAY(regions);
 
       GetResourceManager()->SetInitialContents(
-          id, VulkanResourceManager::InitialContentData(GetWrapped(buf), (uint32_t)dataSize, NULL));
+          id, VulkanResourceManager::InitialContentData(GetWrapped(buf), numRegions, blob));
     }
     else
     {
@@ -2292,11 +2719,6 @@ void WrappedVulkan::Apply_InitialState(WrappedVkRes *live,
 
     WrappedVkBuffer *buf = (WrappedVkBuffer *)initial.resource;
 
-    VkCommandBuffer cmd = GetNextCmd();
-
-    vkr = ObjDisp(cmd)->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
     VkExtent3D extent = m_CreationInfo.m_Image[id].extent;
 
     VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -2319,8 +2741,35 @@ void WrappedVulkan::Apply_InitialState(WrappedVkRes *live,
         ToHandle<VkImage>(live),
         {aspectFlags, 0, 1, 0, (uint32_t)m_CreationInfo.m_Image[id].arrayLayers}};
 
-    if(aspectFlags == VK_IMAGE_ASPECT_DEPTH_BIT && !IsDepthOnlyFormat(fmt))
-      dstimBarrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    // the live image is transitioned into destination optimal before the shared copies run, and
+    // back afterwards (the initial state buffer needs no transition). These depend on the current
+    // layouts so are gathered on every apply.
+    for(size_t si = 0; si < m_ImageLayouts[id].subresourceStates.size(); si++)
+    {
+      dstimBarrier.subresourceRange = m_ImageLayouts[id].subresourceStates[si].subresourceRange;
+      dstimBarrier.oldLayout = m_ImageLayouts[id].subresourceStates[si].newLayout;
+      dstimBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+      dstimBarrier.srcAccessMask =
+          VK_ACCESS_ALL_WRITE_BITS | MakeAccessMask(dstimBarrier.oldLayout);
+      dstimBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+      m_InitialContentsArena.preBarriers.push_back(dstimBarrier);
+
+      // make sure the apply completes before any further work
+      dstimBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+      dstimBarrier.newLayout = m_ImageLayouts[id].subresourceStates[si].newLayout;
+      dstimBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      dstimBarrier.dstAccessMask =
+          VK_ACCESS_ALL_READ_BITS | MakeAccessMask(dstimBarrier.newLayout);
+
+      m_InitialContentsArena.postBarriers.push_back(dstimBarrier);
+    }
+
+    // the copies themselves are only recorded on the first apply
+    if(m_InitialContentsArena.copiesRecorded)
+      return;
+
+    VkCommandBuffer cmd = m_InitialContentsArena.copyCmd;
 
     VkDeviceSize bufOffset = 0;
 
@@ -2356,23 +2805,6 @@ void WrappedVulkan::Apply_InitialState(WrappedVkRes *live,
         // pass 0 for mip since we've already pre-downscaled extent
         bufOffset += GetByteSize(extent.width, extent.height, extent.depth, sizeFormat, 0);
 
-        dstimBarrier.subresourceRange.baseArrayLayer = a;
-        dstimBarrier.subresourceRange.baseMipLevel = m;
-
-        // first update the live image layout into destination optimal (the initial state
-        // image is always and permanently in source optimal already).
-        dstimBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        dstimBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-        for(size_t si = 0; si < m_ImageLayouts[id].subresourceStates.size(); si++)
-        {
-          dstimBarrier.subresourceRange = m_ImageLayouts[id].subresourceStates[si].subresourceRange;
-          dstimBarrier.oldLayout = m_ImageLayouts[id].subresourceStates[si].newLayout;
-          dstimBarrier.srcAccessMask =
-              VK_ACCESS_ALL_WRITE_BITS | MakeAccessMask(dstimBarrier.oldLayout);
-          DoPipelineBarrier(cmd, 1, &dstimBarrier);
-        }
-
         ObjDisp(cmd)->CmdCopyBufferToImage(Unwrap(cmd), buf->real.As<VkBuffer>(),
                                            ToHandle<VkImage>(live),
                                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
@@ -2392,63 +2824,29 @@ void WrappedVulkan::Apply_InitialState(WrappedVkRes *live,
                                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
         }
 
-        // update the live image layout back
-        dstimBarrier.oldLayout = dstimBarrier.newLayout;
-
-        // make sure the apply completes before any further work
-        dstimBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        dstimBarrier.dstAccessMask = VK_ACCESS_ALL_READ_BITS;
-
-        for(size_t si = 0; si < m_ImageLayouts[id].subresourceStates.size(); si++)
-        {
-          dstimBarrier.subresourceRange = m_ImageLayouts[id].subresourceStates[si].subresourceRange;
-          dstimBarrier.newLayout = m_ImageLayouts[id].subresourceStates[si].newLayout;
-          dstimBarrier.dstAccessMask |= MakeAccessMask(dstimBarrier.newLayout);
-          DoPipelineBarrier(cmd, 1, &dstimBarrier);
-        }
-
         // update the extent for the next mip
         extent.width = RDCMAX(extent.width >> 1, 1U);
         extent.height = RDCMAX(extent.height >> 1, 1U);
         extent.depth = RDCMAX(extent.depth >> 1, 1U);
       }
     }
-
-    vkr = ObjDisp(cmd)->EndCommandBuffer(Unwrap(cmd));
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-#if ENABLED(SINGLE_FLUSH_VALIDATE)
-    SubmitCmds();
-#endif
   }
   else if(type == eResDeviceMemory)
   {
-    VkResult vkr = VK_SUCCESS;
-
-    VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
-                                          VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+    // memory copies don't need any transitions, so after the first apply there's nothing to do
+    if(m_InitialContentsArena.copiesRecorded)
+      return;
 
     VkBuffer srcBuf = (VkBuffer)(uint64_t)initial.resource;
-    VkDeviceSize datasize = (VkDeviceSize)initial.num;
-    VkDeviceSize dstMemOffs = 0;
 
-    VkCommandBuffer cmd = GetNextCmd();
+    // only the saved regions are restored, the rest of the memory wasn't referenced
+    VkBufferCopy *regions = (VkBufferCopy *)initial.blob;
 
-    vkr = ObjDisp(cmd)->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
+    VkCommandBuffer cmd = m_InitialContentsArena.copyCmd;
 
     VkBuffer dstBuf = m_CreationInfo.m_Memory[id].wholeMemBuf;
 
-    VkBufferCopy region = {0, dstMemOffs, datasize};
-
-    ObjDisp(cmd)->CmdCopyBuffer(Unwrap(cmd), Unwrap(srcBuf), Unwrap(dstBuf), 1, &region);
-
-    vkr = ObjDisp(cmd)->EndCommandBuffer(Unwrap(cmd));
-    RDCASSERTEQUAL(vkr, VK_SUCCESS);
-
-#if ENABLED(SINGLE_FLUSH_VALIDATE)
-    SubmitCmds();
-#endif
+    ObjDisp(cmd)->CmdCopyBuffer(Unwrap(cmd), Unwrap(srcBuf), Unwrap(dstBuf), initial.num, regions);
   }
   else
   {
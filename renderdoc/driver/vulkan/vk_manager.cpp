@@ -272,7 +272,16 @@ void VulkanResourceManager::SerialiseImageStates(map<ResourceId, ImageLayouts> &
   for(uint32_t i = 0; i < NumMems; i++)
   {
     SERIALISE_ELEMENT(ResourceId, id, srcit->first);
-    SERIALISE_ELEMENT(uint32_t, NumStates, (uint32_t)srcit->second.subresourceStates.size());
+
+    // while capturing, submits on other threads update each image's states under its own lock
+    vector<ImageRegionState> imageStates;
+    if(m_State >= WRITING)
+    {
+      SCOPED_LOCK(srcit->second.lock);
+      imageStates = srcit->second.subresourceStates;
+    }
+
+    SERIALISE_ELEMENT(uint32_t, NumStates, (uint32_t)imageStates.size());
 
     ResourceId liveid;
     if(m_State < WRITING && HasLiveResource(id))
@@ -280,7 +289,7 @@ void VulkanResourceManager::SerialiseImageStates(map<ResourceId, ImageLayouts> &
 
     for(uint32_t m = 0; m < NumStates; m++)
     {
-      SERIALISE_ELEMENT(ImageRegionState, state, srcit->second.subresourceStates[m]);
+      SERIALISE_ELEMENT(ImageRegionState, state, imageStates[m]);
 
       if(m_State < WRITING && liveid != ResourceId() && srcit != states.end())
       {
@@ -346,11 +355,103 @@ void VulkanResourceManager::MarkSparseMapReferenced(SparseMapping *sparse)
       MarkResourceFrameReferenced(GetResID(sparse->pages[a][i].first), eFrameRef_Read);
 }
 
+static bool ImageRangeOverlaps(const VkImageSubresourceRange &r, uint32_t baseMip, uint32_t numMips,
+                               uint32_t baseLayer, uint32_t numLayers)
+{
+  return r.baseMipLevel < baseMip + numMips && baseMip < r.baseMipLevel + r.levelCount &&
+         r.baseArrayLayer < baseLayer + numLayers && baseLayer < r.baseArrayLayer + r.layerCount;
+}
+
+static ImageRegionState ImageRangePiece(const ImageRegionState &state, uint32_t baseMip,
+                                        uint32_t numMips, uint32_t baseLayer, uint32_t numLayers)
+{
+  ImageRegionState ret = state;
+  ret.subresourceRange.baseMipLevel = baseMip;
+  ret.subresourceRange.levelCount = numMips;
+  ret.subresourceRange.baseArrayLayer = baseLayer;
+  ret.subresourceRange.layerCount = numLayers;
+  return ret;
+}
+
+static bool SameImageRangeState(const ImageRegionState &a, const ImageRegionState &b)
+{
+  return a.subresourceRange.aspectMask == b.subresourceRange.aspectMask &&
+         a.oldLayout == b.oldLayout && a.newLayout == b.newLayout;
+}
+
+static bool SortLayersThenMips(const ImageRegionState &a, const ImageRegionState &b)
+{
+  const VkImageSubresourceRange &ra = a.subresourceRange, &rb = b.subresourceRange;
+  if(ra.baseArrayLayer != rb.baseArrayLayer)
+    return ra.baseArrayLayer < rb.baseArrayLayer;
+  if(ra.layerCount != rb.layerCount)
+    return ra.layerCount < rb.layerCount;
+  return ra.baseMipLevel < rb.baseMipLevel;
+}
+
+static bool SortMipsThenLayers(const ImageRegionState &a, const ImageRegionState &b)
+{
+  const VkImageSubresourceRange &ra = a.subresourceRange, &rb = b.subresourceRange;
+  if(ra.baseMipLevel != rb.baseMipLevel)
+    return ra.baseMipLevel < rb.baseMipLevel;
+  if(ra.levelCount != rb.levelCount)
+    return ra.levelCount < rb.levelCount;
+  return ra.baseArrayLayer < rb.baseArrayLayer;
+}
+
+// merge neighbouring ranges in the same state - first runs of mips over the same layers, then
+// runs of layers over the same mips - so that transitioning every subresource one at a time
+// collapses back down instead of leaving one range per subresource.
+static void CoalesceImageRanges(vector<ImageRegionState> &ranges)
+{
+  if(ranges.size() < 2)
+    return;
+
+  std::sort(ranges.begin(), ranges.end(), SortLayersThenMips);
+
+  size_t out = 0;
+  for(size_t i = 1; i < ranges.size(); i++)
+  {
+    VkImageSubresourceRange &prev = ranges[out].subresourceRange;
+    const VkImageSubresourceRange &cur = ranges[i].subresourceRange;
+
+    if(SameImageRangeState(ranges[out], ranges[i]) && prev.baseArrayLayer == cur.baseArrayLayer &&
+       prev.layerCount == cur.layerCount && prev.baseMipLevel + prev.levelCount == cur.baseMipLevel)
+      prev.levelCount += cur.levelCount;
+    else
+      ranges[++out] = ranges[i];
+  }
+  ranges.resize(out + 1);
+
+  std::sort(ranges.begin(), ranges.end(), SortMipsThenLayers);
+
+  out = 0;
+  for(size_t i = 1; i < ranges.size(); i++)
+  {
+    VkImageSubresourceRange &prev = ranges[out].subresourceRange;
+    const VkImageSubresourceRange &cur = ranges[i].subresourceRange;
+
+    if(SameImageRangeState(ranges[out], ranges[i]) && prev.baseMipLevel == cur.baseMipLevel &&
+       prev.levelCount == cur.levelCount &&
+       prev.baseArrayLayer + prev.layerCount == cur.baseArrayLayer)
+      prev.layerCount += cur.layerCount;
+    else
+      ranges[++out] = ranges[i];
+  }
+  ranges.resize(out + 1);
+
+  // keep slice-major order
+  std::sort(ranges.begin(), ranges.end(), SortLayersThenMips);
+}
+
 void VulkanResourceManager::ApplyBarriers(vector<pair<ResourceId, ImageRegionState> > &states,
-                                          map<ResourceId, ImageLayouts> &layouts)
+                                          map<ResourceId, ImageLayouts> &layouts,
+                                          Threading::CriticalSection *layoutsLock)
 {
   TRDBG("Applying %u barriers", (uint32_t)states.size());
 
+  vector<ImageRegionState> updated;
+
   for(size_t ti = 0; ti < states.size(); ti++)
   {
     ResourceId id = states[ti].first;
@@ -358,20 +459,32 @@ void VulkanResourceManager::ApplyBarriers(vector<pair<ResourceId, ImageRegionSta
 
     TRDBG("Applying barrier to %llu", GetOriginalID(id));
 
-    auto stit = layouts.find(id);
+    map<ResourceId, ImageLayouts>::iterator stit;
+
+    // the map lock is only needed to find the image, updating it only takes its own lock.
+    if(layoutsLock)
+      layoutsLock->Lock();
 
-    if(stit == layouts.end())
+    stit = layouts.find(id);
+    bool found = (stit != layouts.end());
+
+    if(layoutsLock)
+      layoutsLock->Unlock();
+
+    if(!found)
     {
       TRDBG("Didn't find ID in image layouts");
       continue;
     }
 
+    ImageLayouts &layout = stit->second;
+
     uint32_t nummips = t.subresourceRange.levelCount;
     uint32_t numslices = t.subresourceRange.layerCount;
     if(nummips == VK_REMAINING_MIP_LEVELS)
-      nummips = layouts[id].levelCount;
+      nummips = layout.levelCount;
     if(numslices == VK_REMAINING_ARRAY_LAYERS)
-      numslices = layouts[id].layerCount;
+      numslices = layout.layerCount;
 
     if(nummips == 0)
       nummips = 1;
@@ -387,148 +500,119 @@ void VulkanResourceManager::ApplyBarriers(vector<pair<ResourceId, ImageRegionSta
           t.subresourceRange.layerCount, ToStr::Get(t.oldLayout).c_str(),
           ToStr::Get(t.newLayout).c_str());
 
-    bool done = false;
+    SCOPED_LOCK(layout.lock);
+
+    vector<ImageRegionState> &ranges = layout.subresourceStates;
 
-    TRDBG("Matching image has %u subresource states", stit->second.subresourceStates.size());
+    TRDBG("Matching image has %u subresource states", ranges.size());
 
-    auto it = stit->second.subresourceStates.begin();
-    for(; it != stit->second.subresourceStates.end(); ++it)
+    // image layouts are tracked as a list of disjoint mip/layer ranges covering the image, which
+    // starts as one range for the whole image. Depth-stencil images must always be transitioned
+    // together for both aspects, so we can ignore the aspect here.
+    //
+    // the common case is a barrier exactly matching a range we already have, e.g. a whole image,
+    // or the same subresource transitioned on its own as before.
+    bool done = false;
+
+    for(size_t i = 0; i < ranges.size(); i++)
     {
-      TRDBG(".. state %s (%u->%u, %u->%u) from %s to %s",
-            ToStr::Get(it->subresourceRange.aspect).c_str(), it->range.baseMipLevel,
-            it->range.levelCount, it->range.baseArrayLayer, it->range.layerCount,
-            ToStr::Get(it->oldLayout).c_str(), ToStr::Get(it->newLayout).c_str());
-
-      // image barriers are handled by initially inserting one subresource range for the whole
-      // object,
-      // and whenever we need more fine-grained detail we split it immediately.
-      // Thereafter if a barrier comes in that covers multiple subresources, we update all matching
-      // ranges.
-      // NOTE: Depth-stencil images must always be trasnsitioned together for both aspects, so we
-      // don't
-      // have to worry about different aspects being in different states and can in fact ignore the
-      // aspect
-      // for the purpose of this case.
+      ImageRegionState &r = ranges[i];
 
+      if(r.subresourceRange.baseMipLevel == t.subresourceRange.baseMipLevel &&
+         r.subresourceRange.levelCount == nummips &&
+         r.subresourceRange.baseArrayLayer == t.subresourceRange.baseArrayLayer &&
+         r.subresourceRange.layerCount == numslices)
       {
-        // we've found a range that completely matches our region, doesn't matter if that's
-        // a whole image and the barrier is the whole image, or it's one subresource.
-        // note that for images with only one array/mip slice (e.g. render targets) we'll never
-        // really have to worry about the else{} branch
-        if(it->subresourceRange.baseMipLevel == t.subresourceRange.baseMipLevel &&
-           it->subresourceRange.levelCount == nummips &&
-           it->subresourceRange.baseArrayLayer == t.subresourceRange.baseArrayLayer &&
-           it->subresourceRange.layerCount == numslices)
-        {
-          /*
-          RDCASSERT(t.oldLayout == UNKNOWN_PREV_IMG_LAYOUT || it->newLayout ==
-          UNKNOWN_PREV_IMG_LAYOUT || // renderdoc untracked/ignored
-                    it->newLayout == t.oldLayout || // valid barrier
-                    t.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED); // can barrier from UNDEFINED to any
-          state
-          */
-          if(it->oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
-            it->oldLayout = t.oldLayout;
-          t.oldLayout = it->newLayout;
-          it->newLayout = t.newLayout;
+        if(r.oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
+          r.oldLayout = t.oldLayout;
+        t.oldLayout = r.newLayout;
+        r.newLayout = t.newLayout;
 
-          done = true;
-          break;
-        }
-        else
-        {
-          // this handles the case where the barrier covers a number of subresources and we need
-          // to update each matching subresource. If the barrier was only one mip & array slice
-          // it would have hit the case above. Find each subresource within the range, update it,
-          // and continue (marking as done so whenever we stop finding matching ranges, we are
-          // satisfied.
-          //
-          // note that regardless of how we lay out our subresources (slice-major or mip-major) the
-          // new
-          // range could be sparse, but that's OK as we only break out of the loop once we go past
-          // the whole
-          // aspect. Any subresources that don't match the range, after the split, will fail to meet
-          // any
-          // of the handled cases, so we'll just continue processing.
-          if(it->subresourceRange.levelCount == 1 && it->subresourceRange.layerCount == 1 &&
-             it->subresourceRange.baseMipLevel >= t.subresourceRange.baseMipLevel &&
-             it->subresourceRange.baseMipLevel < t.subresourceRange.baseMipLevel + nummips &&
-             it->subresourceRange.baseArrayLayer >= t.subresourceRange.baseArrayLayer &&
-             it->subresourceRange.baseArrayLayer < t.subresourceRange.baseArrayLayer + numslices)
-          {
-            // apply it (prevstate is from the start of all barriers accumulated, so only set once)
-            if(it->oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
-              it->oldLayout = t.oldLayout;
-            it->newLayout = t.newLayout;
+        done = true;
+        break;
+      }
+    }
 
-            // continue as there might be more, but we're done
-            done = true;
-            continue;
-          }
-          // finally handle the case where we have a range that covers a whole image but we need to
-          // split it. If the barrier covered the whole image too it would have hit the very first
-          // case, so we know that the barrier doesn't cover the whole range.
-          // Also, if we've already done the split this case won't be hit and we'll either fall into
-          // the case above, or we'll finish as we've covered the whole barrier.
-          else if(it->subresourceRange.levelCount > 1 || it->subresourceRange.layerCount > 1)
-          {
-            ImageRegionState existing = *it;
-
-            // remember where we were in the array, as after this iterators will be
-            // invalidated.
-            size_t offs = it - stit->second.subresourceStates.begin();
-            size_t count = it->subresourceRange.levelCount * it->subresourceRange.layerCount;
-
-            // only insert count-1 as we want count entries total - one per subresource
-            stit->second.subresourceStates.insert(it, count - 1, existing);
-
-            // it now points at the first subresource, but we need to modify the ranges
-            // to be valid
-            it = stit->second.subresourceStates.begin() + offs;
-
-            for(size_t i = 0; i < count; i++)
-            {
-              it->subresourceRange.levelCount = 1;
-              it->subresourceRange.layerCount = 1;
-
-              // slice-major
-              it->subresourceRange.baseArrayLayer =
-                  uint32_t(i / existing.subresourceRange.levelCount);
-              it->subresourceRange.baseMipLevel = uint32_t(i % existing.subresourceRange.levelCount);
-              it++;
-            }
-
-            // reset the iterator to point to the first subresource
-            it = stit->second.subresourceStates.begin() + offs;
-
-            // the loop will continue after this point and look at the next subresources
-            // so we need to check to see if the first subresource lies in the range here
-            if(it->subresourceRange.baseMipLevel >= t.subresourceRange.baseMipLevel &&
-               it->subresourceRange.baseMipLevel < t.subresourceRange.baseMipLevel + nummips &&
-               it->subresourceRange.baseArrayLayer >= t.subresourceRange.baseArrayLayer &&
-               it->subresourceRange.baseArrayLayer < t.subresourceRange.baseArrayLayer + numslices)
-            {
-              // apply it (prevstate is from the start of all barriers accumulated, so only set
-              // once)
-              if(it->oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
-                it->oldLayout = t.oldLayout;
-              it->newLayout = t.newLayout;
-
-              // continue as there might be more, but we're done
-              done = true;
-            }
-
-            // continue processing from here
-            continue;
-          }
-        }
+    if(done)
+    {
+      CoalesceImageRanges(ranges);
+      continue;
+    }
+
+    // otherwise split each range the barrier overlaps into the parts outside the barrier, which
+    // keep their state, and the part inside it which takes the new layout.
+    updated.clear();
+    updated.reserve(ranges.size() + 4);
+
+    bool samePrev = true;
+    VkImageLayout prevLayout = UNKNOWN_PREV_IMG_LAYOUT;
+
+    for(size_t i = 0; i < ranges.size(); i++)
+    {
+      const ImageRegionState &r = ranges[i];
+      const VkImageSubresourceRange &rr = r.subresourceRange;
+
+      if(!ImageRangeOverlaps(rr, t.subresourceRange.baseMipLevel, nummips,
+                             t.subresourceRange.baseArrayLayer, numslices))
+      {
+        updated.push_back(r);
+        continue;
       }
 
-      // otherwise continue to try and find the subresource range
+      uint32_t rMipEnd = rr.baseMipLevel + rr.levelCount;
+      uint32_t rLayerEnd = rr.baseArrayLayer + rr.layerCount;
+
+      uint32_t mipStart = RDCMAX(rr.baseMipLevel, t.subresourceRange.baseMipLevel);
+      uint32_t mipEnd = RDCMIN(rMipEnd, t.subresourceRange.baseMipLevel + nummips);
+      uint32_t layerStart = RDCMAX(rr.baseArrayLayer, t.subresourceRange.baseArrayLayer);
+      uint32_t layerEnd = RDCMIN(rLayerEnd, t.subresourceRange.baseArrayLayer + numslices);
+
+      // layers either side of the barrier, over all of this range's mips
+      if(rr.baseArrayLayer < layerStart)
+        updated.push_back(ImageRangePiece(r, rr.baseMipLevel, rr.levelCount, rr.baseArrayLayer,
+                                          layerStart - rr.baseArrayLayer));
+      if(layerEnd < rLayerEnd)
+        updated.push_back(
+            ImageRangePiece(r, rr.baseMipLevel, rr.levelCount, layerEnd, rLayerEnd - layerEnd));
+
+      // mips either side of the barrier, within the barrier's layers
+      if(rr.baseMipLevel < mipStart)
+        updated.push_back(ImageRangePiece(r, rr.baseMipLevel, mipStart - rr.baseMipLevel,
+                                          layerStart, layerEnd - layerStart));
+      if(mipEnd < rMipEnd)
+        updated.push_back(
+            ImageRangePiece(r, mipEnd, rMipEnd - mipEnd, layerStart, layerEnd - layerStart));
+
+      ImageRegionState inside =
+          ImageRangePiece(r, mipStart, mipEnd - mipStart, layerStart, layerEnd - layerStart);
+
+      if(done && prevLayout != r.newLayout)
+        samePrev = false;
+      prevLayout = r.newLayout;
+
+      // prevstate is from the start of all barriers accumulated, so only set once
+      if(inside.oldLayout == UNKNOWN_PREV_IMG_LAYOUT)
+        inside.oldLayout = t.oldLayout;
+      inside.newLayout = t.newLayout;
+
+      updated.push_back(inside);
+
+      done = true;
     }
 
     if(!done)
+    {
       RDCERR("Couldn't find subresource range to apply barrier to - invalid!");
+      continue;
+    }
+
+    // if the whole barrier came from one layout, report it like an exact match would
+    if(samePrev)
+      t.oldLayout = prevLayout;
+
+    CoalesceImageRanges(updated);
+
+    ranges.swap(updated);
   }
 }
 
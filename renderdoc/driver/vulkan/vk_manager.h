@@ -111,8 +111,11 @@ public:
   void MergeBarriers(vector<pair<ResourceId, ImageRegionState> > &dststates,
                      vector<pair<ResourceId, ImageRegionState> > &srcstates);
 
+  // if layoutsLock is given, it's only held while looking up each image in layouts. The update
+  // itself takes that image's own lock
   void ApplyBarriers(vector<pair<ResourceId, ImageRegionState> > &states,
-                     map<ResourceId, ImageLayouts> &layouts);
+                     map<ResourceId, ImageLayouts> &layouts,
+                     Threading::CriticalSection *layoutsLock = NULL);
 
   void SerialiseImageStates(map<ResourceId, ImageLayouts> &states,
                             vector<VkImageMemoryBarrier> &barriers);
@@ -4566,12 +4566,19 @@ void VulkanReplay::InitPostVSBuffers(const vector<uint32_t> &events)
   // command buffer
   m_pDriver->ReplayLog(0, events.front(), eReplay_WithoutDraw);
 
-  InitPostVSCallback cb(m_pDriver, events);
+  // don't free anything until the replay has finished, since that needs to flush the queue
+  GetDebugManager()->BeginPostVSPass(events);
 
-  // now we replay the events, which are guaranteed (because we generated them in
-  // GetPassEvents above) to come from the same command buffer, so the event IDs are
-  // still locally continuous, even if we jump into replaying.
-  m_pDriver->ReplayLog(events.front(), events.back(), eReplay_Full);
+  {
+    InitPostVSCallback cb(m_pDriver, events);
+
+    // now we replay the events, which are guaranteed (because we generated them in
+    // GetPassEvents above) to come from the same command buffer, so the event IDs are
+    // still locally continuous, even if we jump into replaying.
+    m_pDriver->ReplayLog(events.front(), events.back(), eReplay_Full);
+  }
+
+  GetDebugManager()->EndPostVSPass();
 }
 
 vector<EventUsage> VulkanReplay::GetUsage(ResourceId id)
@@ -4598,6 +4605,17 @@ byte *VulkanReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t m
 
   VulkanCreationInfo::Image &imInfo = m_pDriver->m_CreationInfo.m_Image[tex];
 
+  // ASTC blocks other than 4x4 can't be cropped to, so fail rather than silently returning the
+  // whole subresource
+  if(!params.region.IsWhole() && imInfo.format >= VK_FORMAT_ASTC_5x4_UNORM_BLOCK &&
+     imInfo.format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+  {
+    RDCERR("Can't read a region of %s image %llu, only 4x4 ASTC blocks are supported",
+           ToStr::Get(imInfo.format).c_str(), tex);
+    dataSize = 0;
+    return new byte[0];
+  }
+
   ImageLayouts &layouts = m_pDriver->m_ImageLayouts[tex];
 
   VkImageCreateInfo imCreateInfo = {
@@ -5137,16 +5155,38 @@ byte *VulkanReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t m
     copyregion[i].imageExtent.depth = RDCMAX(1U, copyregion[i].imageExtent.depth >> mip);
   }
 
+  if(!params.region.IsWhole())
+  {
+    VkExtent3D &extent = copyregion[0].imageExtent;
+
+    TextureRegion region =
+        ClampTextureRegion(params.region, extent.width, extent.height,
+                           imCreateInfo.imageType == VK_IMAGE_TYPE_3D ? extent.depth : 1,
+                           IsBlockFormat(imCreateInfo.format) ? 4 : 1);
+
+    for(int i = 0; i < 2; i++)
+    {
+      copyregion[i].imageOffset.x = (int32_t)region.x;
+      copyregion[i].imageOffset.y = (int32_t)region.y;
+      copyregion[i].imageOffset.z = (int32_t)region.z;
+      copyregion[i].imageExtent.width = region.width;
+      copyregion[i].imageExtent.height = region.height;
+      copyregion[i].imageExtent.depth = region.depth;
+    }
+  }
+
+  const VkExtent3D &copyExtent = copyregion[0].imageExtent;
+
   // for most combined depth-stencil images this will be large enough for both to be copied
   // separately, but for D24S8 we need to add extra space since they won't be copied packed
-  dataSize = GetByteSize(imInfo.extent.width, imInfo.extent.height, imInfo.extent.depth,
-                         imCreateInfo.format, mip);
+  dataSize = GetByteSize(copyExtent.width, copyExtent.height, copyExtent.depth,
+                         imCreateInfo.format, 0);
 
   if(imCreateInfo.format == VK_FORMAT_D24_UNORM_S8_UINT)
   {
     dataSize = AlignUp(dataSize, (size_t)4);
-    dataSize += GetByteSize(imInfo.extent.width, imInfo.extent.height, imInfo.extent.depth,
-                            VK_FORMAT_S8_UINT, mip);
+    dataSize +=
+        GetByteSize(copyExtent.width, copyExtent.height, copyExtent.depth, VK_FORMAT_S8_UINT, 0);
   }
 
   VkBufferCreateInfo bufInfo = {
@@ -5179,9 +5219,9 @@ byte *VulkanReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t m
 
   if(isDepth && isStencil)
   {
-    copyregion[1].bufferOffset =
-        GetByteSize(imInfo.extent.width, imInfo.extent.height, imInfo.extent.depth,
-                    GetDepthOnlyFormat(imCreateInfo.format), mip);
+    copyregion[1].bufferOffset = GetByteSize(copyExtent.width, copyExtent.height,
+                                             copyExtent.depth,
+                                             GetDepthOnlyFormat(imCreateInfo.format), 0);
 
     copyregion[1].bufferOffset = AlignUp(copyregion[1].bufferOffset, (VkDeviceSize)4);
 
@@ -5242,8 +5282,7 @@ byte *VulkanReplay::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t m
 
   if(isDepth && isStencil)
   {
-    size_t pixelCount =
-        imCreateInfo.extent.width * imCreateInfo.extent.height * imCreateInfo.extent.depth;
+    size_t pixelCount = copyExtent.width * copyExtent.height * copyExtent.depth;
 
     if(imCreateInfo.format == VK_FORMAT_D16_UNORM_S8_UINT)
     {
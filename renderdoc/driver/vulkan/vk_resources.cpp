@@ -760,6 +760,107 @@ VkResourceRecord::~VkResourceRecord()
     SAFE_DELETE(descInfo);
 }
 
+void DescSetBindRefs::Add(ResourceId id, FrameRefType ref, bool sparse)
+{
+  // keep the table at most half full
+  if((m_Refs.size() + 1) * 2 > m_Slots.size())
+    Rehash();
+
+  size_t slot = FindSlot(id);
+
+  if(m_Slots[slot] == 0)
+  {
+    DescSetBindRef newRef = {id, 0, ref, sparse};
+    m_Refs.push_back(newRef);
+    m_Slots[slot] = (uint32_t)m_Refs.size();
+  }
+
+  DescSetBindRef &bindRef = m_Refs[m_Slots[slot] - 1];
+
+  if(bindRef.count == 0)
+  {
+    bindRef.ref = ref;
+    bindRef.sparse = sparse;
+
+    m_Live++;
+    if(IsWrite(ref))
+      m_Writes++;
+  }
+  else if(ref == eFrameRef_Write && bindRef.ref == eFrameRef_Read)
+  {
+    // be conservative - mark refs as read before write if we see a write and a read ref on it
+    bindRef.ref = eFrameRef_ReadBeforeWrite;
+    m_Writes++;
+  }
+
+  bindRef.count++;
+}
+
+void DescSetBindRefs::Remove(ResourceId id)
+{
+  if(m_Slots.empty())
+    return;
+
+  size_t slot = FindSlot(id);
+
+  // in the case of re-used handles bound to descriptor sets,
+  // it's possible to try and remove a frameref on something we
+  // don't have (which means we'll have a corresponding stale ref)
+  // but this is harmless so we can ignore it.
+  if(m_Slots[slot] == 0)
+    return;
+
+  DescSetBindRef &bindRef = m_Refs[m_Slots[slot] - 1];
+
+  if(bindRef.count == 0)
+    return;
+
+  bindRef.count--;
+
+  // leave the entry where it is, the same resource is likely to be bound again soon. It's dropped
+  // the next time the table is rehashed
+  if(bindRef.count == 0)
+  {
+    m_Live--;
+    if(IsWrite(bindRef.ref))
+      m_Writes--;
+  }
+}
+
+size_t DescSetBindRefs::FindSlot(ResourceId id) const
+{
+  size_t mask = m_Slots.size() - 1;
+
+  // IDs are sequential, so mix the bits before masking
+  size_t slot = size_t((id.id * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+
+  while(m_Slots[slot] != 0 && m_Refs[m_Slots[slot] - 1].id != id)
+    slot = (slot + 1) & mask;
+
+  return slot;
+}
+
+void DescSetBindRefs::Rehash()
+{
+  // drop any unreferenced entries
+  size_t live = 0;
+  for(size_t i = 0; i < m_Refs.size(); i++)
+    if(m_Refs[i].count > 0)
+      m_Refs[live++] = m_Refs[i];
+
+  m_Refs.resize(live);
+
+  // leave the table at most a quarter full, so the rehash cost is amortised over as many adds
+  size_t slotCount = RDCMAX(m_Slots.size(), (size_t)16);
+  while(slotCount < (live + 1) * 4)
+    slotCount *= 2;
+
+  m_Slots.assign(slotCount, 0);
+
+  for(size_t i = 0; i < live; i++)
+    m_Slots[FindSlot(m_Refs[i].id)] = uint32_t(i + 1);
+}
+
 void SparseMapping::Update(uint32_t numBindings, const VkSparseImageMemoryBind *pBindings)
 {
   // update image page table mappings
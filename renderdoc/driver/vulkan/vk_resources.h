@@ -892,6 +892,50 @@ struct CmdBufferRecordingInfo
 
 struct DescSetLayout;
 
+struct DescSetBindRef
+{
+  ResourceId id;
+  // number of descriptors in the set referencing this resource. Entries with a count of 0 are
+  // left in place to be re-used, and should be skipped
+  uint32_t count;
+  FrameRefType ref;
+  // this resource has sparse mapping information
+  bool sparse;
+};
+
+// the resources referenced by a descriptor set's bindings, refcounted so that an update only
+// touches the resources of the descriptors it changes. The entries are kept in a flat array so
+// they can be walked quickly on bind and submit, and are looked up through an open-addressed hash
+// table of indices into that array.
+class DescSetBindRefs
+{
+public:
+  DescSetBindRefs() : m_Live(0), m_Writes(0) {}
+  void Add(ResourceId id, FrameRefType ref, bool sparse);
+  void Remove(ResourceId id);
+
+  typedef vector<DescSetBindRef>::const_iterator const_iterator;
+  const_iterator begin() const { return m_Refs.begin(); }
+  const_iterator end() const { return m_Refs.end(); }
+  // if any resource could be written through this set
+  bool HasWrites() const { return m_Writes > 0; }
+private:
+  size_t FindSlot(ResourceId id) const;
+  void Rehash();
+
+  static bool IsWrite(FrameRefType ref)
+  {
+    return ref == eFrameRef_Write || ref == eFrameRef_ReadBeforeWrite;
+  }
+
+  vector<DescSetBindRef> m_Refs;
+  // power of two sized, each is an index into m_Refs plus one, or 0 if the slot is empty
+  vector<uint32_t> m_Slots;
+  // number of entries with a non-zero count, and how many of those are written
+  size_t m_Live;
+  size_t m_Writes;
+};
+
 struct DescriptorSetData
 {
   DescriptorSetData() : layout(NULL) {}
@@ -911,10 +955,7 @@ struct DescriptorSetData
   // contains the framerefs (ref counted) for the bound resources
   // in the binding slots. Updated when updating descriptor sets
   // and then applied in a block on descriptor set bind.
-  // the refcount has the high-bit set if this resource has sparse
-  // mapping information
-  static const uint32_t SPARSE_REF_BIT = 0x80000000;
-  map<ResourceId, pair<uint32_t, FrameRefType> > bindFrameRefs;
+  DescSetBindRefs bindFrameRefs;
 };
 
 struct MemMapState
@@ -937,6 +978,17 @@ struct MemMapState
   byte *refData;
 };
 
+// the buffers and images bound into a memory object, so that initial contents only need to cover
+// the parts of the memory that a frame references
+struct MemoryBindings
+{
+  MemoryBindings() : untracked(false) {}
+  // bound resource -> offset and size within the memory
+  map<ResourceId, pair<VkDeviceSize, VkDeviceSize> > ranges;
+  // the memory is also used in ways that aren't tracked, e.g. sparse binding
+  bool untracked;
+};
+
 struct AttachmentInfo
 {
   VkResourceRecord *record;
@@ -989,18 +1041,7 @@ public:
       return;
     }
 
-    if((descInfo->bindFrameRefs[id].first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
-    {
-      descInfo->bindFrameRefs[id] =
-          std::make_pair(1 | (hasSparse ? DescriptorSetData::SPARSE_REF_BIT : 0), ref);
-    }
-    else
-    {
-      // be conservative - mark refs as read before write if we see a write and a read ref on it
-      if(ref == eFrameRef_Write && descInfo->bindFrameRefs[id].second == eFrameRef_Read)
-        descInfo->bindFrameRefs[id].second = eFrameRef_ReadBeforeWrite;
-      descInfo->bindFrameRefs[id].first++;
-    }
+    descInfo->bindFrameRefs.Add(id, ref, hasSparse);
   }
 
   void RemoveBindFrameRef(ResourceId id)
@@ -1010,19 +1051,7 @@ public:
     if(id == ResourceId())
       return;
 
-    auto it = descInfo->bindFrameRefs.find(id);
-
-    // in the case of re-used handles bound to descriptor sets,
-    // it's possible to try and remove a frameref on something we
-    // don't have (which means we'll have a corresponding stale ref)
-    // but this is harmless so we can ignore it.
-    if(it == descInfo->bindFrameRefs.end())
-      return;
-
-    it->second.first--;
-
-    if((it->second.first & ~DescriptorSetData::SPARSE_REF_BIT) == 0)
-      descInfo->bindFrameRefs.erase(it);
+    descInfo->bindFrameRefs.Remove(id);
   }
 
   // we have a lot of 'cold' data in the resource record, as it can be accessed
@@ -1144,10 +1173,15 @@ struct ImageLayouts
     extent.width = extent.height = extent.depth = 1;
   }
 
+  // disjoint ranges covering the whole image, with neighbours in the same state coalesced
   vector<ImageRegionState> subresourceStates;
   int layerCount, levelCount, sampleCount;
   VkExtent3D extent;
   VkFormat format;
+
+  // protects subresourceStates while applying barriers, so submits on different threads only
+  // contend when they touch the same image
+  Threading::CriticalSection lock;
 };
 
 bool IsBlockFormat(VkFormat f);
@@ -1409,12 +1409,19 @@ void WrappedVulkan::vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer,
     {
       VkResourceRecord *descSet = GetRecord(pDescriptorSets[i]);
 
-      map<ResourceId, pair<uint32_t, FrameRefType> > &frameRefs = descSet->descInfo->bindFrameRefs;
+      const DescSetBindRefs &frameRefs = descSet->descInfo->bindFrameRefs;
+
+      // most sets only read from their resources, don't walk them at all
+      if(!frameRefs.HasWrites())
+        continue;
 
       for(auto it = frameRefs.begin(); it != frameRefs.end(); ++it)
       {
-        if(it->second.second == eFrameRef_Write || it->second.second == eFrameRef_ReadBeforeWrite)
-          record->cmdInfo->dirtied.insert(it->first);
+        if(it->count == 0)
+          continue;
+
+        if(it->ref == eFrameRef_Write || it->ref == eFrameRef_ReadBeforeWrite)
+          record->cmdInfo->dirtied.insert(it->id);
       }
     }
   }
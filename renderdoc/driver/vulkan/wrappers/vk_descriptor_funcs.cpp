@@ -777,11 +777,14 @@ void WrappedVulkan::vkUpdateDescriptorSets(VkDevice device, uint32_t writeCount,
         for(auto refit = setrecord->descInfo->bindFrameRefs.begin();
             refit != setrecord->descInfo->bindFrameRefs.end(); ++refit)
         {
-          GetResourceManager()->MarkResourceFrameReferenced(refit->first, refit->second.second);
+          if(refit->count == 0)
+            continue;
 
-          if(refit->second.first & DescriptorSetData::SPARSE_REF_BIT)
+          GetResourceManager()->MarkResourceFrameReferenced(refit->id, refit->ref);
+
+          if(refit->sparse)
           {
-            VkResourceRecord *record = GetResourceManager()->GetResourceRecord(refit->first);
+            VkResourceRecord *record = GetResourceManager()->GetResourceRecord(refit->id);
 
             GetResourceManager()->MarkSparseMapReferenced(record->sparseInfo);
           }
@@ -28,6 +28,8 @@
 // vk_dispatchtables.cpp
 void InitDeviceTable(VkDevice dev, PFN_vkGetDeviceProcAddr gpa);
 void InitInstanceTable(VkInstance inst, PFN_vkGetInstanceProcAddr gpa);
+void RemoveDeviceTable(void *loaderTable);
+void RemoveInstanceTable(void *loaderTable);
 
 // Init/shutdown order:
 //
@@ -227,6 +229,7 @@ ReplayCreateStatus WrappedVulkan::Initialise(VkInitParams &params)
   m_QueueFamilyIdx = ~0U;
   m_Queue = VK_NULL_HANDLE;
   m_InternalCmds.Reset();
+  m_InitialContentsArena.Reset();
 
   if(ObjDisp(m_Instance)->CreateDebugReportCallbackEXT)
   {
@@ -367,6 +370,9 @@ void WrappedVulkan::Shutdown()
   for(size_t i = 0; i < m_InternalCmds.freecmds.size(); i++)
     GetResourceManager()->ReleaseWrappedResource(m_InternalCmds.freecmds[i]);
 
+  if(m_InitialContentsArena.copyCmd != VK_NULL_HANDLE)
+    GetResourceManager()->ReleaseWrappedResource(m_InitialContentsArena.copyCmd);
+
   // destroy the pool
   ObjDisp(m_Device)->DestroyCommandPool(Unwrap(m_Device), Unwrap(m_InternalCmds.cmdpool), NULL);
   GetResourceManager()->ReleaseWrappedResource(m_InternalCmds.cmdpool);
@@ -428,9 +434,15 @@ void WrappedVulkan::vkDestroyInstance(VkInstance instance, const VkAllocationCal
   // the device should already have been destroyed, assuming that the
   // application is well behaved. If not, we just leak.
 
+  void *loaderTable = LayerDisp(m_Instance);
+
   ObjDisp(m_Instance)->DestroyInstance(Unwrap(m_Instance), NULL);
   GetResourceManager()->ReleaseWrappedResource(m_Instance);
 
+  // the loader can reuse the dispatch pointer, and applications that create and destroy many
+  // instances would otherwise fill up the lookup
+  RemoveInstanceTable(loaderTable);
+
   RenderDoc::Inst().RemoveDeviceFrameCapturer(LayerDisp(m_Instance));
 
   m_Instance = VK_NULL_HANDLE;
@@ -1353,8 +1365,10 @@ void WrappedVulkan::vkDestroyDevice(VkDevice device, const VkAllocationCallbacks
   // should be deleted by now.
   // If there were any leaks, we will leak them ourselves in vkDestroyInstance
   // rather than try to delete API objects after the device has gone
+  void *loaderTable = LayerDisp(m_Device);
   ObjDisp(m_Device)->DestroyDevice(Unwrap(m_Device), pAllocator);
   GetResourceManager()->ReleaseWrappedResource(m_Device);
+  RemoveDeviceTable(loaderTable);
   m_Device = VK_NULL_HANDLE;
   m_PhysicalDevice = VK_NULL_HANDLE;
 }
@@ -78,8 +78,6 @@ void WrappedVulkan::MakeSubpassLoadRP(VkRenderPassCreateInfo &info,
     ObjDisp(device)->func(Unwrap(device), unwrappedObj, pAllocator);                               \
   }
 
-DESTROY_IMPL(VkBuffer, DestroyBuffer)
-DESTROY_IMPL(VkBufferView, DestroyBufferView)
 DESTROY_IMPL(VkImageView, DestroyImageView)
 DESTROY_IMPL(VkShaderModule, DestroyShaderModule)
 DESTROY_IMPL(VkPipeline, DestroyPipeline)
@@ -133,6 +131,37 @@ void WrappedVulkan::vkDestroySwapchainKHR(VkDevice device, VkSwapchainKHR obj,
   ObjDisp(device)->DestroySwapchainKHR(Unwrap(device), unwrappedObj, pAllocator);
 }
 
+// buffers, buffer views and images need to be separate to remove their memory bindings
+void WrappedVulkan::vkDestroyBuffer(VkDevice device, VkBuffer obj,
+                                    const VkAllocationCallbacks *pAllocator)
+{
+  if(obj == VK_NULL_HANDLE)
+    return;
+
+  // internal objects don't have records
+  if(m_State >= WRITING && GetRecord(obj))
+    RemoveMemoryBinding(GetRecord(obj)->baseResource, GetResID(obj));
+
+  VkBuffer unwrappedObj = Unwrap(obj);
+  GetResourceManager()->ReleaseWrappedResource(obj, true);
+  ObjDisp(device)->DestroyBuffer(Unwrap(device), unwrappedObj, pAllocator);
+}
+
+void WrappedVulkan::vkDestroyBufferView(VkDevice device, VkBufferView obj,
+                                        const VkAllocationCallbacks *pAllocator)
+{
+  if(obj == VK_NULL_HANDLE)
+    return;
+
+  // internal objects don't have records
+  if(m_State >= WRITING && GetRecord(obj))
+    RemoveMemoryBinding(GetRecord(obj)->baseResource, GetResID(obj));
+
+  VkBufferView unwrappedObj = Unwrap(obj);
+  GetResourceManager()->ReleaseWrappedResource(obj, true);
+  ObjDisp(device)->DestroyBufferView(Unwrap(device), unwrappedObj, pAllocator);
+}
+
 // needs to be separate so we don't erase from m_ImageLayouts in other destroy functions
 void WrappedVulkan::vkDestroyImage(VkDevice device, VkImage obj,
                                    const VkAllocationCallbacks *pAllocator)
@@ -144,6 +173,10 @@ void WrappedVulkan::vkDestroyImage(VkDevice device, VkImage obj,
     SCOPED_LOCK(m_ImageLayoutsLock);
     m_ImageLayouts.erase(GetResID(obj));
   }
+
+  // internal objects don't have records
+  if(m_State >= WRITING && GetRecord(obj))
+    RemoveMemoryBinding(GetRecord(obj)->baseResource, GetResID(obj));
   VkImage unwrappedObj = Unwrap(obj);
   GetResourceManager()->ReleaseWrappedResource(obj, true);
   return ObjDisp(device)->DestroyImage(Unwrap(device), unwrappedObj, pAllocator);
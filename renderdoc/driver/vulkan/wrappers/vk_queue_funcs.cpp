@@ -514,11 +514,8 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
 
       VkResourceRecord *record = GetRecord(pSubmits[s].pCommandBuffers[i]);
 
-      {
-        SCOPED_LOCK(m_ImageLayoutsLock);
-        GetResourceManager()->ApplyBarriers(record->bakedCommands->cmdInfo->imgbarriers,
-                                            m_ImageLayouts);
-      }
+      GetResourceManager()->ApplyBarriers(record->bakedCommands->cmdInfo->imgbarriers,
+                                          m_ImageLayouts, &m_ImageLayoutsLock);
 
       // need to lock the whole section of code, not just the check on
       // m_State, as we also need to make sure we don't check the state,
@@ -560,12 +557,15 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
           for(auto refit = setrecord->descInfo->bindFrameRefs.begin();
               refit != setrecord->descInfo->bindFrameRefs.end(); ++refit)
           {
-            refdIDs.insert(refit->first);
-            GetResourceManager()->MarkResourceFrameReferenced(refit->first, refit->second.second);
+            if(refit->count == 0)
+              continue;
 
-            if(refit->second.first & DescriptorSetData::SPARSE_REF_BIT)
+            refdIDs.insert(refit->id);
+            GetResourceManager()->MarkResourceFrameReferenced(refit->id, refit->ref);
+
+            if(refit->sparse)
             {
-              VkResourceRecord *sparserecord = GetResourceManager()->GetResourceRecord(refit->first);
+              VkResourceRecord *sparserecord = GetResourceManager()->GetResourceRecord(refit->id);
 
               GetResourceManager()->MarkSparseMapReferenced(sparserecord->sparseInfo);
             }
@@ -606,6 +606,12 @@ VkResult WrappedVulkan::vkQueueSubmit(VkQueue queue, uint32_t submitCount,
             m_CmdBufferRecords.push_back(record->bakedCommands->cmdInfo->subcmds[sub]->bakedCommands);
         }
 
+        // once submitted, the baked commands aren't read until the frame is written out, so they
+        // can be spilled to disk if the capture goes over its memory budget
+        record->bakedCommands->MakeChunksSpillable();
+        for(size_t sub = 0; sub < record->bakedCommands->cmdInfo->subcmds.size(); sub++)
+          record->bakedCommands->cmdInfo->subcmds[sub]->bakedCommands->MakeChunksSpillable();
+
         record->bakedCommands->AddRef();
       }
 
@@ -819,26 +825,46 @@ VkResult WrappedVulkan::vkQueueBindSparse(VkQueue queue, uint32_t bindInfoCount,
   // update our internal page tables
   if(m_State >= WRITING)
   {
+    // memory bound to sparse resources isn't covered by the tracked memory bindings
+    set<ResourceId> sparseMems;
+
     for(uint32_t i = 0; i < bindInfoCount; i++)
     {
       for(uint32_t buf = 0; buf < pBindInfo[i].bufferBindCount; buf++)
       {
         const VkSparseBufferMemoryBindInfo &bind = pBindInfo[i].pBufferBinds[buf];
         GetRecord(bind.buffer)->sparseInfo->Update(bind.bindCount, bind.pBinds);
+
+        for(uint32_t b = 0; b < bind.bindCount; b++)
+          if(bind.pBinds[b].memory != VK_NULL_HANDLE)
+            sparseMems.insert(GetResID(bind.pBinds[b].memory));
       }
 
       for(uint32_t op = 0; op < pBindInfo[i].imageOpaqueBindCount; op++)
       {
         const VkSparseImageOpaqueMemoryBindInfo &bind = pBindInfo[i].pImageOpaqueBinds[op];
         GetRecord(bind.image)->sparseInfo->Update(bind.bindCount, bind.pBinds);
+
+        for(uint32_t b = 0; b < bind.bindCount; b++)
+          if(bind.pBinds[b].memory != VK_NULL_HANDLE)
+            sparseMems.insert(GetResID(bind.pBinds[b].memory));
       }
 
       for(uint32_t op = 0; op < pBindInfo[i].imageBindCount; op++)
       {
         const VkSparseImageMemoryBindInfo &bind = pBindInfo[i].pImageBinds[op];
         GetRecord(bind.image)->sparseInfo->Update(bind.bindCount, bind.pBinds);
+
+        for(uint32_t b = 0; b < bind.bindCount; b++)
+          if(bind.pBinds[b].memory != VK_NULL_HANDLE)
+            sparseMems.insert(GetResID(bind.pBinds[b].memory));
       }
     }
+
+    SCOPED_LOCK(m_MemoryBindingsLock);
+
+    for(auto it = sparseMems.begin(); it != sparseMems.end(); ++it)
+      m_MemoryBindings[*it].untracked = true;
   }
 
   // need to allocate space for each bind batch
@@ -353,6 +353,11 @@ void WrappedVulkan::vkFreeMemory(VkDevice device, VkDeviceMemory memory,
       if(it != m_CoherentMaps.end())
         m_CoherentMaps.erase(it);
     }
+
+    {
+      SCOPED_LOCK(m_MemoryBindingsLock);
+      m_MemoryBindings.erase(GetResID(memory));
+    }
   }
 
   GetResourceManager()->ReleaseWrappedResource(memory);
@@ -570,9 +575,7 @@ bool WrappedVulkan::Serialise_vkFlushMappedMemoryRanges(Serialiser *localSeriali
     // it's no longer safe to use state->mappedPtr, we need to save *precisely* what
     // was serialised. We do this by copying out of the serialiser since we know this
     // memory is not changing
-    size_t offs = size_t(localSerialiser->GetOffset() - memSize);
-
-    byte *serialisedData = localSerialiser->GetRawPtr(offs);
+    const byte *serialisedData = localSerialiser->GetLastBufferData();
 
     memcpy(state->refData, serialisedData + (size_t)memOffset, (size_t)memSize);
   }
@@ -674,6 +677,31 @@ VkResult WrappedVulkan::vkInvalidateMappedMemoryRanges(VkDevice device, uint32_t
 
 // Generic API object functions
 
+void WrappedVulkan::AddMemoryBinding(ResourceId mem, ResourceId res, VkDeviceSize offset,
+                                     VkDeviceSize size)
+{
+  SCOPED_LOCK(m_MemoryBindingsLock);
+  m_MemoryBindings[mem].ranges[res] = std::make_pair(offset, size);
+}
+
+void WrappedVulkan::RemoveMemoryBinding(ResourceId mem, ResourceId res)
+{
+  SCOPED_LOCK(m_CapTransitionLock);
+  SCOPED_LOCK(m_MemoryBindingsLock);
+
+  // a resource destroyed mid-frame could still have been referenced before it was destroyed, so
+  // its range must stay in the initial contents until the frame has ended
+  if(m_State == WRITING_CAPFRAME)
+  {
+    m_PendingMemoryUnbinds.push_back(std::make_pair(mem, res));
+    return;
+  }
+
+  auto it = m_MemoryBindings.find(mem);
+  if(it != m_MemoryBindings.end())
+    it->second.ranges.erase(res);
+}
+
 bool WrappedVulkan::Serialise_vkBindBufferMemory(Serialiser *localSerialiser, VkDevice device,
                                                  VkBuffer buffer, VkDeviceMemory mem,
                                                  VkDeviceSize memOffset)
@@ -720,6 +748,11 @@ VkResult WrappedVulkan::vkBindBufferMemory(VkDevice device, VkBuffer buffer, VkD
 
     record->AddParent(GetRecord(mem));
     record->baseResource = GetResID(mem);
+
+    VkMemoryRequirements mrq = {0};
+    ObjDisp(device)->GetBufferMemoryRequirements(Unwrap(device), Unwrap(buffer), &mrq);
+
+    AddMemoryBinding(GetResID(mem), GetResID(buffer), memOffset, mrq.size);
   }
 
   return ObjDisp(device)->BindBufferMemory(Unwrap(device), Unwrap(buffer), Unwrap(mem), memOffset);
@@ -775,6 +808,11 @@ VkResult WrappedVulkan::vkBindImageMemory(VkDevice device, VkImage image, VkDevi
     // Anything that looks up a baseResource for an image knows not to chase further
     // than the image.
     record->baseResource = GetResID(mem);
+
+    VkMemoryRequirements mrq = {0};
+    ObjDisp(device)->GetImageMemoryRequirements(Unwrap(device), Unwrap(image), &mrq);
+
+    AddMemoryBinding(GetResID(mem), GetResID(image), memOffset, mrq.size);
   }
 
   return ObjDisp(device)->BindImageMemory(Unwrap(device), Unwrap(image), Unwrap(mem), memOffset);
@@ -957,6 +995,19 @@ VkResult WrappedVulkan::vkCreateBufferView(VkDevice device, const VkBufferViewCr
       // store the base resource
       record->baseResource = bufferRecord->baseResource;
       record->sparseInfo = bufferRecord->sparseInfo;
+
+      // texel buffer views are referenced instead of their buffer, so they cover the same memory
+      {
+        SCOPED_LOCK(m_MemoryBindingsLock);
+
+        auto it = m_MemoryBindings.find(record->baseResource);
+        if(it != m_MemoryBindings.end())
+        {
+          auto range = it->second.ranges.find(bufferRecord->GetResourceID());
+          if(range != it->second.ranges.end())
+            it->second.ranges[id] = range->second;
+        }
+      }
     }
     else
     {
@@ -1165,8 +1216,6 @@ VkResult WrappedVulkan::vkCreateImage(VkDevice device, const VkImageCreateInfo *
     layout->extent = pCreateInfo->extent;
     layout->format = pCreateInfo->format;
 
-    layout->subresourceStates.clear();
-
     range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     if(IsDepthOnlyFormat(pCreateInfo->format))
       range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -1175,6 +1224,9 @@ VkResult WrappedVulkan::vkCreateImage(VkDevice device, const VkImageCreateInfo *
     else if(IsDepthOrStencilFormat(pCreateInfo->format))
       range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
 
+    SCOPED_LOCK(layout->lock);
+
+    layout->subresourceStates.clear();
     layout->subresourceStates.push_back(
         ImageRegionState(range, UNKNOWN_PREV_IMG_LAYOUT, VK_IMAGE_LAYOUT_UNDEFINED));
   }
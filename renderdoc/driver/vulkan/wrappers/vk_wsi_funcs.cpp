@@ -417,8 +417,11 @@ void WrappedVulkan::WrapAndProcessCreatedSwapchain(VkDevice device,
         // fill out image info so we track resource state barriers
         {
           SCOPED_LOCK(m_ImageLayoutsLock);
-          m_ImageLayouts[imid].subresourceStates.clear();
-          m_ImageLayouts[imid].subresourceStates.push_back(
+          ImageLayouts &layout = m_ImageLayouts[imid];
+
+          SCOPED_LOCK(layout.lock);
+          layout.subresourceStates.clear();
+          layout.subresourceStates.push_back(
               ImageRegionState(range, UNKNOWN_PREV_IMG_LAYOUT, VK_IMAGE_LAYOUT_UNDEFINED));
         }
 
@@ -603,9 +606,24 @@ VkResult WrappedVulkan::vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR
 
   RenderDoc::Inst().SetCurrentDriver(RDC_Vulkan);
 
-  // kill any current capture that isn't application defined
+  // kill any current capture that isn't application defined, unless it spans more frames - then
+  // only record where this frame ended
   if(m_State == WRITING_CAPFRAME && !m_AppControlledCapture)
-    RenderDoc::Inst().EndFrameCapture(LayerDisp(m_Instance), swapInfo.wndHandle);
+  {
+    if(RenderDoc::Inst().ContinueFrameCapture())
+    {
+      VkImage backbuffer = swapInfo.images[swapInfo.lastPresent].im;
+
+      GetResourceManager()->MarkResourceFrameReferenced(GetResID(backbuffer), eFrameRef_Read);
+
+      SCOPED_LOCK(m_CapTransitionLock);
+      EndCaptureFrame(backbuffer);
+    }
+    else
+    {
+      RenderDoc::Inst().EndFrameCapture(LayerDisp(m_Instance), swapInfo.wndHandle);
+    }
+  }
 
   if(RenderDoc::Inst().ShouldTriggerCapture(m_FrameCounter) && m_State == WRITING_IDLE)
   {
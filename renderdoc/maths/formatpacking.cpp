@@ -0,0 +1,351 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2016 Baldur Karlsson
+ * Copyright (c) 2014 Crytek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "api/replay/renderdoc_replay.h"
+#include "common/common.h"
+#include "formatpacking.h"
+
+#if ENABLED(RDOC_SSE2)
+#include <emmintrin.h>
+#endif
+
+// Component kernels convert a flat run of n components of one type to floats. Row decoders
+// are then instantiated per component count on top of these, so choosing a decoder resolves
+// every format decision once up front.
+typedef void (*ComponentKernel)(const byte *src, float *dst, size_t n);
+
+static void ConvertFloat32(const byte *src, float *dst, size_t n)
+{
+  memcpy(dst, src, n * sizeof(float));
+}
+
+static void ConvertUInt32(const byte *src, float *dst, size_t n)
+{
+  const uint32_t *in = (const uint32_t *)src;
+  for(size_t i = 0; i < n; i++)
+    dst[i] = float(in[i]);
+}
+
+static void ConvertSInt32(const byte *src, float *dst, size_t n)
+{
+  const int32_t *in = (const int32_t *)src;
+  size_t i = 0;
+
+#if ENABLED(RDOC_SSE2)
+  for(; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(in + i))));
+#endif
+
+  for(; i < n; i++)
+    dst[i] = float(in[i]);
+}
+
+#if ENABLED(RDOC_SSE2)
+// converts the halfs in the low 16 bits of each lane. Denormals are handled by letting the
+// float multiply renormalise them, and inf/nan exponents are restored afterwards.
+static inline __m128 HalfToFloat4(__m128i h)
+{
+  const __m128i noSign = _mm_set1_epi32(0x7fff);
+  const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+  const __m128i wasInfNaN = _mm_set1_epi32(0x7bff);
+  const __m128i expInfNaN = _mm_set1_epi32(255 << 23);
+
+  __m128i expmant = _mm_and_si128(noSign, h);
+  __m128i justsign = _mm_xor_si128(h, expmant);
+  __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), magic);
+  __m128i infnan = _mm_and_si128(_mm_cmpgt_epi32(expmant, wasInfNaN), expInfNaN);
+  __m128i sign = _mm_slli_epi32(justsign, 16);
+
+  return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infnan)));
+}
+#endif
+
+static void ConvertHalf(const byte *src, float *dst, size_t n)
+{
+  const uint16_t *in = (const uint16_t *)src;
+  size_t i = 0;
+
+#if ENABLED(RDOC_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+
+  for(; i + 8 <= n; i += 8)
+  {
+    __m128i h = _mm_loadu_si128((const __m128i *)(in + i));
+    _mm_storeu_ps(dst + i, HalfToFloat4(_mm_unpacklo_epi16(h, zero)));
+    _mm_storeu_ps(dst + i + 4, HalfToFloat4(_mm_unpackhi_epi16(h, zero)));
+  }
+#endif
+
+  for(; i < n; i++)
+    dst[i] = ConvertFromHalf(in[i]);
+}
+
+static void ConvertUInt16(const byte *src, float *dst, size_t n)
+{
+  const uint16_t *in = (const uint16_t *)src;
+  for(size_t i = 0; i < n; i++)
+    dst[i] = float(in[i]);
+}
+
+static void ConvertSInt16(const byte *src, float *dst, size_t n)
+{
+  const int16_t *in = (const int16_t *)src;
+  for(size_t i = 0; i < n; i++)
+    dst[i] = float(in[i]);
+}
+
+static void ConvertUNorm16(const byte *src, float *dst, size_t n)
+{
+  const uint16_t *in = (const uint16_t *)src;
+  size_t i = 0;
+
+#if ENABLED(RDOC_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 scale = _mm_set1_ps(1.0f / 65535.0f);
+
+  for(; i + 8 <= n; i += 8)
+  {
+    __m128i u = _mm_loadu_si128((const __m128i *)(in + i));
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(u, zero)), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(u, zero)), scale));
+  }
+#endif
+
+  for(; i < n; i++)
+    dst[i] = float(in[i]) / 65535.0f;
+}
+
+static void ConvertSNorm16(const byte *src, float *dst, size_t n)
+{
+  const int16_t *in = (const int16_t *)src;
+  for(size_t i = 0; i < n; i++)
+    dst[i] = in[i] == -32768 ? -1.0f : float(in[i]) / 32767.0f;
+}
+
+static void ConvertUInt8(const byte *src, float *dst, size_t n)
+{
+  for(size_t i = 0; i < n; i++)
+    dst[i] = float(src[i]);
+}
+
+static void ConvertSInt8(const byte *src, float *dst, size_t n)
+{
+  const int8_t *in = (const int8_t *)src;
+  for(size_t i = 0; i < n; i++)
+    dst[i] = float(in[i]);
+}
+
+static void ConvertUNorm8(const byte *src, float *dst, size_t n)
+{
+  size_t i = 0;
+
+#if ENABLED(RDOC_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+  for(; i + 16 <= n; i += 16)
+  {
+    __m128i u8 = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i lo = _mm_unpacklo_epi8(u8, zero);
+    __m128i hi = _mm_unpackhi_epi8(u8, zero);
+    _mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+    _mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+    _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+  }
+#endif
+
+  for(; i < n; i++)
+    dst[i] = float(src[i]) / 255.0f;
+}
+
+static void ConvertSRGB8(const byte *src, float *dst, size_t n)
+{
+  for(size_t i = 0; i < n; i++)
+    dst[i] = SRGB8_lookuptable[src[i]];
+}
+
+static void ConvertSNorm8(const byte *src, float *dst, size_t n)
+{
+  const int8_t *in = (const int8_t *)src;
+  for(size_t i = 0; i < n; i++)
+    dst[i] = in[i] == -128 ? -1.0f : float(in[i]) / 127.0f;
+}
+
+template <uint32_t compCount, uint32_t compByteWidth, ComponentKernel kernel>
+static void DecodeRow(const byte *src, Vec4f *dst, uint32_t count)
+{
+  // 4-component data is already laid out as Vec4f
+  if(compCount == 4)
+  {
+    kernel(src, &dst->x, size_t(count) * 4);
+    return;
+  }
+
+  // otherwise convert in batches then expand, filling in missing components
+  const uint32_t batchSize = 256;
+  float tmp[batchSize * 4];
+
+  for(uint32_t base = 0; base < count; base += batchSize)
+  {
+    uint32_t num = RDCMIN(batchSize, count - base);
+
+    kernel(src + size_t(base) * compCount * compByteWidth, tmp, size_t(num) * compCount);
+
+    const float *in = tmp;
+    Vec4f *out = dst + base;
+
+    for(uint32_t i = 0; i < num; i++)
+    {
+      out[i] = Vec4f(in[0], compCount >= 2 ? in[1] : 0.0f, compCount >= 3 ? in[2] : 0.0f, 1.0f);
+      in += compCount;
+    }
+  }
+}
+
+static void DecodeR10G10B10A2Row(const byte *src, Vec4f *dst, uint32_t count)
+{
+  const uint32_t *in = (const uint32_t *)src;
+  uint32_t i = 0;
+
+#if ENABLED(RDOC_SSE2)
+  // unpack four texels at once as one register per component, then transpose back to RGBA
+  const __m128i mask10 = _mm_set1_epi32(0x3ff);
+  const __m128 scale10 = _mm_set1_ps(1.0f / 1023.0f);
+  const __m128 scale2 = _mm_set1_ps(1.0f / 3.0f);
+
+  for(; i + 4 <= count; i += 4)
+  {
+    __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+
+    __m128 r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(v, mask10)), scale10);
+    __m128 g = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 10), mask10)), scale10);
+    __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 20), mask10)), scale10);
+    __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(v, 30)), scale2);
+
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+
+    _mm_storeu_ps(&dst[i + 0].x, r);
+    _mm_storeu_ps(&dst[i + 1].x, g);
+    _mm_storeu_ps(&dst[i + 2].x, b);
+    _mm_storeu_ps(&dst[i + 3].x, a);
+  }
+#endif
+
+  for(; i < count; i++)
+    dst[i] = ConvertFromR10G10B10A2(in[i]);
+}
+
+static void DecodeR11G11B10Row(const byte *src, Vec4f *dst, uint32_t count)
+{
+  const uint32_t *in = (const uint32_t *)src;
+  for(uint32_t i = 0; i < count; i++)
+  {
+    Vec3f v = ConvertFromR11G11B10(in[i]);
+    dst[i] = Vec4f(v.x, v.y, v.z, 1.0f);
+  }
+}
+
+template <uint32_t compByteWidth, ComponentKernel kernel>
+static RowDecoder GetDecoderForCount(uint32_t compCount)
+{
+  switch(compCount)
+  {
+    case 1: return &DecodeRow<1, compByteWidth, kernel>;
+    case 2: return &DecodeRow<2, compByteWidth, kernel>;
+    case 3: return &DecodeRow<3, compByteWidth, kernel>;
+    case 4: return &DecodeRow<4, compByteWidth, kernel>;
+    default: break;
+  }
+
+  return NULL;
+}
+
+RowDecoder GetRowDecoder(const ResourceFormat &fmt)
+{
+  if(fmt.special)
+  {
+    switch(fmt.specialFormat)
+    {
+      case eSpecial_R10G10B10A2: return &DecodeR10G10B10A2Row;
+      case eSpecial_R11G11B10: return &DecodeR11G11B10Row;
+      // other packed formats are downcast to RGBA8 on the GPU before saving, which loses nothing
+      // for their bit depths and handles their differing channel orders.
+      default: break;
+    }
+
+    RDCERR("Unsupported special format %u to decode", fmt.specialFormat);
+    return NULL;
+  }
+
+  const FormatComponentType type = fmt.compType;
+  const bool isUInt = (type == eCompType_UInt || type == eCompType_UScaled);
+  const bool isSInt = (type == eCompType_SInt || type == eCompType_SScaled);
+
+  RowDecoder ret = NULL;
+
+  // 32-bit depth is always floating point, and 16-bit depth is always normalised
+  if(fmt.compByteWidth == 4)
+  {
+    if(type == eCompType_Float || type == eCompType_Depth)
+      ret = GetDecoderForCount<4, &ConvertFloat32>(fmt.compCount);
+    else if(isUInt)
+      ret = GetDecoderForCount<4, &ConvertUInt32>(fmt.compCount);
+    else if(isSInt)
+      ret = GetDecoderForCount<4, &ConvertSInt32>(fmt.compCount);
+  }
+  else if(fmt.compByteWidth == 2)
+  {
+    if(type == eCompType_Float)
+      ret = GetDecoderForCount<2, &ConvertHalf>(fmt.compCount);
+    else if(isUInt)
+      ret = GetDecoderForCount<2, &ConvertUInt16>(fmt.compCount);
+    else if(isSInt)
+      ret = GetDecoderForCount<2, &ConvertSInt16>(fmt.compCount);
+    else if(type == eCompType_UNorm || type == eCompType_Depth)
+      ret = GetDecoderForCount<2, &ConvertUNorm16>(fmt.compCount);
+    else if(type == eCompType_SNorm)
+      ret = GetDecoderForCount<2, &ConvertSNorm16>(fmt.compCount);
+  }
+  else if(fmt.compByteWidth == 1)
+  {
+    if(isUInt)
+      ret = GetDecoderForCount<1, &ConvertUInt8>(fmt.compCount);
+    else if(isSInt)
+      ret = GetDecoderForCount<1, &ConvertSInt8>(fmt.compCount);
+    else if(type == eCompType_UNorm && fmt.srgbCorrected)
+      ret = GetDecoderForCount<1, &ConvertSRGB8>(fmt.compCount);
+    else if(type == eCompType_UNorm)
+      ret = GetDecoderForCount<1, &ConvertUNorm8>(fmt.compCount);
+    else if(type == eCompType_SNorm)
+      ret = GetDecoderForCount<1, &ConvertSNorm8>(fmt.compCount);
+  }
+
+  if(ret == NULL)
+    RDCERR("Unexpected format to decode: %u x %u byte, type %u", fmt.compCount, fmt.compByteWidth,
+           type);
+
+  return ret;
+}
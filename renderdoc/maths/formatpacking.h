@@ -139,4 +139,9 @@ inline float ConvertFromSRGB8(uint8_t comp)
 struct ResourceFormat;
 float ConvertComponent(ResourceFormat fmt, byte *data);
 
+// decodes a run of texels in the given format to RGBA floats, with missing components filled
+// from (0, 0, 0, 1). Look the decoder up once per format rather than converting per-component.
+typedef void (*RowDecoder)(const uint8_t *src, Vec4f *dst, uint32_t count);
+RowDecoder GetRowDecoder(const ResourceFormat &fmt);
+
 #include "half_convert.h"
@@ -25,6 +25,8 @@
 
 #include "os/os_specific.h"
 #include <stdarg.h>
+#include <algorithm>
+#include "common/threading.h"
 #include "serialise/string_utils.h"
 
 using std::string;
@@ -103,6 +105,200 @@ int Wide2UTF8(wchar_t chr, char mbchr[4])
 
 };    // namespace StringFormat
 
+namespace Threading
+{
+bool LockProfilingEnabled = false;
+
+// how many call sites each lock can blame waits on. Locks are only ever taken from a handful of
+// places, waits caused by any beyond this aren't blamed on a holder.
+static const int LockHolderSlots = 8;
+
+// blamed when the holder isn't known, since a NULL slot is a free one
+static const char UnknownHolder[] = "unknown";
+
+// only updated on contended acquires. Everything is atomic so that waiting threads don't serialise
+// on a shared lock to record their wait.
+struct LockWaitStats
+{
+  volatile int64_t contended;
+  volatile int64_t totalWaitTicks;
+  volatile int64_t maxWaitTicks;
+
+  // call sites that held the lock while others waited, each claimed on first use
+  const char *volatile holders[LockHolderSlots];
+  volatile int64_t holderWaitTicks[LockHolderSlots];
+
+  void Reset()
+  {
+    contended = totalWaitTicks = maxWaitTicks = 0;
+
+    for(int i = 0; i < LockHolderSlots; i++)
+    {
+      holders[i] = NULL;
+      holderWaitTicks[i] = 0;
+    }
+  }
+
+  void Record(int64_t waitTicks, const char *holder)
+  {
+    Atomic::Inc64(&contended);
+    Atomic::ExchAdd64(&totalWaitTicks, waitTicks);
+
+    int64_t prevMax = maxWaitTicks;
+    while(waitTicks > prevMax)
+    {
+      int64_t cur = Atomic::CmpExch64(&maxWaitTicks, prevMax, waitTicks);
+      if(cur == prevMax)
+        break;
+      prevMax = cur;
+    }
+
+    if(holder == NULL)
+      holder = UnknownHolder;
+
+    for(int i = 0; i < LockHolderSlots; i++)
+    {
+      const char *slot = holders[i];
+
+      // claim a free slot. If another thread got there first, check what it stored instead
+      if(slot == NULL)
+      {
+        slot = (const char *)Atomic::CmpExchPtr((void *volatile *)&holders[i], NULL,
+                                                (void *)holder);
+        if(slot == NULL)
+          slot = holder;
+      }
+
+      if(slot == holder)
+      {
+        Atomic::ExchAdd64(&holderWaitTicks[i], waitTicks);
+        return;
+      }
+    }
+  }
+};
+
+struct LockStats
+{
+  string name;
+  volatile int64_t acquisitions;
+
+  // since the lock was first named, and since ResetLockContentionWindow()
+  LockWaitStats total, window;
+  int64_t windowAcquisitionsStart;
+};
+
+// function statics so that locks can be named during static initialisation
+static CriticalSection &LockStatsLock()
+{
+  static CriticalSection lock;
+  return lock;
+}
+
+static std::map<string, LockStats *> &LockStatsRegistry()
+{
+  static std::map<string, LockStats *> registry;
+  return registry;
+}
+
+void SetLockProfiling(bool enabled)
+{
+  LockProfilingEnabled = enabled;
+}
+
+LockStats *GetLockStats(const char *name)
+{
+  SCOPED_LOCK(LockStatsLock());
+
+  LockStats *&stats = LockStatsRegistry()[name];
+
+  if(stats == NULL)
+  {
+    stats = new LockStats();
+    stats->name = name;
+    stats->acquisitions = 0;
+    stats->total.Reset();
+    stats->window.Reset();
+    stats->windowAcquisitionsStart = 0;
+  }
+
+  return stats;
+}
+
+void RecordLockAcquire(LockStats *stats, uint64_t waitTicks, const char *holder)
+{
+  Atomic::Inc64(&stats->acquisitions);
+
+  if(waitTicks == 0)
+    return;
+
+  stats->total.Record((int64_t)waitTicks, holder);
+  stats->window.Record((int64_t)waitTicks, holder);
+}
+
+void ResetLockContentionWindow()
+{
+  SCOPED_LOCK(LockStatsLock());
+
+  std::map<string, LockStats *> &registry = LockStatsRegistry();
+
+  for(auto it = registry.begin(); it != registry.end(); ++it)
+  {
+    it->second->window.Reset();
+    it->second->windowAcquisitionsStart = it->second->acquisitions;
+  }
+}
+
+static bool SortByWaitTime(const LockContention &a, const LockContention &b)
+{
+  return a.totalWaitMS > b.totalWaitMS;
+}
+
+vector<LockContention> GetLockContention(bool window)
+{
+  vector<LockContention> ret;
+
+  double ticksPerMS = Timing::GetTickFrequency();
+
+  SCOPED_LOCK(LockStatsLock());
+
+  std::map<string, LockStats *> &registry = LockStatsRegistry();
+
+  for(auto it = registry.begin(); it != registry.end(); ++it)
+  {
+    LockStats *stats = it->second;
+    const LockWaitStats &wait = window ? stats->window : stats->total;
+
+    LockContention lock;
+    lock.name = stats->name;
+    lock.acquisitions = uint64_t(stats->acquisitions);
+    if(window)
+      lock.acquisitions -= uint64_t(stats->windowAcquisitionsStart);
+    lock.contended = uint64_t(wait.contended);
+    lock.totalWaitMS = double(wait.totalWaitTicks) / ticksPerMS;
+    lock.maxWaitMS = double(wait.maxWaitTicks) / ticksPerMS;
+
+    int64_t worst = 0;
+    for(int h = 0; h < LockHolderSlots; h++)
+    {
+      const char *holder = wait.holders[h];
+
+      if(holder && wait.holderWaitTicks[h] > worst)
+      {
+        worst = wait.holderWaitTicks[h];
+        lock.worstHolder = holder == UnknownHolder ? holder : basename(string(holder));
+      }
+    }
+
+    ret.push_back(lock);
+  }
+
+  std::sort(ret.begin(), ret.end(), SortByWaitTime);
+
+  return ret;
+}
+};
+
 string Callstack::AddressDetails::formattedString(const char *commonPath)
 {
   char fmt[512] = {0};
@@ -106,37 +106,135 @@ uint64_t GetUnixTimestamp();
 
 namespace Threading
 {
+// optional contention tracking for named locks, see CriticalSectionTemplate::SetName. Nothing is
+// recorded unless lock profiling is enabled, and unnamed locks are never tracked.
+struct LockStats;
+struct LockContention
+{
+  string name;
+  uint64_t acquisitions;
+  uint64_t contended;
+  double totalWaitMS;
+  double maxWaitMS;
+  // the call site that held the lock for the most time spent waiting on it
+  string worstHolder;
+};
+
+extern bool LockProfilingEnabled;
+void SetLockProfiling(bool enabled);
+LockStats *GetLockStats(const char *name);
+void RecordLockAcquire(LockStats *stats, uint64_t waitTicks, const char *holder);
+// starts a new window of contention, e.g. for the duration of a capture
+void ResetLockContentionWindow();
+// contention since each lock was first named, or since the window was last reset
+vector<LockContention> GetLockContention(bool window = false);
+
 template <class data>
 class CriticalSectionTemplate
 {
 public:
   CriticalSectionTemplate();
   ~CriticalSectionTemplate();
-  void Lock();
-  bool Trylock();
-  void Unlock();
 
+  // site is a "file:line" string for the caller, which is what gets blamed for time that other
+  // threads spend waiting on this lock.
+  void Lock(const char *site = NULL)
+  {
+    if(m_Stats && LockProfilingEnabled)
+      ProfiledLock(site);
+    else
+      OSLock();
+  }
+  bool Trylock()
+  {
+    bool ret = OSTrylock();
+    if(ret && m_Stats && LockProfilingEnabled)
+    {
+      m_Holder = NULL;
+      RecordLockAcquire(m_Stats, 0, NULL);
+    }
+    return ret;
+  }
+  void Unlock() { OSUnlock(); }
+  // locks with the same name are reported together
+  void SetName(const char *name) { m_Stats = GetLockStats(name); }
+  // for locks that are created often, the stats can be looked up once with GetLockStats and shared
+  void SetStats(LockStats *stats) { m_Stats = stats; }
 private:
   // no copying
   CriticalSectionTemplate &operator=(const CriticalSectionTemplate &other);
   CriticalSectionTemplate(const CriticalSectionTemplate &other);
 
+  void OSLock();
+  bool OSTrylock();
+  void OSUnlock();
+
+  void ProfiledLock(const char *site)
+  {
+    uint64_t waitTicks = 0;
+    const char *holder = NULL;
+
+    if(!OSTrylock())
+    {
+      holder = m_Holder;
+      uint64_t start = Timing::GetTick();
+      OSLock();
+      // a contended acquire always counts as some wait, even below the timer resolution
+      waitTicks = Timing::GetTick() - start;
+      if(waitTicks == 0)
+        waitTicks = 1;
+    }
+
+    m_Holder = site;
+    RecordLockAcquire(m_Stats, waitTicks, holder);
+  }
+
+  data m_Data;
+  LockStats *m_Stats;
+  const char *volatile m_Holder;
+};
+
+// allows any number of concurrent readers, or a single writer. Unlike CriticalSection this is not
+// recursive - a thread holding it must not take it again, even just to read.
+template <class data>
+class RWLockTemplate
+{
+public:
+  RWLockTemplate();
+  ~RWLockTemplate();
+  void ReadLock();
+  void ReadUnlock();
+  void WriteLock();
+  void WriteUnlock();
+
+private:
+  // no copying
+  RWLockTemplate &operator=(const RWLockTemplate &other);
+  RWLockTemplate(const RWLockTemplate &other);
+
   data m_Data;
 };
 
 void Init();
 void Shutdown();
-uint64_t AllocateTLSSlot();
+
+// if a destructor is given, it's called on each thread as it exits with that thread's value in
+// the slot, if it was set to something non-NULL. It isn't called for threads still running at
+// shutdown.
+typedef void (*TLSDestructor)(void *value);
+uint64_t AllocateTLSSlot(TLSDestructor destructor = NULL);
 
 void *GetTLSValue(uint64_t slot);
 void SetTLSValue(uint64_t slot, void *value);
 
-// must typedef CriticalSectionTemplate<X> CriticalSection
+// must typedef CriticalSectionTemplate<X> CriticalSection and RWLockTemplate<Y> RWLock
 
 typedef void (*ThreadEntry)(void *);
 typedef uint64_t ThreadHandle;
 ThreadHandle CreateThread(ThreadEntry entryFunc, void *userData);
 uint64_t GetCurrentID();
+// CPU time consumed by the calling thread, in seconds
+double GetCurrentThreadCPUTime();
 void JoinThread(ThreadHandle handle);
 void CloseThread(ThreadHandle handle);
 void Sleep(uint32_t milliseconds);
@@ -211,6 +309,8 @@ int64_t Inc64(volatile int64_t *i);
 int64_t Dec64(volatile int64_t *i);
 int64_t ExchAdd64(volatile int64_t *i, int64_t a);
 int32_t CmpExch32(volatile int32_t *dest, int32_t oldVal, int32_t newVal);
+int64_t CmpExch64(volatile int64_t *dest, int64_t oldVal, int64_t newVal);
+void *CmpExchPtr(void *volatile *dest, void *oldVal, void *newVal);
 };
 
 namespace Callstack
@@ -350,6 +450,7 @@ inline bool slurp(const char *filename, vector<unsigned char> &buffer)
 namespace Keyboard
 {
 void Init();
+void Shutdown();
 void AddInputWindow(void *wnd);
 void RemoveInputWindow(void *wnd);
 bool GetKeyState(int key);
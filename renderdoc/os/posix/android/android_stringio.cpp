@@ -35,6 +35,10 @@ void Init()
 {
 }
 
+void Shutdown()
+{
+}
+
 bool PlatformHasKeyInput()
 {
   return false;
@@ -34,6 +34,10 @@ void Init()
 {
 }
 
+void Shutdown()
+{
+}
+
 bool PlatformHasKeyInput()
 {
   return false;
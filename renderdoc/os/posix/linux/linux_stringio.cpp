@@ -49,6 +49,21 @@ using std::string;
 
 namespace Keyboard
 {
+// Key state is sampled on a background thread and published for GetKeyState to read, so that
+// RenderDoc::Tick on the application's present thread never has to make a synchronous round trip
+// to the X server. Each sample queries the keymap once per connection, covering every key.
+static volatile int32_t keyDown[eRENDERDOC_Key_Max] = {};
+
+static Threading::ThreadHandle monitorThread = 0;
+static volatile bool monitorShutdown = false;
+static const uint32_t monitorPeriodMS = 10;
+
+// protects the display/connection and cached keycodes below, which are registered from
+// application threads and sampled on the monitor thread
+static Threading::CriticalSection monitorLock;
+
+static void StartKeyMonitor();
+
 void Init()
 {
 }
@@ -62,23 +77,46 @@ bool PlatformHasKeyInput()
 #endif
 }
 
+static bool IsKeyDown(const uint8_t *keymap, uint8_t keycode)
+{
+  if(keycode == 0)
+    return false;
+
+  int byteIdx = (keycode / 8);
+  int bitMask = 1 << (keycode % 8);
+
+  return (keymap[byteIdx] & bitMask) != 0;
+}
+
 #if ENABLED(RDOC_XLIB)
 
 Display *CurrentXDisplay = NULL;
 
+static KeyCode xlibKeyCodes[eRENDERDOC_Key_Max] = {};
+static bool xlibKeyCodesFetched = false;
+
 void CloneDisplay(Display *dpy)
 {
-  if(CurrentXDisplay || dpy == NULL)
+  if(dpy == NULL)
     return;
 
-  CurrentXDisplay = XOpenDisplay(XDisplayString(dpy));
+  {
+    SCOPED_LOCK(monitorLock);
+
+    if(CurrentXDisplay)
+      return;
+
+    CurrentXDisplay = XOpenDisplay(XDisplayString(dpy));
+
+    if(CurrentXDisplay == NULL)
+      return;
+  }
+
+  StartKeyMonitor();
 }
 
-bool GetXlibKeyState(int key)
+static KeySym GetXlibKeySym(int key)
 {
-  if(CurrentXDisplay == NULL)
-    return false;
-
   KeySym ks = 0;
 
   if(key >= eRENDERDOC_Key_A && key <= eRENDERDOC_Key_Z)
@@ -117,27 +155,43 @@ bool GetXlibKeyState(int key)
     default: break;
   }
 
-  if(ks == 0)
+  return ks;
+}
+
+// must be called with monitorLock held
+static bool SampleXlibKeys(bool *down)
+{
+  if(CurrentXDisplay == NULL)
     return false;
 
-  KeyCode kc = XKeysymToKeycode(CurrentXDisplay, ks);
+  // keysym to keycode lookups are resolved client-side, so only do them once
+  if(!xlibKeyCodesFetched)
+  {
+    for(int key = 0; key < eRENDERDOC_Key_Max; key++)
+    {
+      KeySym ks = GetXlibKeySym(key);
+
+      if(ks != 0)
+        xlibKeyCodes[key] = XKeysymToKeycode(CurrentXDisplay, ks);
+    }
+
+    xlibKeyCodesFetched = true;
+  }
 
   char keyState[32];
   XQueryKeymap(CurrentXDisplay, keyState);
 
-  int byteIdx = (kc / 8);
-  int bitMask = 1 << (kc % 8);
+  for(int key = 0; key < eRENDERDOC_Key_Max; key++)
+    down[key] |= IsKeyDown((const uint8_t *)keyState, xlibKeyCodes[key]);
 
-  uint8_t keyByte = (uint8_t)keyState[byteIdx];
-
-  return (keyByte & bitMask) != 0;
+  return true;
 }
 
 #else
 
 // if RENDERDOC_WINDOWING_XLIB is not enabled
 
-bool GetXlibKeyState(int key)
+static bool SampleXlibKeys(bool *down)
 {
   return false;
 }
@@ -146,20 +200,77 @@ bool GetXlibKeyState(int key)
 
 #if ENABLED(RDOC_XCB)
 
-xcb_connection_t *connection;
-xcb_key_symbols_t *symbols;
+// our own connection to the application's display, like CurrentXDisplay above. Polling on the
+// application's connection would add round trips to it, and it could be disconnected under us.
+static xcb_connection_t *connection = NULL;
+static xcb_key_symbols_t *symbols = NULL;
 
-void UseConnection(xcb_connection_t *conn)
+static xcb_keycode_t xcbKeyCodes[eRENDERDOC_Key_Max] = {};
+static bool xcbKeyCodesFetched = false;
+
+static xcb_window_t GetXCBRootWindow(xcb_connection_t *conn)
 {
-  connection = conn;
-  symbols = xcb_key_symbols_alloc(conn);
+  xcb_screen_iterator_t it = xcb_setup_roots_iterator(xcb_get_setup(conn));
+  return it.rem > 0 ? it.data->root : 0;
 }
 
-bool GetXCBKeyState(int key)
+// must be called with monitorLock held
+static void CloseXCBConnection()
 {
-  if(symbols == NULL)
-    return false;
+  if(symbols)
+    xcb_key_symbols_free(symbols);
+  symbols = NULL;
+
+  if(connection)
+    xcb_disconnect(connection);
+  connection = NULL;
+}
+
+void UseConnection(xcb_connection_t *conn)
+{
+  if(conn == NULL)
+    return;
+
+  {
+    SCOPED_LOCK(monitorLock);
+
+    if(connection)
+      return;
+
+    // there's no way to get the display name back from a connection, so connect to the default
+    // display and check that it's the same server as the application's
+    connection = xcb_connect(NULL, NULL);
+
+    if(xcb_connection_has_error(connection))
+    {
+      RDCWARN("Couldn't open an XCB connection for keyboard input");
+      CloseXCBConnection();
+      return;
+    }
+
+    if(GetXCBRootWindow(connection) != GetXCBRootWindow(conn) ||
+       xcb_get_setup(connection)->release_number != xcb_get_setup(conn)->release_number)
+    {
+      RDCWARN("Application's XCB connection isn't to the default display, keyboard input is "
+              "unavailable");
+      CloseXCBConnection();
+      return;
+    }
+
+    symbols = xcb_key_symbols_alloc(connection);
+
+    if(symbols == NULL)
+    {
+      CloseXCBConnection();
+      return;
+    }
+  }
+
+  StartKeyMonitor();
+}
 
+static KeySym GetXCBKeySym(int key)
+{
   KeySym ks = 0;
 
   if(key >= eRENDERDOC_Key_A && key <= eRENDERDOC_Key_Z)
@@ -198,44 +309,132 @@ bool GetXCBKeyState(int key)
     default: break;
   }
 
-  if(ks == 0)
-    return false;
+  return ks;
+}
 
-  xcb_keycode_t *keyCodes = xcb_key_symbols_get_keycode(symbols, ks);
+// must be called with monitorLock held
+static bool SampleXCBKeys(bool *down)
+{
+  if(symbols == NULL)
+    return false;
 
-  if(!keyCodes)
+  // stop polling if the connection has broken
+  if(xcb_connection_has_error(connection))
+  {
+    CloseXCBConnection();
     return false;
+  }
 
-  xcb_query_keymap_cookie_t keymapcookie = xcb_query_keymap(connection);
-  xcb_query_keymap_reply_t *keys = xcb_query_keymap_reply(connection, keymapcookie, NULL);
+  // the key symbols table is fetched from the server on first use then cached, so only look
+  // the keycodes up once
+  if(!xcbKeyCodesFetched)
+  {
+    for(int key = 0; key < eRENDERDOC_Key_Max; key++)
+    {
+      KeySym ks = GetXCBKeySym(key);
 
-  bool ret = false;
+      if(ks == 0)
+        continue;
 
-  if(keys && keyCodes[0] != XCB_NO_SYMBOL)
-  {
-    int byteIdx = (keyCodes[0] / 8);
-    int bitMask = 1 << (keyCodes[0] % 8);
+      xcb_keycode_t *keyCodes = xcb_key_symbols_get_keycode(symbols, ks);
+
+      if(keyCodes && keyCodes[0] != XCB_NO_SYMBOL)
+        xcbKeyCodes[key] = keyCodes[0];
+
+      free(keyCodes);
+    }
 
-    ret = (keys->keys[byteIdx] & bitMask) != 0;
+    xcbKeyCodesFetched = true;
   }
 
-  free(keyCodes);
+  xcb_query_keymap_cookie_t keymapcookie = xcb_query_keymap(connection);
+  xcb_query_keymap_reply_t *keys = xcb_query_keymap_reply(connection, keymapcookie, NULL);
+
+  if(keys == NULL)
+    return false;
+
+  for(int key = 0; key < eRENDERDOC_Key_Max; key++)
+    down[key] |= IsKeyDown(keys->keys, xcbKeyCodes[key]);
+
   free(keys);
 
-  return ret;
+  return true;
 }
 
 #else
 
 // if RENDERDOC_WINDOWING_XCB is not enabled
 
-bool GetXCBKeyState(int key)
+static bool SampleXCBKeys(bool *down)
 {
   return false;
 }
 
+static void CloseXCBConnection()
+{
+}
+
 #endif
 
+static void KeyMonitorThread(void *)
+{
+  bool down[eRENDERDOC_Key_Max];
+
+  while(!monitorShutdown)
+  {
+    memset(down, 0, sizeof(down));
+
+    bool sampled = false;
+
+    {
+      SCOPED_LOCK(monitorLock);
+      sampled = SampleXCBKeys(down);
+      sampled |= SampleXlibKeys(down);
+    }
+
+    if(sampled)
+    {
+      for(int key = 0; key < eRENDERDOC_Key_Max; key++)
+        keyDown[key] = down[key] ? 1 : 0;
+    }
+
+    Threading::Sleep(monitorPeriodMS);
+  }
+}
+
+static void StartKeyMonitor()
+{
+  SCOPED_LOCK(monitorLock);
+
+  if(monitorThread)
+    return;
+
+  monitorShutdown = false;
+  monitorThread = Threading::CreateThread(&KeyMonitorThread, NULL);
+}
+
+void Shutdown()
+{
+  Threading::ThreadHandle thread = 0;
+
+  {
+    SCOPED_LOCK(monitorLock);
+    thread = monitorThread;
+    monitorThread = 0;
+    monitorShutdown = true;
+  }
+
+  // the monitor thread takes the lock, so join outside it
+  if(thread)
+  {
+    Threading::JoinThread(thread);
+    Threading::CloseThread(thread);
+  }
+
+  SCOPED_LOCK(monitorLock);
+  CloseXCBConnection();
+}
+
 void AddInputWindow(void *wnd)
 {
   // TODO check against this drawable & parent window being focused in GetKeyState
@@ -247,7 +446,10 @@ void RemoveInputWindow(void *wnd)
 
 bool GetKeyState(int key)
 {
-  return GetXCBKeyState(key) || GetXlibKeyState(key);
+  if(key < 0 || key >= eRENDERDOC_Key_Max)
+    return false;
+
+  return keyDown[key] != 0;
 }
 }
 
@@ -64,6 +64,16 @@ int32_t CmpExch32(volatile int32_t *dest, int32_t oldVal, int32_t newVal)
 {
   return __sync_val_compare_and_swap(dest, oldVal, newVal);
 }
+
+int64_t CmpExch64(volatile int64_t *dest, int64_t oldVal, int64_t newVal)
+{
+  return __sync_val_compare_and_swap(dest, oldVal, newVal);
+}
+
+void *CmpExchPtr(void *volatile *dest, void *oldVal, void *newVal)
+{
+  return __sync_val_compare_and_swap(dest, oldVal, newVal);
+}
 };
 
 namespace Threading
@@ -71,6 +81,9 @@ namespace Threading
 template <>
 CriticalSection::CriticalSectionTemplate()
 {
+  m_Stats = NULL;
+  m_Holder = NULL;
+
   pthread_mutexattr_init(&m_Data.attr);
   pthread_mutexattr_settype(&m_Data.attr, PTHREAD_MUTEX_RECURSIVE);
   pthread_mutex_init(&m_Data.lock, &m_Data.attr);
@@ -84,23 +97,59 @@ CriticalSection::~CriticalSectionTemplate()
 }
 
 template <>
-void CriticalSection::Lock()
+void CriticalSection::OSLock()
 {
   pthread_mutex_lock(&m_Data.lock);
 }
 
 template <>
-bool CriticalSection::Trylock()
+bool CriticalSection::OSTrylock()
 {
   return pthread_mutex_trylock(&m_Data.lock) == 0;
 }
 
 template <>
-void CriticalSection::Unlock()
+void CriticalSection::OSUnlock()
 {
   pthread_mutex_unlock(&m_Data.lock);
 }
 
+template <>
+RWLock::RWLockTemplate()
+{
+  pthread_rwlock_init(&m_Data, NULL);
+}
+
+template <>
+RWLock::~RWLockTemplate()
+{
+  pthread_rwlock_destroy(&m_Data);
+}
+
+template <>
+void RWLock::ReadLock()
+{
+  pthread_rwlock_rdlock(&m_Data);
+}
+
+template <>
+void RWLock::ReadUnlock()
+{
+  pthread_rwlock_unlock(&m_Data);
+}
+
+template <>
+void RWLock::WriteLock()
+{
+  pthread_rwlock_wrlock(&m_Data);
+}
+
+template <>
+void RWLock::WriteUnlock()
+{
+  pthread_rwlock_unlock(&m_Data);
+}
+
 struct ThreadInitData
 {
   ThreadEntry entryFunc;
@@ -132,36 +181,82 @@ struct TLSData
 
 static CriticalSection *m_TLSListLock = NULL;
 static vector<TLSData *> *m_TLSList = NULL;
+static vector<TLSDestructor> *m_TLSDestructors = NULL;
+
+static void ExitThreadTLS(TLSData *slots);
+
+static void ThreadExitCallback(void *value)
+{
+  ExitThreadTLS((TLSData *)value);
+}
 
 void Init()
 {
-  int err = pthread_key_create(&OSTLSHandle, NULL);
+  int err = pthread_key_create(&OSTLSHandle, &ThreadExitCallback);
   if(err != 0)
     RDCFATAL("Can't allocate OS TLS slot");
 
   m_TLSListLock = new CriticalSection();
   m_TLSList = new vector<TLSData *>();
+  m_TLSDestructors = new vector<TLSDestructor>();
 
   CacheDebuggerPresent();
 }
 
 void Shutdown()
 {
+  // delete the key first so no more thread exit callbacks happen
+  pthread_key_delete(OSTLSHandle);
+
   for(size_t i = 0; i < m_TLSList->size(); i++)
     delete m_TLSList->at(i);
 
   delete m_TLSList;
+  delete m_TLSDestructors;
   delete m_TLSListLock;
-
-  pthread_key_delete(OSTLSHandle);
 }
 
 // allocate a TLS slot in our per-thread vectors with an atomic increment.
 // Note this is going to be 1-indexed because Inc64 returns the post-increment
 // value
-uint64_t AllocateTLSSlot()
+uint64_t AllocateTLSSlot(TLSDestructor destructor)
+{
+  uint64_t slot = Atomic::Inc64(&nextTLSSlot);
+
+  if(destructor)
+  {
+    m_TLSListLock->Lock();
+    if(slot > m_TLSDestructors->size())
+      m_TLSDestructors->resize((size_t)slot);
+    m_TLSDestructors->at((size_t)slot - 1) = destructor;
+    m_TLSListLock->Unlock();
+  }
+
+  return slot;
+}
+
+// run the destructors for a thread's TLS values, and free its per-thread vector
+static void ExitThreadTLS(TLSData *slots)
 {
-  return Atomic::Inc64(&nextTLSSlot);
+  vector<TLSDestructor> destructors;
+
+  m_TLSListLock->Lock();
+  destructors = *m_TLSDestructors;
+  for(size_t i = 0; i < m_TLSList->size(); i++)
+  {
+    if(m_TLSList->at(i) == slots)
+    {
+      m_TLSList->erase(m_TLSList->begin() + i);
+      break;
+    }
+  }
+  m_TLSListLock->Unlock();
+
+  for(size_t i = 0; i < destructors.size() && i < slots->data.size(); i++)
+    if(destructors[i] && slots->data[i])
+      destructors[i](slots->data[i]);
+
+  delete slots;
 }
 
 // look up our per-thread vector.
@@ -225,6 +320,15 @@ uint64_t GetCurrentID()
   return (uint64_t)pthread_self();
 }
 
+double GetCurrentThreadCPUTime()
+{
+  timespec ts = {0, 0};
+  if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    return 0.0;
+
+  return double(ts.tv_sec) + double(ts.tv_nsec) / 1.0e9;
+}
+
 void JoinThread(ThreadHandle handle)
 {
   pthread_join((pthread_t)handle, NULL);
@@ -80,5 +80,8 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserv
     return ret;
   }
 
+  if(ul_reason_for_call == DLL_THREAD_DETACH)
+    Threading::ThreadExit();
+
   return TRUE;
 }
@@ -62,6 +62,10 @@ void WriteOutput(int channel, const char *str);
 namespace Threading
 {
 typedef CriticalSectionTemplate<CRITICAL_SECTION> CriticalSection;
+typedef RWLockTemplate<SRWLOCK> RWLock;
+
+// called from DllMain as each thread exits, to run TLS destructors
+void ThreadExit();
 };
 
 namespace Bits
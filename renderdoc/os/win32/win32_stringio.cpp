@@ -73,6 +73,10 @@ void Init()
 {
 }
 
+void Shutdown()
+{
+}
+
 bool PlatformHasKeyInput()
 {
   return true;
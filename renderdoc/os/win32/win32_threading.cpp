@@ -77,12 +77,25 @@ int32_t CmpExch32(volatile int32_t *dest, int32_t oldVal, int32_t newVal)
 {
   return (int32_t)InterlockedCompareExchange((volatile LONG *)dest, newVal, oldVal);
 }
+
+int64_t CmpExch64(volatile int64_t *dest, int64_t oldVal, int64_t newVal)
+{
+  return (int64_t)InterlockedCompareExchange64((volatile LONG64 *)dest, newVal, oldVal);
+}
+
+void *CmpExchPtr(void *volatile *dest, void *oldVal, void *newVal)
+{
+  return InterlockedCompareExchangePointer((PVOID volatile *)dest, newVal, oldVal);
+}
 };
 
 namespace Threading
 {
 CriticalSection::CriticalSectionTemplate()
 {
+  m_Stats = NULL;
+  m_Holder = NULL;
+
   InitializeCriticalSection(&m_Data);
 }
 
@@ -91,21 +104,50 @@ CriticalSection::~CriticalSectionTemplate()
   DeleteCriticalSection(&m_Data);
 }
 
-void CriticalSection::Lock()
+void CriticalSection::OSLock()
 {
   EnterCriticalSection(&m_Data);
 }
 
-bool CriticalSection::Trylock()
+bool CriticalSection::OSTrylock()
 {
   return TryEnterCriticalSection(&m_Data) == TRUE;
 }
 
-void CriticalSection::Unlock()
+void CriticalSection::OSUnlock()
 {
   LeaveCriticalSection(&m_Data);
 }
 
+RWLock::RWLockTemplate()
+{
+  InitializeSRWLock(&m_Data);
+}
+
+RWLock::~RWLockTemplate()
+{
+}
+
+void RWLock::ReadLock()
+{
+  AcquireSRWLockShared(&m_Data);
+}
+
+void RWLock::ReadUnlock()
+{
+  ReleaseSRWLockShared(&m_Data);
+}
+
+void RWLock::WriteLock()
+{
+  AcquireSRWLockExclusive(&m_Data);
+}
+
+void RWLock::WriteUnlock()
+{
+  ReleaseSRWLockExclusive(&m_Data);
+}
+
 struct ThreadInitData
 {
   ThreadEntry entryFunc;
@@ -137,6 +179,9 @@ struct TLSData
 
 static CriticalSection *m_TLSListLock = NULL;
 static vector<TLSData *> *m_TLSList = NULL;
+static vector<TLSDestructor> *m_TLSDestructors = NULL;
+
+static void ExitThreadTLS(TLSData *slots);
 
 void Init()
 {
@@ -146,6 +191,22 @@ void Init()
 
   m_TLSListLock = new CriticalSection();
   m_TLSList = new vector<TLSData *>();
+  m_TLSDestructors = new vector<TLSDestructor>();
+}
+
+void ThreadExit()
+{
+  // DllMain can be called for threads before we've initialised, or after shutdown
+  if(m_TLSListLock == NULL)
+    return;
+
+  TLSData *slots = (TLSData *)TlsGetValue(OSTLSHandle);
+
+  if(slots)
+  {
+    TlsSetValue(OSTLSHandle, NULL);
+    ExitThreadTLS(slots);
+  }
 }
 
 void Shutdown()
@@ -154,7 +215,9 @@ void Shutdown()
     delete m_TLSList->at(i);
 
   delete m_TLSList;
+  delete m_TLSDestructors;
   delete m_TLSListLock;
+  m_TLSListLock = NULL;
 
   TlsFree(OSTLSHandle);
 }
@@ -162,9 +225,44 @@ void Shutdown()
 // allocate a TLS slot in our per-thread vectors with an atomic increment.
 // Note this is going to be 1-indexed because Inc64 returns the post-increment
 // value
-uint64_t AllocateTLSSlot()
+uint64_t AllocateTLSSlot(TLSDestructor destructor)
+{
+  uint64_t slot = Atomic::Inc64(&nextTLSSlot);
+
+  if(destructor)
+  {
+    m_TLSListLock->Lock();
+    if(slot > m_TLSDestructors->size())
+      m_TLSDestructors->resize((size_t)slot);
+    m_TLSDestructors->at((size_t)slot - 1) = destructor;
+    m_TLSListLock->Unlock();
+  }
+
+  return slot;
+}
+
+// run the destructors for a thread's TLS values, and free its per-thread vector
+static void ExitThreadTLS(TLSData *slots)
 {
-  return Atomic::Inc64(&nextTLSSlot);
+  vector<TLSDestructor> destructors;
+
+  m_TLSListLock->Lock();
+  destructors = *m_TLSDestructors;
+  for(size_t i = 0; i < m_TLSList->size(); i++)
+  {
+    if(m_TLSList->at(i) == slots)
+    {
+      m_TLSList->erase(m_TLSList->begin() + i);
+      break;
+    }
+  }
+  m_TLSListLock->Unlock();
+
+  for(size_t i = 0; i < destructors.size() && i < slots->data.size(); i++)
+    if(destructors[i] && slots->data[i])
+      destructors[i](slots->data[i]);
+
+  delete slots;
 }
 
 // look up our per-thread vector.
@@ -221,6 +319,22 @@ uint64_t GetCurrentID()
   return (uint64_t)::GetCurrentThreadId();
 }
 
+double GetCurrentThreadCPUTime()
+{
+  FILETIME creation, exit, kernel, user;
+  if(!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+    return 0.0;
+
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+
+  // 100ns units
+  return double(k.QuadPart + u.QuadPart) / 1.0e7;
+}
+
 void JoinThread(ThreadHandle handle)
 {
   if(handle == 0)
@@ -138,8 +138,16 @@ static void SetActiveWindow(void *device, void *wndHandle)
   RenderDoc::Inst().SetActiveWindow(device, wndHandle);
 }
 
+static uint32_t SaveRecentFrame(uint32_t framesAgo)
+{
+  return RenderDoc::Inst().SaveRecentFrame(framesAgo) ? 1 : 0;
+}
+
 static void StartFrameCapture(void *device, void *wndHandle)
 {
+  // a capture the application starts itself is always saved, even when flight recording
+  RenderDoc::Inst().MarkExplicitCapture();
+
   RenderDoc::Inst().StartFrameCapture(device, wndHandle);
 
   if(device == NULL || wndHandle == NULL)
@@ -165,22 +173,22 @@ int RENDERDOC_CC SetCaptureOptionF32(RENDERDOC_CaptureOption opt, float val);
 uint32_t RENDERDOC_CC GetCaptureOptionU32(RENDERDOC_CaptureOption opt);
 float RENDERDOC_CC GetCaptureOptionF32(RENDERDOC_CaptureOption opt);
 
-void RENDERDOC_CC GetAPIVersion_1_1_1(int *major, int *minor, int *patch)
+void RENDERDOC_CC GetAPIVersion_1_2_0(int *major, int *minor, int *patch)
 {
   if(major)
     *major = 1;
   if(minor)
-    *minor = 1;
+    *minor = 2;
   if(patch)
-    *patch = 1;
+    *patch = 0;
 }
 
-RENDERDOC_API_1_1_1 api_1_1_1;
-void Init_1_1_1()
+RENDERDOC_API_1_2_0 api_1_2_0;
+void Init_1_2_0()
 {
-  RENDERDOC_API_1_1_1 &api = api_1_1_1;
+  RENDERDOC_API_1_2_0 &api = api_1_2_0;
 
-  api.GetAPIVersion = &GetAPIVersion_1_1_1;
+  api.GetAPIVersion = &GetAPIVersion_1_2_0;
 
   api.SetCaptureOptionU32 = &SetCaptureOptionU32;
   api.SetCaptureOptionF32 = &SetCaptureOptionF32;
@@ -215,6 +223,8 @@ void Init_1_1_1()
   api.EndFrameCapture = &EndFrameCapture;
 
   api.TriggerMultiFrameCapture = &TriggerMultiFrameCapture;
+
+  api.SaveRecentFrame = &SaveRecentFrame;
 }
 
 extern "C" RENDERDOC_API int RENDERDOC_CC RENDERDOC_GetAPI(RENDERDOC_Version version,
@@ -241,11 +251,12 @@ extern "C" RENDERDOC_API int RENDERDOC_CC RENDERDOC_GetAPI(RENDERDOC_Version ver
     ret = 1;                                                       \
   }
 
-  API_VERSION_HANDLE(1_0_0, 1_1_1);
-  API_VERSION_HANDLE(1_0_1, 1_1_1);
-  API_VERSION_HANDLE(1_0_2, 1_1_1);
-  API_VERSION_HANDLE(1_1_0, 1_1_1);
-  API_VERSION_HANDLE(1_1_1, 1_1_1);
+  API_VERSION_HANDLE(1_0_0, 1_2_0);
+  API_VERSION_HANDLE(1_0_1, 1_2_0);
+  API_VERSION_HANDLE(1_0_2, 1_2_0);
+  API_VERSION_HANDLE(1_1_0, 1_2_0);
+  API_VERSION_HANDLE(1_1_1, 1_2_0);
+  API_VERSION_HANDLE(1_2_0, 1_2_0);
 
 #undef API_VERSION_HANDLE
 
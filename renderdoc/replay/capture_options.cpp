@@ -48,6 +48,10 @@ int RENDERDOC_CC SetCaptureOptionU32(RENDERDOC_CaptureOption opt, uint32_t val)
     case eRENDERDOC_Option_SaveAllInitials: opts.SaveAllInitials = (val != 0); break;
     case eRENDERDOC_Option_CaptureAllCmdLists: opts.CaptureAllCmdLists = (val != 0); break;
     case eRENDERDOC_Option_DebugOutputMute: opts.DebugOutputMute = (val != 0); break;
+    case eRENDERDOC_Option_FlightRecorderFrames: opts.FlightRecorderFrames = val; break;
+    case eRENDERDOC_Option_FlightRecorderMemoryMB: opts.FlightRecorderMemoryMB = val; break;
+    case eRENDERDOC_Option_CaptureMemoryBudgetMB: opts.CaptureMemoryBudgetMB = val; break;
+    case eRENDERDOC_Option_ProfileLocks: opts.ProfileLocks = (val != 0); break;
     default: RDCLOG("Unrecognised capture option '%d'", opt); return 0;
   }
 
@@ -75,6 +79,12 @@ int RENDERDOC_CC SetCaptureOptionF32(RENDERDOC_CaptureOption opt, float val)
     case eRENDERDOC_Option_SaveAllInitials: opts.SaveAllInitials = (val != 0.0f); break;
     case eRENDERDOC_Option_CaptureAllCmdLists: opts.CaptureAllCmdLists = (val != 0.0f); break;
     case eRENDERDOC_Option_DebugOutputMute: opts.DebugOutputMute = (val != 0.0f); break;
+    case eRENDERDOC_Option_FlightRecorderFrames: opts.FlightRecorderFrames = (uint32_t)val; break;
+    case eRENDERDOC_Option_FlightRecorderMemoryMB:
+      opts.FlightRecorderMemoryMB = (uint32_t)val;
+      break;
+    case eRENDERDOC_Option_CaptureMemoryBudgetMB: opts.CaptureMemoryBudgetMB = (uint32_t)val; break;
+    case eRENDERDOC_Option_ProfileLocks: opts.ProfileLocks = (val != 0.0f); break;
     default: RDCLOG("Unrecognised capture option '%d'", opt); return 0;
   }
 
@@ -110,6 +120,14 @@ uint32_t RENDERDOC_CC GetCaptureOptionU32(RENDERDOC_CaptureOption opt)
       return (RenderDoc::Inst().GetCaptureOptions().CaptureAllCmdLists ? 1 : 0);
     case eRENDERDOC_Option_DebugOutputMute:
       return (RenderDoc::Inst().GetCaptureOptions().DebugOutputMute ? 1 : 0);
+    case eRENDERDOC_Option_FlightRecorderFrames:
+      return (RenderDoc::Inst().GetCaptureOptions().FlightRecorderFrames);
+    case eRENDERDOC_Option_FlightRecorderMemoryMB:
+      return (RenderDoc::Inst().GetCaptureOptions().FlightRecorderMemoryMB);
+    case eRENDERDOC_Option_CaptureMemoryBudgetMB:
+      return (RenderDoc::Inst().GetCaptureOptions().CaptureMemoryBudgetMB);
+    case eRENDERDOC_Option_ProfileLocks:
+      return (RenderDoc::Inst().GetCaptureOptions().ProfileLocks ? 1 : 0);
     default: break;
   }
 
@@ -145,6 +163,14 @@ float RENDERDOC_CC GetCaptureOptionF32(RENDERDOC_CaptureOption opt)
       return (RenderDoc::Inst().GetCaptureOptions().CaptureAllCmdLists ? 1.0f : 0.0f);
     case eRENDERDOC_Option_DebugOutputMute:
       return (RenderDoc::Inst().GetCaptureOptions().DebugOutputMute ? 1.0f : 0.0f);
+    case eRENDERDOC_Option_FlightRecorderFrames:
+      return (RenderDoc::Inst().GetCaptureOptions().FlightRecorderFrames * 1.0f);
+    case eRENDERDOC_Option_FlightRecorderMemoryMB:
+      return (RenderDoc::Inst().GetCaptureOptions().FlightRecorderMemoryMB * 1.0f);
+    case eRENDERDOC_Option_CaptureMemoryBudgetMB:
+      return (RenderDoc::Inst().GetCaptureOptions().CaptureMemoryBudgetMB * 1.0f);
+    case eRENDERDOC_Option_ProfileLocks:
+      return (RenderDoc::Inst().GetCaptureOptions().ProfileLocks ? 1.0f : 0.0f);
     default: break;
   }
 
@@ -166,4 +192,8 @@ CaptureOptions::CaptureOptions()
   SaveAllInitials = false;
   CaptureAllCmdLists = false;
   DebugOutputMute = true;
+  FlightRecorderFrames = 0;
+  FlightRecorderMemoryMB = 256;
+  CaptureMemoryBudgetMB = 0;
+  ProfileLocks = false;
 }
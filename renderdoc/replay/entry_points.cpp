@@ -27,6 +27,7 @@
 #include "api/replay/renderdoc_replay.h"
 #include "api/replay/version.h"
 #include "common/common.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "jpeg-compressor/jpgd.h"
 #include "jpeg-compressor/jpge.h"
@@ -300,6 +301,31 @@ extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_LogMessage(LogMessageType t
   rdclog_int((LogType)type, project ? project : "UNK?", file ? file : "unknown", line, "%s", text);
 }
 
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_SetTraceEnabled(bool32 enabled)
+{
+  Trace::SetEnabled(enabled != 0);
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_ClearTrace()
+{
+  Trace::Clear();
+}
+
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC RENDERDOC_WriteTrace(const char *filename)
+{
+  return Trace::WriteJSON(filename);
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_BeginTraceZone(const char *name)
+{
+  Trace::BeginZone(name);
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_EndTraceZone()
+{
+  Trace::EndZone();
+}
+
 extern "C" RENDERDOC_API const char *RENDERDOC_CC RENDERDOC_GetLogFile()
 {
   return RDCGETLOGFILE();
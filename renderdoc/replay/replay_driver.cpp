@@ -0,0 +1,164 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2016 Baldur Karlsson
+ * Copyright (c) 2014 Crytek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "replay_driver.h"
+#include <string.h>
+
+TextureRegion ClampTextureRegion(const TextureRegion &region, uint32_t width, uint32_t height,
+                                 uint32_t depth, uint32_t blockDim)
+{
+  TextureRegion ret;
+
+  if(region.IsWhole())
+  {
+    ret.width = width;
+    ret.height = height;
+    ret.depth = depth;
+    return ret;
+  }
+
+  // always keep at least one texel so drivers never issue an empty copy
+  uint32_t x0 = RDCMIN(region.x, width - 1);
+  uint32_t y0 = RDCMIN(region.y, height - 1);
+  uint32_t z0 = RDCMIN(region.z, depth - 1);
+
+  // compute the far corner before aligning so the region still covers what was asked for
+  uint32_t x1 = RDCMIN(x0 + RDCMAX(region.width, 1U), width);
+  uint32_t y1 = RDCMIN(y0 + RDCMAX(region.height, 1U), height);
+  uint32_t z1 = RDCMIN(z0 + RDCMAX(region.depth, 1U), depth);
+
+  if(blockDim > 1)
+  {
+    x0 -= x0 % blockDim;
+    y0 -= y0 % blockDim;
+    x1 = RDCMIN(AlignUp(x1, blockDim), width);
+    y1 = RDCMIN(AlignUp(y1, blockDim), height);
+  }
+
+  ret.x = x0;
+  ret.y = y0;
+  ret.z = z0;
+  ret.width = x1 - x0;
+  ret.height = y1 - y0;
+  ret.depth = z1 - z0;
+
+  return ret;
+}
+
+bool GetTextureDataBlockSize(const ResourceFormat &fmt, RemapTextureEnum remap,
+                             uint32_t &blockDim, uint32_t &blockBytes)
+{
+  blockDim = 1;
+  blockBytes = 0;
+
+  switch(remap)
+  {
+    case eRemap_RGBA8: blockBytes = 4; return true;
+    case eRemap_RGBA16: blockBytes = 8; return true;
+    case eRemap_RGBA32: blockBytes = 16; return true;
+    case eRemap_D32S8: blockBytes = 8; return true;
+    case eRemap_None: break;
+  }
+
+  if(!fmt.special)
+  {
+    blockBytes = fmt.compByteWidth * fmt.compCount;
+    return blockBytes > 0;
+  }
+
+  switch(fmt.specialFormat)
+  {
+    case eSpecial_BC1:
+    case eSpecial_BC4: blockDim = 4; blockBytes = 8; break;
+    case eSpecial_BC2:
+    case eSpecial_BC3:
+    case eSpecial_BC5:
+    case eSpecial_BC6:
+    case eSpecial_BC7: blockDim = 4; blockBytes = 16; break;
+    case eSpecial_ETC2:
+      blockDim = 4;
+      blockBytes = fmt.compCount == 4 ? 16 : 8;
+      break;
+    case eSpecial_EAC:
+      blockDim = 4;
+      blockBytes = fmt.compCount == 1 ? 8 : 16;
+      break;
+    case eSpecial_R10G10B10A2:
+    case eSpecial_R11G11B10:
+    case eSpecial_R9G9B9E5:
+    case eSpecial_D16S8:
+    case eSpecial_D24S8: blockBytes = 4; break;
+    case eSpecial_R5G6B5:
+    case eSpecial_R5G5B5A1:
+    case eSpecial_R4G4B4A4: blockBytes = 2; break;
+    case eSpecial_R4G4:
+    case eSpecial_S8: blockBytes = 1; break;
+    case eSpecial_D32S8: blockBytes = 8; break;
+    // ASTC block dimensions aren't described by ResourceFormat, and planar formats aren't laid
+    // out as a simple grid
+    case eSpecial_ASTC:
+    case eSpecial_YUV:
+    case eSpecial_Unknown: return false;
+  }
+
+  return true;
+}
+
+byte *CropTextureData(const byte *data, uint32_t width, uint32_t height, uint32_t depth,
+                      uint32_t blockDim, uint32_t blockBytes, const TextureRegion &region,
+                      size_t &dataSize)
+{
+  uint32_t blocksWide = (width + blockDim - 1) / blockDim;
+  uint32_t blocksHigh = (height + blockDim - 1) / blockDim;
+
+  uint32_t regionBlocksWide = (region.width + blockDim - 1) / blockDim;
+  uint32_t regionBlocksHigh = (region.height + blockDim - 1) / blockDim;
+
+  size_t srcRowPitch = size_t(blocksWide) * blockBytes;
+  size_t srcSlicePitch = srcRowPitch * blocksHigh;
+
+  size_t dstRowPitch = size_t(regionBlocksWide) * blockBytes;
+  size_t dstSlicePitch = dstRowPitch * regionBlocksHigh;
+
+  RDCASSERT(srcSlicePitch * depth <= dataSize);
+
+  dataSize = dstSlicePitch * region.depth;
+  byte *ret = new byte[dataSize];
+
+  const byte *src = data + srcSlicePitch * region.z + srcRowPitch * (region.y / blockDim) +
+                    blockBytes * (region.x / blockDim);
+  byte *dst = ret;
+
+  for(uint32_t z = 0; z < region.depth; z++)
+  {
+    for(uint32_t y = 0; y < regionBlocksHigh; y++)
+      memcpy(dst + dstRowPitch * y, src + srcRowPitch * y, dstRowPitch);
+
+    src += srcSlicePitch;
+    dst += dstSlicePitch;
+  }
+
+  return ret;
+}
@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include <stdlib.h>
+#include <list>
 #include "api/replay/renderdoc_replay.h"
 #include "core/core.h"
 #include "maths/vec.h"
@@ -35,6 +37,11 @@ struct FetchFrameRecord
   FetchFrameInfo frameInfo;
 
   rdctype::array<FetchDrawcall> drawcallList;
+
+  FetchLoadProfile loadProfile;
+
+  // where each frame in the capture ends, as recorded by its footer
+  rdctype::array<FetchCapturedFrame> frames;
 };
 
 enum RemapTextureEnum
@@ -46,6 +53,18 @@ enum RemapTextureEnum
   eRemap_D32S8
 };
 
+// a box within a single subresource. z and depth are only meaningful for 3D textures, for
+// arrays and cubes the box is within the requested slice.
+struct TextureRegion
+{
+  TextureRegion() : x(0), y(0), z(0), width(0), height(0), depth(0) {}
+  uint32_t x, y, z;
+  uint32_t width, height, depth;
+
+  // a zero width means 'the whole subresource'
+  bool IsWhole() const { return width == 0; }
+};
+
 struct GetTextureDataParams
 {
   bool forDiskSave;
@@ -55,6 +74,10 @@ struct GetTextureDataParams
   float blackPoint;
   float whitePoint;
 
+  // if set, only this region of the subresource is returned, tightly packed. The region is
+  // clamped to the subresource and expanded out to whole blocks for block-compressed formats.
+  TextureRegion region;
+
   GetTextureDataParams()
       : forDiskSave(false),
         typeHint(eCompType_None),
@@ -66,6 +89,24 @@ struct GetTextureDataParams
   }
 };
 
+// clamp a requested region to a subresource of the given dimensions, aligning it out to
+// blockDim x blockDim blocks. A whole region is returned as the full subresource.
+TextureRegion ClampTextureRegion(const TextureRegion &region, uint32_t width, uint32_t height,
+                                 uint32_t depth, uint32_t blockDim);
+
+// the size of a texel (or block, for block-compressed formats) of data returned from
+// GetTextureData with the given format and remap. Returns false for formats that can't be
+// cropped on the CPU, such as planar YUV.
+bool GetTextureDataBlockSize(const ResourceFormat &fmt, RemapTextureEnum remap,
+                             uint32_t &blockDim, uint32_t &blockBytes);
+
+// for drivers that can only read back whole subresources: copies the given (already clamped)
+// region out of tightly packed subresource data. Returns a new[] allocated buffer and updates
+// dataSize.
+byte *CropTextureData(const byte *data, uint32_t width, uint32_t height, uint32_t depth,
+                      uint32_t blockDim, uint32_t blockBytes, const TextureRegion &region,
+                      size_t &dataSize);
+
 // these two interfaces define what an API driver implementation must provide
 // to the replay. At minimum it must implement IRemoteDriver which contains
 // all of the functionality that cannot be achieved elsewhere. An IReplayDriver
@@ -208,6 +249,149 @@ public:
   virtual uint32_t PickVertex(uint32_t eventID, const MeshDisplay &cfg, uint32_t x, uint32_t y) = 0;
 };
 
+// utility function to flatten the per-chunk statistics each driver gathers in
+// ReadLogInitialisation into the load profile
+template <typename ChunkType>
+void FillLoadProfileChunks(FetchLoadProfile &profile,
+                           const map<ChunkType, FetchChunkLoadStats> &chunkInfos)
+{
+  vector<FetchChunkLoadStats> chunks;
+  chunks.reserve(chunkInfos.size());
+
+  for(auto it = chunkInfos.begin(); it != chunkInfos.end(); ++it)
+    chunks.push_back(it->second);
+
+  profile.chunks = chunks;
+}
+
+// Tracks the post-transform vertex data a driver has cached, in least-recently-used order, so
+// the GPU memory it holds can be kept within a budget. The budget is set in megabytes by the
+// "postVSCacheMB" config setting, defaulting to 512MB.
+class PostVSCacheLRU
+{
+public:
+  PostVSCacheLRU() : m_TotalBytes(0), m_DeferDepth(0) {}
+  // records a newly generated entry as the most recently used
+  void Add(uint32_t eventID, uint64_t bytes)
+  {
+    LeavePass(eventID);
+    Remove(eventID);
+
+    m_Order.push_front(Entry(eventID, bytes));
+    m_Lookup[eventID] = m_Order.begin();
+    m_TotalBytes += bytes;
+  }
+
+  // marks an existing entry as the most recently used
+  void Touch(uint32_t eventID)
+  {
+    LeavePass(eventID);
+
+    auto it = m_Lookup.find(eventID);
+    if(it != m_Lookup.end())
+      m_Order.splice(m_Order.begin(), m_Order, it->second);
+  }
+
+  void Remove(uint32_t eventID)
+  {
+    auto it = m_Lookup.find(eventID);
+    if(it != m_Lookup.end())
+    {
+      m_TotalBytes -= it->second->bytes;
+      m_Order.erase(it->second);
+      m_Lookup.erase(it);
+    }
+  }
+
+  // while trimming is deferred, Trim() returns nothing. This is used while a whole pass is being
+  // generated so nothing is freed in the middle of a replay.
+  //
+  // The pass's events are also protected from eviction until an event outside the pass is used,
+  // so other entries are always evicted first. Otherwise a pass bigger than the budget would
+  // evict and regenerate its own entries every time it's refreshed.
+  void BeginDeferTrim(const vector<uint32_t> &passEvents)
+  {
+    if(m_DeferDepth++ == 0)
+      m_Pass = set<uint32_t>(passEvents.begin(), passEvents.end());
+  }
+  void EndDeferTrim() { m_DeferDepth--; }
+  // returns the least recently used entries that must be freed to get back within budget, and
+  // stops tracking them. The most recently used entry and entries in the current pass are never
+  // returned, even if they alone are over budget.
+  vector<uint32_t> Trim()
+  {
+    vector<uint32_t> evicted;
+
+    if(m_DeferDepth > 0)
+      return evicted;
+
+    const uint64_t budget = GetBudget();
+
+    auto it = m_Order.end();
+
+    while(m_TotalBytes > budget && it != m_Order.begin())
+    {
+      --it;
+
+      if(it == m_Order.begin())
+        break;
+
+      if(m_Pass.find(it->eventID) != m_Pass.end())
+        continue;
+
+      evicted.push_back(it->eventID);
+      m_TotalBytes -= it->bytes;
+      m_Lookup.erase(it->eventID);
+      it = m_Order.erase(it);
+    }
+
+    return evicted;
+  }
+
+  void Clear()
+  {
+    m_Order.clear();
+    m_Lookup.clear();
+    m_Pass.clear();
+    m_TotalBytes = 0;
+  }
+
+  uint64_t GetTotalBytes() const { return m_TotalBytes; }
+  static uint64_t GetBudget()
+  {
+    const string &setting = RenderDoc::Inst().GetConfigSetting("postVSCacheMB");
+
+    uint64_t megabytes = 512;
+    if(!setting.empty())
+      megabytes = strtoull(setting.c_str(), NULL, 10);
+
+    return megabytes * 1024 * 1024;
+  }
+
+private:
+  struct Entry
+  {
+    Entry(uint32_t e, uint64_t b) : eventID(e), bytes(b) {}
+    uint32_t eventID;
+    uint64_t bytes;
+  };
+
+  // using an event outside the protected pass means it's no longer being displayed
+  void LeavePass(uint32_t eventID)
+  {
+    if(m_DeferDepth == 0 && m_Pass.find(eventID) == m_Pass.end())
+      m_Pass.clear();
+  }
+
+  // most recently used at the front
+  std::list<Entry> m_Order;
+  map<uint32_t, std::list<Entry>::iterator> m_Lookup;
+  uint64_t m_TotalBytes;
+  int m_DeferDepth;
+  // the events of the last pass generated, see BeginDeferTrim
+  set<uint32_t> m_Pass;
+};
+
 // utility function useful in any driver implementation
 template <typename FetchDrawcallContainer>
 FetchDrawcall *SetupDrawcallPointers(vector<FetchDrawcall *> *drawcallTable,
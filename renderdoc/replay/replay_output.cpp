@@ -195,14 +195,16 @@ void ReplayOutput::RefreshOverlay()
 
     if(draw != NULL && (draw->flags & eDraw_Drawcall))
     {
-      m_pDevice->InitPostVSBuffers(draw->eventID);
-
       if(postVSWholePass && !passEvents.empty())
       {
         m_pDevice->InitPostVSBuffers(passEvents);
 
         m_pDevice->ReplayLog(m_EventID, eReplay_WithoutDraw);
       }
+
+      // initialise the selected draw last so it's the most recently used, and can't be evicted
+      // to make room for the rest of the pass
+      m_pDevice->InitPostVSBuffers(draw->eventID);
     }
   }
 
@@ -26,6 +26,8 @@
 #include "replay_renderer.h"
 #include <string.h>
 #include <time.h>
+#include <deque>
+#include <type_traits>
 #include "common/dds_readwrite.h"
 #include "jpeg-compressor/jpgd.h"
 #include "jpeg-compressor/jpge.h"
@@ -37,6 +39,11 @@
 #include "stb/stb_image_write.h"
 #include "tinyexr/tinyexr.h"
 
+// drawcall trees are built up in std::vectors, which only move elements on reallocation if that
+// can't throw
+RDCCOMPILE_ASSERT(std::is_nothrow_move_constructible<FetchDrawcall>::value,
+                  "FetchDrawcall must be nothrow movable");
+
 float ConvertComponent(ResourceFormat fmt, byte *data)
 {
   if(fmt.compByteWidth == 4)
@@ -133,11 +140,83 @@ static void fileWriteFunc(void *context, void *data, int size)
   FileIO::fwrite(data, 1, size, (FILE *)context);
 }
 
+struct FloatConvertJob
+{
+  RowDecoder decoder;
+  const byte *src;
+  uint32_t rowPitch;
+  uint32_t width;
+  uint32_t rowStart, rowEnd;
+
+  bool clampNegative;
+  int channelExtract;
+
+  // either interleaved RGBA output, or planar ABGR output
+  float *rgba;
+  float *abgr[4];
+};
+
+static void ConvertRowsToFloat(void *data)
+{
+  FloatConvertJob *job = (FloatConvertJob *)data;
+
+  vector<Vec4f> planarRow;
+  if(job->rgba == NULL)
+    planarRow.resize(job->width);
+
+  for(uint32_t y = job->rowStart; y < job->rowEnd; y++)
+  {
+    Vec4f *row = job->rgba ? (Vec4f *)(job->rgba + size_t(y) * job->width * 4) : &planarRow[0];
+
+    job->decoder(job->src + size_t(y) * job->rowPitch, row, job->width);
+
+    if(job->clampNegative || job->channelExtract >= 0)
+    {
+      for(uint32_t x = 0; x < job->width; x++)
+      {
+        Vec4f &v = row[x];
+
+        // HDR can't represent negative values
+        if(job->clampNegative)
+        {
+          v.x = RDCMAX(v.x, 0.0f);
+          v.y = RDCMAX(v.y, 0.0f);
+          v.z = RDCMAX(v.z, 0.0f);
+          v.w = RDCMAX(v.w, 0.0f);
+        }
+
+        if(job->channelExtract >= 0)
+        {
+          float c = (&v.x)[job->channelExtract];
+          v = Vec4f(c, c, c, 1.0f);
+        }
+      }
+    }
+
+    if(job->rgba == NULL)
+    {
+      size_t offs = size_t(y) * job->width;
+
+      for(uint32_t x = 0; x < job->width; x++)
+      {
+        job->abgr[0][offs + x] = row[x].w;
+        job->abgr[1][offs + x] = row[x].z;
+        job->abgr[2][offs + x] = row[x].y;
+        job->abgr[3][offs + x] = row[x].x;
+      }
+    }
+  }
+}
+
 ReplayRenderer::ReplayRenderer()
 {
   m_pDevice = NULL;
 
   m_EventID = 100000;
+
+  m_PipelineStateVersion = 0;
+
+  RDCEraseEl(m_APIProps);
 }
 
 ReplayRenderer::~ReplayRenderer()
@@ -225,6 +304,11 @@ bool ReplayRenderer::GetVulkanPipelineState(VulkanPipelineState *state)
   return false;
 }
 
+uint32_t ReplayRenderer::GetPipelineStateVersion()
+{
+  return m_PipelineStateVersion;
+}
+
 bool ReplayRenderer::GetFrameInfo(FetchFrameInfo *info)
 {
   if(info == NULL)
@@ -235,6 +319,37 @@ bool ReplayRenderer::GetFrameInfo(FetchFrameInfo *info)
   return true;
 }
 
+bool ReplayRenderer::GetCapturedFrames(rdctype::array<FetchCapturedFrame> *frames)
+{
+  if(frames == NULL)
+    return false;
+
+  *frames = m_FrameRecord.frames;
+
+  // drivers that don't record frame boundaries hold a single frame
+  if(frames->count == 0)
+  {
+    FetchCapturedFrame frame;
+    frame.frameNumber = m_FrameRecord.frameInfo.frameNumber;
+    frame.firstEvent = m_FrameRecord.frameInfo.firstEvent;
+    frame.lastEvent = m_Drawcalls.empty() ? frame.firstEvent : uint32_t(m_Drawcalls.size() - 1);
+
+    create_array_init(*frames, 1, &frame);
+  }
+
+  return true;
+}
+
+bool ReplayRenderer::GetLoadProfile(FetchLoadProfile *profile)
+{
+  if(profile == NULL)
+    return false;
+
+  *profile = m_FrameRecord.loadProfile;
+
+  return true;
+}
+
 FetchDrawcall *ReplayRenderer::GetDrawcallByEID(uint32_t eventID)
 {
   if(eventID >= m_Drawcalls.size())
@@ -421,6 +536,64 @@ bool ReplayRenderer::GetBufferData(ResourceId buff, uint64_t offset, uint64_t le
 
 bool ReplayRenderer::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
                                     rdctype::array<byte> *data)
+{
+  return FetchTextureData(tex, arrayIdx, mip, GetTextureDataParams(), data);
+}
+
+bool ReplayRenderer::GetTextureRegionData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
+                                          uint32_t *x, uint32_t *y, uint32_t *z, uint32_t *width,
+                                          uint32_t *height, uint32_t *depth,
+                                          rdctype::array<byte> *data)
+{
+  if(x == NULL || y == NULL || z == NULL || width == NULL || height == NULL || depth == NULL)
+    return false;
+
+  ResourceId liveId = m_pDevice->GetLiveID(tex);
+
+  if(liveId == ResourceId())
+  {
+    RDCERR("Couldn't get Live ID for %llu getting texture region", tex);
+    return false;
+  }
+
+  GetTextureDataParams params;
+  params.region.x = *x;
+  params.region.y = *y;
+  params.region.z = *z;
+  // a zero-sized region would otherwise mean the whole subresource
+  params.region.width = RDCMAX(*width, 1U);
+  params.region.height = RDCMAX(*height, 1U);
+  params.region.depth = RDCMAX(*depth, 1U);
+
+  // the drivers fail for formats they can't crop, rather than returning the whole subresource
+  if(!FetchTextureData(tex, arrayIdx, mip, params, data) || data->count == 0)
+    return false;
+
+  // work out the same clamped and block-aligned region the driver read, to return it
+  FetchTexture details = m_pDevice->GetTexture(liveId);
+
+  uint32_t blockDim = 1, blockBytes = 0;
+  if(!GetTextureDataBlockSize(details.format, eRemap_None, blockDim, blockBytes) &&
+     details.format.specialFormat == eSpecial_ASTC)
+    blockDim = 4;    // only 4x4 ASTC can be read successfully
+
+  TextureRegion region = ClampTextureRegion(
+      params.region, RDCMAX(1U, details.width >> mip), RDCMAX(1U, details.height >> mip),
+      details.dimension == 3 ? RDCMAX(1U, details.depth >> mip) : 1, blockDim);
+
+  *x = region.x;
+  *y = region.y;
+  *z = region.z;
+  *width = region.width;
+  *height = region.height;
+  *depth = region.depth;
+
+  return true;
+}
+
+bool ReplayRenderer::FetchTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
+                                      const GetTextureDataParams &params,
+                                      rdctype::array<byte> *data)
 {
   if(data == NULL)
     return false;
@@ -434,7 +607,7 @@ bool ReplayRenderer::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t
   }
 
   size_t sz = 0;
-  byte *bytes = m_pDevice->GetTextureData(liveId, arrayIdx, mip, GetTextureDataParams(), sz);
+  byte *bytes = m_pDevice->GetTextureData(liveId, arrayIdx, mip, params, sz);
 
   if(sz == 0 || bytes == NULL)
     create_array_uninit(*data, 0);
@@ -448,11 +621,33 @@ bool ReplayRenderer::GetTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t
 
 bool ReplayRenderer::SaveTexture(const TextureSave &saveData, const char *path)
 {
-  TextureSave sd = saveData;    // mutable copy
-  ResourceId liveid = m_pDevice->GetLiveID(sd.id);
-  FetchTexture td = m_pDevice->GetTexture(liveid);
+  TextureSaveData data;
 
-  bool success = false;
+  if(!ReadbackTexture(saveData, data))
+    return false;
+
+  return EncodeTexture(data, path);
+}
+
+void ReplayRenderer::TextureSaveData::Free()
+{
+  for(size_t i = 0; i < subdata.size(); i++)
+    delete[] subdata[i];
+
+  subdata.clear();
+  subdataSize.clear();
+}
+
+bool ReplayRenderer::ReadbackTexture(const TextureSave &saveData, TextureSaveData &data)
+{
+  data.Free();
+
+  data.sd = saveData;    // mutable copy
+  ResourceId liveid = m_pDevice->GetLiveID(data.sd.id);
+  data.td = m_pDevice->GetTexture(liveid);
+
+  TextureSave &sd = data.sd;
+  FetchTexture &td = data.td;
 
   // clamp sample/mip/slice indices
   if(td.msSamp == 1)
@@ -600,7 +795,8 @@ bool ReplayRenderer::SaveTexture(const TextureSave &saveData, const char *path)
     // otherwise take all mips, as by default
   }
 
-  vector<byte *> subdata;
+  vector<byte *> &subdata = data.subdata;
+  vector<size_t> &subdataSize = data.subdataSize;
 
   bool downcast = false;
 
@@ -709,8 +905,7 @@ bool ReplayRenderer::SaveTexture(const TextureSave &saveData, const char *path)
       {
         RDCERR("Couldn't get bytes for mip %u, slice %u", mip, slice);
 
-        for(size_t i = 0; i < subdata.size(); i++)
-          delete[] subdata[i];
+        data.Free();
 
         return false;
       }
@@ -718,6 +913,7 @@ bool ReplayRenderer::SaveTexture(const TextureSave &saveData, const char *path)
       if(td.depth == 1)
       {
         subdata.push_back(bytes);
+        subdataSize.push_back(datasize);
         continue;
       }
 
@@ -746,6 +942,7 @@ bool ReplayRenderer::SaveTexture(const TextureSave &saveData, const char *path)
         byte *b = bytes + mipSlicePitch * sliceOffset;
         memcpy(depthslice, b, slicePitch);
         subdata.push_back(depthslice);
+        subdataSize.push_back(mipSlicePitch);
 
         delete[] bytes;
         continue;
@@ -763,6 +960,7 @@ bool ReplayRenderer::SaveTexture(const TextureSave &saveData, const char *path)
         memcpy(depthslice, b, mipSlicePitch);
 
         subdata.push_back(depthslice);
+        subdataSize.push_back(mipSlicePitch);
 
         b += mipSlicePitch;
       }
@@ -771,6 +969,25 @@ bool ReplayRenderer::SaveTexture(const TextureSave &saveData, const char *path)
     }
   }
 
+  data.numSlices = numSlices;
+  data.numMips = numMips;
+  data.rowPitch = rowPitch;
+
+  return true;
+}
+
+bool ReplayRenderer::EncodeTexture(TextureSaveData &data, const char *path)
+{
+  const TextureSave &sd = data.sd;
+  FetchTexture &td = data.td;
+  vector<byte *> &subdata = data.subdata;
+
+  const uint32_t numSlices = data.numSlices;
+  const uint32_t numMips = data.numMips;
+  uint32_t rowPitch = data.rowPitch;
+
+  bool success = false;
+
   // should have been handled above, but verify incoming data is RGBA8
   if(sd.slice.slicesAsGrid && td.format.compByteWidth == 1 && td.format.compCount == 4)
   {
@@ -1068,110 +1285,74 @@ bool ReplayRenderer::SaveTexture(const TextureSave &saveData, const char *path)
         abgr[3] = new float[td.width * td.height];
       }
 
-      byte *srcData = subdata[0];
+      // pick the decoder once for the whole image, then convert rows in parallel for large
+      // images since the per-texel float conversion dominates the cost of saving.
+      RowDecoder decoder = GetRowDecoder(td.format);
 
-      for(uint32_t y = 0; y < td.height; y++)
+      if(decoder == NULL)
       {
-        for(uint32_t x = 0; x < td.width; x++)
+        success = false;
+      }
+      else
+      {
+        FloatConvertJob job;
+        job.decoder = decoder;
+        job.src = subdata[0];
+        job.rowPitch = rowPitch;
+        job.width = td.width;
+        job.rowStart = 0;
+        job.rowEnd = td.height;
+        job.clampNegative = (sd.destType == eFileType_HDR);
+        job.channelExtract = sd.channelExtract;
+        job.rgba = fldata;
+        for(int i = 0; i < 4; i++)
+          job.abgr[i] = abgr[i];
+
+        const uint32_t maxWorkers = 4;
+        uint32_t numWorkers = RDCMIN(maxWorkers, td.height);
+
+        // not worth spinning up threads for small images
+        if(td.width * td.height < 512 * 512)
+          numWorkers = 1;
+
+        if(numWorkers <= 1)
         {
-          float r = 0.0f;
-          float g = 0.0f;
-          float b = 0.0f;
-          float a = 1.0f;
-
-          if(td.format.special && td.format.specialFormat == eSpecial_R10G10B10A2)
-          {
-            uint32_t *u32 = (uint32_t *)srcData;
-
-            Vec4f vec = ConvertFromR10G10B10A2(*u32);
-
-            r = vec.x;
-            g = vec.y;
-            b = vec.z;
-            a = vec.w;
-
-            srcData += 4;
-          }
-          else if(td.format.special && td.format.specialFormat == eSpecial_R11G11B10)
-          {
-            uint32_t *u32 = (uint32_t *)srcData;
-
-            Vec3f vec = ConvertFromR11G11B10(*u32);
+          ConvertRowsToFloat(&job);
+        }
+        else
+        {
+          FloatConvertJob jobs[maxWorkers];
+          Threading::ThreadHandle threads[maxWorkers];
 
-            r = vec.x;
-            g = vec.y;
-            b = vec.z;
-            a = 1.0f;
+          uint32_t rowsPerWorker = (td.height + numWorkers - 1) / numWorkers;
 
-            srcData += 4;
-          }
-          else
+          for(uint32_t i = 0; i < numWorkers; i++)
           {
-            if(td.format.compCount >= 1)
-              r = ConvertComponent(td.format, srcData + td.format.compByteWidth * 0);
-            if(td.format.compCount >= 2)
-              g = ConvertComponent(td.format, srcData + td.format.compByteWidth * 1);
-            if(td.format.compCount >= 3)
-              b = ConvertComponent(td.format, srcData + td.format.compByteWidth * 2);
-            if(td.format.compCount >= 4)
-              a = ConvertComponent(td.format, srcData + td.format.compByteWidth * 3);
-
-            srcData += td.format.compCount * td.format.compByteWidth;
-          }
+            jobs[i] = job;
+            jobs[i].rowStart = RDCMIN(td.height, i * rowsPerWorker);
+            jobs[i].rowEnd = RDCMIN(td.height, (i + 1) * rowsPerWorker);
 
-          // HDR can't represent negative values
-          if(sd.destType == eFileType_HDR)
-          {
-            r = RDCMAX(r, 0.0f);
-            g = RDCMAX(g, 0.0f);
-            b = RDCMAX(b, 0.0f);
-            a = RDCMAX(a, 0.0f);
+            // convert the last range on this thread
+            if(i + 1 < numWorkers)
+              threads[i] = Threading::CreateThread(&ConvertRowsToFloat, &jobs[i]);
           }
 
-          if(sd.channelExtract == 0)
-          {
-            g = b = r;
-            a = 1.0f;
-          }
-          if(sd.channelExtract == 1)
-          {
-            r = b = g;
-            a = 1.0f;
-          }
-          if(sd.channelExtract == 2)
-          {
-            r = g = b;
-            a = 1.0f;
-          }
-          if(sd.channelExtract == 3)
-          {
-            r = g = b = a;
-            a = 1.0f;
-          }
+          ConvertRowsToFloat(&jobs[numWorkers - 1]);
 
-          if(fldata)
-          {
-            fldata[(y * td.width + x) * 4 + 0] = r;
-            fldata[(y * td.width + x) * 4 + 1] = g;
-            fldata[(y * td.width + x) * 4 + 2] = b;
-            fldata[(y * td.width + x) * 4 + 3] = a;
-          }
-          else
+          for(uint32_t i = 0; i + 1 < numWorkers; i++)
           {
-            abgr[0][(y * td.width + x)] = a;
-            abgr[1][(y * td.width + x)] = b;
-            abgr[2][(y * td.width + x)] = g;
-            abgr[3][(y * td.width + x)] = r;
+            Threading::JoinThread(threads[i]);
+            Threading::CloseThread(threads[i]);
           }
         }
       }
 
-      if(sd.destType == eFileType_HDR)
+      if(success && sd.destType == eFileType_HDR)
       {
         int ret = stbi_write_hdr_to_func(fileWriteFunc, (void *)f, td.width, td.height, 4, fldata);
         success = (ret != 0);
       }
-      else if(sd.destType == eFileType_EXR)
+      else if(success && sd.destType == eFileType_EXR)
       {
         const char *err = NULL;
 
@@ -1224,8 +1405,355 @@ bool ReplayRenderer::SaveTexture(const TextureSave &saveData, const char *path)
     FileIO::fclose(f);
   }
 
-  for(size_t i = 0; i < subdata.size(); i++)
-    delete[] subdata[i];
+  data.Free();
+
+  return success;
+}
+
+// exported textures waiting to be encoded, shared between the replay thread reading them back
+// and the workers encoding them.
+struct ReplayRenderer::TextureExportQueue
+{
+  struct Job
+  {
+    Job() : success(false) {}
+    TextureSaveData data;
+    string path;
+    bool success;
+  };
+
+  TextureExportQueue() : finished(false) {}
+  Threading::CriticalSection lock;
+  std::deque<Job *> pending;
+  bool finished;
+};
+
+void ReplayRenderer::TextureExportWorker(void *param)
+{
+  TextureExportQueue *queue = (TextureExportQueue *)param;
+
+  for(;;)
+  {
+    TextureExportQueue::Job *job = NULL;
+    bool finished = false;
+
+    {
+      SCOPED_LOCK(queue->lock);
+      if(!queue->pending.empty())
+      {
+        job = queue->pending.front();
+        queue->pending.pop_front();
+      }
+      finished = queue->finished;
+    }
+
+    if(job)
+      job->success = EncodeTexture(job->data, job->path.c_str());
+    else if(finished)
+      break;
+    else
+      Threading::Sleep(1);
+  }
+}
+
+// hashes the read back contents of a texture along with its size and format, so that textures
+// which didn't change between exported events are only written once.
+static uint64_t HashTextureData(const FetchTexture &td, const vector<byte *> &subdata,
+                                const vector<size_t> &subdataSize)
+{
+  const uint64_t prime = 1099511628211ULL;
+  uint64_t hash = 14695981039346656037ULL;
+
+  uint64_t header[] = {td.width,           td.height,           td.depth,
+                       td.arraysize,       td.format.compCount, td.format.compByteWidth,
+                       td.format.compType, td.format.specialFormat, subdata.size()};
+
+  for(size_t i = 0; i < ARRAY_COUNT(header); i++)
+  {
+    hash ^= header[i];
+    hash *= prime;
+  }
+
+  for(size_t s = 0; s < subdata.size(); s++)
+  {
+    const byte *data = subdata[s];
+    size_t size = subdataSize[s];
+    size_t words = size / sizeof(uint64_t);
+
+    hash ^= size;
+    hash *= prime;
+
+    // hash a word at a time, folding the high bits back down since the multiply only carries
+    // upwards
+    for(size_t i = 0; i < words; i++)
+    {
+      uint64_t w;
+      memcpy(&w, data + i * sizeof(uint64_t), sizeof(uint64_t));
+      hash ^= w;
+      hash *= prime;
+      hash ^= hash >> 32;
+    }
+
+    for(size_t i = words * sizeof(uint64_t); i < size; i++)
+    {
+      hash ^= data[i];
+      hash *= prime;
+    }
+  }
+
+  return hash;
+}
+
+// a copy of the read back contents of an exported texture, to confirm that a later texture with
+// the same hash really is identical before skipping it as a duplicate
+struct ExportedTextureContents
+{
+  uint64_t hash;
+  size_t result;
+  uint64_t header[8];
+  vector<size_t> sizes;
+  vector<byte> bytes;
+
+  static void GetHeader(const FetchTexture &td, uint64_t *header)
+  {
+    header[0] = td.width;
+    header[1] = td.height;
+    header[2] = td.depth;
+    header[3] = td.arraysize;
+    header[4] = td.format.compCount;
+    header[5] = td.format.compByteWidth;
+    header[6] = td.format.compType;
+    header[7] = td.format.specialFormat;
+  }
+
+  template <typename SaveData>
+  void Store(const SaveData &data)
+  {
+    GetHeader(data.td, header);
+    sizes = data.subdataSize;
+
+    size_t total = 0;
+    for(size_t s = 0; s < sizes.size(); s++)
+      total += sizes[s];
+
+    bytes.resize(total);
+
+    byte *dst = bytes.data();
+    for(size_t s = 0; s < data.subdata.size(); s++)
+    {
+      memcpy(dst, data.subdata[s], sizes[s]);
+      dst += sizes[s];
+    }
+  }
+
+  template <typename SaveData>
+  bool Matches(const SaveData &data) const
+  {
+    uint64_t other[ARRAY_COUNT(header)];
+    GetHeader(data.td, other);
+
+    if(memcmp(header, other, sizeof(header)) != 0 || sizes != data.subdataSize)
+      return false;
+
+    const byte *src = bytes.data();
+    for(size_t s = 0; s < data.subdata.size(); s++)
+    {
+      if(memcmp(src, data.subdata[s], sizes[s]) != 0)
+        return false;
+      src += sizes[s];
+    }
+
+    return true;
+  }
+};
+
+bool ReplayRenderer::ExportTextures(const TextureSave &saveData, uint32_t firstEvent,
+                                    uint32_t lastEvent, const ResourceId *ids, uint32_t numIDs,
+                                    const char *pathPrefix, rdctype::array<TextureExport> *exports)
+{
+  if(pathPrefix == NULL || exports == NULL || (numIDs > 0 && ids == NULL))
+    return false;
+
+  const char *extensions[eFileType_Count] = {"dds", "png", "jpg", "bmp", "tga", "hdr", "exr"};
+
+  if((uint32_t)saveData.destType >= eFileType_Count)
+  {
+    RDCERR("Invalid file type %u for export", saveData.destType);
+    return false;
+  }
+
+  TextureExportQueue queue;
+
+  // textures are read back on this thread while earlier ones are encoded and written by the
+  // workers, so replay and readback of one event overlaps with the encoding of the last.
+  const uint32_t numWorkers = 4;
+  Threading::ThreadHandle workers[numWorkers];
+
+  for(uint32_t i = 0; i < numWorkers; i++)
+    workers[i] = Threading::CreateThread(&TextureExportWorker, &queue);
+
+  // every export, the job writing it (NULL for duplicates) and the export that holds its contents
+  vector<TextureExport> results;
+  vector<TextureExportQueue::Job *> jobs;
+  vector<size_t> sources;
+
+  // the contents of recently written exports. A hash match is only treated as a duplicate once
+  // the contents compare equal too. To bound memory only the most recent exports are kept, and a
+  // texture matching an older one is just written again.
+  std::deque<ExportedTextureContents> written;
+  size_t writtenBytes = 0;
+  const size_t writtenBudget = 256 * 1024 * 1024;
+
+  bool success = true;
+
+  for(uint32_t eid = firstEvent; eid <= lastEvent && eid < m_Drawcalls.size(); eid++)
+  {
+    FetchDrawcall *draw = GetDrawcallByEID(eid);
+
+    // markers don't write anything themselves
+    if(draw == NULL || draw->children.count > 0 ||
+       (draw->flags & (eDraw_SetMarker | eDraw_PushMarker | eDraw_PopMarker)))
+      continue;
+
+    vector<ResourceId> textures;
+
+    if(numIDs > 0)
+    {
+      textures.assign(ids, ids + numIDs);
+    }
+    else
+    {
+      for(size_t i = 0; i < ARRAY_COUNT(draw->outputs); i++)
+        if(draw->outputs[i] != ResourceId())
+          textures.push_back(draw->outputs[i]);
+
+      if(draw->depthOut != ResourceId())
+        textures.push_back(draw->depthOut);
+    }
+
+    if(textures.empty())
+      continue;
+
+    m_pDevice->ReplayLog(eid, eReplay_Full);
+
+    for(size_t t = 0; t < textures.size(); t++)
+    {
+      TextureSave sd = saveData;
+      sd.id = textures[t];
+
+      TextureExportQueue::Job *job = new TextureExportQueue::Job();
+
+      if(!ReadbackTexture(sd, job->data))
+      {
+        RDCERR("Couldn't read back %llu at event %u for export", sd.id, eid);
+        delete job;
+        success = false;
+        continue;
+      }
+
+      uint64_t hash = HashTextureData(job->data.td, job->data.subdata, job->data.subdataSize);
+
+      TextureExport exp;
+      exp.eventID = eid;
+      exp.id = sd.id;
+      exp.duplicate = false;
+
+      const ExportedTextureContents *match = NULL;
+
+      for(size_t i = 0; i < written.size() && match == NULL; i++)
+        if(written[i].hash == hash && written[i].Matches(job->data))
+          match = &written[i];
+
+      if(match)
+      {
+        exp.path = results[match->result].path;
+        exp.duplicate = true;
+
+        sources.push_back(match->result);
+        jobs.push_back(NULL);
+
+        delete job;
+      }
+      else
+      {
+        job->path = StringFormat::Fmt("%s_%u_%llu.%s", pathPrefix, eid, sd.id.id,
+                                      extensions[saveData.destType]);
+        exp.path = job->path;
+
+        // keep a copy before the encoder modifies and frees the data
+        written.push_back(ExportedTextureContents());
+        written.back().hash = hash;
+        written.back().result = results.size();
+        written.back().Store(job->data);
+        writtenBytes += written.back().bytes.size();
+
+        while(writtenBytes > writtenBudget && written.size() > 1)
+        {
+          writtenBytes -= written.front().bytes.size();
+          written.pop_front();
+        }
+
+        sources.push_back(results.size());
+        jobs.push_back(job);
+
+        // if the encoders fall behind, wait for them so we don't hold on to an unbounded amount
+        // of read back data
+        for(;;)
+        {
+          {
+            SCOPED_LOCK(queue.lock);
+            if(queue.pending.size() < numWorkers * 2)
+            {
+              queue.pending.push_back(job);
+              break;
+            }
+          }
+
+          Threading::Sleep(1);
+        }
+      }
+
+      results.push_back(exp);
+    }
+  }
+
+  {
+    SCOPED_LOCK(queue.lock);
+    queue.finished = true;
+  }
+
+  for(uint32_t i = 0; i < numWorkers; i++)
+  {
+    Threading::JoinThread(workers[i]);
+    Threading::CloseThread(workers[i]);
+  }
+
+  // drop anything that failed to write, along with its duplicates
+  vector<TextureExport> ret;
+  ret.reserve(results.size());
+
+  for(size_t i = 0; i < results.size(); i++)
+  {
+    if(!jobs[sources[i]]->success)
+    {
+      if(sources[i] == i)
+      {
+        RDCERR("Couldn't write %s", results[i].path.elems);
+        success = false;
+      }
+      continue;
+    }
+
+    ret.push_back(results[i]);
+  }
+
+  for(size_t i = 0; i < jobs.size(); i++)
+    delete jobs[i];
+
+  *exports = ret;
+
+  // put the replay back where it was
+  SetFrameEvent(m_EventID, true);
 
   return success;
 }
@@ -1568,12 +2096,17 @@ ReplayCreateStatus ReplayRenderer::PostCreateInit(IReplayDriver *device)
 
   m_pDevice->ReadLogInitialisation();
 
+  m_APIProps = m_pDevice->GetAPIProperties();
+
   FetchPipelineState();
 
   FetchFrameRecord fr = m_pDevice->GetFrameRecord();
 
-  m_FrameRecord.frameInfo = fr.frameInfo;
-  m_FrameRecord.m_DrawCallList = fr.drawcallList;
+  // fr is our own copy, so take its contents rather than deep-copying the drawcall tree again
+  m_FrameRecord.frameInfo = std::move(fr.frameInfo);
+  m_FrameRecord.m_DrawCallList.take(fr.drawcallList);
+  m_FrameRecord.loadProfile = std::move(fr.loadProfile);
+  m_FrameRecord.frames = std::move(fr.frames);
   SetupDrawcallPointers(&m_Drawcalls, m_FrameRecord.m_DrawCallList, NULL, NULL);
 
   return eReplayCreate_Success;
@@ -1604,12 +2137,43 @@ void ReplayRenderer::FetchPipelineState()
 {
   m_pDevice->SavePipelineState();
 
-  m_D3D11PipelineState = m_pDevice->GetD3D11PipelineState();
-  m_D3D12PipelineState = m_pDevice->GetD3D12PipelineState();
-  m_GLPipelineState = m_pDevice->GetGLPipelineState();
-  m_VulkanPipelineState = m_pDevice->GetVulkanPipelineState();
+  // only replace (and look up shader details for) the state if it actually changed, so that
+  // unchanged states keep their version and the UI can skip refreshing them. Only the replaying
+  // API's state is ever filled out, so the others aren't fetched or diffed.
+  D3D11PipelineState d3d11;
+  D3D12PipelineState d3d12;
+  GLPipelineState gl;
+  VulkanPipelineState vulkan;
+
+  bool changed[4] = {false, false, false, false};
+
+  switch(m_APIProps.pipelineType)
+  {
+    case eGraphicsAPI_D3D11:
+      d3d11 = m_pDevice->GetD3D11PipelineState();
+      changed[0] = m_D3D11PipelineBlob.Update(d3d11);
+      break;
+    case eGraphicsAPI_D3D12:
+      d3d12 = m_pDevice->GetD3D12PipelineState();
+      changed[1] = m_D3D12PipelineBlob.Update(d3d12);
+      break;
+    case eGraphicsAPI_OpenGL:
+      gl = m_pDevice->GetGLPipelineState();
+      changed[2] = m_GLPipelineBlob.Update(gl);
+      break;
+    case eGraphicsAPI_Vulkan:
+      vulkan = m_pDevice->GetVulkanPipelineState();
+      changed[3] = m_VulkanPipelineBlob.Update(vulkan);
+      break;
+  }
+
+  if(changed[0] || changed[1] || changed[2] || changed[3])
+    m_PipelineStateVersion++;
 
+  if(changed[0])
   {
+    m_D3D11PipelineState = d3d11;
+
     D3D11PipelineState::ShaderStage *stages[] = {
         &m_D3D11PipelineState.m_VS, &m_D3D11PipelineState.m_HS, &m_D3D11PipelineState.m_DS,
         &m_D3D11PipelineState.m_GS, &m_D3D11PipelineState.m_PS, &m_D3D11PipelineState.m_CS,
@@ -1620,7 +2184,10 @@ void ReplayRenderer::FetchPipelineState()
         stages[i]->ShaderDetails = m_pDevice->GetShader(m_pDevice->GetLiveID(stages[i]->Shader), "");
   }
 
+  if(changed[1])
   {
+    m_D3D12PipelineState = d3d12;
+
     D3D12PipelineState::ShaderStage *stages[] = {
         &m_D3D12PipelineState.m_VS, &m_D3D12PipelineState.m_HS, &m_D3D12PipelineState.m_DS,
         &m_D3D12PipelineState.m_GS, &m_D3D12PipelineState.m_PS, &m_D3D12PipelineState.m_CS,
@@ -1631,7 +2198,10 @@ void ReplayRenderer::FetchPipelineState()
         stages[i]->ShaderDetails = m_pDevice->GetShader(m_pDevice->GetLiveID(stages[i]->Shader), "");
   }
 
+  if(changed[2])
   {
+    m_GLPipelineState = gl;
+
     GLPipelineState::ShaderStage *stages[] = {
         &m_GLPipelineState.m_VS, &m_GLPipelineState.m_TCS, &m_GLPipelineState.m_TES,
         &m_GLPipelineState.m_GS, &m_GLPipelineState.m_FS,  &m_GLPipelineState.m_CS,
@@ -1642,7 +2212,10 @@ void ReplayRenderer::FetchPipelineState()
         stages[i]->ShaderDetails = m_pDevice->GetShader(m_pDevice->GetLiveID(stages[i]->Shader), "");
   }
 
+  if(changed[3])
   {
+    m_VulkanPipelineState = vulkan;
+
     VulkanPipelineState::ShaderStage *stages[] = {
         &m_VulkanPipelineState.VS, &m_VulkanPipelineState.TCS, &m_VulkanPipelineState.TES,
         &m_VulkanPipelineState.GS, &m_VulkanPipelineState.FS,  &m_VulkanPipelineState.CS,
@@ -1723,6 +2296,11 @@ ReplayRenderer_GetVulkanPipelineState(ReplayRenderer *rend, VulkanPipelineState
 {
   return rend->GetVulkanPipelineState(state);
 }
+extern "C" RENDERDOC_API uint32_t RENDERDOC_CC
+ReplayRenderer_GetPipelineStateVersion(ReplayRenderer *rend)
+{
+  return rend->GetPipelineStateVersion();
+}
 
 extern "C" RENDERDOC_API void RENDERDOC_CC ReplayRenderer_BuildCustomShader(
     ReplayRenderer *rend, const char *entry, const char *source, const uint32_t compileFlags,
@@ -1771,6 +2349,16 @@ extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetFrameInfo(ReplayR
   return rend->GetFrameInfo(frame);
 }
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC
+ReplayRenderer_GetCapturedFrames(ReplayRenderer *rend, rdctype::array<FetchCapturedFrame> *frames)
+{
+  return rend->GetCapturedFrames(frames);
+}
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC
+ReplayRenderer_GetLoadProfile(ReplayRenderer *rend, FetchLoadProfile *profile)
+{
+  return rend->GetLoadProfile(profile);
+}
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC
 ReplayRenderer_GetDrawcalls(ReplayRenderer *rend, rdctype::array<FetchDrawcall> *draws)
 {
   return rend->GetDrawcalls(draws);
@@ -1862,6 +2450,14 @@ extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_SaveTexture(ReplayRe
   return rend->SaveTexture(saveData, path);
 }
 
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_ExportTextures(
+    ReplayRenderer *rend, const TextureSave &saveData, uint32_t firstEvent, uint32_t lastEvent,
+    const ResourceId *ids, uint32_t numIDs, const char *pathPrefix,
+    rdctype::array<TextureExport> *exports)
+{
+  return rend->ExportTextures(saveData, firstEvent, lastEvent, ids, numIDs, pathPrefix, exports);
+}
+
 extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetPostVSData(ReplayRenderer *rend,
                                                                           uint32_t instID,
                                                                           MeshDataStage stage,
@@ -1881,3 +2477,10 @@ extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetTextureData(
 {
   return rend->GetTextureData(tex, arrayIdx, mip, data);
 }
+
+extern "C" RENDERDOC_API bool32 RENDERDOC_CC ReplayRenderer_GetTextureRegionData(
+    ReplayRenderer *rend, ResourceId tex, uint32_t arrayIdx, uint32_t mip, uint32_t *x, uint32_t *y,
+    uint32_t *z, uint32_t *width, uint32_t *height, uint32_t *depth, rdctype::array<byte> *data)
+{
+  return rend->GetTextureRegionData(tex, arrayIdx, mip, x, y, z, width, height, depth, data);
+}
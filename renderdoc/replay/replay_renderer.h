@@ -30,6 +30,7 @@
 #include "api/replay/renderdoc_replay.h"
 #include "common/common.h"
 #include "core/core.h"
+#include "core/replay_proxy.h"
 #include "replay/replay_driver.h"
 #include "type_helpers.h"
 
@@ -143,6 +144,7 @@ public:
   bool GetD3D12PipelineState(D3D12PipelineState *state);
   bool GetGLPipelineState(GLPipelineState *state);
   bool GetVulkanPipelineState(VulkanPipelineState *state);
+  uint32_t GetPipelineStateVersion();
 
   ResourceId BuildCustomShader(const char *entry, const char *source, const uint32_t compileFlags,
                                ShaderStageType type, rdctype::str *errors);
@@ -155,6 +157,8 @@ public:
   bool FreeTargetResource(ResourceId id);
 
   bool GetFrameInfo(FetchFrameInfo *frame);
+  bool GetCapturedFrames(rdctype::array<FetchCapturedFrame> *frames);
+  bool GetLoadProfile(FetchLoadProfile *profile);
   bool GetDrawcalls(rdctype::array<FetchDrawcall> *draws);
   bool FetchCounters(uint32_t *counters, uint32_t numCounters,
                      rdctype::array<CounterResult> *results);
@@ -180,8 +184,14 @@ public:
 
   bool GetBufferData(ResourceId buff, uint64_t offset, uint64_t len, rdctype::array<byte> *data);
   bool GetTextureData(ResourceId buff, uint32_t arrayIdx, uint32_t mip, rdctype::array<byte> *data);
+  bool GetTextureRegionData(ResourceId tex, uint32_t arrayIdx, uint32_t mip, uint32_t *x,
+                            uint32_t *y, uint32_t *z, uint32_t *width, uint32_t *height,
+                            uint32_t *depth, rdctype::array<byte> *data);
 
   bool SaveTexture(const TextureSave &saveData, const char *path);
+  bool ExportTextures(const TextureSave &saveData, uint32_t firstEvent, uint32_t lastEvent,
+                      const ResourceId *ids, uint32_t numIDs, const char *pathPrefix,
+                      rdctype::array<TextureExport> *exports);
 
   bool GetCBufferVariableContents(ResourceId shader, const char *entryPoint, uint32_t cbufslot,
                                   ResourceId buffer, uint64_t offs,
@@ -197,6 +207,37 @@ public:
 private:
   ReplayCreateStatus PostCreateInit(IReplayDriver *device);
 
+  bool FetchTextureData(ResourceId tex, uint32_t arrayIdx, uint32_t mip,
+                        const GetTextureDataParams &params, rdctype::array<byte> *data);
+
+  // texture subresources read back and converted for a TextureSave, ready to be encoded.
+  // Reading back needs the replay device, encoding doesn't and can happen on any thread.
+  struct TextureSaveData
+  {
+    TextureSaveData() : numSlices(0), numMips(0), rowPitch(0) {}
+    ~TextureSaveData() { Free(); }
+    void Free();
+
+    TextureSave sd;
+    FetchTexture td;
+    vector<byte *> subdata;
+    vector<size_t> subdataSize;
+    uint32_t numSlices;
+    uint32_t numMips;
+    uint32_t rowPitch;
+
+  private:
+    // no copying
+    TextureSaveData(const TextureSaveData &);
+    TextureSaveData &operator=(const TextureSaveData &);
+  };
+
+  bool ReadbackTexture(const TextureSave &saveData, TextureSaveData &data);
+  static bool EncodeTexture(TextureSaveData &data, const char *path);
+
+  struct TextureExportQueue;
+  static void TextureExportWorker(void *param);
+
   FetchDrawcall *GetDrawcallByEID(uint32_t eventID);
 
   IReplayDriver *GetDevice() { return m_pDevice; }
@@ -205,6 +246,10 @@ private:
     FetchFrameInfo frameInfo;
 
     rdctype::array<FetchDrawcall> m_DrawCallList;
+
+    FetchLoadProfile loadProfile;
+
+    rdctype::array<FetchCapturedFrame> frames;
   };
   FrameRecord m_FrameRecord;
   vector<FetchDrawcall *> m_Drawcalls;
@@ -216,6 +261,15 @@ private:
   GLPipelineState m_GLPipelineState;
   VulkanPipelineState m_VulkanPipelineState;
 
+  PipelineStateBlob m_D3D11PipelineBlob;
+  PipelineStateBlob m_D3D12PipelineBlob;
+  PipelineStateBlob m_GLPipelineBlob;
+  PipelineStateBlob m_VulkanPipelineBlob;
+  uint32_t m_PipelineStateVersion;
+
+  // cached at init, to know which API's pipeline state to fetch
+  APIProperties m_APIProps;
+
   std::vector<ReplayOutput *> m_Outputs;
 
   std::vector<FetchBuffer> m_Buffers;
@@ -27,6 +27,7 @@
 #include <errno.h>
 #include "3rdparty/lz4/lz4.h"
 #include "common/timing.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "serialise/string_utils.h"
 
@@ -36,10 +37,12 @@
 #pragma warning(disable : 4422)
 #endif
 
-#if ENABLED(RDOC_DEVEL)
-
 int64_t Chunk::m_LiveChunks = 0;
 int64_t Chunk::m_TotalMem = 0;
+int64_t Chunk::m_SpilledMem = 0;
+
+#if ENABLED(RDOC_DEVEL)
+
 int64_t Chunk::m_MaxChunks = 0;
 
 #endif
@@ -53,14 +56,16 @@ struct CompressedFileIO
   // large block size
   static const size_t BlockSize = 64 * 1024;
 
-  CompressedFileIO(FILE *f)
+  CompressedFileIO(FILE *f, vector<byte> *mem = NULL)
   {
     m_F = f;
+    m_Mem = mem;
     LZ4_resetStream(&m_LZ4Comp);
     LZ4_setStreamDecode(&m_LZ4Decomp, NULL, 0);
     m_CompressedSize = m_UncompressedSize = 0;
     m_PageIdx = m_PageOffset = 0;
     m_PageData = 0;
+    m_DecompressTime = 0.0;
 
     m_CompressSize = LZ4_COMPRESSBOUND(BlockSize);
     m_CompressBuf = new byte[m_CompressSize];
@@ -69,6 +74,8 @@ struct CompressedFileIO
   ~CompressedFileIO() { SAFE_DELETE_ARRAY(m_CompressBuf); }
   uint32_t GetCompressedSize() { return m_CompressedSize; }
   uint32_t GetUncompressedSize() { return m_UncompressedSize; }
+  // total time in milliseconds spent decompressing read data, not including the file reads
+  double GetDecompressTime() { return m_DecompressTime; }
   // write out some data - accumulate into the input pages, then
   // when a page is full call Flush() to flush it out to disk
   void Write(const void *data, size_t len)
@@ -122,8 +129,17 @@ struct CompressedFileIO
       return;
     }
 
-    FileIO::fwrite(&compSize, sizeof(compSize), 1, m_F);
-    FileIO::fwrite(m_CompressBuf, 1, compSize, m_F);
+    if(m_Mem)
+    {
+      const byte *sizeBytes = (const byte *)&compSize;
+      m_Mem->insert(m_Mem->end(), sizeBytes, sizeBytes + sizeof(compSize));
+      m_Mem->insert(m_Mem->end(), m_CompressBuf, m_CompressBuf + compSize);
+    }
+    else
+    {
+      FileIO::fwrite(&compSize, sizeof(compSize), 1, m_F);
+      FileIO::fwrite(m_CompressBuf, 1, compSize, m_F);
+    }
 
     m_CompressedSize += compSize + sizeof(int32_t);
 
@@ -186,9 +202,13 @@ struct CompressedFileIO
 
     m_PageIdx = 1 - m_PageIdx;
 
+    PerformanceTimer timer;
+
     int32_t decompSize = LZ4_decompress_safe_continue(
         &m_LZ4Decomp, (const char *)m_CompressBuf, (char *)m_InPages[m_PageIdx], compSize, BlockSize);
 
+    m_DecompressTime += timer.GetMilliseconds();
+
     if(decompSize < 0)
     {
       RDCERR("Error decompressing: %i (%i / %i)", decompSize, int(numRead), compSize);
@@ -228,47 +248,581 @@ struct CompressedFileIO
   LZ4_stream_t m_LZ4Comp;
   LZ4_streamDecode_t m_LZ4Decomp;
   FILE *m_F;
+  vector<byte> *m_Mem;
   uint32_t m_CompressedSize, m_UncompressedSize;
 
   byte m_InPages[2][BlockSize];
   size_t m_PageIdx, m_PageOffset, m_PageData;
 
+  double m_DecompressTime;
+
   byte *m_CompressBuf;
   size_t m_CompressSize;
 };
 
-Chunk::Chunk(Serialiser *ser, uint32_t chunkType, bool temporary)
+// a deduplicated buffer. Blobs are shared between every serialiser in the process, since chunks are
+// created in one serialiser and written to disk by another, and they can outlive both.
+struct SerialisedBlob
 {
-  m_Length = (uint32_t)ser->GetOffset();
+  Serialiser::BlobHash hash;
+  byte *data;
+  uint32_t length;
+  int32_t refcount;
+
+  // spilling, protected by spillLock. A blob is pinned in memory while any serialiser still holds
+  // it pending (its contents may be read back via GetLastBufferData), and otherwise isn't needed
+  // until the capture is written out so it can be spilled like a chunk.
+  int32_t pinned;
+  bool spilled;
+  uint64_t spillQueueID;
+  uint64_t spillOffset;
+};
 
-  RDCASSERT(ser->GetOffset() < 0xffffffff);
+static Threading::CriticalSection blobLock;
+static map<Serialiser::BlobHash, SerialisedBlob *> blobStore;
 
-  m_ChunkType = chunkType;
+// used to indicate a serialised buffer is a reference to a blob, instead of a length
+static const uint32_t BlobReference = 0xffffffff;
 
-  m_Temporary = temporary;
+// blob contents held in memory and spilled, counted alongside chunk data in Chunk::TotalMem() and
+// Chunk::SpilledMem()
+static int64_t blobMem = 0;
+static int64_t spilledBlobMem = 0;
+
+// Capture memory governor. Chunks that are made spillable and unpinned blobs queue up here oldest
+// first, and while memory is over budget the oldest have their data appended to a temporary spill
+// file. The file is only appended to, and is deleted once nothing has data in it any more.
+struct SpillEntry
+{
+  Chunk *chunk;
+  SerialisedBlob *blob;
+};
+
+static Threading::CriticalSection spillLock;
+static map<uint64_t, SpillEntry> spillQueue;
+static uint64_t spillQueueID = 0;
+static FILE *spillFile = NULL;
+static string spillFilename;
+static uint64_t spillFileSize = 0;
+static uint32_t spilledCount = 0;
+static bool spillFailed = false;
+
+// called with spillLock held, appends data to the spill file and returns where it was written
+static bool WriteSpillData(const byte *data, uint32_t length, uint64_t &offset)
+{
+  if(spillFile == NULL)
+  {
+    spillFilename = StringFormat::Fmt("%s_%u.spill", RenderDoc::Inst().GetLogFile(),
+                                      Process::GetCurrentPID());
+
+    FileIO::CreateParentDirectory(spillFilename);
+    spillFile = FileIO::fopen(spillFilename.c_str(), "w+b");
+    spillFileSize = 0;
+
+    if(spillFile == NULL)
+    {
+      RDCERR("Can't open capture spill file '%s' errno %d, captured data will stay in memory",
+             spillFilename.c_str(), errno);
+      spillFailed = true;
+      return false;
+    }
+  }
+
+  FileIO::fseek64(spillFile, spillFileSize, SEEK_SET);
+  if(FileIO::fwrite(data, 1, length, spillFile) != length)
+  {
+    RDCERR("Failed to write %u bytes to capture spill file '%s'", length, spillFilename.c_str());
+    return false;
+  }
+
+  offset = spillFileSize;
+  spillFileSize += length;
+  spilledCount++;
+
+  return true;
+}
+
+// called with spillLock held
+static void ReadSpillData(byte *data, uint32_t length, uint64_t offset)
+{
+  FileIO::fseek64(spillFile, offset, SEEK_SET);
+  size_t numRead = FileIO::fread(data, 1, length, spillFile);
+  RDCASSERT(numRead == length);
+}
+
+// called with spillLock held whenever data leaves the spill file
+static void ReleaseSpilledData()
+{
+  spilledCount--;
+
+  if(spilledCount == 0 && spillFile)
+  {
+    FileIO::fclose(spillFile);
+    FileIO::Delete(spillFilename.c_str());
+    spillFile = NULL;
+    spillFileSize = 0;
+  }
+}
+
+// called with spillLock held
+static bool SpillBlob(SerialisedBlob *blob)
+{
+  if(!WriteSpillData(blob->data, blob->length, blob->spillOffset))
+    return false;
+
+  SAFE_DELETE_ARRAY(blob->data);
+  blob->spilled = true;
+
+  Atomic::ExchAdd64(&blobMem, -int64_t(blob->length));
+  Atomic::ExchAdd64(&spilledBlobMem, int64_t(blob->length));
+
+  return true;
+}
+
+// keeps a blob from being spilled until it's unpinned, optionally bringing its contents back into
+// memory if they're already spilled
+static void PinBlob(SerialisedBlob *blob, bool load)
+{
+  SCOPED_LOCK(spillLock);
+
+  blob->pinned++;
+
+  if(blob->spillQueueID)
+  {
+    spillQueue.erase(blob->spillQueueID);
+    blob->spillQueueID = 0;
+  }
+
+  if(load && blob->spilled)
+  {
+    blob->data = new byte[blob->length];
+    ReadSpillData(blob->data, blob->length, blob->spillOffset);
+    blob->spilled = false;
+
+    Atomic::ExchAdd64(&blobMem, int64_t(blob->length));
+    Atomic::ExchAdd64(&spilledBlobMem, -int64_t(blob->length));
+
+    ReleaseSpilledData();
+  }
+}
+
+static void UnpinBlob(SerialisedBlob *blob)
+{
+  SCOPED_LOCK(spillLock);
+
+  blob->pinned--;
+
+  if(blob->pinned == 0 && !blob->spilled && !spillFailed && Chunk::MemoryBudget() > 0)
+  {
+    blob->spillQueueID = ++spillQueueID;
+    SpillEntry entry = {NULL, blob};
+    spillQueue[blob->spillQueueID] = entry;
+  }
+}
+
+// reads a pinned blob's contents back from the spill file without bringing them back into memory,
+// returns false if the contents aren't spilled
+static bool ReadSpilledBlob(SerialisedBlob *blob, vector<byte> &data)
+{
+  SCOPED_LOCK(spillLock);
+
+  if(!blob->spilled)
+    return false;
+
+  data.resize(blob->length);
+  ReadSpillData(&data[0], blob->length, blob->spillOffset);
+
+  return true;
+}
+
+static uint64_t rotl64(uint64_t x, uint32_t r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t fmix64(uint64_t k)
+{
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+// MurmurHash3 x64 128-bit variant
+static Serialiser::BlobHash HashBlob(const byte *data, size_t len)
+{
+  const uint64_t c1 = 0x87c37b91114253d5ULL;
+  const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+  uint64_t h1 = 0, h2 = 0;
+  uint64_t k1 = 0, k2 = 0;
+
+  const size_t numBlocks = len / 16;
+
+  for(size_t i = 0; i < numBlocks; i++)
+  {
+    memcpy(&k1, data + i * 16, sizeof(uint64_t));
+    memcpy(&k2, data + i * 16 + sizeof(uint64_t), sizeof(uint64_t));
+
+    k1 *= c1;
+    k1 = rotl64(k1, 31);
+    k1 *= c2;
+    h1 ^= k1;
+
+    h1 = rotl64(h1, 27);
+    h1 += h2;
+    h1 = h1 * 5 + 0x52dce729;
+
+    k2 *= c2;
+    k2 = rotl64(k2, 33);
+    k2 *= c1;
+    h2 ^= k2;
+
+    h2 = rotl64(h2, 31);
+    h2 += h1;
+    h2 = h2 * 5 + 0x38495ab5;
+  }
+
+  const byte *tail = data + numBlocks * 16;
+  const size_t tailLen = len & 15;
+
+  k1 = k2 = 0;
+
+  if(tailLen > 8)
+  {
+    for(size_t i = 8; i < tailLen; i++)
+      k2 ^= uint64_t(tail[i]) << ((i - 8) * 8);
+
+    k2 *= c2;
+    k2 = rotl64(k2, 33);
+    k2 *= c1;
+    h2 ^= k2;
+  }
+
+  if(tailLen > 0)
+  {
+    for(size_t i = 0; i < RDCMIN(tailLen, (size_t)8); i++)
+      k1 ^= uint64_t(tail[i]) << (i * 8);
+
+    k1 *= c1;
+    k1 = rotl64(k1, 31);
+    k1 *= c2;
+    h1 ^= k1;
+  }
+
+  h1 ^= (uint64_t)len;
+  h2 ^= (uint64_t)len;
 
-  if(ser->HasAlignedData())
+  h1 += h2;
+  h2 += h1;
+
+  h1 = fmix64(h1);
+  h2 = fmix64(h2);
+
+  h1 += h2;
+  h2 += h1;
+
+  return Serialiser::BlobHash(h1, h2);
+}
+
+// returns a referenced and pinned blob with the given contents, or NULL if the contents can't be
+// stored as a blob and must be serialised inline.
+static SerialisedBlob *AcquireBlob(const byte *data, uint32_t length)
+{
+  Serialiser::BlobHash hash = HashBlob(data, length);
+
+  SerialisedBlob *blob = NULL;
+
+  {
+    SCOPED_LOCK(blobLock);
+
+    auto it = blobStore.find(hash);
+
+    if(it != blobStore.end())
+    {
+      blob = it->second;
+
+      if(blob->length != length)
+        return NULL;
+
+      PinBlob(blob, true);
+
+      // on the off chance of a collision, fall back to storing the contents inline
+      if(memcmp(blob->data, data, length))
+      {
+        UnpinBlob(blob);
+        return NULL;
+      }
+
+      blob->refcount++;
+      return blob;
+    }
+
+    blob = new SerialisedBlob;
+    blob->hash = hash;
+    blob->data = new byte[length];
+    blob->length = length;
+    blob->refcount = 1;
+    blob->pinned = 1;
+    blob->spilled = false;
+    blob->spillQueueID = 0;
+    blob->spillOffset = 0;
+    memcpy(blob->data, data, length);
+
+    blobStore[hash] = blob;
+
+    Atomic::ExchAdd64(&blobMem, int64_t(length));
+  }
+
+  // the new blob can't be spilled yet, but it may push other data over budget
+  Chunk::CheckMemoryBudget();
+
+  return blob;
+}
+
+static void UnpinBlobs(const vector<SerialisedBlob *> &blobs)
+{
+  for(size_t i = 0; i < blobs.size(); i++)
+    UnpinBlob(blobs[i]);
+}
+
+static void AddRefBlobs(const vector<SerialisedBlob *> &blobs)
+{
+  if(blobs.empty())
+    return;
+
+  SCOPED_LOCK(blobLock);
+
+  for(size_t i = 0; i < blobs.size(); i++)
+    blobs[i]->refcount++;
+}
+
+static void ReleaseBlobs(const vector<SerialisedBlob *> &blobs)
+{
+  if(blobs.empty())
+    return;
+
+  SCOPED_LOCK(blobLock);
+
+  for(size_t i = 0; i < blobs.size(); i++)
   {
-    m_Data = Serialiser::AllocAlignedBuffer(m_Length);
-    m_AlignedData = true;
+    SerialisedBlob *blob = blobs[i];
+
+    blob->refcount--;
+
+    if(blob->refcount == 0)
+    {
+      blobStore.erase(blob->hash);
+
+      {
+        SCOPED_LOCK(spillLock);
+
+        if(blob->spillQueueID)
+          spillQueue.erase(blob->spillQueueID);
+
+        if(blob->spilled)
+        {
+          Atomic::ExchAdd64(&spilledBlobMem, -int64_t(blob->length));
+          ReleaseSpilledData();
+        }
+        else
+        {
+          Atomic::ExchAdd64(&blobMem, -int64_t(blob->length));
+        }
+      }
+
+      SAFE_DELETE_ARRAY(blob->data);
+      SAFE_DELETE(blob);
+    }
   }
+}
+
+static byte *AllocChunkData(uint32_t length, bool aligned)
+{
+  if(aligned)
+    return Serialiser::AllocAlignedBuffer(length);
+
+  return new byte[length];
+}
+
+static void FreeChunkData(byte *data, bool aligned)
+{
+  if(data == NULL)
+    return;
+
+  if(aligned)
+    Serialiser::FreeAlignedBuffer(data);
   else
+    delete[] data;
+}
+
+uint64_t Chunk::MemoryBudget()
+{
+  return uint64_t(RenderDoc::Inst().GetCaptureOptions().CaptureMemoryBudgetMB) * 1024 * 1024;
+}
+
+uint64_t Chunk::TotalMem()
+{
+  return uint64_t(m_TotalMem + blobMem);
+}
+
+uint64_t Chunk::SpilledMem()
+{
+  return uint64_t(m_SpilledMem + spilledBlobMem);
+}
+
+void Chunk::MakeSpillable()
+{
+  // without a budget nothing is ever spilled, so there's no need to track the chunk
+  if(MemoryBudget() == 0 || m_Spillable || spillFailed)
+    return;
+
   {
-    m_Data = new byte[m_Length];
-    m_AlignedData = false;
+    SCOPED_LOCK(spillLock);
+
+    m_Spillable = true;
+    m_SpillQueueID = ++spillQueueID;
+    SpillEntry entry = {this, NULL};
+    spillQueue[m_SpillQueueID] = entry;
   }
 
+  CheckMemoryBudget();
+}
+
+void Chunk::CheckMemoryBudget()
+{
+  uint64_t budget = MemoryBudget();
+
+  if(budget == 0 || spillFailed || TotalMem() <= budget)
+    return;
+
+  SCOPED_LOCK(spillLock);
+
+  while(TotalMem() > budget && !spillQueue.empty())
+  {
+    SpillEntry entry = spillQueue.begin()->second;
+    spillQueue.erase(spillQueue.begin());
+
+    if(entry.chunk)
+    {
+      entry.chunk->m_SpillQueueID = 0;
+
+      if(!entry.chunk->Spill())
+        break;
+    }
+    else
+    {
+      entry.blob->spillQueueID = 0;
+
+      if(!SpillBlob(entry.blob))
+        break;
+    }
+  }
+}
+
+// called with spillLock held
+bool Chunk::Spill()
+{
+  if(!WriteSpillData(m_Data, m_Length, m_SpillOffset))
+    return false;
+
+  FreeChunkData(m_Data, m_AlignedData);
+  m_Data = NULL;
+  m_Spilled = true;
+
+  Atomic::ExchAdd64(&m_TotalMem, -int64_t(m_Length));
+  Atomic::ExchAdd64(&m_SpilledMem, int64_t(m_Length));
+
+  return true;
+}
+
+byte *Chunk::GetData()
+{
+  // the data of chunks that can't spill never moves, so there's no need to lock
+  if(!m_Spillable)
+    return m_Data;
+
+  SCOPED_LOCK(spillLock);
+
+  // once the data has been asked for, it stays in memory
+  if(m_SpillQueueID)
+  {
+    spillQueue.erase(m_SpillQueueID);
+    m_SpillQueueID = 0;
+  }
+
+  if(m_Spilled)
+  {
+    m_Data = AllocChunkData(m_Length, m_AlignedData);
+
+    ReadSpillData(m_Data, m_Length, m_SpillOffset);
+
+    m_Spilled = false;
+
+    Atomic::ExchAdd64(&m_TotalMem, int64_t(m_Length));
+    Atomic::ExchAdd64(&m_SpilledMem, -int64_t(m_Length));
+
+    ReleaseSpilledData();
+  }
+
+  return m_Data;
+}
+
+// reads the chunk's data back from the spill file without bringing it back into memory, returns
+// false if the data isn't spilled
+bool Chunk::ReadSpilledData(vector<byte> &data)
+{
+  if(!m_Spillable)
+    return false;
+
+  SCOPED_LOCK(spillLock);
+
+  if(!m_Spilled)
+    return false;
+
+  data.resize(m_Length);
+
+  ReadSpillData(&data[0], m_Length, m_SpillOffset);
+
+  return true;
+}
+
+Chunk::Chunk(Serialiser *ser, uint32_t chunkType, bool temporary)
+{
+  m_Length = (uint32_t)ser->GetOffset();
+
+  RDCASSERT(ser->GetOffset() < 0xffffffff);
+
+  m_ChunkType = chunkType;
+
+  m_Temporary = temporary;
+
+  m_Spillable = false;
+  m_Spilled = false;
+  m_SpillQueueID = 0;
+  m_SpillOffset = 0;
+
+  m_AlignedData = ser->HasAlignedData();
+  m_Data = AllocChunkData(m_Length, m_AlignedData);
+
   memcpy(m_Data, ser->GetRawPtr(0), m_Length);
 
   if(ser->GetDebugText())
     m_DebugStr = ser->GetDebugStr();
 
+  // take over the serialiser's references to any blobs in our data. Nothing reads them back until
+  // the capture is written out, so they can be spilled from now on
+  m_Blobs.swap(ser->m_PendingBlobs);
+  UnpinBlobs(m_Blobs);
+
   ser->Rewind();
 
-#if ENABLED(RDOC_DEVEL)
   int64_t newval = Atomic::Inc64(&m_LiveChunks);
   Atomic::ExchAdd64(&m_TotalMem, m_Length);
 
+#if ENABLED(RDOC_DEVEL)
   if(newval > m_MaxChunks)
   {
     int breakpointme = 0;
@@ -276,7 +830,12 @@ Chunk::Chunk(Serialiser *ser, uint32_t chunkType, bool temporary)
   }
 
   m_MaxChunks = RDCMAX(newval, m_MaxChunks);
+#else
+  (void)newval;
 #endif
+
+  // chunks that aren't spillable still count against the budget
+  CheckMemoryBudget();
 }
 
 Chunk *Chunk::Duplicate()
@@ -288,17 +847,17 @@ Chunk *Chunk::Duplicate()
   ret->m_Temporary = m_Temporary;
   ret->m_AlignedData = m_AlignedData;
 
-  if(m_AlignedData)
-    ret->m_Data = Serialiser::AllocAlignedBuffer(m_Length);
-  else
-    ret->m_Data = new byte[m_Length];
+  ret->m_Data = AllocChunkData(m_Length, m_AlignedData);
 
-  memcpy(ret->m_Data, m_Data, m_Length);
+  memcpy(ret->m_Data, GetData(), m_Length);
+
+  ret->m_Blobs = m_Blobs;
+  AddRefBlobs(ret->m_Blobs);
 
-#if ENABLED(RDOC_DEVEL)
   int64_t newval = Atomic::Inc64(&m_LiveChunks);
   Atomic::ExchAdd64(&m_TotalMem, m_Length);
 
+#if ENABLED(RDOC_DEVEL)
   if(newval > m_MaxChunks)
   {
     int breakpointme = 0;
@@ -306,29 +865,45 @@ Chunk *Chunk::Duplicate()
   }
 
   m_MaxChunks = RDCMAX(newval, m_MaxChunks);
+#else
+  (void)newval;
 #endif
 
+  CheckMemoryBudget();
+
   return ret;
 }
 
 Chunk::~Chunk()
 {
-#if ENABLED(RDOC_DEVEL)
   Atomic::Dec64(&m_LiveChunks);
-  Atomic::ExchAdd64(&m_TotalMem, -int64_t(m_Length));
-#endif
 
-  if(m_AlignedData)
+  if(m_Spillable)
   {
-    if(m_Data)
-      Serialiser::FreeAlignedBuffer(m_Data);
+    SCOPED_LOCK(spillLock);
 
-    m_Data = NULL;
+    if(m_SpillQueueID)
+      spillQueue.erase(m_SpillQueueID);
+
+    if(m_Spilled)
+    {
+      Atomic::ExchAdd64(&m_SpilledMem, -int64_t(m_Length));
+      ReleaseSpilledData();
+    }
+    else
+    {
+      Atomic::ExchAdd64(&m_TotalMem, -int64_t(m_Length));
+    }
   }
   else
   {
-    SAFE_DELETE_ARRAY(m_Data);
+    Atomic::ExchAdd64(&m_TotalMem, -int64_t(m_Length));
   }
+
+  FreeChunkData(m_Data, m_AlignedData);
+  m_Data = NULL;
+
+  ReleaseBlobs(m_Blobs);
 }
 
 /*
@@ -399,6 +974,27 @@ Chunk::~Chunk()
  // binary form
  Section sections[];
 
+ -----------------------------
+ File format for version 0x33:
+
+ Identical to 0x32, except that any buffer in the frame capture data can be stored as a reference
+ to a deduplicated blob:
+
+ uint32_t marker = 0xffffffff;
+ uint32_t length;
+ uint64_t hash[2];
+
+ instead of a length, padding and the inline contents. The blobs are stored in an LZ4 compressed
+ section of type eSectionType_Blobs:
+
+ uint64_t count;
+ Blob
+ {
+   uint64_t hash[2];
+   uint64_t length;
+   byte data[length];
+ } blobs[count];
+
 */
 
 struct FileHeader
@@ -437,7 +1033,7 @@ struct BinarySectionHeader
   }
 
 Serialiser::Serialiser(size_t length, const byte *memoryBuf, bool fileheader)
-    : m_pCallstack(NULL), m_pResolver(NULL), m_Buffer(NULL)
+    : m_pCallstack(NULL), m_pResolver(NULL), m_Buffer(NULL), m_MemoryDest(NULL)
 {
   m_ResolverThread = 0;
 
@@ -533,7 +1129,7 @@ Serialiser::Serialiser(size_t length, const byte *memoryBuf, bool fileheader)
     m_Sections.push_back(frameCap);
     m_KnownSections[eSectionType_FrameCapture] = frameCap;
   }
-  else if(header->version == SERIALISE_VERSION)
+  else if(header->version == 0x00000032 || header->version == SERIALISE_VERSION)
   {
     memoryBuf += sizeof(FileHeader);
 
@@ -635,7 +1231,7 @@ Serialiser::Serialiser(size_t length, const byte *memoryBuf, bool fileheader)
 }
 
 Serialiser::Serialiser(const char *path, Mode mode, bool debugMode)
-    : m_pCallstack(NULL), m_pResolver(NULL), m_Buffer(NULL)
+    : m_pCallstack(NULL), m_pResolver(NULL), m_Buffer(NULL), m_MemoryDest(NULL)
 {
   m_ResolverThread = 0;
 
@@ -742,7 +1338,7 @@ Serialiser::Serialiser(const char *path, Mode mode, bool debugMode)
       m_Sections.push_back(frameCap);
       m_KnownSections[eSectionType_FrameCapture] = frameCap;
     }
-    else if(header.version == SERIALISE_VERSION)
+    else if(header.version == 0x00000032 || header.version == SERIALISE_VERSION)
     {
       while(!FileIO::feof(m_ReadFileHandle))
       {
@@ -870,9 +1466,26 @@ Serialiser::Serialiser(const char *path, Mode mode, bool debugMode)
             m_KnownSections[sect->type] = sect;
           m_Sections.push_back(sect);
 
+          // blobs can be referenced from anywhere in the frame capture, so decompress them all
+          // now and keep them resident
+          if(sect->type == eSectionType_Blobs)
+          {
+            sect->data.resize((size_t)sect->size);
+
+            if(sect->size > 0)
+            {
+              if(sect->compressedReader)
+                sect->compressedReader->Read(&sect->data[0], (size_t)sect->size);
+              else
+                FileIO::fread(&sect->data[0], 1, (size_t)sect->size, m_ReadFileHandle);
+            }
+
+            LoadBlobs(sect->data);
+          }
           // if section isn't frame capture data and is small enough, read it all into memory now,
           // otherwise skip
-          if(sect->type != eSectionType_FrameCapture && sectionHeader.sectionLength < 4 * 1024 * 1024)
+          else if(sect->type != eSectionType_FrameCapture &&
+                  sectionHeader.sectionLength < 4 * 1024 * 1024)
           {
             sect->data.resize(sectionHeader.sectionLength);
             FileIO::fread(&sect->data[0], 1, sectionHeader.sectionLength, m_ReadFileHandle);
@@ -978,9 +1591,18 @@ void Serialiser::Reset()
 
   m_AlignedData = false;
 
+  m_BlobStorage = false;
+  m_InlineNextBuffer = false;
+  m_LastBufferData = NULL;
+  m_ElementMarks = NULL;
+  ReleasePendingBlobs();
+  m_BlobLookup.clear();
+
   m_ReadFileHandle = NULL;
 
   m_ReadOffset = 0;
+  m_FileReadTime = 0.0;
+  m_DecompressTime = 0.0;
 
   m_BufferHead = m_Buffer = NULL;
   m_CurrentBufferSize = 0;
@@ -1017,6 +1639,8 @@ Serialiser::~Serialiser()
 
   m_Chunks.clear();
 
+  ReleasePendingBlobs();
+
   SAFE_DELETE(m_pResolver);
   SAFE_DELETE(m_pCallstack);
   if(m_Buffer)
@@ -1028,6 +1652,78 @@ Serialiser::~Serialiser()
   m_BufferHead = NULL;
 }
 
+void Serialiser::ReleasePendingBlobs()
+{
+  UnpinBlobs(m_PendingBlobs);
+  ReleaseBlobs(m_PendingBlobs);
+  m_PendingBlobs.clear();
+}
+
+void Serialiser::LoadBlobs(const vector<byte> &data)
+{
+  const byte *cur = data.empty() ? NULL : &data[0];
+  const byte *end = cur + data.size();
+
+  uint64_t count = 0;
+
+  if(end - cur >= (ptrdiff_t)sizeof(count))
+  {
+    memcpy(&count, cur, sizeof(count));
+    cur += sizeof(count);
+  }
+
+  for(uint64_t i = 0; i < count; i++)
+  {
+    uint64_t header[3];    // hash[2], length
+
+    if(end - cur < (ptrdiff_t)sizeof(header))
+    {
+      RDCERR("Truncated blob section, only %llu of %llu blobs found", i, count);
+      return;
+    }
+
+    memcpy(header, cur, sizeof(header));
+    cur += sizeof(header);
+
+    if(uint64_t(end - cur) < header[2])
+    {
+      RDCERR("Truncated blob section, only %llu of %llu blobs found", i, count);
+      return;
+    }
+
+    m_BlobLookup[BlobHash(header[0], header[1])] = std::make_pair(cur, header[2]);
+    cur += header[2];
+  }
+}
+
+bool Serialiser::ReadBlob(BlobHash hash, uint32_t length, byte *dest)
+{
+  auto it = m_BlobLookup.find(hash);
+
+  if(it != m_BlobLookup.end())
+  {
+    if(it->second.second != length)
+      return false;
+
+    memcpy(dest, it->second.first, length);
+    return true;
+  }
+
+  // chunks that were never written to disk can still be read back while the blob is alive
+  SCOPED_LOCK(blobLock);
+
+  auto blob = blobStore.find(hash);
+
+  if(blob == blobStore.end() || blob->second->length != length)
+    return false;
+
+  PinBlob(blob->second, true);
+  memcpy(dest, blob->second->data, length);
+  UnpinBlob(blob->second);
+
+  return true;
+}
+
 void Serialiser::WriteBytes(const byte *buf, size_t nBytes)
 {
   if(m_HasError)
@@ -1134,15 +1830,24 @@ void Serialiser::ReadFromFile(uint64_t bufferOffs, size_t length)
 
   RDCASSERT(s);
 
+  PerformanceTimer timer;
+
+  double decompressTime = 0.0;
+
   if(s->flags & eSectionFlag_LZ4Compressed)
   {
     RDCASSERT(s->compressedReader);
+    decompressTime = s->compressedReader->GetDecompressTime();
     s->compressedReader->Read(m_Buffer + bufferOffs, length);
+    decompressTime = s->compressedReader->GetDecompressTime() - decompressTime;
   }
   else
   {
     FileIO::fread(m_Buffer + bufferOffs, 1, length, m_ReadFileHandle);
   }
+
+  m_DecompressTime += decompressTime;
+  m_FileReadTime += timer.GetMilliseconds() - decompressTime;
 }
 
 byte *Serialiser::AllocAlignedBuffer(size_t size, size_t alignment)
@@ -1310,15 +2015,48 @@ void Serialiser::CreateResolver(void *ths)
                                              &ser->m_ResolverThreadKillSignal);
 }
 
+// the destination of a capture being written out, either a file or a memory buffer
+struct CaptureWriter
+{
+  FILE *file;
+  vector<byte> *mem;
+
+  void Write(const void *data, size_t len)
+  {
+    if(mem)
+      mem->insert(mem->end(), (const byte *)data, (const byte *)data + len);
+    else
+      FileIO::fwrite(data, 1, len, file);
+  }
+
+  uint64_t Tell() { return mem ? mem->size() : FileIO::ftell64(file); }
+  // overwrite previously written data, leaving the write position at the end
+  void Patch(uint64_t offs, const void *data, size_t len)
+  {
+    if(mem)
+    {
+      memcpy(&(*mem)[(size_t)offs], data, len);
+    }
+    else
+    {
+      uint64_t curoffs = FileIO::ftell64(file);
+      FileIO::fseek64(file, offs, SEEK_SET);
+      FileIO::fwrite(data, 1, len, file);
+      FileIO::fseek64(file, curoffs, SEEK_SET);
+    }
+  }
+};
+
 void Serialiser::FlushToDisk()
 {
+  RDCTRACE_ZONE("Serialiser::FlushToDisk");
   SCOPED_TIMER("File writing");
 
-  if(m_Filename != "" && !m_HasError && m_Mode == WRITING)
+  if((m_Filename != "" || m_MemoryDest) && !m_HasError && m_Mode == WRITING)
   {
     RDCDEBUG("writing capture files");
 
-    if(m_DebugEnabled && !m_DebugText.empty())
+    if(m_DebugEnabled && !m_DebugText.empty() && m_MemoryDest == NULL)
     {
       FILE *dbgFile = FileIO::fopen((m_Filename + ".txt").c_str(), "wb");
 
@@ -1346,22 +2084,33 @@ void Serialiser::FlushToDisk()
       }
     }
 
-    FILE *binFile = FileIO::fopen(m_Filename.c_str(), "w+b");
+    FILE *binFile = NULL;
 
-    if(!binFile)
+    if(m_MemoryDest)
     {
-      RDCERR("Can't open capture file '%s' for write, errno %d", m_Filename.c_str(), errno);
-      m_ErrorCode = eSerError_FileIO;
-      m_HasError = true;
-      return;
+      m_MemoryDest->clear();
     }
+    else
+    {
+      binFile = FileIO::fopen(m_Filename.c_str(), "w+b");
 
-    RDCDEBUG("Opened capture file for write");
+      if(!binFile)
+      {
+        RDCERR("Can't open capture file '%s' for write, errno %d", m_Filename.c_str(), errno);
+        m_ErrorCode = eSerError_FileIO;
+        m_HasError = true;
+        return;
+      }
+
+      RDCDEBUG("Opened capture file for write");
+    }
+
+    CaptureWriter out = {binFile, m_MemoryDest};
 
     FileHeader header;    // automagically initialised with correct data
 
     // write header
-    FileIO::fwrite(&header, 1, sizeof(FileHeader), binFile);
+    out.Write(&header, sizeof(FileHeader));
 
     static const byte padding[BufferAlignment] = {0};
 
@@ -1380,23 +2129,39 @@ void Serialiser::FlushToDisk()
       section.sectionLength =
           0;    // will be fixed up later, to avoid having to compress everything into memory
 
-      compressedSizeOffset = FileIO::ftell64(binFile) + offsetof(BinarySectionHeader, sectionLength);
+      compressedSizeOffset = out.Tell() + offsetof(BinarySectionHeader, sectionLength);
 
-      FileIO::fwrite(&section, 1, offsetof(BinarySectionHeader, name), binFile);
-      FileIO::fwrite(sectionName, 1, sizeof(sectionName), binFile);
+      out.Write(&section, offsetof(BinarySectionHeader, name));
+      out.Write(sectionName, sizeof(sectionName));
 
       uint64_t len = 0;    // will be fixed up later
-      uncompressedSizeOffset = FileIO::ftell64(binFile);
-      FileIO::fwrite(&len, 1, sizeof(uint64_t), binFile);
+      uncompressedSizeOffset = out.Tell();
+      out.Write(&len, sizeof(uint64_t));
+    }
+
+    // gather the blobs referenced by the chunks and keep them alive, since temporary chunks are
+    // deleted as they're written
+    vector<SerialisedBlob *> blobs;
+    {
+      set<SerialisedBlob *> uniqueBlobs;
+      for(size_t i = 0; i < m_Chunks.size(); i++)
+        uniqueBlobs.insert(m_Chunks[i]->m_Blobs.begin(), m_Chunks[i]->m_Blobs.end());
+
+      blobs.assign(uniqueBlobs.begin(), uniqueBlobs.end());
+      AddRefBlobs(blobs);
     }
 
-    CompressedFileIO fwriter(binFile);
+    CompressedFileIO fwriter(binFile, m_MemoryDest);
 
     // track offset so we can add padding. The padding is relative
     // to the start of the decompressed buffer, so we start it from 0
     uint64_t offs = 0;
     uint64_t alignedoffs = 0;
 
+    // chunks that were spilled during capture are streamed back from the spill file through here,
+    // rather than all being brought back into memory at once
+    vector<byte> spilledData;
+
     // write frame capture contents
     for(size_t i = 0; i < m_Chunks.size(); i++)
     {
@@ -1434,7 +2199,10 @@ void Serialiser::FlushToDisk()
         }
       }
 
-      fwriter.Write(chunk->GetData(), chunk->GetLength());
+      if(chunk->ReadSpilledData(spilledData))
+        fwriter.Write(&spilledData[0], chunk->GetLength());
+      else
+        fwriter.Write(chunk->GetData(), chunk->GetLength());
 
       offs += chunk->GetLength();
 
@@ -1448,25 +2216,80 @@ void Serialiser::FlushToDisk()
 
     // fixup section size
     {
-      uint32_t compsize = 0;
-      uint64_t uncompsize = 0;
+      uint32_t compsize = fwriter.GetCompressedSize();
+      out.Patch(compressedSizeOffset, &compsize, sizeof(compsize));
 
-      uint64_t curoffs = FileIO::ftell64(binFile);
+      uint64_t uncompsize = fwriter.GetUncompressedSize();
+      out.Patch(uncompressedSizeOffset, &uncompsize, sizeof(uncompsize));
 
-      FileIO::fseek64(binFile, compressedSizeOffset, SEEK_SET);
+      RDCLOG("Compressed frame capture data from %u to %u", fwriter.GetUncompressedSize(),
+             fwriter.GetCompressedSize());
+    }
 
-      compsize = fwriter.GetCompressedSize();
-      FileIO::fwrite(&compsize, 1, sizeof(compsize), binFile);
+    // write deduplicated blob section
+    if(!blobs.empty())
+    {
+      const char sectionName[] = "renderdoc/internal/blobs";
 
-      FileIO::fseek64(binFile, uncompressedSizeOffset, SEEK_SET);
+      BinarySectionHeader section = {0};
+      section.isASCII = 0;                                // redundant but explicit
+      section.sectionNameLength = sizeof(sectionName);    // includes null terminator
+      section.sectionType = eSectionType_Blobs;
+      section.sectionFlags = eSectionFlag_LZ4Compressed;
+      section.sectionLength = 0;    // will be fixed up below
 
-      uncompsize = fwriter.GetUncompressedSize();
-      FileIO::fwrite(&uncompsize, 1, sizeof(uncompsize), binFile);
+      compressedSizeOffset = out.Tell() + offsetof(BinarySectionHeader, sectionLength);
 
-      FileIO::fseek64(binFile, curoffs, SEEK_SET);
+      out.Write(&section, offsetof(BinarySectionHeader, name));
+      out.Write(sectionName, sizeof(sectionName));
 
-      RDCLOG("Compressed frame capture data from %u to %u", fwriter.GetUncompressedSize(),
-             fwriter.GetCompressedSize());
+      uint64_t len = 0;    // will be fixed up below
+      uncompressedSizeOffset = out.Tell();
+      out.Write(&len, sizeof(uint64_t));
+
+      // allocated rather than on the stack alongside fwriter, they aren't small
+      CompressedFileIO *bwriter = new CompressedFileIO(binFile, m_MemoryDest);
+
+      uint64_t count = blobs.size();
+      bwriter->Write(&count, sizeof(count));
+
+      uint64_t blobBytes = 0;
+
+      // as with chunks, spilled blobs are streamed back from the spill file
+      vector<byte> spilledBlob;
+
+      for(size_t i = 0; i < blobs.size(); i++)
+      {
+        uint64_t header[3] = {blobs[i]->hash.first, blobs[i]->hash.second, blobs[i]->length};
+
+        bwriter->Write(header, sizeof(header));
+
+        PinBlob(blobs[i], false);
+
+        if(ReadSpilledBlob(blobs[i], spilledBlob))
+          bwriter->Write(&spilledBlob[0], blobs[i]->length);
+        else
+          bwriter->Write(blobs[i]->data, blobs[i]->length);
+
+        UnpinBlob(blobs[i]);
+
+        blobBytes += blobs[i]->length;
+      }
+
+      bwriter->Flush();
+
+      uint32_t compsize = bwriter->GetCompressedSize();
+      out.Patch(compressedSizeOffset, &compsize, sizeof(compsize));
+
+      uint64_t uncompsize = bwriter->GetUncompressedSize();
+      out.Patch(uncompressedSizeOffset, &uncompsize, sizeof(uncompsize));
+
+      RDCLOG("Wrote %llu deduplicated blobs, %llu bytes compressed to %u", count, blobBytes,
+             compsize);
+
+      SAFE_DELETE(bwriter);
+
+      ReleaseBlobs(blobs);
     }
 
     char *symbolDB = NULL;
@@ -1495,11 +2318,11 @@ void Serialiser::FlushToDisk()
       section.sectionType = eSectionType_ResolveDatabase;
       section.sectionLength = (uint32_t)symbolDBSize;
 
-      FileIO::fwrite(&section, 1, offsetof(BinarySectionHeader, name), binFile);
-      FileIO::fwrite(sectionName, 1, sizeof(sectionName), binFile);
+      out.Write(&section, offsetof(BinarySectionHeader, name));
+      out.Write(sectionName, sizeof(sectionName));
 
       // write actual data
-      FileIO::fwrite(symbolDB, 1, symbolDBSize, binFile);
+      out.Write(symbolDB, symbolDBSize);
 
       SAFE_DELETE_ARRAY(symbolDB);
     }
@@ -1517,12 +2340,13 @@ void Serialiser::FlushToDisk()
       section.sectionFlags = eSectionFlag_None;
       section.sectionLength = sizeof(machineID);
 
-      FileIO::fwrite(&section, 1, offsetof(BinarySectionHeader, name), binFile);
-      FileIO::fwrite(sectionName, 1, sizeof(sectionName), binFile);
-      FileIO::fwrite(&machineID, 1, sizeof(machineID), binFile);
+      out.Write(&section, offsetof(BinarySectionHeader, name));
+      out.Write(sectionName, sizeof(sectionName));
+      out.Write(&machineID, sizeof(machineID));
     }
 
-    FileIO::fclose(binFile);
+    if(binFile)
+      FileIO::fclose(binFile);
   }
 }
 
@@ -1869,44 +2693,90 @@ void Serialiser::SerialiseBuffer(const char *name, byte *&buf, size_t &len)
 {
   uint32_t bufLen = (uint32_t)len;
 
+  bool allowBlob = !m_InlineNextBuffer;
+  m_InlineNextBuffer = false;
+
   if(m_Mode >= WRITING)
   {
-    WriteFrom(bufLen);
+    SerialisedBlob *blob = NULL;
 
-    // ensure byte alignment
-    uint64_t offs = GetOffset();
-    uint64_t alignedoffs = AlignUp(offs, BufferAlignment);
+    if(m_BlobStorage && allowBlob && bufLen >= BlobThreshold && bufLen != BlobReference)
+      blob = AcquireBlob(buf, bufLen);
 
-    if(offs != alignedoffs)
+    if(blob)
     {
-      static const byte padding[BufferAlignment] = {0};
-      WriteBytes(&padding[0], (size_t)(alignedoffs - offs));
+      // the contents are stored once in the blob section, only reference them here
+      WriteFrom(BlobReference);
+      WriteFrom(bufLen);
+      WriteFrom(blob->hash.first);
+      WriteFrom(blob->hash.second);
+
+      m_PendingBlobs.push_back(blob);
+
+      m_LastBufferData = blob->data;
     }
+    else
+    {
+      WriteFrom(bufLen);
 
-    RDCASSERT((GetOffset() % BufferAlignment) == 0);
+      // ensure byte alignment
+      uint64_t offs = GetOffset();
+      uint64_t alignedoffs = AlignUp(offs, BufferAlignment);
 
-    WriteBytes(buf, bufLen);
+      if(offs != alignedoffs)
+      {
+        static const byte padding[BufferAlignment] = {0};
+        WriteBytes(&padding[0], (size_t)(alignedoffs - offs));
+      }
+
+      RDCASSERT((GetOffset() % BufferAlignment) == 0);
 
-    m_AlignedData = true;
+      WriteBytes(buf, bufLen);
+
+      m_AlignedData = true;
+
+      m_LastBufferData = m_BufferHead - bufLen;
+    }
   }
   else
   {
     ReadInto(bufLen);
 
-    // ensure byte alignment
-    uint64_t offs = GetOffset();
+    if(m_SerVer >= 0x00000033 && bufLen == BlobReference)
+    {
+      uint64_t hash[2] = {0};
 
-    // serialise version 0x00000031 had only 16-byte alignment
-    uint64_t alignedoffs = AlignUp(offs, m_SerVer == 0x00000031 ? 16 : BufferAlignment);
+      ReadInto(bufLen);
+      ReadInto(hash[0]);
+      ReadInto(hash[1]);
 
-    if(offs != alignedoffs)
-    {
-      ReadBytes((size_t)(alignedoffs - offs));
+      // callers own the returned buffer, so the contents are still copied out of the blob
+      if(buf == NULL)
+        buf = new byte[bufLen];
+
+      if(!ReadBlob(BlobHash(hash[0], hash[1]), bufLen, buf))
+      {
+        RDCERR("Missing deduplicated blob %016llx%016llx of %u bytes", hash[0], hash[1], bufLen);
+        memset(buf, 0, bufLen);
+      }
     }
+    else
+    {
+      // ensure byte alignment
+      uint64_t offs = GetOffset();
+
+      // serialise version 0x00000031 had only 16-byte alignment
+      uint64_t alignedoffs = AlignUp(offs, m_SerVer == 0x00000031 ? 16 : BufferAlignment);
+
+      if(offs != alignedoffs)
+      {
+        ReadBytes((size_t)(alignedoffs - offs));
+      }
 
-    if(buf == NULL)
-      buf = new byte[bufLen];
-    memcpy(buf, ReadBytes(bufLen), bufLen);
+      if(buf == NULL)
+        buf = new byte[bufLen];
+      memcpy(buf, ReadBytes(bufLen), bufLen);
+    }
   }
 
   len = (size_t)bufLen;
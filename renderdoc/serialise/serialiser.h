@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <list>
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -91,24 +92,33 @@ struct CompressedFileIO;
 
 // holds the memory, length and type for a given chunk, so that it can be
 // passed around and moved between owners before being serialised out
+struct SerialisedBlob;
+
 class Chunk
 {
 public:
   ~Chunk();
 
   const char *GetDebugString() { return m_DebugStr.c_str(); }
-  byte *GetData() { return m_Data; }
+  byte *GetData();
   uint32_t GetLength() { return m_Length; }
   uint32_t GetChunkType() { return m_ChunkType; }
   bool IsAligned() { return m_AlignedData; }
   bool IsTemporary() { return m_Temporary; }
-#if ENABLED(RDOC_DEVEL)
   static uint64_t NumLiveChunks() { return m_LiveChunks; }
-  static uint64_t TotalMem() { return m_TotalMem; }
-#else
-  static uint64_t NumLiveChunks() { return 0; }
-  static uint64_t TotalMem() { return 0; }
-#endif
+  // chunk and deduplicated blob data held in memory, not counting anything spilled to disk
+  static uint64_t TotalMem();
+  static uint64_t SpilledMem();
+  // the budget that spillable data is held to, from eRENDERDOC_Option_CaptureMemoryBudgetMB
+  static uint64_t MemoryBudget();
+  // spills the oldest spillable chunks and blobs while memory is over budget
+  static void CheckMemoryBudget();
+
+  // allows this chunk's data to be moved out to a temporary file whenever chunk memory is over
+  // budget. Only call this from the chunk's owner, on chunks that won't be read again until the
+  // capture is written out. If the data is needed after all GetData() reads it back in, and the
+  // chunk then stays in memory.
+  void MakeSpillable();
 
   // grab current contents of the serialiser into this chunk
   Chunk(Serialiser *ser, uint32_t chunkType, bool temp);
@@ -116,12 +126,13 @@ public:
   Chunk *Duplicate();
 
 private:
-  Chunk() {}
+  Chunk() : m_Spillable(false), m_Spilled(false), m_SpillQueueID(0), m_SpillOffset(0) {}
   // no copy semantics
   Chunk(const Chunk &);
   Chunk &operator=(const Chunk &);
 
   friend class ScopedContext;
+  friend class Serialiser;
 
   bool m_AlignedData;
   bool m_Temporary;
@@ -132,8 +143,22 @@ private:
   byte *m_Data;
   string m_DebugStr;
 
+  // deduplicated buffers referenced from m_Data, see Serialiser::SetBlobStorage
+  vector<SerialisedBlob *> m_Blobs;
+
+  // spilling, see MakeSpillable. m_SpillQueueID is non-zero while the chunk is waiting to be
+  // spilled, and m_Data is NULL while it is spilled at m_SpillOffset in the spill file.
+  bool m_Spillable;
+  bool m_Spilled;
+  uint64_t m_SpillQueueID;
+  uint64_t m_SpillOffset;
+
+  bool Spill();
+  bool ReadSpilledData(vector<byte> &data);
+
+  static int64_t m_LiveChunks, m_TotalMem, m_SpilledMem;
 #if ENABLED(RDOC_DEVEL)
-  static int64_t m_LiveChunks, m_MaxChunks, m_TotalMem;
+  static int64_t m_MaxChunks;
 #endif
 };
 
@@ -186,15 +211,22 @@ public:
     eSectionType_MachineID,          // renderdoc/internal/machineid
     eSectionType_FrameBookmarks,     // renderdoc/ui/bookmarks
     eSectionType_Notes,              // renderdoc/ui/notes
+    eSectionType_Blobs,              // renderdoc/internal/blobs
     eSectionType_Num,
   };
 
   // version number of overall file format or chunk organisation. If the contents/meaning/order of
   // chunks have changed this does not need to be bumped, there are version numbers within each
   // API that interprets the stream that can be bumped.
-  static const uint64_t SERIALISE_VERSION = 0x00000032;
+  static const uint64_t SERIALISE_VERSION = 0x00000033;
   static const uint32_t MAGIC_HEADER;
 
+  // content hash identifying a deduplicated buffer
+  typedef std::pair<uint64_t, uint64_t> BlobHash;
+
+  // buffers at least this large are candidates for deduplication
+  static const size_t BlobThreshold = 4 * 1024;
+
   //////////////////////////////////////////
   // Init and error handling
 
@@ -209,6 +241,9 @@ public:
 
   void *GetUserData() { return m_pUserData; }
   void SetUserData(void *userData) { m_pUserData = userData; }
+  // while writing, records the offset at the start and end of every rdctype::array and of each
+  // element in it, so serialised structures can be compared element by element.
+  void SetElementMarks(vector<uint64_t> *marks) { m_ElementMarks = marks; }
   bool AtEnd() { return GetOffset() >= m_BufferSize; }
   bool HasAlignedData() { return m_AlignedData; }
   bool IsReading() const { return m_Mode == READING; }
@@ -241,6 +276,10 @@ public:
     return 0;
   }
 
+  // total time in milliseconds spent reading from the file, and decompressing what was read
+  double GetFileReadTime() const { return m_FileReadTime; }
+  double GetDecompressTime() const { return m_DecompressTime; }
+
   byte *GetRawPtr(size_t offs) const { return m_Buffer + offs; }
   // Set up the base pointer and size. Serialiser will allocate enough for
   // the rest of the file and keep it all in memory (useful to keep everything
@@ -254,9 +293,21 @@ public:
     m_DebugText = "";
     m_Indent = 0;
     m_AlignedData = false;
+    ReleasePendingBlobs();
     SetOffset(0);
   }
 
+  // when enabled, large buffers are hashed and stored once per capture in a separate blob section,
+  // with chunks only holding a reference. This is only valid for serialisers whose chunks end up
+  // in a capture file written by FlushToDisk.
+  void SetBlobStorage(bool enabled) { m_BlobStorage = enabled; }
+  // forces the next buffer to be written inline in the chunk even with blob storage enabled, for
+  // callers that keep an offset to the serialised contents (see ResourceRecord::SetDataOffset)
+  void InlineNextBuffer() { m_InlineNextBuffer = true; }
+  // the contents of the last buffer written by SerialiseBuffer, wherever they ended up being
+  // stored. Only valid until the next write.
+  const byte *GetLastBufferData() const { return m_LastBufferData; }
+
   // assumes buffer head is sitting before a chunk (ie. pushcontext will be valid)
   void SkipToChunk(uint32_t chunkIdx, uint32_t *idx = NULL)
   {
@@ -481,11 +532,19 @@ public:
   void Serialise(const char *name, rdctype::array<X> &el)
   {
     int32_t sz = el.count;
+    if(m_ElementMarks)
+      m_ElementMarks->push_back(GetOffset());
     Serialise(name, sz);
     if(m_Mode == WRITING)
     {
       for(int32_t i = 0; i < sz; i++)
+      {
+        if(m_ElementMarks)
+          m_ElementMarks->push_back(GetOffset());
         Serialise("[]", el.elems[i]);
+      }
+      if(m_ElementMarks)
+        m_ElementMarks->push_back(GetOffset());
     }
     else
     {
@@ -572,6 +631,10 @@ public:
 
   void FlushToDisk();
 
+  // makes FlushToDisk write the complete capture file into dest instead of to the file this
+  // serialiser was opened with, for captures that are only kept in memory
+  void RedirectToMemory(vector<byte> *dest) { m_MemoryDest = dest; }
+
   // set a function used when serialising a text representation
   // of the chunks
   void SetChunkNameLookup(ChunkLookup lookup) { m_ChunkLookup = lookup; }
@@ -614,11 +677,17 @@ private:
   // no copies
   Serialiser(const Serialiser &other);
 
+  friend class Chunk;
+
   static void CreateResolver(void *ths);
 
   // clean out for before constructor and after destructor (and other times probably)
   void Reset();
 
+  void ReleasePendingBlobs();
+  void LoadBlobs(const vector<byte> &data);
+  bool ReadBlob(BlobHash hash, uint32_t length, byte *dest);
+
   string GetIndent()
   {
     if(m_Mode == READING)
@@ -651,6 +720,7 @@ private:
   volatile bool m_ResolverThreadKillSignal;
 
   string m_Filename;
+  vector<byte> *m_MemoryDest;
 
   // raw binary buffer
   uint64_t m_BufferSize;
@@ -660,6 +730,15 @@ private:
   bool m_AlignedData;
   vector<uint64_t> m_ChunkFixups;
 
+  // writing with deduplicated buffers:
+  bool m_BlobStorage;
+  bool m_InlineNextBuffer;
+  const byte *m_LastBufferData;
+  // see SetElementMarks
+  vector<uint64_t> *m_ElementMarks;
+  // blobs referenced since the last chunk was created, handed over to the next Chunk
+  vector<SerialisedBlob *> m_PendingBlobs;
+
   // reading from file:
 
   struct Section
@@ -684,12 +763,18 @@ private:
   // this lists known sections, some may be NULL
   Section *m_KnownSections[eSectionType_Num];
 
+  // deduplicated buffers in the blob section, pointing into its data
+  map<BlobHash, std::pair<const byte *, uint64_t> > m_BlobLookup;
+
   // where does our in-memory window point to in the data stream. ie. m_pBuffer[0] is
   // m_ReadOffset into the frame capture section
   uint64_t m_ReadOffset;
 
   uint64_t m_FileSize;
 
+  double m_FileReadTime;
+  double m_DecompressTime;
+
   // how big is the current in-memory window
   size_t m_CurrentBufferSize;
 
@@ -26,6 +26,8 @@
 #include "renderdoccmd.h"
 #include <app/renderdoc_app.h>
 #include <replay/renderdoc_replay.h>
+#include <algorithm>
+#include <chrono>
 #include <string>
 
 using std::string;
@@ -542,6 +544,607 @@ struct ReplayCommand : public Command
   }
 };
 
+static std::string EscapeJSON(const std::string &str)
+{
+  std::string ret;
+  ret.reserve(str.size());
+
+  for(size_t i = 0; i < str.size(); i++)
+  {
+    char c = str[i];
+
+    if(c == '"' || c == '\\')
+    {
+      ret.push_back('\\');
+      ret.push_back(c);
+    }
+    else if((unsigned char)c < 0x20)
+    {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", (unsigned int)c);
+      ret += buf;
+    }
+    else
+    {
+      ret.push_back(c);
+    }
+  }
+
+  return ret;
+}
+
+struct LoadProfileCommand : public Command
+{
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc>");
+    parser.add<string>("json", 'j',
+                       "Write the profile as JSON to the given file instead of printing a summary. "
+                       "Use - to write to stdout.",
+                       false, "");
+  }
+  virtual const char *Description()
+  {
+    return "Opens a capture and reports where the time was spent loading it.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    if(parser.rest().empty())
+    {
+      std::cerr << "Error: loadprofile command requires a filename to load." << std::endl
+                << std::endl
+                << parser.usage();
+      return 0;
+    }
+
+    string filename = parser.rest()[0];
+
+    float progress = 0.0f;
+    ReplayRenderer *renderer = NULL;
+    ReplayCreateStatus status =
+        RENDERDOC_CreateReplayRenderer(filename.c_str(), &progress, &renderer);
+
+    if(status != eReplayCreate_Success || renderer == NULL)
+    {
+      std::cerr << "Couldn't load and replay '" << filename << "'." << std::endl;
+      return 1;
+    }
+
+    FetchFrameInfo frameInfo;
+    FetchLoadProfile profile;
+    renderer->GetFrameInfo(&frameInfo);
+    renderer->GetLoadProfile(&profile);
+
+    renderer->Shutdown();
+
+    // sort by most expensive chunk type first
+    std::vector<const FetchChunkLoadStats *> chunks;
+    for(int32_t i = 0; i < profile.chunks.count; i++)
+      chunks.push_back(&profile.chunks[i]);
+
+    std::sort(chunks.begin(), chunks.end(),
+              [](const FetchChunkLoadStats *a, const FetchChunkLoadStats *b) {
+                return a->totalTime > b->totalTime;
+              });
+
+    string jsonfile = parser.get<string>("json");
+
+    if(jsonfile.empty())
+    {
+      printf("Loaded '%s' in %.3f ms\n", filename.c_str(), profile.totalTime);
+      printf("  File read:                 %10.3f ms (%llu bytes compressed, %llu uncompressed)\n",
+             profile.fileReadTime, (unsigned long long)frameInfo.compressedFileSize,
+             (unsigned long long)frameInfo.uncompressedFileSize);
+      printf("  Decompression:             %10.3f ms\n", profile.decompressTime);
+      printf("  Initial contents load:     %10.3f ms (%llu bytes)\n", profile.initialContentsTime,
+             (unsigned long long)frameInfo.initDataSize);
+      printf("  Initial contents apply:    %10.3f ms\n", profile.initialContentsApplyTime);
+      printf("\n");
+      printf("  %-40s %8s %12s %12s %12s\n", "Chunk", "Count", "Total (ms)", "Avg (ms)",
+             "Size (MB)");
+
+      for(size_t i = 0; i < chunks.size(); i++)
+      {
+        const FetchChunkLoadStats *c = chunks[i];
+        printf("  %-40s %8u %12.3f %12.3f %12.3f\n", c->name.c_str(), c->count, c->totalTime,
+               c->count > 0 ? c->totalTime / double(c->count) : 0.0,
+               double(c->totalSize) / (1024.0 * 1024.0));
+      }
+
+      return 0;
+    }
+
+    FILE *f = jsonfile == "-" ? stdout : fopen(jsonfile.c_str(), "w");
+
+    if(!f)
+    {
+      std::cerr << "Couldn't open destination file '" << jsonfile << "'" << std::endl;
+      return 1;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"capture\": \"%s\",\n", EscapeJSON(filename).c_str());
+    fprintf(f, "  \"compressedFileSize\": %llu,\n",
+            (unsigned long long)frameInfo.compressedFileSize);
+    fprintf(f, "  \"uncompressedFileSize\": %llu,\n",
+            (unsigned long long)frameInfo.uncompressedFileSize);
+    fprintf(f, "  \"initDataSize\": %llu,\n", (unsigned long long)frameInfo.initDataSize);
+    fprintf(f, "  \"totalTime\": %.6f,\n", profile.totalTime);
+    fprintf(f, "  \"fileReadTime\": %.6f,\n", profile.fileReadTime);
+    fprintf(f, "  \"decompressTime\": %.6f,\n", profile.decompressTime);
+    fprintf(f, "  \"initialContentsTime\": %.6f,\n", profile.initialContentsTime);
+    fprintf(f, "  \"initialContentsApplyTime\": %.6f,\n", profile.initialContentsApplyTime);
+    fprintf(f, "  \"chunks\": [\n");
+
+    for(size_t i = 0; i < chunks.size(); i++)
+    {
+      const FetchChunkLoadStats *c = chunks[i];
+      fprintf(f,
+              "    {\"id\": %u, \"name\": \"%s\", \"count\": %u, \"totalTime\": %.6f, "
+              "\"totalSize\": %llu}%s\n",
+              c->chunkID, EscapeJSON(c->name.c_str()).c_str(), c->count, c->totalTime,
+              (unsigned long long)c->totalSize, i + 1 < chunks.size() ? "," : "");
+    }
+
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+
+    if(f != stdout)
+    {
+      fclose(f);
+      std::cerr << "Wrote load profile of '" << filename << "' to '" << jsonfile << "'."
+                << std::endl;
+    }
+
+    return 0;
+  }
+};
+
+struct BenchmarkCommand : public Command
+{
+  // latencies in milliseconds of one replay operation across the sweep
+  struct Samples
+  {
+    const char *name;
+    std::vector<double> times;
+
+    double percentile(double p) const
+    {
+      if(times.empty())
+        return 0.0;
+
+      size_t idx = size_t(p * double(times.size() - 1) + 0.5);
+      return times[std::min(idx, times.size() - 1)];
+    }
+
+    double average() const
+    {
+      double total = 0.0;
+      for(size_t i = 0; i < times.size(); i++)
+        total += times[i];
+      return times.empty() ? 0.0 : total / double(times.size());
+    }
+  };
+
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc>");
+    parser.add<uint32_t>("every", 'n', "Only replay to every Nth drawcall.", false, 1);
+    parser.add<uint32_t>("repeat", 'r', "Number of times to sweep the frame.", false, 1);
+    parser.add<string>("trace", 't',
+                       "Write a Chrome trace of RenderDoc's internal zones to the given file.",
+                       false, "");
+    parser.add<string>("json", 'j',
+                       "Write the results as JSON to the given file instead of printing a summary. "
+                       "Use - to write to stdout.",
+                       false, "");
+    parser.add<string>("save-path", 's',
+                       "The file that textures are saved to while timing SaveTexture. It's "
+                       "overwritten at each event and deleted afterwards. Defaults to a file in "
+                       "the temporary folder.",
+                       false, "");
+  }
+  virtual const char *Description()
+  {
+    return "Opens a capture headlessly and times common replay operations over its drawcalls.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    if(parser.rest().empty())
+    {
+      std::cerr << "Error: benchmark command requires a filename to load." << std::endl
+                << std::endl
+                << parser.usage();
+      return 0;
+    }
+
+    string filename = parser.rest()[0];
+
+    uint32_t every = std::max(1U, parser.get<uint32_t>("every"));
+    uint32_t repeat = std::max(1U, parser.get<uint32_t>("repeat"));
+    string tracefile = parser.get<string>("trace");
+
+    if(!tracefile.empty())
+      RENDERDOC_SetTraceEnabled(true);
+
+    std::chrono::high_resolution_clock::time_point loadStart =
+        std::chrono::high_resolution_clock::now();
+
+    float progress = 0.0f;
+    ReplayRenderer *renderer = NULL;
+    ReplayCreateStatus status =
+        RENDERDOC_CreateReplayRenderer(filename.c_str(), &progress, &renderer);
+
+    double loadTime = Elapsed(loadStart);
+
+    if(status != eReplayCreate_Success || renderer == NULL)
+    {
+      std::cerr << "Couldn't load and replay '" << filename << "'." << std::endl;
+      return 1;
+    }
+
+    APIProperties props = renderer->GetAPIProperties();
+
+    rdctype::array<FetchDrawcall> drawcalls;
+    renderer->GetDrawcalls(&drawcalls);
+
+    rdctype::array<FetchTexture> textures;
+    renderer->GetTextures(&textures);
+
+    // prefer real drawcalls, but image captures and frames with only clears/copies still have
+    // events worth replaying to.
+    std::vector<const FetchDrawcall *> draws;
+    for(int32_t i = 0; i < drawcalls.count; i++)
+      AddDraws(drawcalls[i], draws, true);
+
+    if(draws.empty())
+    {
+      for(int32_t i = 0; i < drawcalls.count; i++)
+        AddDraws(drawcalls[i], draws, false);
+    }
+
+    string savePath = parser.get<string>("save-path");
+    if(savePath.empty())
+      savePath = GetTempFolder() + "renderdoccmd_benchmark.png";
+
+    Samples setEvent = {"SetFrameEvent"};
+    Samples pipeState = {"PipelineState"};
+    Samples postVS = {"GetPostVSData"};
+    Samples texData = {"GetTextureData"};
+    Samples usage = {"GetUsage"};
+    Samples save = {"SaveTexture"};
+
+    uint32_t replayed = 0;
+
+    for(uint32_t r = 0; r < repeat; r++)
+    {
+      for(size_t i = 0; i < draws.size(); i += every)
+      {
+        const FetchDrawcall *draw = draws[i];
+
+        std::chrono::high_resolution_clock::time_point start =
+            std::chrono::high_resolution_clock::now();
+        renderer->SetFrameEvent(draw->eventID, true);
+        setEvent.times.push_back(Elapsed(start));
+
+        start = std::chrono::high_resolution_clock::now();
+        FetchPipelineState(renderer, props.pipelineType);
+        pipeState.times.push_back(Elapsed(start));
+
+        MeshFormat mesh;
+        start = std::chrono::high_resolution_clock::now();
+        renderer->GetPostVSData(0, eMeshDataStage_VSOut, &mesh);
+        postVS.times.push_back(Elapsed(start));
+
+        ResourceId tex = draw->outputs[0];
+        if(tex == ResourceId())
+          tex = draw->depthOut;
+        if(tex == ResourceId() && textures.count > 0)
+          tex = textures[0].ID;
+
+        replayed++;
+
+        if(tex == ResourceId())
+          continue;
+
+        rdctype::array<byte> data;
+        start = std::chrono::high_resolution_clock::now();
+        renderer->GetTextureData(tex, 0, 0, &data);
+        texData.times.push_back(Elapsed(start));
+
+        rdctype::array<EventUsage> usages;
+        start = std::chrono::high_resolution_clock::now();
+        renderer->GetUsage(tex, &usages);
+        usage.times.push_back(Elapsed(start));
+
+        TextureSave saveData = {};
+        saveData.id = tex;
+        saveData.typeHint = eCompType_None;
+        saveData.destType = eFileType_PNG;
+        saveData.mip = 0;
+        saveData.comp.blackPoint = 0.0f;
+        saveData.comp.whitePoint = 1.0f;
+        saveData.sample.mapToArray = false;
+        saveData.sample.sampleIndex = ~0U;
+        saveData.slice.sliceIndex = 0;
+        saveData.channelExtract = -1;
+        saveData.alpha = eAlphaMap_Preserve;
+        saveData.jpegQuality = 90;
+
+        start = std::chrono::high_resolution_clock::now();
+        renderer->SaveTexture(saveData, savePath.c_str());
+        save.times.push_back(Elapsed(start));
+      }
+    }
+
+    renderer->Shutdown();
+
+    remove(savePath.c_str());
+
+    if(!tracefile.empty())
+    {
+      RENDERDOC_SetTraceEnabled(false);
+
+      if(!RENDERDOC_WriteTrace(tracefile.c_str()))
+        std::cerr << "Couldn't write trace to '" << tracefile << "'" << std::endl;
+    }
+
+    uint64_t peakMem = GetPeakMemoryUsage();
+
+    Samples *results[] = {&setEvent, &pipeState, &postVS, &texData, &usage, &save};
+    const size_t numResults = sizeof(results) / sizeof(results[0]);
+
+    for(size_t i = 0; i < numResults; i++)
+      std::sort(results[i]->times.begin(), results[i]->times.end());
+
+    string jsonfile = parser.get<string>("json");
+
+    if(jsonfile.empty())
+    {
+      printf("Loaded '%s' in %.3f ms\n", filename.c_str(), loadTime);
+      printf("Replayed %u events (%u sweeps over every %u of %u drawcalls)\n", replayed, repeat,
+             every, (uint32_t)draws.size());
+      printf("Peak memory usage: %.3f MB\n", double(peakMem) / (1024.0 * 1024.0));
+      printf("\n");
+      printf("  %-16s %8s %10s %10s %10s %10s %10s %10s\n", "Operation", "Count", "Min (ms)",
+             "Avg (ms)", "p50 (ms)", "p90 (ms)", "p99 (ms)", "Max (ms)");
+
+      for(size_t i = 0; i < numResults; i++)
+      {
+        const Samples &s = *results[i];
+        printf("  %-16s %8u %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n", s.name,
+               (uint32_t)s.times.size(), s.percentile(0.0), s.average(), s.percentile(0.5),
+               s.percentile(0.9), s.percentile(0.99), s.percentile(1.0));
+      }
+
+      return 0;
+    }
+
+    FILE *f = jsonfile == "-" ? stdout : fopen(jsonfile.c_str(), "w");
+
+    if(!f)
+    {
+      std::cerr << "Couldn't open destination file '" << jsonfile << "'" << std::endl;
+      return 1;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"capture\": \"%s\",\n", EscapeJSON(filename).c_str());
+    fprintf(f, "  \"loadTime\": %.6f,\n", loadTime);
+    fprintf(f, "  \"peakMemory\": %llu,\n", (unsigned long long)peakMem);
+    fprintf(f, "  \"drawcalls\": %u,\n", (uint32_t)draws.size());
+    fprintf(f, "  \"replayed\": %u,\n", replayed);
+    fprintf(f, "  \"operations\": [\n");
+
+    for(size_t i = 0; i < numResults; i++)
+    {
+      const Samples &s = *results[i];
+      fprintf(f,
+              "    {\"name\": \"%s\", \"count\": %u, \"min\": %.6f, \"avg\": %.6f, \"p50\": %.6f, "
+              "\"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f}%s\n",
+              s.name, (uint32_t)s.times.size(), s.percentile(0.0), s.average(), s.percentile(0.5),
+              s.percentile(0.9), s.percentile(0.99), s.percentile(1.0),
+              i + 1 < numResults ? "," : "");
+    }
+
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+
+    if(f != stdout)
+    {
+      fclose(f);
+      std::cerr << "Wrote benchmark results of '" << filename << "' to '" << jsonfile << "'."
+                << std::endl;
+    }
+
+    return 0;
+  }
+
+  static double Elapsed(std::chrono::high_resolution_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() -
+                                                     start)
+        .count();
+  }
+
+  static void AddDraws(const FetchDrawcall &draw, std::vector<const FetchDrawcall *> &draws,
+                       bool drawcallsOnly)
+  {
+    if(draw.children.count > 0)
+    {
+      for(int32_t i = 0; i < draw.children.count; i++)
+        AddDraws(draw.children[i], draws, drawcallsOnly);
+    }
+    else if(!drawcallsOnly || (draw.flags & eDraw_Drawcall))
+    {
+      draws.push_back(&draw);
+    }
+  }
+
+  static void FetchPipelineState(ReplayRenderer *renderer, GraphicsAPI api)
+  {
+    if(api == eGraphicsAPI_D3D11)
+    {
+      D3D11PipelineState state;
+      renderer->GetD3D11PipelineState(&state);
+    }
+    else if(api == eGraphicsAPI_D3D12)
+    {
+      D3D12PipelineState state;
+      renderer->GetD3D12PipelineState(&state);
+    }
+    else if(api == eGraphicsAPI_OpenGL)
+    {
+      GLPipelineState state;
+      renderer->GetGLPipelineState(&state);
+    }
+    else if(api == eGraphicsAPI_Vulkan)
+    {
+      VulkanPipelineState state;
+      renderer->GetVulkanPipelineState(&state);
+    }
+  }
+};
+
+struct ExportCommand : public Command
+{
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc>");
+    parser.add<string>("out", 'o',
+                       "The prefix for exported files, which are named "
+                       "<prefix>_<eventID>_<resourceID>.<format>. Defaults to the capture "
+                       "filename.",
+                       false, "");
+    parser.add<string>("format", 'f', "The format of the exported files.", false, "png",
+                       cmdline::oneof<string>("png", "jpg", "bmp", "tga", "hdr", "exr", "dds"));
+    parser.add<uint32_t>("first", 0, "The first event to export.", false, 0);
+    parser.add<uint32_t>("last", 0, "The last event to export. Defaults to the end of the frame.",
+                         false, ~0U);
+    parser.add<string>("resources", 'r',
+                       "A comma-separated list of resource IDs to export at each drawcall, "
+                       "instead of the bound outputs.",
+                       false, "");
+  }
+  virtual const char *Description()
+  {
+    return "Saves the outputs of every drawcall in a capture to disk, e.g. for golden images.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual int Execute(cmdline::parser &parser, const CaptureOptions &)
+  {
+    if(parser.rest().empty())
+    {
+      std::cerr << "Error: export command requires a filename to load." << std::endl
+                << std::endl
+                << parser.usage();
+      return 0;
+    }
+
+    string filename = parser.rest()[0];
+
+    string prefix = parser.get<string>("out");
+    if(prefix.empty())
+      prefix = filename;
+
+    string format = parser.get<string>("format");
+
+    TextureSave saveData = {};
+    saveData.typeHint = eCompType_None;
+    saveData.destType = eFileType_PNG;
+    saveData.mip = 0;
+    saveData.comp.blackPoint = 0.0f;
+    saveData.comp.whitePoint = 1.0f;
+    saveData.sample.mapToArray = false;
+    saveData.sample.sampleIndex = ~0U;
+    saveData.slice.sliceIndex = 0;
+    saveData.channelExtract = -1;
+    saveData.alpha = eAlphaMap_Preserve;
+    saveData.jpegQuality = 90;
+
+    if(format == "jpg")
+      saveData.destType = eFileType_JPG;
+    else if(format == "bmp")
+      saveData.destType = eFileType_BMP;
+    else if(format == "tga")
+      saveData.destType = eFileType_TGA;
+    else if(format == "hdr")
+      saveData.destType = eFileType_HDR;
+    else if(format == "exr")
+      saveData.destType = eFileType_EXR;
+    else if(format == "dds")
+      saveData.destType = eFileType_DDS;
+
+    std::vector<ResourceId> ids;
+
+    string resources = parser.get<string>("resources");
+    for(const char *c = resources.c_str(); *c;)
+    {
+      char *end = NULL;
+      unsigned long long id = strtoull(c, &end, 10);
+
+      if(end == c)
+      {
+        std::cerr << "Invalid resource list '" << resources << "'." << std::endl;
+        return 1;
+      }
+
+      ids.push_back(ResourceId(id, true));
+
+      c = end;
+      while(*c == ',' || *c == ' ')
+        c++;
+    }
+
+    float progress = 0.0f;
+    ReplayRenderer *renderer = NULL;
+    ReplayCreateStatus status =
+        RENDERDOC_CreateReplayRenderer(filename.c_str(), &progress, &renderer);
+
+    if(status != eReplayCreate_Success || renderer == NULL)
+    {
+      std::cerr << "Couldn't load and replay '" << filename << "'." << std::endl;
+      return 1;
+    }
+
+    rdctype::array<TextureExport> exports;
+    bool success = renderer->ExportTextures(
+        saveData, parser.get<uint32_t>("first"), parser.get<uint32_t>("last"),
+        ids.empty() ? NULL : &ids[0], (uint32_t)ids.size(), prefix.c_str(), &exports);
+
+    renderer->Shutdown();
+
+    uint32_t written = 0;
+
+    for(int32_t i = 0; i < exports.count; i++)
+    {
+      const TextureExport &exp = exports[i];
+
+      printf("%u %llu %s%s\n", exp.eventID, (unsigned long long)exp.id.id, exp.path.elems,
+             exp.duplicate ? " (duplicate)" : "");
+
+      if(!exp.duplicate)
+        written++;
+    }
+
+    std::cerr << "Exported " << exports.count << " textures from '" << filename << "', "
+              << written << " files written." << std::endl;
+
+    if(!success)
+    {
+      std::cerr << "Some textures couldn't be exported." << std::endl;
+      return 1;
+    }
+
+    return 0;
+  }
+};
+
 struct Cap32For64Command : public Command
 {
   virtual void AddOptions(cmdline::parser &parser)
@@ -673,6 +1276,9 @@ int renderdoccmd(std::vector<std::string> &argv)
     add_command("inject", new InjectCommand());
     add_command("remoteserver", new RemoteServerCommand());
     add_command("replay", new ReplayCommand());
+    add_command("loadprofile", new LoadProfileCommand());
+    add_command("benchmark", new BenchmarkCommand());
+    add_command("export", new ExportCommand());
     add_command("cap32for64", new Cap32For64Command());
 
     if(argv.size() <= 1)
@@ -749,6 +1355,17 @@ int renderdoccmd(std::vector<std::string> &argv)
               "Capturing Option: Save all initial resource contents at frame start.");
       cmd.add("opt-capture-all-cmd-lists", 0,
               "Capturing Option: In D3D11, record all command lists from application start.");
+      cmd.add<int>("opt-flight-recorder", 0,
+                   "Capturing Option: Keep this many recent frames in memory, to save on demand.",
+                   false, 0, cmdline::range(0, 10000));
+      cmd.add<int>("opt-flight-recorder-mb", 0,
+                   "Capturing Option: Memory limit in MB for frames kept by --opt-flight-recorder.",
+                   false, 256, cmdline::range(1, 65536));
+      cmd.add<int>("opt-capture-memory-mb", 0,
+                   "Capturing Option: Spill captured data to disk above this many MB in memory.",
+                   false, 0, cmdline::range(0, 1048576));
+      cmd.add("opt-profile-locks", 0,
+              "Capturing Option: Measure contention on RenderDoc's internal locks.");
     }
 
     cmd.parse_check(argv, true);
@@ -780,8 +1397,13 @@ int renderdoccmd(std::vector<std::string> &argv)
         opts.SaveAllInitials = true;
       if(cmd.exist("opt-capture-all-cmd-lists"))
         opts.CaptureAllCmdLists = true;
+      if(cmd.exist("opt-profile-locks"))
+        opts.ProfileLocks = true;
 
       opts.DelayForDebugger = (uint32_t)cmd.get<int>("opt-delay-for-debugger");
+      opts.FlightRecorderFrames = (uint32_t)cmd.get<int>("opt-flight-recorder");
+      opts.FlightRecorderMemoryMB = (uint32_t)cmd.get<int>("opt-flight-recorder-mb");
+      opts.CaptureMemoryBudgetMB = (uint32_t)cmd.get<int>("opt-capture-memory-mb");
     }
 
     if(cmd.exist("help"))
@@ -64,3 +64,7 @@ void readCapOpts(const std::string &str, CaptureOptions *opts);
 void DisplayRendererPreview(ReplayRenderer *renderer, TextureDisplay &displayCfg, uint32_t width,
                             uint32_t height);
 void Daemonise();
+// peak resident memory of this process, in bytes
+uint64_t GetPeakMemoryUsage();
+// a folder for scratch files, with a trailing separator
+std::string GetTempFolder();
@@ -25,7 +25,9 @@
 #include "renderdoccmd.h"
 #include <locale.h>
 #include <replay/renderdoc_replay.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <unistd.h>
 #include <string>
 
@@ -48,6 +50,26 @@ void Daemonise()
 {
 }
 
+uint64_t GetPeakMemoryUsage()
+{
+  rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+  // ru_maxrss is reported in kilobytes
+  return uint64_t(usage.ru_maxrss) * 1024;
+}
+
+std::string GetTempFolder()
+{
+  const char *tmpdir = getenv("TMPDIR");
+  if(tmpdir == NULL || tmpdir[0] == 0)
+    return "/data/local/tmp/";
+
+  std::string ret = tmpdir;
+  if(ret[ret.size() - 1] != '/')
+    ret += '/';
+  return ret;
+}
+
 void DisplayRendererPreview(ReplayRenderer *renderer, TextureDisplay &displayCfg, uint32_t width,
                             uint32_t height)
 {
@@ -31,6 +31,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -51,6 +52,26 @@ void Daemonise()
   daemon(1, 0);
 }
 
+uint64_t GetPeakMemoryUsage()
+{
+  rusage usage = {};
+  getrusage(RUSAGE_SELF, &usage);
+  // ru_maxrss is reported in kilobytes
+  return uint64_t(usage.ru_maxrss) * 1024;
+}
+
+std::string GetTempFolder()
+{
+  const char *tmpdir = getenv("TMPDIR");
+  if(tmpdir == NULL || tmpdir[0] == 0)
+    return "/tmp/";
+
+  std::string ret = tmpdir;
+  if(ret[ret.size() - 1] != '/')
+    ret += '/';
+  return ret;
+}
+
 // this is exported from vk_linux.cpp
 
 #if defined(RENDERDOC_SUPPORT_VULKAN)
@@ -233,6 +233,24 @@ void Daemonise()
   // nothing really to do, windows version of renderdoccmd is already 'detached'
 }
 
+uint64_t GetPeakMemoryUsage()
+{
+  PROCESS_MEMORY_COUNTERS counters = {};
+  counters.cb = sizeof(counters);
+
+  if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return (uint64_t)counters.PeakWorkingSetSize;
+
+  return 0;
+}
+
+std::string GetTempFolder()
+{
+  char tempPath[MAX_PATH + 1] = {0};
+  GetTempPathA(MAX_PATH, tempPath);
+  return tempPath;
+}
+
 void DisplayRendererPreview(ReplayRenderer *renderer, TextureDisplay &displayCfg, uint32_t width,
                             uint32_t height)
 {
@@ -78,6 +78,7 @@ public class Core
         private GLPipelineState m_GLPipelineState = null;
         private VulkanPipelineState m_VulkanPipelineState = null;
         private CommonPipelineState m_PipelineState = new CommonPipelineState();
+        private UInt32 m_PipelineStateVersion = 0;
 
         private List<ILogViewerForm> m_LogViewers = new List<ILogViewerForm>();
         private List<ILogLoadProgressListener> m_ProgressListeners = new List<ILogLoadProgressListener>();
@@ -179,6 +180,9 @@ public void AddMessages(DebugMessage[] msgs)
         public GLPipelineState CurGLPipelineState { get { return m_GLPipelineState; } }
         public VulkanPipelineState CurVulkanPipelineState { get { return m_VulkanPipelineState; } }
         public CommonPipelineState CurPipelineState { get { return m_PipelineState; } }
+        // changes whenever the pipeline state above changes, so views can skip refreshing
+        // when stepping between events with identical state
+        public UInt32 PipelineStateVersion { get { return m_PipelineStateVersion; } }
 
         #endregion
 
@@ -571,6 +575,7 @@ public void LoadLogfile(string logFile, string origFilename, bool temporary, boo
                 m_GLPipelineState = r.GetGLPipelineState();
                 m_VulkanPipelineState = r.GetVulkanPipelineState();
                 m_PipelineState.SetStates(m_APIProperties, m_D3D11PipelineState, m_D3D12PipelineState, m_GLPipelineState, m_VulkanPipelineState);
+                m_PipelineStateVersion = r.GetPipelineStateVersion();
 
                 UnreadMessageCount = 0;
                 AddMessages(m_FrameInfo.debugMessages);
@@ -905,6 +910,13 @@ private void SetEventID(ILogViewerForm exclude, UInt32 eventID, bool force)
             m_Renderer.Invoke((ReplayRenderer r) =>
             {
                 r.SetFrameEvent(m_EventID, force);
+
+                // don't marshal the whole state again if nothing changed
+                UInt32 version = r.GetPipelineStateVersion();
+                if (version == m_PipelineStateVersion && !force)
+                    return;
+
+                m_PipelineStateVersion = version;
                 m_D3D11PipelineState = r.GetD3D11PipelineState();
                 m_D3D12PipelineState = r.GetD3D12PipelineState();
                 m_GLPipelineState = r.GetGLPipelineState();
@@ -554,20 +554,29 @@ private void RunThread()
 
                         if (m_current.method != null)
                         {
-                            if (CatchExceptions)
+                            StaticExports.BeginTraceZone(m_current.method.Method.Name);
+
+                            try
                             {
-                                try
+                                if (CatchExceptions)
                                 {
-                                    m_current.method(renderer);
+                                    try
+                                    {
+                                        m_current.method(renderer);
+                                    }
+                                    catch (Exception ex)
+                                    {
+                                        m_current.ex = ex;
+                                    }
                                 }
-                                catch (Exception ex)
+                                else
                                 {
-                                    m_current.ex = ex;
+                                    m_current.method(renderer);
                                 }
                             }
-                            else
+                            finally
                             {
-                                m_current.method(renderer);
+                                StaticExports.EndTraceZone();
                             }
                         }
 
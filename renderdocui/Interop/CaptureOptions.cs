@@ -80,5 +80,9 @@ public class CaptureOptions
         public bool SaveAllInitials;
         public bool CaptureAllCmdLists;
         public bool DebugOutputMute;
+        public UInt32 FlightRecorderFrames;
+        public UInt32 FlightRecorderMemoryMB;
+        public UInt32 CaptureMemoryBudgetMB;
+        public bool ProfileLocks;
     };
 };
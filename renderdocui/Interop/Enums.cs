@@ -554,6 +554,9 @@ public enum TargetControlMessageType
         CaptureCopied,
         RegisterAPI,
         NewChild,
+        TraceCopied,
+        CaptureMemory,
+        LockContention,
     };
 
     public enum EnvironmentModificationType
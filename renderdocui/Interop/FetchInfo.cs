@@ -102,6 +102,26 @@ public int CompareTo(DirectoryFile o)
         }
     };
 
+    [StructLayout(LayoutKind.Sequential)]
+    public class RemoteServerSession
+    {
+        public UInt32 clientIP;
+        [CustomMarshalAs(CustomUnmanagedType.UTF8TemplatedString)]
+        public string capture;
+        public float cpuUsage;
+    };
+
+    [StructLayout(LayoutKind.Sequential)]
+    public class RemoteServerStatus
+    {
+        public UInt32 maxSessions;
+        public UInt32 maxQueued;
+        public UInt32 queued;
+        public float sessionCPUQuota;
+        [CustomMarshalAs(CustomUnmanagedType.TemplatedArray)]
+        public RemoteServerSession[] sessions;
+    };
+
     [StructLayout(LayoutKind.Sequential)]
     public class ResourceFormat
     {
@@ -509,6 +529,37 @@ public class FetchFrameInfo
         public DebugMessage[] debugMessages;
     };
 
+    [StructLayout(LayoutKind.Sequential)]
+    public class FetchCapturedFrame
+    {
+        public UInt32 frameNumber;
+        public UInt32 firstEvent;
+        public UInt32 lastEvent;
+    };
+
+    [StructLayout(LayoutKind.Sequential)]
+    public class FetchChunkLoadStats
+    {
+        public UInt32 chunkID;
+        public UInt32 count;
+        public UInt64 totalSize;
+        public double totalTime;
+        [CustomMarshalAs(CustomUnmanagedType.UTF8TemplatedString)]
+        public string name;
+    };
+
+    [StructLayout(LayoutKind.Sequential)]
+    public class FetchLoadProfile
+    {
+        public double totalTime;
+        public double fileReadTime;
+        public double decompressTime;
+        public double initialContentsTime;
+        public double initialContentsApplyTime;
+        [CustomMarshalAs(CustomUnmanagedType.TemplatedArray)]
+        public FetchChunkLoadStats[] chunks;
+    };
+
     [StructLayout(LayoutKind.Sequential)]
     public class FetchAPIEvent
     {
@@ -769,6 +820,16 @@ public class SliceMapping
         public int jpegQuality = 90;
     };
 
+    [StructLayout(LayoutKind.Sequential)]
+    public class TextureExport
+    {
+        public UInt32 eventID;
+        public ResourceId id;
+        [CustomMarshalAs(CustomUnmanagedType.UTF8TemplatedString)]
+        public string path;
+        public bool duplicate;
+    };
+
     [StructLayout(LayoutKind.Sequential)]
     public class APIProperties
     {
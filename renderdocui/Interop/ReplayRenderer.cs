@@ -114,6 +114,39 @@ public struct NewChildData
         };
         [CustomMarshalAs(CustomUnmanagedType.CustomClass)]
         public NewChildData NewChild;
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct CaptureMemoryData
+        {
+            public UInt64 residentBytes;
+            public UInt64 spilledBytes;
+            public UInt64 liveChunks;
+            public UInt64 budgetBytes;
+        };
+        [CustomMarshalAs(CustomUnmanagedType.CustomClass)]
+        public CaptureMemoryData CaptureMemory;
+
+        [StructLayout(LayoutKind.Sequential)]
+        public class LockContentionStats
+        {
+            [CustomMarshalAs(CustomUnmanagedType.UTF8TemplatedString)]
+            public string name;
+            public UInt64 acquisitions;
+            public UInt64 contended;
+            public double totalWaitMS;
+            public double maxWaitMS;
+            [CustomMarshalAs(CustomUnmanagedType.UTF8TemplatedString)]
+            public string worstHolder;
+        };
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct LockContentionData
+        {
+            [CustomMarshalAs(CustomUnmanagedType.TemplatedArray)]
+            public LockContentionStats[] locks;
+        };
+        [CustomMarshalAs(CustomUnmanagedType.CustomClass)]
+        public LockContentionData LockContention;
     };
 
     public class ReplayOutput
@@ -307,6 +340,8 @@ public class ReplayRenderer
         private static extern bool ReplayRenderer_GetGLPipelineState(IntPtr real, IntPtr mem);
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern bool ReplayRenderer_GetVulkanPipelineState(IntPtr real, IntPtr mem);
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern UInt32 ReplayRenderer_GetPipelineStateVersion(IntPtr real);
 
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern void ReplayRenderer_BuildCustomShader(IntPtr real, IntPtr entry, IntPtr source, UInt32 compileFlags, ShaderStageType type, ref ResourceId shaderID, IntPtr errorMem);
@@ -325,6 +360,10 @@ public class ReplayRenderer
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern bool ReplayRenderer_GetFrameInfo(IntPtr real, IntPtr outframe);
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern bool ReplayRenderer_GetCapturedFrames(IntPtr real, IntPtr outframes);
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern bool ReplayRenderer_GetLoadProfile(IntPtr real, IntPtr outprofile);
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern bool ReplayRenderer_GetDrawcalls(IntPtr real, IntPtr outdraws);
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern bool ReplayRenderer_FetchCounters(IntPtr real, IntPtr counters, UInt32 numCounters, IntPtr outresults);
@@ -358,6 +397,9 @@ public class ReplayRenderer
 
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern bool ReplayRenderer_SaveTexture(IntPtr real, TextureSave saveData, IntPtr path);
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern bool ReplayRenderer_ExportTextures(IntPtr real, TextureSave saveData, UInt32 firstEvent, UInt32 lastEvent,
+                                                                 ResourceId[] ids, UInt32 numIDs, IntPtr pathPrefix, IntPtr outexports);
 
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern bool ReplayRenderer_GetPostVSData(IntPtr real, UInt32 instID, MeshDataStage stage, IntPtr outdata);
@@ -366,6 +408,9 @@ public class ReplayRenderer
         private static extern bool ReplayRenderer_GetBufferData(IntPtr real, ResourceId buff, UInt64 offset, UInt64 len, IntPtr outdata);
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern bool ReplayRenderer_GetTextureData(IntPtr real, ResourceId tex, UInt32 arrayIdx, UInt32 mip, IntPtr outdata);
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern bool ReplayRenderer_GetTextureRegionData(IntPtr real, ResourceId tex, UInt32 arrayIdx, UInt32 mip,
+                                                                       ref UInt32 x, ref UInt32 y, ref UInt32 z, ref UInt32 width, ref UInt32 height, ref UInt32 depth, IntPtr outdata);
 
         private IntPtr m_Real = IntPtr.Zero;
 
@@ -483,6 +528,11 @@ public VulkanPipelineState GetVulkanPipelineState()
             return ret;
         }
 
+        public UInt32 GetPipelineStateVersion()
+        {
+            return ReplayRenderer_GetPipelineStateVersion(m_Real);
+        }
+
         public ResourceId BuildCustomShader(string entry, string source, UInt32 compileFlags, ShaderStageType type, out string errors)
         {
             IntPtr mem = CustomMarshal.Alloc(typeof(templated_array));
@@ -551,6 +601,38 @@ public FetchFrameInfo GetFrameInfo()
             return ret;
         }
 
+        public FetchCapturedFrame[] GetCapturedFrames()
+        {
+            IntPtr mem = CustomMarshal.Alloc(typeof(templated_array));
+
+            bool success = ReplayRenderer_GetCapturedFrames(m_Real, mem);
+
+            FetchCapturedFrame[] ret = null;
+
+            if (success)
+                ret = (FetchCapturedFrame[])CustomMarshal.GetTemplatedArray(mem, typeof(FetchCapturedFrame), true);
+
+            CustomMarshal.Free(mem);
+
+            return ret;
+        }
+
+        public FetchLoadProfile GetLoadProfile()
+        {
+            IntPtr mem = CustomMarshal.Alloc(typeof(FetchLoadProfile));
+
+            bool success = ReplayRenderer_GetLoadProfile(m_Real, mem);
+
+            FetchLoadProfile ret = null;
+
+            if (success)
+                ret = (FetchLoadProfile)CustomMarshal.PtrToStructure(mem, typeof(FetchLoadProfile), true);
+
+            CustomMarshal.Free(mem);
+
+            return ret;
+        }
+
         private void PopulateDraws(ref Dictionary<Int64, FetchDrawcall> map, FetchDrawcall[] draws)
         {
             if (draws.Length == 0) return;
@@ -848,6 +930,24 @@ public bool SaveTexture(TextureSave saveData, string path)
             return ret;
         }
 
+        public TextureExport[] ExportTextures(TextureSave saveData, UInt32 firstEvent, UInt32 lastEvent,
+                                              ResourceId[] ids, string pathPrefix)
+        {
+            IntPtr mem = CustomMarshal.Alloc(typeof(templated_array));
+            IntPtr prefix_mem = CustomMarshal.MakeUTF8String(pathPrefix);
+
+            UInt32 numIDs = ids == null ? 0 : (UInt32)ids.Length;
+
+            ReplayRenderer_ExportTextures(m_Real, saveData, firstEvent, lastEvent, ids, numIDs, prefix_mem, mem);
+
+            TextureExport[] ret = (TextureExport[])CustomMarshal.GetTemplatedArray(mem, typeof(TextureExport), true);
+
+            CustomMarshal.Free(prefix_mem);
+            CustomMarshal.Free(mem);
+
+            return ret;
+        }
+
         public MeshFormat GetPostVSData(UInt32 instID, MeshDataStage stage)
         {
             IntPtr mem = CustomMarshal.Alloc(typeof(MeshFormat));
@@ -896,6 +996,24 @@ public byte[] GetTextureData(ResourceId tex, UInt32 arrayIdx, UInt32 mip)
 
             return ret;
         }
+
+        // the region is updated to the region actually read, after clamping and block alignment
+        public byte[] GetTextureRegionData(ResourceId tex, UInt32 arrayIdx, UInt32 mip,
+                                           ref UInt32 x, ref UInt32 y, ref UInt32 z, ref UInt32 width, ref UInt32 height, ref UInt32 depth)
+        {
+            IntPtr mem = CustomMarshal.Alloc(typeof(templated_array));
+
+            bool success = ReplayRenderer_GetTextureRegionData(m_Real, tex, arrayIdx, mip, ref x, ref y, ref z, ref width, ref height, ref depth, mem);
+
+            byte[] ret = new byte[] { };
+
+            if (success)
+                ret = (byte[])CustomMarshal.GetTemplatedArray(mem, typeof(byte), true);
+
+            CustomMarshal.Free(mem);
+
+            return ret;
+        }
     };
 
     public class RemoteServer
@@ -1148,9 +1266,15 @@ public class TargetControl
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern void TargetControl_QueueCapture(IntPtr real, UInt32 frameNumber);
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern void TargetControl_SaveRecentFrame(IntPtr real, UInt32 framesAgo);
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern void TargetControl_CopyCapture(IntPtr real, UInt32 remoteID, IntPtr localpath);
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern void TargetControl_DeleteCapture(IntPtr real, UInt32 remoteID);
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern void TargetControl_SetTraceEnabled(IntPtr real, bool enabled);
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern void TargetControl_CopyTrace(IntPtr real, IntPtr localpath);
 
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern void TargetControl_ReceiveMessage(IntPtr real, IntPtr outmsg);
@@ -1220,6 +1344,11 @@ public void QueueCapture(UInt32 frameNum)
             TargetControl_QueueCapture(m_Real, frameNum);
         }
 
+        public void SaveRecentFrame(UInt32 framesAgo)
+        {
+            TargetControl_SaveRecentFrame(m_Real, framesAgo);
+        }
+
         public void CopyCapture(UInt32 id, string localpath)
         {
             IntPtr localpath_mem = CustomMarshal.MakeUTF8String(localpath);
@@ -1234,6 +1363,20 @@ public void DeleteCapture(UInt32 id)
             TargetControl_DeleteCapture(m_Real, id);
         }
 
+        public void SetTraceEnabled(bool enabled)
+        {
+            TargetControl_SetTraceEnabled(m_Real, enabled);
+        }
+
+        public void CopyTrace(string localpath)
+        {
+            IntPtr localpath_mem = CustomMarshal.MakeUTF8String(localpath);
+
+            TargetControl_CopyTrace(m_Real, localpath_mem);
+
+            CustomMarshal.Free(localpath_mem);
+        }
+
         public void ReceiveMessage()
         {
             if (m_Real != IntPtr.Zero)
@@ -1281,6 +1424,21 @@ public void ReceiveMessage()
                     NewChild = msg.NewChild;
                     ChildAdded = true;
                 }
+                else if (msg.Type == TargetControlMessageType.TraceCopied)
+                {
+                    TracePath = msg.NewCapture.path;
+                    TraceCopied = true;
+                }
+                else if (msg.Type == TargetControlMessageType.CaptureMemory)
+                {
+                    CaptureMemory = msg.CaptureMemory;
+                    CaptureMemoryUpdated = true;
+                }
+                else if (msg.Type == TargetControlMessageType.LockContention)
+                {
+                    LockContention = msg.LockContention.locks;
+                    LockContentionUpdated = true;
+                }
             }
         }
 
@@ -1293,9 +1451,18 @@ public void ReceiveMessage()
         public bool ChildAdded;
         public bool CaptureCopied;
         public bool InfoUpdated;
+        public bool TraceCopied;
+        public bool CaptureMemoryUpdated;
+        public bool LockContentionUpdated;
+
+        public string TracePath;
 
         public TargetControlMessage.NewCaptureData CaptureFile = new TargetControlMessage.NewCaptureData();
 
         public TargetControlMessage.NewChildData NewChild = new TargetControlMessage.NewChildData();
+
+        public TargetControlMessage.CaptureMemoryData CaptureMemory = new TargetControlMessage.CaptureMemoryData();
+
+        public TargetControlMessage.LockContentionStats[] LockContention = null;
     };
 };
@@ -73,6 +73,9 @@ public class StaticExports
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern ReplayCreateStatus RENDERDOC_CreateRemoteServerConnection(IntPtr host, UInt32 port, ref IntPtr outrend);
 
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern bool RENDERDOC_GetRemoteServerStatus(IntPtr host, UInt32 port, IntPtr outstatus);
+
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern void RENDERDOC_GetDefaultCaptureOptions(IntPtr outopts);
 
@@ -88,6 +91,21 @@ public class StaticExports
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern IntPtr RENDERDOC_GetLogFile();
 
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern void RENDERDOC_SetTraceEnabled(bool enabled);
+
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern void RENDERDOC_ClearTrace();
+
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern bool RENDERDOC_WriteTrace(IntPtr filename);
+
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern void RENDERDOC_BeginTraceZone(IntPtr name);
+
+        [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
+        private static extern void RENDERDOC_EndTraceZone();
+
         [DllImport("renderdoc.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.Cdecl)]
         private static extern IntPtr RENDERDOC_GetConfigSetting(IntPtr name);
 
@@ -307,6 +325,24 @@ public static RemoteServer CreateRemoteServer(string host, uint port)
             return new RemoteServer(rendPtr);
         }
 
+        public static RemoteServerStatus GetRemoteServerStatus(string host, uint port)
+        {
+            IntPtr host_mem = CustomMarshal.MakeUTF8String(host);
+            IntPtr mem = CustomMarshal.Alloc(typeof(RemoteServerStatus));
+
+            bool success = RENDERDOC_GetRemoteServerStatus(host_mem, port, mem);
+
+            RemoteServerStatus ret = null;
+
+            if (success)
+                ret = (RemoteServerStatus)CustomMarshal.PtrToStructure(mem, typeof(RemoteServerStatus), true);
+
+            CustomMarshal.Free(host_mem);
+            CustomMarshal.Free(mem);
+
+            return ret;
+        }
+
         public static void BecomeRemoteServer(string host, uint port, ref bool killReplay)
         {
             IntPtr host_mem = CustomMarshal.MakeUTF8String(host);
@@ -335,6 +371,41 @@ public static string GetLogFilename()
             return CustomMarshal.PtrToStringUTF8(RENDERDOC_GetLogFile());
         }
 
+        public static void SetTraceEnabled(bool enabled)
+        {
+            RENDERDOC_SetTraceEnabled(enabled);
+        }
+
+        public static void ClearTrace()
+        {
+            RENDERDOC_ClearTrace();
+        }
+
+        public static bool WriteTrace(string filename)
+        {
+            IntPtr filename_mem = CustomMarshal.MakeUTF8String(filename);
+
+            bool success = RENDERDOC_WriteTrace(filename_mem);
+
+            CustomMarshal.Free(filename_mem);
+
+            return success;
+        }
+
+        public static void BeginTraceZone(string name)
+        {
+            IntPtr name_mem = CustomMarshal.MakeUTF8String(name);
+
+            RENDERDOC_BeginTraceZone(name_mem);
+
+            CustomMarshal.Free(name_mem);
+        }
+
+        public static void EndTraceZone()
+        {
+            RENDERDOC_EndTraceZone();
+        }
+
         public static string GetVersionString()
         {
             return CustomMarshal.PtrToStringUTF8(RENDERDOC_GetVersionString());